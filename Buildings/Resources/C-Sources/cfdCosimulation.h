@@ -23,10 +23,6 @@
 #else /* Linux*/
 #include <dlfcn.h>  /*For load shared library*/
 #include <unistd.h> /*For Linux function*/
-/* Use usleep (microseconds) to avoid integer division truncation.
- * The original sleep(ceil(x/1000.)) converts ms->s using integer sleep(),
- * so Sleep(10) becomes sleep(1) = 1 second instead of 10 ms. */
-#define Sleep(x) usleep((unsigned int)((x) * 1000U))
 #endif
 
 #ifndef _MODELICA_FFD_COMMON_H
@@ -35,7 +31,18 @@
 #include <stdint.h> /* Needed to detect 32 vs. 64 bit using UINTPTR_MAX*/
 #endif
 
-extern CosimulationData *cosim;
-
 /*declare the ffd_dll function in DLL*/
 void *ffd_dll(CosimulationData *cosim);
+
+/*declare the functions in DLL that synchronize the data exchange,
+  see cosim_sync.h of FFD*/
+int cosim_sync_init(CosimulationData *cosim);
+void cosim_sync_free(CosimulationData *cosim);
+void cosim_lock(CosimulationData *cosim);
+void cosim_unlock(CosimulationData *cosim);
+int cosim_wait(CosimulationData *cosim, int timeout);
+void cosim_notify(CosimulationData *cosim);
+void cosim_set_flag(CosimulationData *cosim, volatile int *flag, int value);
+int cosim_get_flag(CosimulationData *cosim, volatile int *flag);
+int cosim_acquire_id(void);
+void cosim_release_id(void);
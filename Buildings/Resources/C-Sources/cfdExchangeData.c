@@ -16,12 +16,14 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 
 #include "ModelicaUtilities.h"
 
 /*
  * Exchange the data between Modelica and CFD
  *
+ * @param FFDThre Pointer to the cosimulation data of the instance
  * @param t0 Current time of integration for Modelica
  * @param dt Time step size for next synchronization defined by Modelica
  * @param u Pointer to the input data from Modelica to CFD
@@ -31,11 +33,20 @@
  *
  * @return 0 if no error occurred
  */
-int cfdExchangeData(double t0, double dt, const double *u, size_t nU, size_t nY,
-                 double *t1, double *y) {
-  size_t i, j, k;
+int cfdExchangeData(void *FFDThre, double t0, double dt, const double *u,
+                 size_t nU, size_t nY, double *t1, double *y) {
+  CosimulationData *cosim = (CosimulationData *) FFDThre;
+  ModelicaSharedData *modelica;
+  ffdSharedData *ffd;
+  size_t i;
   int writeData = 1;
 
+  if(nU<(size_t)cosim->para->nU || nY<(size_t)cosim->para->nY) {
+    ModelicaFormatError("Expected %d inputs and %d outputs for CFD, "
+                        "but received %d inputs and %d outputs.",
+                        cosim->para->nU, cosim->para->nY, (int)nU, (int)nY);
+  }
+
   /*check if current modelica time equals to last time*/
   /*if yes, it means cfdExchangeData() was called multiple times at one synchronization point, then skip writing data to CFD (only copy result to outputs)*/
   if(fabs(cosim->modelica->lt - t0) < 1E-6){
@@ -50,116 +61,68 @@ int cfdExchangeData(double t0, double dt, const double *u, size_t nU, size_t nY,
   |  1: data waiting for the other program to read
   --------------------------------------------------------------------------*/
   if (writeData) {
-    /* If previous data hasn't been read, wait*/
-    while(cosim->modelica->flag==1) {
-      if(cosim->para->ffdError==1)
-        ModelicaError(cosim->ffd->msg);
-      else
-        Sleep(10);
-    }
+    /* Write the data to the back buffer, which is not read by CFD.
+       The arrays of the buffer have the layout of u.*/
+    modelica = cosim->modelicaBack;
+    modelica->t = t0;
+    modelica->dt = dt;
+    modelica->lt = t0;
 
-    cosim->modelica->t = t0;
-    cosim->modelica->dt = dt;
-    cosim->modelica->lt = t0;
-
-    /* Copy the Modelica data to shared memory*/
-    for(i=0; i<cosim->para->nSur; i++) {
-      cosim->modelica->temHea[i] = u[i];
-    }
+    memcpy(modelica->u, u, cosim->para->nU*sizeof(double));
 
+    i = cosim->para->nSur;
     if(cosim->para->sha==1) {
-      for(j=0; j<cosim->para->nConExtWin; j++) {
-        cosim->modelica->shaConSig[j] = u[i+j];
-        cosim->modelica->shaAbsRad[j] = u[i+j+cosim->para->nConExtWin];
-      }
       i = i + 2*cosim->para->nConExtWin;
     }
-
-    cosim->modelica->sensibleHeat = u[i];
-    i++;
-
-    cosim->modelica->latentHeat = u[i];
-    i++;
-
-    cosim->modelica->p = u[i];
-    i++;
-
-    for(j=0; j<cosim->para->nPorts; j++) {
-      cosim->modelica->mFloRatPor[j] = u[i+j];
-      cosim->modelica->TPor[j] = u[i+j+cosim->para->nPorts];
+    modelica->sensibleHeat = u[i];
+    modelica->latentHeat = u[i+1];
+    modelica->p = u[i+2];
+
+    /* If previous data hasn't been read, wait.
+       FFD wakes up this thread when it has read the data or stopped with
+       an error.*/
+    cosim_lock(cosim);
+    while(cosim->modelica->flag==1 && cosim->para->ffdError!=1)
+      cosim_wait(cosim, 1000);
+    if(cosim->para->ffdError==1) {
+      cosim_unlock(cosim);
+      ModelicaError(cosim->ffd->msg);
     }
 
-    i = i + 2*cosim->para->nPorts;
-    for(j=0; j<cosim->para->nPorts; j++)
-      for(k=0; k<cosim->para->nXi; k++) {
-        cosim->modelica->XiPor[j][k] = u[i+j*cosim->para->nXi+k];
-      }
-
-    i = i + cosim->para->nPorts*cosim->para->nXi;
-    for(j=0; j<cosim->para->nPorts; j++)
-      for(k=0; k<cosim->para->nC; k++) {
-        cosim->modelica->CPor[j][k] = u[i+j*cosim->para->nC+k];
-      }
-
-    /* Set the flag to new data*/
+    /* Publish the new data by swapping the buffers*/
+    cosim->modelicaBack = cosim->modelica;
+    cosim->modelica = modelica;
     cosim->modelica->flag = 1;
+    cosim_notify(cosim);
+    cosim_unlock(cosim);
   } else {
-    cosim->ffd->flag = 1;
+    cosim_set_flag(cosim, &cosim->ffd->flag, 1);
   }
 
   /****************************************************************************
   | Copy data from CFD
   ****************************************************************************/
-  /* If the data is not ready or not updated, check again*/
-  while(cosim->ffd->flag!=1) {
-    if(cosim->para->ffdError==1)
-      ModelicaError(cosim->ffd->msg);
-    else
-      Sleep(10);
-  }
-
-  /* Get the temperature/heat flux for solid surface*/
-  for(i=0; i<cosim->para->nSur; i++) {
-    y[i] = cosim->ffd->temHea[i];
-  }
+  /* If the data is not ready or not updated, wait until FFD wakes up
+     this thread*/
+  cosim_lock(cosim);
+  while(cosim->ffd->flag!=1 && cosim->para->ffdError!=1)
+    cosim_wait(cosim, 1000);
+  cosim_unlock(cosim);
+  if(cosim->para->ffdError==1)
+    ModelicaError(cosim->ffd->msg);
+
+  /* FFD does not swap the buffers before the data has been taken.
+     The arrays of the buffer have the layout of y.*/
+  ffd = cosim->ffd;
+  memcpy(y, ffd->y, cosim->para->nY*sizeof(double));
 
   /* Get the averaged room temperature*/
-  y[i] = cosim->ffd->TRoo;
-  i++;
+  y[cosim->para->nSur] = ffd->TRoo;
 
-  /* Get the temperature of shading device if there is a shading device*/
-  if(cosim->para->sha==1) {
-    for(j=0; j<cosim->para->nConExtWin; i++, j++) {
-      y[i] = cosim->ffd->TSha[j];
-    }
-  }
-
-  /* Get the temperature fluid at the fluid ports*/
-  for(j=0; j<cosim->para->nPorts; i++, j++) {
-    y[i] = cosim->ffd->TPor[j];
-  }
-
-  /* Get the mass fraction at fluid ports*/
-  for(j=0; j<cosim->para->nPorts; j++)
-    for(k=0; k<cosim->para->nXi; k++, i++) {
-       y[i] = cosim->ffd->XiPor[j][k];
-    }
-
-  /* Get the trace substance at fluid ports*/
-  for(j=0; j<cosim->para->nPorts; j++)
-    for(k=0; k<cosim->para->nC; k++, i++) {
-       y[i] = cosim->ffd->CPor[j][k];
-    }
-
-  /* Get the sensor data*/
-  for(j=0; j<cosim->para->nSen; j++, i++) {
-    y[i] = cosim->ffd->senVal[j];
-  }
+  *t1 = ffd->t;
 
   /* Update the data status*/
-  cosim->ffd->flag = 0;
-
-  *t1 = cosim->ffd->t;
+  cosim_set_flag(cosim, &ffd->flag, 0);
 
   return 0;
 } /* End of cfdExchangeData()*/
@@ -16,29 +16,71 @@
 #include "cfdCosimulation.h"
 
 #include <stdlib.h>
+/*
+ * Free the arrays of a buffer for the data sent from Modelica to CFD
+ *
+ * @param modelica Pointer to the buffer
+ *
+ * @return No return needed
+ */
+static void cfdFreeModelicaData(ModelicaSharedData *modelica) {
+  if (modelica->u != NULL){
+    free(modelica->u);
+  }
+  if (modelica->XiPor != NULL){
+    free(modelica->XiPor);
+  }
+  if (modelica->CPor != NULL){
+    free(modelica->CPor);
+  }
+} /* End of cfdFreeModelicaData*/
+
+/*
+ * Free the arrays of a buffer for the data sent from CFD to Modelica
+ *
+ * @param ffd Pointer to the buffer
+ *
+ * @return No return needed
+ */
+static void cfdFreeFfdData(ffdSharedData *ffd) {
+  if (ffd->y != NULL){
+    free(ffd->y);
+  }
+  if (ffd->XiPor != NULL){
+    free(ffd->XiPor);
+  }
+  if (ffd->CPor != NULL){
+    free(ffd->CPor);
+  }
+} /* End of cfdFreeFfdData*/
+
 /*
  * Send a stop command to terminate the CFD simulation
  *
+ * @param thread Pointer to the cosimulation data of the instance
+ *
  * @return No return needed
  */
 void cfdSendStopCommand(void *thread) {
 
+  CosimulationData *cosim = (CosimulationData *) thread;
   size_t i = 0;
   size_t imax = 10000;
 
   /*send stop command to FFD*/
+  cosim_lock(cosim);
   cosim->para->flag = 0;
+  cosim_notify(cosim);
 
-  /* Wait for the feedback from FFD*/
- while(cosim->started==1 && cosim->para->flag==0 && i<imax) {
-    if(cosim->para->ffdError==1) {
-      ModelicaError(cosim->ffd->msg);
-    }
-    else {
-      Sleep(10);
+  /* Wait for the feedback from FFD.
+     Only the waits that time out are counted, so that FFD has
+     imax times 10 ms to stop.*/
+  while(cosim->started==1 && cosim->para->flag==0 && i<imax
+        && cosim->para->ffdError!=1) {
+    if(cosim_wait(cosim, 10)!=0)
       i++;
-    }
   }
+  cosim_unlock(cosim);
 
   if(i<imax) {
     if(cosim->para->ffdError==1) {
@@ -78,9 +120,6 @@ void cfdSendStopCommand(void *thread) {
     }
   }
   if (cosim->para->nSen>0){
-    if (cosim->ffd->senVal != NULL){
-      free(cosim->ffd->senVal);
-    }
     for(i=0; i<cosim->para->nSen; i++) {
       free(cosim->para->sensorName[i]);
     }
@@ -88,58 +127,20 @@ void cfdSendStopCommand(void *thread) {
       free(cosim->para->sensorName);
     }
   }
-  if (cosim->modelica->temHea != NULL){
-    free(cosim->modelica->temHea);
-  }
-  if (cosim->para->sha==1){
-    if (cosim->modelica->shaConSig != NULL){
-      free(cosim->modelica->shaConSig);
-    }
-    if (cosim->modelica->shaAbsRad != NULL){
-      free(cosim->modelica->shaAbsRad);
-    }
-    if (cosim->ffd->TSha != NULL){
-      free(cosim->ffd->TSha);
-    }
-  }
   if (cosim->para->nPorts>0){
-    for(i=0; i<cosim->para->nPorts; i++) {
-      free(cosim->modelica->XiPor[i]);
-      free(cosim->ffd->XiPor[i]);
-      free(cosim->modelica->CPor[i]);
-      free(cosim->ffd->CPor[i]);
-    }
-    if (cosim->modelica->CPor != NULL){
-      free(cosim->modelica->CPor);
-    }
-    if (cosim->ffd->CPor != NULL){
-      free(cosim->ffd->CPor);
-    }
-    if (cosim->modelica->XiPor != NULL){
-      free(cosim->modelica->XiPor);
-    }
-    if (cosim->ffd->XiPor != NULL){
-      free(cosim->ffd->XiPor);
-    }
-    if (cosim->modelica->TPor != NULL){
-      free(cosim->modelica->TPor);
-    }
-    if (cosim->ffd->TPor != NULL){
-      free(cosim->ffd->TPor);
-    }
     for(i=0; i<cosim->para->nPorts; i++) {
       free(cosim->para->portName[i]);
     }
     if (cosim->para->portName != NULL){
       free(cosim->para->portName);
     }
-    if (cosim->modelica->mFloRatPor != NULL){
-      free(cosim->modelica->mFloRatPor);
-    }
-  }
-  if (cosim->ffd->temHea != NULL){
-    free(cosim->ffd->temHea);
   }
+  /* The arrays of the buffers point into u and y*/
+  cfdFreeModelicaData(cosim->modelica);
+  cfdFreeModelicaData(cosim->modelicaBack);
+  cfdFreeFfdData(cosim->ffd);
+  cfdFreeFfdData(cosim->ffdBack);
+  /* The message is shared by both buffers of FFD*/
   if (cosim->ffd->msg != NULL){
     free(cosim->ffd->msg);
   }
@@ -152,11 +153,16 @@ void cfdSendStopCommand(void *thread) {
   if (cosim->ffd != NULL){
     free(cosim->ffd);
   }
+  if (cosim->modelicaBack != NULL){
+    free(cosim->modelicaBack);
+  }
+  if (cosim->ffdBack != NULL){
+    free(cosim->ffdBack);
+  }
   if (cosim != NULL){
+    cosim_sync_free(cosim);
     free(cosim);
-    /* If it is not explicitly set to NULL - then the check in cfdcosim()
-       will fail if a second simulation is performed. */
-    cosim = NULL;
+    cosim_release_id();
   }
 
 } /* End of cfdSendStopCommand*/
@@ -21,11 +21,127 @@
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Allocate a buffer for the data sent from Modelica to CFD
+ *
+ * The arrays point into one block that has the layout of the inputs of
+ * cfdExchangeData(), so that the inputs are copied at once.
+ *
+ * @param modelica Pointer to the buffer
+ * @param para Pointer to the parameters of the cosimulation
+ *
+ * @return No return needed
+ */
+static void cfdAllocateModelicaData(ModelicaSharedData *modelica,
+                                    const ParameterSharedData *para) {
+  double *u;
+  int i;
+
+  modelica->u = (double *) calloc(para->nU, sizeof(double));
+  if (modelica->u == NULL){
+    ModelicaError("Failed to allocate memory for cosim->modelica->u in cfdStartCosimulation.c");
+  }
+  modelica->XiPor = (double **) malloc(para->nPorts*sizeof(double *));
+  if (modelica->XiPor == NULL){
+    ModelicaError("Failed to allocate memory for cosim->modelica->XiPor in cfdStartCosimulation.c");
+  }
+  modelica->CPor = (double **) malloc(para->nPorts*sizeof(double *));
+  if (modelica->CPor == NULL){
+    ModelicaError("Failed to allocate memory for cosim->modelica->CPor in cfdStartCosimulation.c");
+  }
+
+  u = modelica->u;
+  modelica->temHea = u;
+  u += para->nSur;
+  /* Having a shade for window*/
+  if(para->sha==1) {
+    modelica->shaConSig = u;
+    u += para->nConExtWin;
+    modelica->shaAbsRad = u;
+    u += para->nConExtWin;
+  }
+  /* Skip sensibleHeat, latentHeat and p*/
+  u += 3;
+  modelica->mFloRatPor = u;
+  u += para->nPorts;
+  modelica->TPor = u;
+  u += para->nPorts;
+  for(i=0; i<para->nPorts; i++) {
+    modelica->XiPor[i] = u;
+    u += para->nXi;
+  }
+  for(i=0; i<para->nPorts; i++) {
+    modelica->CPor[i] = u;
+    u += para->nC;
+  }
+
+  modelica->flag = 0;
+  modelica->t = 0;
+  modelica->dt = 0;
+  modelica->lt = -1;/*initialize lt to -1 to avoid skipping all exchange() at time = 0*/
+} /* End of cfdAllocateModelicaData()*/
+
+/*
+ * Allocate a buffer for the data sent from CFD to Modelica
+ *
+ * The arrays point into one block that has the layout of the outputs of
+ * cfdExchangeData(), so that the outputs are copied at once.
+ *
+ * @param ffd Pointer to the buffer
+ * @param para Pointer to the parameters of the cosimulation
+ *
+ * @return No return needed
+ */
+static void cfdAllocateFfdData(ffdSharedData *ffd,
+                               const ParameterSharedData *para) {
+  double *y;
+  int i;
+
+  ffd->y = (double *) calloc(para->nY, sizeof(double));
+  if (ffd->y == NULL){
+    ModelicaError("Failed to allocate memory for cosim->ffd->y in cfdStartCosimulation.c");
+  }
+  ffd->XiPor = (double **) malloc(para->nPorts*sizeof(double *));
+  if (ffd->XiPor == NULL){
+    ModelicaError("Failed to allocate memory for cosim->ffd->XiPor in cfdStartCosimulation.c");
+  }
+  ffd->CPor = (double **) malloc(para->nPorts*sizeof(double *));
+  if (ffd->CPor == NULL){
+    ModelicaError("Failed to allocate memory for cosim->ffd->CPor in cfdStartCosimulation.c");
+  }
+
+  y = ffd->y;
+  ffd->temHea = y;
+  y += para->nSur;
+  /* Skip TRoo*/
+  y++;
+  if(para->sha==1) {
+    ffd->TSha = y;
+    y += para->nConExtWin;
+  }
+  ffd->TPor = y;
+  y += para->nPorts;
+  for(i=0; i<para->nPorts; i++) {
+    ffd->XiPor[i] = y;
+    y += para->nXi;
+  }
+  for(i=0; i<para->nPorts; i++) {
+    ffd->CPor[i] = y;
+    y += para->nC;
+  }
+  ffd->senVal = y;
+
+  ffd->flag = 0;
+  ffd->t = 0;
+  ffd->TRoo = 0;
+} /* End of cfdAllocateFfdData()*/
+
 /*
  * Start the cosimulation
  *
  * Allocate memory for the data exchange and launch CFD simulation
  *
+ * @param FFDThre Pointer to the cosimulation data of the instance
  * @param cfdFilNam Name of the input file for the CFD simulation
  * @param name Pointer to the names of surfaces and fluid ports
  * @param A Pointer to the area of surfaces in the same order of name
@@ -46,10 +162,11 @@
  *
  * @return 0 if no error occurred
  */
-int cfdStartCosimulation(const char *cfdFilNam, const char **name, const double *A, const double *til,
+int cfdStartCosimulation(void *FFDThre, const char *cfdFilNam, const char **name, const double *A, const double *til,
                 const int *bouCon, int nPorts, const char** portName, int haveSensor,
                 const char **sensorName, int haveShade, size_t nSur, size_t nSen,
                 size_t nConExtWin, size_t nXi, size_t nC, double rho_start) {
+  CosimulationData *cosim = (CosimulationData *) FFDThre;
   size_t i;
   size_t nBou;
 
@@ -60,6 +177,7 @@ int cfdStartCosimulation(const char *cfdFilNam, const char **name, const double
   | Calling this function more than once would launch additional FFD threads
   | that all share the same cosim data structure, causing data races and
   | heap corruption ("free(): unaligned chunk detected in tcache 2").
+  | The flag is kept per instance, so other rooms are started independently.
   ****************************************************************************/
   if (cosim->started == 1) {
     return 0;
@@ -133,10 +251,6 @@ int cfdStartCosimulation(const char *cfdFilNam, const char **name, const double
     if (  cosim->para->sensorName == NULL){
       ModelicaError("Failed to allocate memory for cosim->para->sensorName in cfdStartCosimulation.c");
     }
-    cosim->ffd->senVal = (double *) malloc(nSen*sizeof(double));
-    if (  cosim->ffd->senVal == NULL){
-      ModelicaError("Failed to allocate memory for cosim->ffd->senVal in cfdStartCosimulation.c");
-    }
     for(i=0; i<nSen; i++) {
       cosim->para->sensorName[i] = NULL;
       cosim->para->sensorName[i] = (char *)malloc(sizeof(char)*(strlen(sensorName[i])+1));
@@ -147,99 +261,31 @@ int cfdStartCosimulation(const char *cfdFilNam, const char **name, const double
     }
   }
 
-  /* Set the flag to initial value*/
-  cosim->modelica->flag = 0;
-  cosim->ffd->flag = 0;
-  cosim->para->flag = 1;
-  cosim->para->ffdError = 0;
-  cosim->modelica->t = 0;
-  cosim->modelica->lt = -1;/*initialize lt to -1 to avoid skipping all exchange() at time = 0*/
-
-  cosim->modelica->temHea = (double *) malloc(nSur*sizeof(double));
-  if (cosim->modelica->temHea == NULL){
-    ModelicaError("Failed to allocate memory for cosim->modelica->temHea in cfdStartCosimulation.c");
-  }
-  /* Having a shade for window*/
+  /****************************************************************************
+  | Allocate two buffers for each direction of the data exchange
+  ****************************************************************************/
+  cosim->para->nU = (int) (nSur + 3 + nPorts*(2+nXi+nC));
+  cosim->para->nY = (int) (nSur + 1 + nPorts*(1+nXi+nC) + nSen);
   if(haveShade==1) {
-    cosim->modelica->shaConSig = (double *) malloc(nConExtWin*sizeof(double));
-    if (  cosim->modelica->shaConSig == NULL){
-      ModelicaError("Failed to allocate memory for cosim->modelica->shaConSig in cfdStartCosimulation.c");
-    }
-    cosim->modelica->shaAbsRad = (double *) malloc(nConExtWin*sizeof(double));
-    if (  cosim->modelica->shaAbsRad == NULL){
-      ModelicaError("Failed to allocate memory for cosim->modelica->shaAbsRad in cfdStartCosimulation.c");
-    }
-  }
-  cosim->modelica->mFloRatPor = (double *) malloc(nPorts*sizeof(double));
-  if (cosim->modelica->mFloRatPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->modelica->mFloRatPor in cfdStartCosimulation.c");
-  }
-  cosim->modelica->TPor = (double *) malloc(nPorts*sizeof(double));
-  if (cosim->modelica->TPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->modelica->TPor in cfdStartCosimulation.c");
+    cosim->para->nU += (int) (2*nConExtWin);
+    cosim->para->nY += (int) nConExtWin;
   }
 
-  cosim->modelica->XiPor = (double **) malloc(nPorts*sizeof(double *));
-  if (cosim->modelica->XiPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->modelica->XiPor in cfdStartCosimulation.c");
-  }
-  cosim->ffd->XiPor = (double **) malloc(nPorts*sizeof(double *));
-  if (cosim->ffd->XiPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->ffd->XiPor in cfdStartCosimulation.c");
-  }
-  for(i=0; i<nPorts; i++) {
-    cosim->modelica->XiPor[i] = NULL;
-    cosim->modelica->XiPor[i] = (double *) malloc(cosim->para->nXi*sizeof(double));
-    if (  cosim->modelica->XiPor[i] == NULL){
-      ModelicaError("Failed to allocate memory for cosim->modelica->XiPor[i] in cfdStartCosimulation.c");
-    }
-    cosim->ffd->XiPor[i] = NULL;
-    cosim->ffd->XiPor[i] = (double *) malloc(cosim->para->nXi*sizeof(double));
-    if (  cosim->ffd->XiPor[i] == NULL){
-      ModelicaError("Failed to allocate memory for cosim->ffd->XiPor[i] in cfdStartCosimulation.c");
-    }
-  }
+  cfdAllocateModelicaData(cosim->modelica, cosim->para);
+  cfdAllocateModelicaData(cosim->modelicaBack, cosim->para);
+  cfdAllocateFfdData(cosim->ffd, cosim->para);
+  cfdAllocateFfdData(cosim->ffdBack, cosim->para);
 
-  cosim->modelica->CPor = (double **) malloc(nPorts*sizeof(double *));
-  if (cosim->modelica->CPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->modelica->CPor in cfdStartCosimulation.c");
-  }
-  cosim->ffd->CPor = (double **) malloc(nPorts*sizeof(double *));
-  if (cosim->ffd->CPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->ffd->CPor in cfdStartCosimulation.c");
-  }
-  for(i=0; i<nPorts; i++) {
-    cosim->modelica->CPor[i] = NULL;
-    cosim->modelica->CPor[i] = (double *) malloc(cosim->para->nC*sizeof(double));
-    if (  cosim->modelica->CPor[i] == NULL){
-      ModelicaError("Failed to allocate memory for cosim->modelica->CPor[i] in cfdStartCosimulation.c");
-    }
-    cosim->ffd->CPor[i] = NULL;
-    cosim->ffd->CPor[i] = (double *) malloc(cosim->para->nC*sizeof(double));
-    if (  cosim->ffd->CPor[i] == NULL){
-      ModelicaError("Failed to allocate memory for cosim->ffd->CPor[i] in cfdStartCosimulation.c");
-    }
-  }
+  /* Set the flag to initial value*/
+  cosim->para->flag = 1;
+  cosim->para->ffdError = 0;
 
+  /* The message is shared by both buffers of FFD*/
   cosim->ffd->msg = (char *) malloc(1000*sizeof(char));
   if (cosim->ffd->msg == NULL){
     ModelicaError("Failed to allocate memory for cosim->ffd->msg in cfdStartCosimulation.c");
   }
-
-  cosim->ffd->temHea = (double *) malloc(nSur*sizeof(double));
-  if (cosim->ffd->temHea == NULL){
-    ModelicaError("Failed to allocate memory for cosim->ffd->temHea in cfdStartCosimulation.c");
-  }
-  if(haveShade==1){
-     cosim->ffd->TSha = (double *) malloc(nConExtWin*sizeof(double));
-     if (   cosim->ffd->TSha == NULL){
-       ModelicaError("Failed to allocate memory for    cosim->ffd->TSha in cfdStartCosimulation.c");
-     }
-  }
-  cosim->ffd->TPor = (double *) malloc(nPorts*sizeof(double));
-  if (cosim->ffd->TPor == NULL){
-    ModelicaError("Failed to allocate memory for cosim->ffd->TPor in cfdStartCosimulation.c");
-  }
+  cosim->ffdBack->msg = cosim->ffd->msg;
 
   /****************************************************************************
   | Implicitly launch DLL module.
@@ -249,9 +295,10 @@ int cfdStartCosimulation(const char *cfdFilNam, const char **name, const double
      * Windows). The thread is detached inside ffd_dll(), so we only need to
      * free the handle pointer itself once it is no longer needed. */
     void *threadHandle = ffd_dll(cosim);
-    if (threadHandle != NULL) {
-      free(threadHandle);
+    if (threadHandle == NULL) {
+      ModelicaError("Failed to launch the FFD simulation in cfdStartCosimulation.c");
     }
+    free(threadHandle);
   }
   cosim->started = 1;
 
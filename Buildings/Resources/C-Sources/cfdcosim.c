@@ -25,24 +25,18 @@
 
 #include <stdlib.h>
 
-/* Single definition of the global cosim pointer shared across all C-Source files */
-CosimulationData *cosim = NULL;
-
 /*
  * Start the cosimulation
  *
- * Allocate memory for cosimulation variables
+ * Allocate memory for cosimulation variables.
+ * Each call creates a new instance, so that every room with FFD runs its
+ * own simulation.
  *
+ * @return Pointer to the cosimulation data of the instance
  */
 void *cfdcosim() {
 
-  /* CosimulationData *cosim = NULL; */
-
-  /****************************************************************************
-  | return modelica error if more than one ffd instances are created
-  ****************************************************************************/
-  if ( cosim != NULL )
-    ModelicaError("ModelicaError: Only one room with FFD can be used, but more than one is used.");
+  CosimulationData *cosim = NULL;
 
   /****************************************************************************
   | Allocate memory for cosimulation variables
@@ -71,6 +65,20 @@ void *cfdcosim() {
     ModelicaError("Failed to allocate memory for cosim->ffd in cfdcosim.c");
   }
 
+  /* Second buffer of each side, so that one side can write its next data
+     while the other side reads the current data*/
+  cosim->modelicaBack = NULL;
+  cosim->modelicaBack = (ModelicaSharedData *) malloc(sizeof(ModelicaSharedData));
+  if (cosim->modelicaBack == NULL){
+    ModelicaError("Failed to allocate memory for cosim->modelicaBack in cfdcosim.c");
+  }
+
+  cosim->ffdBack = NULL;
+  cosim->ffdBack = (ffdSharedData *) malloc(sizeof(ffdSharedData));
+  if (cosim->ffdBack == NULL){
+    ModelicaError("Failed to allocate memory for cosim->ffdBack in cfdcosim.c");
+  }
+
   /****************************************************************************
   | Initialize cosimulation variables
   ****************************************************************************/
@@ -85,6 +93,8 @@ void *cfdcosim() {
   cosim->para->sha = 0;
   cosim->para->nC = 0;
   cosim->para->nXi = 0;
+  cosim->para->nU = 0;
+  cosim->para->nY = 0;
   cosim->ffd->msg = NULL;
   cosim->para->fileName = NULL;
   cosim->para->filePath = NULL;
@@ -107,7 +117,22 @@ void *cfdcosim() {
   cosim->modelica->shaConSig = NULL;
   cosim->modelica->shaAbsRad = NULL;
   cosim->ffd->TSha = NULL;
+  cosim->modelica->u = NULL;
+  cosim->ffd->y = NULL;
+  *cosim->modelicaBack = *cosim->modelica;
+  *cosim->ffdBack = *cosim->ffd;
   cosim->started = 0;
 
+  /* Lock of the flags used by Modelica and FFD*/
+  if (cosim_sync_init(cosim) != 0){
+    ModelicaError("Failed to allocate memory for cosim->sync in cfdcosim.c");
+  }
+
+  /****************************************************************************
+  | Assign the ID of the instance. The IDs are kept by the FFD library, as
+  | this file is included in the code of each model.
+  ****************************************************************************/
+  cosim->id = cosim_acquire_id();
+
   return (void*) cosim;
 } /* End of cfdcosim()*/
@@ -90,8 +90,8 @@ goto missing
 
 ::Source Files and Header Files setting
 
-  set SourceFile=advection.c;boundary.c;chen_zero_equ_model.c;cosimulation.c;data_writer.c;diffusion.c;ffd.c;ffd_data_reader.c;ffd_dll.c;geometry.c;initialization.c;interpolation.c;parameter_reader.c;projection.c;sci_reader.c;solver.c;solver_gs.c;solver_tdma.c;timing.c;utility.c;
-  set HeaderFile=advection.h;boundary.h;chen_zero_equ_model.h;cosimulation.h;data_structure.h;data_writer.h;diffusion.h;ffd.h;ffd_data_reader.h;ffd_dll.h;geometry.h;initialization.h;interpolation.h;modelica_ffd_common.h;parameter_reader.h;projection.h;sci_reader.h;solver.h;solver_gs.h;solver_tdma.h;timing.h;utility.h
+  set SourceFile=advection.c;boundary.c;checkpoint.c;chen_zero_equ_model.c;cosim_sync.c;cosimulation.c;data_writer.c;diffusion.c;ffd.c;ffd_data_reader.c;ffd_dll.c;geometry.c;initialization.c;interpolation.c;logger.c;parameter_reader.c;projection.c;sci_cache.c;sci_reader.c;solver.c;solver_gs.c;solver_mg.c;solver_pcg.c;solver_rbgs.c;solver_tdma.c;species.c;thread_team.c;timing.c;utility.c;vtk_writer.c;
+  set HeaderFile=advection.h;boundary.h;checkpoint.h;chen_zero_equ_model.h;cosim_sync.h;cosimulation.h;data_structure.h;data_writer.h;diffusion.h;ffd.h;ffd_data_reader.h;ffd_dll.h;geometry.h;initialization.h;interpolation.h;logger.h;modelica_ffd_common.h;parameter_reader.h;projection.h;sci_cache.h;sci_reader.h;solver.h;solver_gs.h;solver_mg.h;solver_pcg.h;solver_rbgs.h;solver_tdma.h;species.h;thread_team.h;timing.h;utility.h;vtk_writer.h
 
 ::-------------------------------------------------------------------
 ::Conditional PropertyGroup for Debug Mode and Release Mode
@@ -0,0 +1,42 @@
+/*
+	*
+	* \file   ModelicaUtilities.h
+	*
+	* \brief  Modelica utility functions for the drivers that run without
+	*         Modelica
+	*
+	* \date   10/18/2026
+	*
+	* The drivers, such as test_cosimulation.c, include the sources of
+	* Buildings/Resources/C-Sources, which include this header. The messages
+	* are written to the standard error and the errors stop the driver.
+	* This header is not used to build the FFD library.
+	*
+	*/
+#ifndef _MODELICA_UTILITIES_H
+#define _MODELICA_UTILITIES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+static void ModelicaMessage(const char *string) {
+  fprintf(stderr, "%s\n", string);
+}
+
+static void ModelicaError(const char *string) {
+  fprintf(stderr, "Error: %s\n", string);
+  exit(1);
+}
+
+static void ModelicaFormatError(const char *string, ...) {
+  va_list args;
+  va_start(args, string);
+  fprintf(stderr, "Error: ");
+  vfprintf(stderr, string, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+  exit(1);
+}
+
+#endif
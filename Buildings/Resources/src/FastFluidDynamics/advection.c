@@ -24,7 +24,7 @@
 	*/
 
 #include "advection.h"
-char msg[1000];
+FFD_THREAD_LOCAL char msg[1000];
 
 /*
 	* Entrance of advection step
@@ -106,129 +106,460 @@ int advect(PARA_DATA *para, REAL **var, int var_type, int index,
   return flag;
 } /* End of advect( )*/
 
+/* Work of the team for one advection*/
+typedef struct {
+  PARA_DATA *para;
+  REAL **var;
+  int var_type; /* Type of variable*/
+  int nb; /* Number of scalar variables that share the velocity field*/
+  REAL **d; /* Variables at the current time step*/
+  REAL **d0; /* Variables at the previous time step*/
+  int *fail; /* 4 entries per thread: failed flag, i, j, k of the cell*/
+} TRACE_TASK;
+
 	/*
-		* Advection for velocity at X-direction
+		* Trace back the location of a particle at the previous time step
+		*
+		* The particle is moved cell by cell in each direction until it reaches
+		* its location at the previous time step or hits a boundary.
 		*
 		* @param para Pointer to FFD parameters
 		* @param var Pointer to FFD simulation variables
-		* @param var_type The type of variable for advection solver
-		* @param d Pointer to the computed variables at previous time step
-		* @param d0 Pointer to the computed variables for current time step
-		* @param BINDEX Pointer to boundary index
+		* @param flag Pointer to the property of the cell
+		* @param xs Pointer to the X-location of the variable
+		* @param ys Pointer to the Y-location of the variable
+		* @param zs Pointer to the Z-location of the variable
+		* @param u0 X-velocity at the location of the variable
+		* @param v0 Y-velocity at the location of the variable
+		* @param w0 Z-velocity at the location of the variable
+		* @param i I-index of the cell
+		* @param j J-index of the cell
+		* @param k K-index of the cell
+		* @param OL Pointer to the location of particle at the previous time step
+		* @param OC Pointer to the coordinates of the cell for the interpolation
 		*
 		* @return 0 if no error occurred
 		*/
-int trace_vx(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
-             int **BINDEX) {
-  int i, j, k;
+static int trace_back(PARA_DATA *para, REAL **var, REAL *flag,
+                      REAL *xs, REAL *ys, REAL *zs, REAL u0, REAL v0, REAL w0,
+                      int i, int j, int k, REAL *OL, int *OC) {
   int it;
   int itmax = 20000; /* Max number of iterations for backward tracing*/
   int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL x_1, y_1, z_1;
   REAL dt = para->mytime->dt;
+  int COOD[3], LOC[3];
+
+  /* Find the location at previous time step*/
+  OL[X] = xs[IX(i,j,k)] - u0*dt;
+  OL[Y] = ys[IX(i,j,k)] - v0*dt;
+  OL[Z] = zs[IX(i,j,k)] - w0*dt;
+  /* Initialize the coordinates of previous step*/
+  OC[X] = i;
+  OC[Y] = j;
+  OC[Z] = k;
+  /* Initialize the signs for tracing process*/
+  /* Completed: 0; In process: 1*/
+  COOD[X] = 1;
+  COOD[Y] = 1;
+  COOD[Z] = 1;
+  /* Initialize the flags for recording if the tracing back hits the boundary*/
+  /* Hit the boundary: 0; Not hit the boundary: 1*/
+  LOC[X] = 1;
+  LOC[Y] = 1;
+  LOC[Z] = 1;
+  /*Initialize the number of iterations*/
+  it=1;
+
+  /* Trace back more if the any of the trace is still in process*/
+  while(COOD[X]==1 || COOD[Y]==1 || COOD[Z]==1) {
+    it++;
+    /* If trace in X is in process and donot hit the boundary*/
+    if(COOD[X]==1 && LOC[X]==1)
+      set_x_location(para, var, flag, xs, u0, i, j, k, OL, OC, LOC, COOD);
+    /* If trace in Y is in process and donot hit the boundary*/
+    if(COOD[Y]==1 && LOC[Y]==1)
+      set_y_location(para, var, flag, ys, v0, i, j, k, OL, OC, LOC, COOD);
+    /* If trace in Z is in process and donot hit the boundary*/
+    if(COOD[Z]==1 && LOC[Z]==1)
+      set_z_location(para, var, flag, zs, w0, i, j, k, OL, OC, LOC, COOD);
+
+    if(it>itmax)
+      return 1;
+  } /* End of while() for backward tracing*/
+
+  /* Set the coordinates of previous location if it is as boundary*/
+  if(u0>=0 && LOC[X]==0) OC[X] -=1;
+  if(v0>=0 && LOC[Y]==0) OC[Y] -=1;
+  if(w0>=0 && LOC[Z]==0) OC[Z] -=1;
+
+  /* LOC=1 means that traced back point hits boundary.*/
+  /* When u is less than zero, the traced back point is towards west.*/
+  /* When it hits the boundary, according to the code,*/
+  /* the east cell of west boundary will be given as the traced back location*/
+  /* and the index (OC) is also marching on one cell.*/
+  /* This means that the index and traced back location are on same cell.*/
+  /* That is why the index needs to move backward for one cell*/
+  /* in order to do interpolation.*/
+  if(u0<0 && LOC[X]==1) OC[X] -=1;
+  if(v0<0 && LOC[Y]==1) OC[Y] -=1;
+  if(w0<0 && LOC[Z]==1) OC[Z] -=1;
+
+  return 0;
+} /* End of trace_back()*/
+
+	/*
+		* Interpolate the variable at the location found by trace_back()
+		*
+		* @param para Pointer to FFD parameters
+		* @param d0 Pointer to the variable for interpolation
+		* @param xs Pointer to the X-location of the variable
+		* @param ys Pointer to the Y-location of the variable
+		* @param zs Pointer to the Z-location of the variable
+		* @param OL Pointer to the location of particle at the previous time step
+		* @param OC Pointer to the coordinates of the cell for the interpolation
+		*
+		* @return Interpolated value
+		*/
+static REAL trace_interpolate(PARA_DATA *para, REAL *d0,
+                              REAL *xs, REAL *ys, REAL *zs,
+                              REAL *OL, int *OC) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int c = IX(OC[X],OC[Y],OC[Z]);
+  REAL x_1, y_1, z_1;
+
+  x_1 = (OL[X]-xs[c]) / (xs[c+1]-xs[c]);
+  y_1 = (OL[Y]-ys[c]) / (ys[c+IMAX]-ys[c]);
+  z_1 = (OL[Z]-zs[c]) / (zs[c+IJMAX]-zs[c]);
+
+  return interpolation_bilinear(x_1, y_1, z_1,
+    d0[c],       d0[c+IMAX],       d0[c+1],       d0[c+1+IMAX],
+    d0[c+IJMAX], d0[c+IMAX+IJMAX], d0[c+1+IJMAX], d0[c+1+IMAX+IJMAX]);
+} /* End of trace_interpolate()*/
+
+	/*
+		* Advection of the cells with VX in a slab of k-planes
+		*
+		* @param task Pointer to the task
+		* @param k_start First k-plane of the slab
+		* @param k_end Last k-plane of the slab
+		* @param fail Pointer to the failed flag and the cell that failed
+		*
+		* @return No return needed
+		*/
+static void trace_vx_slab(TRACE_TASK *task, int k_start, int k_end,
+                          int *fail) {
+  PARA_DATA *para = task->para;
+  REAL **var = task->var;
+  int i, j, k;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
   REAL u0, v0, w0;
   REAL *x = var[X], *y = var[Y],  *z = var[Z];
   REAL *gx = var[GX];
   REAL *u = var[VX], *v = var[VY], *w = var[VZ];
   REAL *flagu = var[FLAGU];
-  int  COOD[3], LOC[3];
+  REAL *d = task->d[0], *d0 = task->d0[0];
   REAL OL[3];
   int  OC[3];
 
-  /****************************************************************************
-  | Go through all the cells with VX
-  ****************************************************************************/
-  FOR_U_CELL
-    if(flagu[IX(i,j,k)]>=0) continue;
-    /*-------------------------------------------------------------------------
-    | Step 1: Tracing Back
-    -------------------------------------------------------------------------*/
-    /* Get velocities at the location of VX*/
-    u0 = u[IX(i,j,k)];
-    v0 = (REAL) 0.5
-        * ((v[IX(i,  j,k)]+v[IX(i,  j-1,k)])*( x[IX(i+1,j,k)]-gx[IX(i,j,k)])
-          +(v[IX(i+1,j,k)]+v[IX(i+1,j-1,k)])*(gx[IX(i,  j,k)]- x[IX(i,j,k)]))
-        / (x[IX(i+1,j,k)]-x[IX(i,j,k)]);
-    w0 = (REAL) 0.5
-        * ((w[IX(i,  j,k)]+w[IX(i  ,j, k-1)])*( x[IX(i+1,j,k)]-gx[IX(i,j,k)])
-          +(w[IX(i+1,j,k)]+w[IX(i+1,j, k-1)])*(gx[IX(i,  j,k)]- x[IX(i,j,k)]))
-        / (x[IX(i+1,j,k)]-x[IX(i,j,k)]);
-    /* Find the location at previous time step*/
-    OL[X] =gx[IX(i,j,k)] - u0*dt;
-    OL[Y] = y[IX(i,j,k)] - v0*dt;
-    OL[Z] = z[IX(i,j,k)] - w0*dt;
-    /* Initialize the coordinates of previous step*/
-    OC[X] = i;
-    OC[Y] = j;
-    OC[Z] = k; /*OC is the trace back coordinates*/
-    /* Initialize the signs for track process*/
-    /* Completed: 0; In process: 1*/
-    COOD[X] = 1;
-    COOD[Y] = 1;
-    COOD[Z] = 1;
-    /* Initialize the signs for recording if the track back hits the boundary*/
-    /* Hit the boundary: 0; Not hit the boundary: 1*/
-    LOC[X] = 1;
-    LOC[Y] = 1;
-    LOC[Z] = 1;
-    /*Initialize the number of iterations*/
-    it=1;
-
-    /* Trace back more if the any of the trace is still in process*/
-    while(COOD[X]==1 || COOD[Y] ==1 || COOD[Z] ==1)
-    {
-      it++;
-      /* If trace in X is in process and donot hit the boundary*/
-      if(COOD[X]==1 && LOC[X]==1)
-        set_x_location(para, var, flagu, gx, u0, i, j, k, OL, OC, LOC, COOD);
-      /* If trace in Y is in process and donot hit the boundary*/
-      if(COOD[Y]==1 && LOC[Y]==1)
-        set_y_location(para, var, flagu, y, v0, i, j, k, OL, OC, LOC, COOD);
-      /* If trace in Z is in process and donot hit the boundary*/
-      if(COOD[Z]==1 && LOC[Z]==1)
-        set_z_location(para, var, flagu, z, w0, i, j, k, OL, OC, LOC, COOD);
-
-      if(it>itmax)
-      {
-        printf("Error: advection.c, can not track the location for VX(%d, %d,%d)",
-                i, j, k);
-        printf("after %d iterations.\n", it);
-        return 1;
+  for(k=k_start; k<=k_end; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax-1; i++) {
+        if(flagu[IX(i,j,k)]>=0) continue;
+        /* Get velocities at the location of VX*/
+        u0 = u[IX(i,j,k)];
+        v0 = (REAL) 0.5
+          * ((v[IX(i,  j,k)]+v[IX(i,  j-1,k)])*( x[IX(i+1,j,k)]-gx[IX(i,j,k)])
+            +(v[IX(i+1,j,k)]+v[IX(i+1,j-1,k)])*(gx[IX(i,  j,k)]- x[IX(i,j,k)]))
+          / (x[IX(i+1,j,k)]-x[IX(i,j,k)]);
+        w0 = (REAL) 0.5
+          * ((w[IX(i,  j,k)]+w[IX(i  ,j, k-1)])*( x[IX(i+1,j,k)]-gx[IX(i,j,k)])
+            +(w[IX(i+1,j,k)]+w[IX(i+1,j, k-1)])*(gx[IX(i,  j,k)]- x[IX(i,j,k)]))
+          / (x[IX(i+1,j,k)]-x[IX(i,j,k)]);
+
+        if(trace_back(para, var, flagu, gx, y, z, u0, v0, w0, i, j, k,
+                      OL, OC)) {
+          fail[0] = 1; fail[1] = i; fail[2] = j; fail[3] = k;
+          return;
+        }
+
+        d[IX(i,j,k)] = trace_interpolate(para, d0, gx, y, z, OL, OC);
       }
-    } /* End of while() for backward tracing*/
-
-    /* Set the coordinates of previous location if it is as boundary*/
-    if(u0>0 && LOC[X]==0) OC[X] -=1;
-    if(v0>0 && LOC[Y]==0) OC[Y] -=1;
-    if(w0>0 && LOC[Z]==0) OC[Z] -=1;
-
-    /* LOC=1 means that traced back point hits boundary.*/
-    /* When u is less than zero, the traced back point is towards west.*/
-    /* When it hits the boundary, according to the code,*/
-    /* the east cell of west boundary will be given as the traced back location*/
-    /* and the index (OC) is also marching on one cell.*/
-    /* This means that the index and traced back location are on same cell.*/
-    /* That is why the index needs to move backward for one cell*/
-    /* in order to do interpolation.*/
-    if(u0<0 && LOC[X]==1) OC[X] -=1;
-    if(v0<0 && LOC[Y]==1) OC[Y] -=1;
-    if(w0<0 && LOC[Z]==1) OC[Z] -=1;
+} /* End of trace_vx_slab()*/
 
-    /*-------------------------------------------------------------------------
-    | Interpolate
-    -------------------------------------------------------------------------*/
-    x_1 = (OL[X]-gx[IX(OC[X],OC[Y],OC[Z])])
-        / (gx[IX(OC[X]+1,OC[Y],OC[Z])]-gx[IX(OC[X],OC[Y],OC[Z])]);
-    y_1 = (OL[Y]-y[IX(OC[X],OC[Y],OC[Z])])
-        / (y[IX(OC[X],OC[Y]+1,OC[Z])]-y[IX(OC[X],OC[Y],OC[Z])]);
-    z_1 = (OL[Z]-z[IX(OC[X],OC[Y],OC[Z])])
-        / (z[IX(OC[X],OC[Y],OC[Z]+1)]-z[IX(OC[X],OC[Y],OC[Z])]);
+	/*
+		* Advection of the cells with VY in a slab of k-planes
+		*
+		* @param task Pointer to the task
+		* @param k_start First k-plane of the slab
+		* @param k_end Last k-plane of the slab
+		* @param fail Pointer to the failed flag and the cell that failed
+		*
+		* @return No return needed
+		*/
+static void trace_vy_slab(TRACE_TASK *task, int k_start, int k_end,
+                          int *fail) {
+  PARA_DATA *para = task->para;
+  REAL **var = task->var;
+  int i, j, k;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  REAL u0, v0, w0;
+  REAL *x = var[X], *y = var[Y],  *z = var[Z];
+  REAL *gy = var[GY];
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  REAL *flagv = var[FLAGV];
+  REAL *d = task->d[0], *d0 = task->d0[0];
+  REAL OL[3];
+  int  OC[3];
 
-    d[IX(i,j,k)] = interpolation(para, d0, x_1, y_1, z_1, OC[X], OC[Y], OC[Z]);
+  for(k=k_start; k<=k_end; k++)
+    for(j=1; j<=jmax-1; j++)
+      for(i=1; i<=imax; i++) {
+        /* Do not trace for boundary cells*/
+        if(flagv[IX(i,j,k)]>=0) continue;
+        /* Get velocities at the location of VY*/
+        u0 = (REAL) 0.5
+           * ((u[IX(i,j,k)]+u[IX(i-1,j,  k)])*(y [IX(i,j+1,k)]-gy[IX(i,j,k)])
+             +(u[IX(i,j+1,k)]+u[IX(i-1,j+1,k)])*(gy[IX(i,j,  k)]-y[IX(i,j,k)]))
+           / (y[IX(i,j+1,k)]-y[IX(i,j,k)]);
+        v0 = v[IX(i,j,k)];
+        w0 = (REAL) 0.5
+           * ((w[IX(i,j,k)]+w[IX(i,j,k-1)])*(y[IX(i,j+1,k)]-gy[IX(i,j,k)])
+             +(w[IX(i,j+1,k)]+w[IX(i,j+1,k-1)])*(gy[IX(i,j,k)]-y[IX(i,j,k)]))
+           / (y[IX(i,j+1,k)]-y[IX(i,j,k)]);
+
+        if(trace_back(para, var, flagv, x, gy, z, u0, v0, w0, i, j, k,
+                      OL, OC)) {
+          fail[0] = 1; fail[1] = i; fail[2] = j; fail[3] = k;
+          return;
+        }
+
+        d[IX(i,j,k)] = trace_interpolate(para, d0, x, gy, z, OL, OC);
+      }
+} /* End of trace_vy_slab()*/
 
-  END_FOR /* End of loop for all cells*/
+	/*
+		* Advection of the cells with VZ in a slab of k-planes
+		*
+		* @param task Pointer to the task
+		* @param k_start First k-plane of the slab
+		* @param k_end Last k-plane of the slab
+		* @param fail Pointer to the failed flag and the cell that failed
+		*
+		* @return No return needed
+		*/
+static void trace_vz_slab(TRACE_TASK *task, int k_start, int k_end,
+                          int *fail) {
+  PARA_DATA *para = task->para;
+  REAL **var = task->var;
+  int i, j, k;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  REAL u0, v0, w0;
+  REAL *x = var[X], *y = var[Y],  *z = var[Z];
+  REAL *gz = var[GZ];
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  REAL *flagw = var[FLAGW];
+  REAL *d = task->d[0], *d0 = task->d0[0];
+  REAL OL[3];
+  int  OC[3];
+
+  for(k=k_start; k<=k_end; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        /* Do not trace for boundary cells*/
+        if(flagw[IX(i,j,k)]>=0) continue;
+        /* Get velocities at the location of VZ*/
+        u0 = (REAL) 0.5
+           * ((u[IX(i,j,k  )]+u[IX(i-1,j,k  )])*(z [IX(i,j,k+1)]-gz[IX(i,j,k)])
+             +(u[IX(i,j,k+1)]+u[IX(i-1,j,k+1)])*(gz[IX(i,j,k  )]- z[IX(i,j,k)]))
+           /  (z[IX(i,j,k+1)]-z[IX(i,j,k)]);
+        v0 = (REAL) 0.5
+           * ((v[IX(i,j,k  )]+v[IX(i,j-1,k  )])*(z [IX(i,j,k+1)]-gz[IX(i,j,k)])
+             +(v[IX(i,j,k+1)]+v[IX(i,j-1,k+1)])*(gz[IX(i,j,k  )]-z [IX(i,j,k)]))
+           /  (z[IX(i,j,k+1)]-z[IX(i,j,k)]);
+        w0 = w[IX(i,j,k)];
+
+        if(trace_back(para, var, flagw, x, y, gz, u0, v0, w0, i, j, k,
+                      OL, OC)) {
+          fail[0] = 1; fail[1] = i; fail[2] = j; fail[3] = k;
+          return;
+        }
+
+        d[IX(i,j,k)] = trace_interpolate(para, d0, x, y, gz, OL, OC);
+      }
+} /* End of trace_vz_slab()*/
+
+	/*
+		* Advection of the scalar cells in a slab of k-planes
+		*
+		* The departure point of each cell is traced once for all variables
+		* of the task.
+		*
+		* @param task Pointer to the task
+		* @param k_start First k-plane of the slab
+		* @param k_end Last k-plane of the slab
+		* @param fail Pointer to the failed flag and the cell that failed
+		*
+		* @return No return needed
+		*/
+static void trace_scalar_slab(TRACE_TASK *task, int k_start, int k_end,
+                              int *fail) {
+  PARA_DATA *para = task->para;
+  REAL **var = task->var;
+  int i, j, k;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  REAL u0, v0, w0;
+  REAL *x = var[X], *y = var[Y], *z = var[Z];
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  REAL *flagp = var[FLAGP];
+  REAL **d = task->d, **d0 = task->d0;
+  int n, nb = task->nb;
+  REAL OL[3];
+  int  OC[3];
+
+  for(k=k_start; k<=k_end; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        /* Do not trace for boundary cells*/
+        if(flagp[IX(i,j,k)]>=0) continue;
+        /* Get velocities at the location of scalar variable*/
+        u0 = (REAL) 0.5 * (u[IX(i,j,k)]+u[IX(i-1,j,k  )]);
+        v0 = (REAL) 0.5 * (v[IX(i,j,k)]+v[IX(i,j-1,k  )]);
+        w0 = (REAL) 0.5 * (w[IX(i,j,k)]+w[IX(i,j  ,k-1)]);
+
+        if(trace_back(para, var, flagp, x, y, z, u0, v0, w0, i, j, k,
+                      OL, OC)) {
+          fail[0] = 1; fail[1] = i; fail[2] = j; fail[3] = k;
+          return;
+        }
+
+        /*Store the local minimum and maximum values of the first variable*/
+        var[LOCMIN][IX(i,j,k)]=check_min(para, d0[0], OC[X], OC[Y], OC[Z]);
+        var[LOCMAX][IX(i,j,k)]=check_max(para, d0[0], OC[X], OC[Y], OC[Z]);
+
+        /* All variables are interpolated at the same departure point*/
+        for(n=0; n<nb; n++)
+          d[n][IX(i,j,k)] = trace_interpolate(para, d0[n], x, y, z, OL, OC);
+      }
+} /* End of trace_scalar_slab()*/
+
+	/*
+		* Run the advection of one thread
+		*
+		* Each thread traces the cells of a slab of k-planes. The cells are
+		* independent since they only read the variables of the previous
+		* time step.
+		*
+		* @param arg Pointer to the task
+		* @param rank Rank of the thread
+		* @param size Number of threads of the team
+		* @param barrier Pointer to the barrier of the team
+		*
+		* @return No return needed
+		*/
+static void trace_run(void *arg, int rank, int size, TEAM_BARRIER *barrier) {
+  TRACE_TASK *task = (TRACE_TASK *) arg;
+  int kmax = task->para->geom->kmax;
+  int nk = task->var_type==VZ ? kmax-1 : kmax;
+  int k_start = 1 + rank*nk/size, k_end = (rank+1)*nk/size;
+  int *fail = task->fail + 4*rank;
+
+  fail[0] = 0;
+  switch(task->var_type) {
+    case VX:
+      trace_vx_slab(task, k_start, k_end, fail);
+      break;
+    case VY:
+      trace_vy_slab(task, k_start, k_end, fail);
+      break;
+    case VZ:
+      trace_vz_slab(task, k_start, k_end, fail);
+      break;
+    default:
+      trace_scalar_slab(task, k_start, k_end, fail);
+  }
+} /* End of trace_run()*/
+
+	/*
+		* Advection of variables by a team of threads
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param var_type The type of variable for advection solver
+		* @param nb Number of variables, 1 for the velocities
+		* @param d Pointer to the computed variables at previous time step
+		* @param d0 Pointer to the computed variables for current time step
+		*
+		* @return 0 if no error occurred
+		*/
+static int trace_parallel(PARA_DATA *para, REAL **var, int var_type, int nb,
+                          REAL **d, REAL **d0) {
+  int kmax = para->geom->kmax;
+  int nb_thread = para->solv->nb_thread;
+  int n, nb_started, flag = 0;
+  TRACE_TASK task;
+
+  if(para->solv->interpolation!=BILINEAR) {
+    sprintf(msg,
+      "trace_parallel(): the required interpolation method %d is not available.",
+      para->solv->interpolation);
+    ffd_log(msg, FFD_ERROR);
+    return 1;
+  }
+
+  if(nb_thread>kmax-1) nb_thread = kmax-1;
+  if(nb_thread<1) nb_thread = 1;
+
+  task.para = para;
+  task.var = var;
+  task.var_type = var_type;
+  task.nb = nb;
+  task.d = d;
+  task.d0 = d0;
+  task.fail = (int *) malloc(4*nb_thread*sizeof(int));
+  if(task.fail==NULL) {
+    ffd_log("trace_parallel(): Could not allocate memory for the team.",
+            FFD_ERROR);
+    return 1;
+  }
+
+  nb_started = team_run((THREAD_TEAM *) para->solv->team, nb_thread, trace_run,
+                        &task);
+
+  for(n=0; n<nb_started; n++) {
+    if(task.fail[4*n]==0) continue;
+    sprintf(msg, "trace_parallel(): Could not track the location for "
+      "variable %d at cell(%d, %d,%d)", var_type, task.fail[4*n+1],
+      task.fail[4*n+2], task.fail[4*n+3]);
+    ffd_log(msg, FFD_ERROR);
+    flag = 1;
+  }
+
+  free(task.fail);
+  return flag;
+} /* End of trace_parallel()*/
+
+	/*
+		* Advection for velocity at X-direction
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param var_type The type of variable for advection solver
+		* @param d Pointer to the computed variables at previous time step
+		* @param d0 Pointer to the computed variables for current time step
+		* @param BINDEX Pointer to boundary index
+		*
+		* @return 0 if no error occurred
+		*/
+int trace_vx(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
+             int **BINDEX) {
+  if(trace_parallel(para, var, var_type, 1, &d, &d0)!=0)
+    return 1;
 
   /****************************************************************************
   | define the boundary condition
@@ -252,99 +583,8 @@ int trace_vx(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
 		*/
 int trace_vy(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
              int **BINDEX) {
-  int i, j, k;
-  int it;
-  int itmax = 20000; /* Max number of iterations for backward tracing*/
-  int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
-  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL x_1, y_1, z_1;
-  REAL dt = para->mytime->dt;
-  REAL u0, v0, w0;
-  REAL *x = var[X], *y = var[Y],  *z = var[Z];
-  REAL *gy = var[GY];
-  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
-  REAL *flagv = var[FLAGV];
-  int  COOD[3], LOC[3];
-  REAL OL[3];
-  int  OC[3];
-
-  FOR_V_CELL
-    /* Do not trace for boundary cells*/
-    if(flagv[IX(i,j,k)]>=0) continue;
-
-    /*-------------------------------------------------------------------------
-    | Step 1: Tracing Back
-    -------------------------------------------------------------------------*/
-    /* Get velocities at the location of VY*/
-    u0 = (REAL) 0.5
-       * ((u[IX(i,j,k)]+u[IX(i-1,j,  k)])*(y [IX(i,j+1,k)]-gy[IX(i,j,k)])
-         +(u[IX(i,j+1,k)]+u[IX(i-1,j+1,k)])*(gy[IX(i,j,  k)]-y[IX(i,j,k)]))
-       / (y[IX(i,j+1,k)]-y[IX(i,j,k)]);
-    v0 = v[IX(i,j,k)];
-    w0 = (REAL) 0.5
-       * ((w[IX(i,j,k)]+w[IX(i,j,k-1)])*(y[IX(i,j+1,k)]-gy[IX(i,j,k)])
-         +(w[IX(i,j+1,k)]+w[IX(i,j+1,k-1)])*(gy[IX(i,j,k)]-y[IX(i,j,k)]))
-       / (y[IX(i,j+1,k)]-y[IX(i,j,k)]);
-    /* Find the location at previous time step*/
-    OL[X] = x[IX(i,j,k)] - u0*dt;
-    OL[Y] = gy[IX(i,j,k)] - v0*dt;
-    OL[Z] = z[IX(i,j,k)] - w0*dt;
-    /* Initialize the coordinates of previous step*/
-    OC[X] = i;
-    OC[Y] = j;
-    OC[Z] = k;
-    /* Initialize the signs for track process*/
-    /* Completed: 0; In process: 1*/
-    COOD[X] = 1;
-    COOD[Y] = 1;
-    COOD[Z] = 1;
-    /* Initialize the signs for recording if the track back hits the boundary*/
-    /* Hit the boundary: 0; Not hit the boundary: 1*/
-    LOC[X] = 1;
-    LOC[Y] = 1;
-    LOC[Z] = 1;
-    /*Initialize the number of iterations*/
-    it=1;
-
-    /* Trace back more if the any of the trace is still in process*/
-    while(COOD[X]==1 || COOD[Y] ==1 || COOD[Z] == 1) {
-      it++;
-      if(COOD[X]==1 && LOC[X]==1)
-        set_x_location(para, var, flagv, x, u0, i, j, k, OL, OC, LOC, COOD);
-      if(COOD[Y]==1 && LOC[Y]==1)
-        set_y_location(para, var, flagv, gy, v0, i, j, k, OL, OC, LOC, COOD);
-      if(COOD[Z]==1 && LOC[Z]==1)
-          set_z_location(para, var, flagv, z, w0, i, j, k, OL, OC, LOC, COOD);
-
-      if(it>itmax) {
-        printf("Error: advection.c can not track the location for VY(%d, %d,%d)",
-                i, j, k);
-        printf("after %d iterations.\n", it);
-        return 1;
-      }
-    } /* End of while() loop*/
-
-    /* Set the coordinates of previous location if it is as boundary*/
-    if(u0>=0 && LOC[X]==0) OC[X] -= 1;
-    if(v0>=0 && LOC[Y]==0) OC[Y] -= 1;
-    if(w0>=0 && LOC[Z]==0) OC[Z] -= 1;
-
-    if(u0<0 && LOC[X]==1) OC[X] -= 1;
-    if(v0<0 && LOC[Y]==1) OC[Y] -= 1;
-    if(w0<0 && LOC[Z]==1) OC[Z] -= 1;
-
-    /*-------------------------------------------------------------------------
-    | Interpolating for all variables
-    -------------------------------------------------------------------------*/
-    x_1 = (OL[X]-x[IX(OC[X],OC[Y],OC[Z])])
-        / (x[IX(OC[X]+1,OC[Y],OC[Z])]-x[IX(OC[X],OC[Y],OC[Z])]);
-    y_1 = (OL[Y]-gy[IX(OC[X],OC[Y],OC[Z])])
-        / (gy[IX(OC[X],OC[Y]+1,OC[Z])]-gy[IX(OC[X],OC[Y],OC[Z])]);
-    z_1 = (OL[Z]-z[IX(OC[X],OC[Y],OC[Z])])
-        / (z[IX(OC[X],OC[Y],OC[Z]+1)]-z[IX(OC[X],OC[Y],OC[Z])]);
-    d[IX(i,j,k)] = interpolation(para, d0, x_1, y_1, z_1, OC[X],OC[Y],OC[Z]);
-  END_FOR /* End of For() loop for each cell*/
+  if(trace_parallel(para, var, var_type, 1, &d, &d0)!=0)
+    return 1;
 
   /*---------------------------------------------------------------------------
   | define the b.c.
@@ -367,99 +607,8 @@ int trace_vy(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
 		*/
 int trace_vz(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
              int **BINDEX) {
-  int i, j, k;
-  int it;
-  int itmax = 20000; /* Max number of iterations for backward tracing*/
-  int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
-  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL x_1, y_1, z_1;
-  REAL dt = para->mytime->dt;
-  REAL u0, v0, w0;
-  REAL *x = var[X], *y = var[Y],  *z = var[Z];
-  REAL *gz = var[GZ];
-  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
-  REAL *flagw = var[FLAGW];
-  int  COOD[3], LOC[3];
-  REAL OL[3];
-  int  OC[3];
-
-  FOR_W_CELL
-    /* Do not trace for boundary cells*/
-    if(flagw[IX(i,j,k)]>=0) continue;
-
-    /*-------------------------------------------------------------------------
-    | Step 1: Tracing Back
-    -------------------------------------------------------------------------*/
-    /* Get velocities at the location of VZ*/
-    u0 = (REAL) 0.5
-       * ((u[IX(i,j,k  )]+u[IX(i-1,j,k  )])*(z [IX(i,j,k+1)]-gz[IX(i,j,k)])
-         +(u[IX(i,j,k+1)]+u[IX(i-1,j,k+1)])*(gz[IX(i,j,k  )]- z[IX(i,j,k)]))
-       /  (z[IX(i,j,k+1)]-z[IX(i,j,k)]);
-    v0 = (REAL) 0.5
-       * ((v[IX(i,j,k  )]+v[IX(i,j-1,k  )])*(z [IX(i,j,k+1)]-gz[IX(i,j,k)])
-       +(v[IX(i,j,k+1)]+v[IX(i,j-1,k+1)])*(gz[IX(i,j,k  )]-z [IX(i,j,k)]))
-       /  (z[IX(i,j,k+1)]-z[IX(i,j,k)]);
-    w0 = w[IX(i,j,k)];
-    /* Find the location at previous time step*/
-    OL[X] = x[IX(i,j,k)] - u0*dt;
-    OL[Y] = y[IX(i,j,k)] - v0*dt;
-    OL[Z] = gz[IX(i,j,k)] - w0*dt;
-    /* Initialize the coordinates of previous step*/
-    OC[X] = i;
-    OC[Y] = j;
-    OC[Z] = k;
-    /* Initialize the signs for track process*/
-    /* Completed: 0; In process: 1*/
-    COOD[X] = 1;
-    COOD[Y] = 1;
-    COOD[Z] = 1;
-    /* Initialize the signs for recording if the track back hits the boundary*/
-    /* Hit the boundary: 0; Not hit the boundary: 1*/
-    LOC[X] = 1;
-    LOC[Y] = 1;
-    LOC[Z] = 1;
-    /*Initialize the number of iterations*/
-    it=1;
-
-    /* Trace back more if the any of the trace is still in process*/
-    while(COOD[X]==1 || COOD[Y] ==1 || COOD[Z] == 1) {
-      it++;
-      if(COOD[X]==1 && LOC[X]==1)
-        set_x_location(para, var, flagw, x, u0, i, j, k, OL, OC, LOC, COOD);
-      if(COOD[Y]==1 && LOC[Y]==1)
-        set_y_location(para, var, flagw, y, v0, i, j, k, OL, OC, LOC, COOD);
-      if(COOD[Z]==1 && LOC[Z]==1)
-        set_z_location(para, var, flagw, gz, w0, i, j, k, OL, OC, LOC, COOD);
-
-      if(it>itmax) {
-        printf("Error: advection.c can not track the location for VY(%d, %d,%d)",
-                i, j, k);
-        printf("after %d iterations.\n", it);
-        return 1;
-      }
-    } /* End of while() loop*/
-
-    /* Set the coordinates of previous location if it is as boundary*/
-    if(u0>=0 && LOC[X] == 0) OC[X] -=1;
-    if(v0>=0 && LOC[Y] == 0) OC[Y] -=1;
-    if(w0>=0 && LOC[Z] == 0) OC[Z] -=1;
-
-    if(u0<0 && LOC[X]==1) OC[X] -=1;
-    if(v0<0 && LOC[Y]==1) OC[Y] -=1;
-    if(w0<0 && LOC[Z]==1) OC[Z] -=1;
-
-    /*-------------------------------------------------------------------------
-    | Interpolating for all variables
-    -------------------------------------------------------------------------*/
-    x_1 = (OL[X]- x[IX(OC[X],OC[Y],OC[Z])])
-        / ( x[IX(OC[X]+1,OC[Y],   OC[Z]  )]- x[IX(OC[X],OC[Y],OC[Z])]);
-    y_1 = (OL[Y]- y[IX(OC[X],OC[Y],OC[Z])])
-        / ( y[IX(OC[X],  OC[Y]+1, OC[Z]  )]- y[IX(OC[X],OC[Y],OC[Z])]);
-    z_1 = (OL[Z]-gz[IX(OC[X],OC[Y],OC[Z])])
-        / (gz[IX(OC[X],  OC[Y],   OC[Z]+1)]-gz[IX(OC[X],OC[Y],OC[Z])]);
-     d[IX(i,j,k)] = interpolation(para, d0, x_1, y_1, z_1, OC[X], OC[Y], OC[Z]);
-  END_FOR
+  if(trace_parallel(para, var, var_type, 1, &d, &d0)!=0)
+    return 1;
 
   /*---------------------------------------------------------------------------
   | define the b.c.
@@ -483,106 +632,47 @@ int trace_vz(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
 		*/
 int trace_scalar(PARA_DATA *para, REAL **var, int var_type, int index,
                  REAL *d, REAL *d0, int **BINDEX) {
-  int i, j, k;
-  int it;
-  int itmax = 20000; /* Max number of iterations for backward tracing*/
-  int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
-  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL x_1, y_1, z_1;
-  REAL dt = para->mytime->dt;
-  REAL u0, v0, w0;
-  REAL *x = var[X], *y = var[Y], *z = var[Z];
-  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
-  REAL *flagp = var[FLAGP];
-  int  COOD[3], LOC[3];
-  REAL OL[3];
-  int  OC[3];
+  if(trace_parallel(para, var, var_type, 1, &d, &d0)!=0)
+    return 1;
 
-  FOR_EACH_CELL
-    /* Do not trace for boundary cells*/
-    if(flagp[IX(i,j,k)]>=0) continue;
-
-    /*-------------------------------------------------------------------------
-    | Step 1: Tracing Back
-    -------------------------------------------------------------------------*/
-    /* Get velocities at the location of scalar variable*/
-    u0 = (REAL) 0.5 * (u[IX(i,j,k)]+u[IX(i-1,j,k  )]);
-    v0 = (REAL) 0.5 * (v[IX(i,j,k)]+v[IX(i,j-1,k  )]);
-    w0 = (REAL) 0.5 * (w[IX(i,j,k)]+w[IX(i,j  ,k-1)]);
-    /* Find the location at previous time step*/
-    OL[X] = x[IX(i,j,k)] - u0*dt;
-    OL[Y] = y[IX(i,j,k)] - v0*dt;
-    OL[Z] = z[IX(i,j,k)] - w0*dt;
-    /* Initialize the coordinates of previous step*/
-    OC[X] = i;
-    OC[Y] = j;
-    OC[Z] = k;
-    /* Initialize the signs for tracing process*/
-    /* Completed: 0; In process: 1*/
-    COOD[X] = 1;
-    COOD[Y] = 1;
-    COOD[Z] = 1;
-    /* Initialize the flags for recording if the tracing back hits the boundary*/
-    /* Hit the boundary: 0; Not hit the boundary: 1*/
-    LOC[X] = 1;
-    LOC[Y] = 1;
-    LOC[Z] = 1;
-    /*Initialize the number of iterations*/
-    it=1;
-
-    /* Trace back more if the any of the trace is still in process*/
-    while(COOD[X]==1 || COOD[Y] ==1 || COOD[Z] == 1) {
-      it++;
-      /* If trace in X is in process and donot hit the boundary*/
-      if(COOD[X]==1 && LOC[X]==1)
-        set_x_location(para, var, flagp, x, u0, i, j, k, OL, OC, LOC, COOD);
-      /* If trace in Y is in process and donot hit the boundary*/
-      if(COOD[Y]==1 && LOC[Y]==1)
-        set_y_location(para, var, flagp, y, v0, i, j, k, OL, OC, LOC, COOD);
-      /* If trace in Z is in process and donot hit the boundary*/
-      if(COOD[Z]==1 && LOC[Z]==1)
-        set_z_location(para, var, flagp, z, w0, i, j, k, OL, OC, LOC, COOD);
-      if(it>itmax) {
-        sprintf(msg, "trace_scalar(): Could not track the location for scalar "
-          "variable %d at cell(%d, %d,%d) after %d iterations",
-          var_type, i, j, k, it);
-        ffd_log(msg, FFD_ERROR);
-        return 1;
-      }
-    } /* End of while() for backward tracing*/
-
-    /* Set the coordinates of previous location if it is as boundary*/
-    if(u0>=0 && LOC[X]==0) OC[X] -=1;
-    if(v0>=0 && LOC[Y]==0) OC[Y] -=1;
-    if(w0>=0 && LOC[Z]==0) OC[Z] -=1;
-
-    if(u0<0 && LOC[X]==1) OC[X] -=1;
-    if(v0<0 && LOC[Y]==1) OC[Y] -=1;
-    if(w0<0 && LOC[Z]==1) OC[Z] -=1;
+  /*---------------------------------------------------------------------------
+  | Define the b.c.
+  ---------------------------------------------------------------------------*/
+  set_bnd(para, var, var_type, index, d, BINDEX);
+  return 0;
+} /* End of trace_scalar()*/
 
-    /*Store the local minimum and maximum values*/
-    var[LOCMIN][IX(i,j,k)]=check_min(para, d0, OC[X], OC[Y], OC[Z]);
-    var[LOCMAX][IX(i,j,k)]=check_max(para, d0, OC[X], OC[Y], OC[Z]);
+	/*
+		* Advection for species and trace substances
+		*
+		* The departure point of each cell is traced once and all variables are
+		* interpolated at that point.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param nb Number of variables
+		* @param var_type Pointer to the type of the variables, Xi1 or C1
+		* @param index Pointer to the index of the species or trace substances
+		* @param d Pointer to the computed variables at previous time step
+		* @param d0 Pointer to the computed variables for current time step
+		* @param BINDEX Pointer to boundary index
+		*
+		* @return 0 if no error occurred
+		*/
+int trace_species(PARA_DATA *para, REAL **var, int nb, int *var_type,
+                  int *index, REAL **d, REAL **d0, int **BINDEX) {
+  int n;
 
-    /*-------------------------------------------------------------------------
-    | Interpolate
-    -------------------------------------------------------------------------*/
-    x_1 = (OL[X]- x[IX(OC[X],OC[Y],OC[Z])])
-        / ( x[IX(OC[X]+1,OC[Y],   OC[Z]  )] - x[IX(OC[X],OC[Y],OC[Z])]);
-    y_1 = (OL[Y]- y[IX(OC[X],OC[Y],OC[Z])])
-        / ( y[IX(OC[X],  OC[Y]+1, OC[Z]  )] - y[IX(OC[X],OC[Y],OC[Z])]);
-    z_1 = (OL[Z]- z[IX(OC[X],OC[Y],OC[Z])])
-        / ( z[IX(OC[X],  OC[Y],   OC[Z]+1)] - z[IX(OC[X],OC[Y],OC[Z])]);
-    d[IX(i,j,k)] = interpolation(para, d0, x_1, y_1, z_1, OC[X], OC[Y], OC[Z]);
-  END_FOR /* End of loop for all cells*/
+  if(trace_parallel(para, var, Xi1, nb, d, d0)!=0)
+    return 1;
 
   /*---------------------------------------------------------------------------
   | Define the b.c.
   ---------------------------------------------------------------------------*/
-  set_bnd(para, var, var_type, index, d, BINDEX);
+  for(n=0; n<nb; n++)
+    set_bnd(para, var, var_type[n], index[n], d[n], BINDEX);
   return 0;
-} /* End of trace_scalar()*/
+} /* End of trace_species()*/
 
 
 	/*
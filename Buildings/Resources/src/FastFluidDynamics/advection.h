@@ -47,6 +47,11 @@
 #include "interpolation.h"
 #endif
 
+#ifndef _THREAD_TEAM_H
+#define _THREAD_TEAM_H
+#include "thread_team.h"
+#endif
+
 #ifndef _SOLVER_H
 #define _SOLVER_H
 #include "solver.h"
@@ -133,6 +138,26 @@ int trace_vz(PARA_DATA *para, REAL **var, int var_type, REAL *d, REAL *d0,
 int trace_scalar(PARA_DATA *para, REAL **var, int var_type, int index,
                  REAL *d, REAL *d0, int **BINDEX);
 
+/*
+	* Advection for species and trace substances
+	*
+	* The departure point of each cell is traced once and all variables are
+	* interpolated at that point.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param nb Number of variables
+	* @param var_type Pointer to the type of the variables, Xi1 or C1
+	* @param index Pointer to the index of the species or trace substances
+	* @param d Pointer to the computed variables at previous time step
+	* @param d0 Pointer to the computed variables for current time step
+	* @param BINDEX Pointer to boundary index
+	*
+	* @return 0 if no error occurred
+	*/
+int trace_species(PARA_DATA *para, REAL **var, int nb, int *var_type,
+                  int *index, REAL **d, REAL **d0, int **BINDEX);
+
 /*
 	* Find the X-location and coordinates at previous time step
 	*
@@ -0,0 +1,102 @@
+/*
+	*
+	* \file   benchmark.c
+	*
+	* \brief  Run FFD cases without Modelica and report their throughput
+	*
+	* \date   10/18/2026
+	*
+	* The driver is not part of the FFD library. It is built with
+	* "make benchmark" and runs each FFD parameter file given on the command
+	* line as a single simulation, e.g.
+	*
+	*   ./ffd_benchmark case1/input.ffd case2/input.ffd
+	*
+	* The other input files of a case are read from the directory of its
+	* parameter file. The output files are written to the current directory.
+	* For each case, a line with the number of cells, the number of time
+	* steps, the time spent in the solver and the number of cells that were
+	* advanced per second is printed. Add "outp.profile 1" to the parameter
+	* file to get the times of all phases in profile.json.
+	*
+	*/
+
+#include "ffd.h"
+#include <string.h>
+
+	/*
+		* Run one FFD case
+		*
+		* @param file_name Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if no error occurred
+		*/
+static int run_case(char *file_name) {
+  FFD_INSTANCE *inst;
+  TIME_DATA *t;
+  double compute;
+  long cells;
+  int flag;
+
+  inst = create_instance(NULL);
+  if(inst==NULL) {
+    fprintf(stderr, "Could not allocate memory for the FFD instance.\n");
+    return 1;
+  }
+
+  if(strlen(file_name)>=sizeof(inst->inpu.ffd_file_name)) {
+    fprintf(stderr, "The file name %s is too long.\n", file_name);
+    free(inst);
+    return 1;
+  }
+  strcpy(inst->inpu.ffd_file_name, file_name);
+
+  /* Messages of this thread belong to the instance*/
+  ffd_instance = inst;
+  sprintf(msg, "Start FFD benchmark of %s", file_name);
+  ffd_log(msg, FFD_NEW);
+
+  flag = ffd(inst, 0);
+
+  t = &inst->mytime;
+  compute = t->phase_time[PHASE_VEL] + t->phase_time[PHASE_TEMP]
+          + t->phase_time[PHASE_DEN];
+  cells = (long) inst->geom.imax*inst->geom.jmax*inst->geom.kmax;
+
+  if(flag!=0)
+    printf("%-40s failed, see %s\n", file_name, inst->log_file_name);
+  else
+    printf("%-40s %10ld %8d %12.4f %14.4e\n", file_name, cells,
+           t->step_current, compute,
+           compute>0 ? (double) cells*t->step_current/compute : 0.0);
+
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+  return flag;
+} /* End of run_case()*/
+
+	/*
+		* Main routine of the benchmark
+		*
+		* @param argc Number of arguments
+		* @param argv Pointer to the names of the FFD parameter files
+		*
+		* @return 0 if all cases ran without error
+		*/
+int main(int argc, char **argv) {
+  int i, nb_error = 0;
+
+  if(argc<2) {
+    fprintf(stderr, "Usage: %s input.ffd [input.ffd ...]\n", argv[0]);
+    return 2;
+  }
+
+  printf("%-40s %10s %8s %12s %14s\n", "case", "cells", "steps",
+         "compute[s]", "cells/s");
+  for(i=1; i<argc; i++)
+    nb_error += run_case(argv[i]);
+
+  return nb_error>0 ? 1 : 0;
+} /* End of main()*/
@@ -40,6 +40,8 @@
 int set_bnd(PARA_DATA *para, REAL **var, int var_type, int index, REAL *psi,
             int **BINDEX) {
   int flag;
+
+  phase_start(para, PHASE_BOUNDARY);
   switch(var_type) {
     case VX:
       flag = set_bnd_vel(para, var, VX, psi, BINDEX);
@@ -81,6 +83,7 @@ int set_bnd(PARA_DATA *para, REAL **var, int var_type, int index, REAL *psi,
               var_type);
       ffd_log(msg, FFD_ERROR);
   }
+  phase_end(para, PHASE_BOUNDARY);
 
   return flag;
 } /* End of set_bnd()*/
@@ -249,327 +252,73 @@ int set_bnd_vel(PARA_DATA *para, REAL **var, int var_type, REAL *psi,
 	*/
 int set_bnd_temp(PARA_DATA *para, REAL **var, int var_type, REAL *psi,
                  int **BINDEX) {
-  int i, j, k;
-  int it;
-  int index=para->geom->index;
+  int i, j, k, c, f, n, m;
   int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL *aw = var[AW], *ae = var[AE], *as = var[AS], *an = var[AN];
-  REAL *af = var[AF], *ab = var[AB], *b=var[B],
-       *qflux = var[QFLUX], *qfluxbc = var[QFLUXBC];
-  REAL axy, ayz, azx; /* Area of surfaces*/
+  REAL *b = var[B], *qflux = var[QFLUX], *qfluxbc = var[QFLUXBC];
+  REAL *tempbc = var[TEMPBC], *flagp = var[FLAGP];
+  /* Coefficient of the neighbor that points back to the boundary cell*/
+  REAL *coef[6];
   REAL h;
   REAL rhoCp_1 = 1/ (para->prob->rho * para->prob->Cp);
-  REAL D;
-  REAL *flagp = var[FLAGP];
+  FACE_LIST *wall = para->geom->wall_face, *port = para->geom->port_face;
+
+  coef[EAST] = var[AW]; coef[WEST] = var[AE];
+  coef[NORTH] = var[AS]; coef[SOUTH] = var[AN];
+  coef[CEILING] = var[AB]; coef[FLOOR] = var[AF];
 
   /****************************************************************************
-  | Go through all the boundary cells
+  | Solid wall or block
   ****************************************************************************/
-  for(it=0; it<index; it++) {
-    i = BINDEX[0][it];
-    j = BINDEX[1][it];
-    k = BINDEX[2][it];
-
-    axy = area_xy(para, var, i, j, k);
-    ayz = area_yz(para, var, i, j, k);
-    azx = area_zx(para, var, i, j, k);
-
+  for(c=0; c<wall->nb_cell; c++) {
+    n = wall->cell[c];
     /*-------------------------------------------------------------------------
-    | Inlet boundary
-    | 0: Inlet, -1: Fluid,  1: Solid Wall or Block, 2: Outlet
+    | Constant temperature
     -------------------------------------------------------------------------*/
-    if(flagp[IX(i,j,k)]==INLET) psi[IX(i,j,k)] = var[TEMPBC][IX(i,j,k)];
-
-    /*-------------------------------------------------------------------------
-    | Solid wall or block
-    -------------------------------------------------------------------------*/
-    if(flagp[IX(i,j,k)]==SOLID) {
-      /*......................................................................
-      | Constant temperature
-      ......................................................................*/
-      if(BINDEX[3][it]==1) {
-        psi[IX(i,j,k)] = var[TEMPBC][IX(i,j,k)];
-
-        /* West boundary wall and eastern neighbor cell is fluid*/
-        if(i==0) {
-          if(flagp[IX(i+1,j,k)]==FLUID) {
-            D = 0.5 * length_x(para,var,i+1,j,k);
-            h = h_coef(para,var,i+1,j,k,D);
-            aw[IX(i+1,j,k)] = h * rhoCp_1 * ayz;
-            qflux[IX(i,j,k)] = h * (psi[IX(i+1,j,k)]-psi[IX(i,j,k)]);
-          }
-        } /* End of if(i==0)*/
-        /* East boundary wall and western neighbor cell is fluid*/
-        else if(i==imax+1) {
-          if(flagp[IX(i-1,j,k)]==FLUID) {
-            D = 0.5 * length_x(para,var,i-1,j,k);
-            h = h_coef(para,var,i-1,j,k,D);
-            ae[IX(i-1,j,k)] = h * rhoCp_1 * ayz;
-            qflux[IX(i,j,k)] = h * (psi[IX(i-1,j,k)]-psi[IX(i,j,k)]);
-          }
-        } /* End of else if(i==imax+1)*/
-        /* Between West and East*/
-        else {
-          /* Eastern neighbor cell is fluid*/
-          if(flagp[IX(i+1,j,k)]==FLUID) {
-            D = 0.5 * length_x(para,var,i+1,j,k);
-            h = h_coef(para,var,i+1,j,k,D);
-            aw[IX(i+1,j,k)] = h * rhoCp_1 * ayz;
-            qflux[IX(i,j,k)] = h * (psi[IX(i+1,j,k)]-psi[IX(i,j,k)]);
-          }
-          /* Western neighbor cell is fluid*/
-          if(flagp[IX(i-1,j,k)]==FLUID) {
-            D = 0.5 * length_x(para,var,i-1,j,k);
-            h = h_coef(para,var,i-1,j,k,D);
-            ae[IX(i-1,j,k)] = h * rhoCp_1 * ayz;
-            qflux[IX(i,j,k)] = h * (psi[IX(i-1,j,k)]-psi[IX(i,j,k)]);
-          }
-        } /* End of 0<i<imax+1*/
-        /* South wall boundary and northern neighbor is fluid*/
-        if(j==0) {
-          if(flagp[IX(i,j+1,k)]==FLUID) {
-            D = 0.5 * length_y(para,var,i,j+1,k);
-            h = h_coef(para,var,i,j+1,k,D);
-            as[IX(i,j+1,k)] = h * rhoCp_1 * azx;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j+1,k)]-psi[IX(i,j,k)]);
-          }
-        }
-        /* North wall boundary and southern neighbor is fluid*/
-        else if(j==jmax+1) {
-          if(flagp[IX(i,j-1,k)]==FLUID) {
-            D = 0.5 * length_y(para,var,i,j-1,k);
-            h = h_coef(para,var,i,j-1,k,D);
-            an[IX(i,j-1,k)] = h * rhoCp_1 * azx;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j-1,k)]-psi[IX(i,j,k)]);
-          }
-        }
-        /* Between South and North*/
-        else {
-          /* Southern neighbor is fluid*/
-          if(flagp[IX(i,j-1,k)]==FLUID) {
-            D = 0.5 * length_y(para,var,i,j-1,k);
-            h = h_coef(para,var,i,j-1,k,D);
-            an[IX(i,j-1,k)] = h * rhoCp_1 * azx;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j-1,k)]-psi[IX(i,j,k)]);
-          }
-          /* Northern neighbor is fluid*/
-          if(flagp[IX(i,j+1,k)]==FLUID) {
-            D = 0.5 * length_y(para,var,i,j+1,k);
-            h = h_coef(para,var,i,j+1,k,D);
-            as[IX(i,j+1,k)] = h * rhoCp_1 * azx;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j+1,k)]-psi[IX(i,j,k)]);
-          }
-        }
-        /* Floor and ceiling neighbor is fluid*/
-        if(k==0) {
-          if(flagp[IX(i,j,k+1)]==FLUID) {
-            D = 0.5 * length_z(para,var,i,j,k+1);
-            h = h_coef(para,var,i,j,k+1,D);
-            ab[IX(i,j,k+1)] = h * rhoCp_1 * axy;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j,k+1)]-psi[IX(i,j,k)]);
-          }
-        }
-        /* Ceiling and floor neighbor is fluid*/
-        else if(k==kmax+1) {
-          if(flagp[IX(i,j,k-1)]==FLUID) {
-            D = 0.5 * length_z(para,var,i,j,k-1);
-            h = h_coef(para,var,i,j,k-1,D);
-            af[IX(i,j,k-1)] = h * rhoCp_1 * axy;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j,k-1)]-psi[IX(i,j,k)]);
-          }
-        }
-        /* Between Floor and Ceiling*/
-        else {
-          /* Ceiling neighbor is fluid*/
-          if(flagp[IX(i,j,k+1)]==FLUID) {
-            D = 0.5 * length_z(para,var,i,j,k+1);
-            h = h_coef(para,var,i,j,k+1,D);
-            ab[IX(i,j,k+1)] = h * rhoCp_1 * axy;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j,k+1)]-psi[IX(i,j,k)]);
-          }
-          /* Floor neighbor is fluid*/
-          if(flagp[IX(i,j,k-1)]==FLUID) {
-            D = 0.5 * length_z(para,var,i,j,k-1);
-            h = h_coef(para,var,i,j,k-1,D);
-            af[IX(i,j,k-1)] = h * rhoCp_1 * axy;
-            qflux[IX(i,j,k)] = h * (psi[IX(i,j,k-1)]-psi[IX(i,j,k)]);
-          }
-        }
-      } /* End of constant temperature wall*/
-      /*.......................................................................
-      | Constant heat flux
-      .......................................................................*/
-      if(BINDEX[3][it]==0) {
-        /* West wall boundary and eastern neighbor is fluid*/
-        if(i==0) {
-          if(flagp[IX(i+1,j,k)]==FLUID) {
-            aw[IX(i+1,j,k)] = 0;
-            D = 0.5 * length_z(para,var,i+1,j,k);
-            h = h_coef(para,var,i+1,j,k,D);
-            b[IX(i+1,j,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * ayz;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i+1,j,k)];
-          }
-        } /* End of if(i==0)*/
-        /* East wall boundary and western neighbor is fluid*/
-        else if(i==imax+1) {
-          if(flagp[IX(i-1,j,k)]==FLUID) {
-            ae[IX(i-1,j,k)] = 0;
-            D = 0.5 * length_z(para,var,i-1,j,k);
-            h = h_coef(para,var,i-1,j,k,D);
-            b[IX(i-1,j,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * ayz;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i-1,j,k)];
-          }
-        } /* End of else if(i==imax+1)*/
-        /* Between West and East*/
-        else {
-          /* Eastern neighbor is fluid*/
-          if(flagp[IX(i+1,j,k)]==FLUID) {
-            aw[IX(i+1,j,k)] = 0;
-            D = 0.5 * length_z(para,var,i+1,j,k);
-            h = h_coef(para,var,i+1,j,k,D);
-            b[IX(i+1,j,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * ayz;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i+1,j,k)];
-          }
-          /* Western neighbor is fluid*/
-          if(flagp[IX(i-1,j,k)]==FLUID) {
-            ae[IX(i-1,j,k)] = 0;
-            D = 0.5 * length_z(para,var,i-1,j,k);
-            h = h_coef(para,var,i-1,j,k,D);
-            b[IX(i-1,j,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * ayz;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i-1,j,k)];
-          }
-        } /* End of else*/
-        /* South wall boundary and northern neighbor is fluid*/
-        if(j==0) {
-          if(flagp[IX(i,j+1,k)]==FLUID) {
-            as[IX(i,j+1,k)] = 0;
-            D = 0.5 * length_z(para,var,i,j+1,k);
-            h = h_coef(para,var,i,j+1,k,D);
-            b[IX(i,j+1,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * azx;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j+1,k)];
-          }
-        }
-        /* North wall boundary and southern neighbor is fluid*/
-        else if(j==jmax+1) {
-          if(flagp[IX(i,j-1,k)]==FLUID) {
-            an[IX(i,j-1,k)] = 0;
-            D = 0.5 * length_z(para,var,i,j-1,k);
-            h = h_coef(para,var,i,j-1,k,D);
-            b[IX(i,j-1,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * azx;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j-1,k)];
-          }
-        }
-        /* Between South and North*/
-        else {
-          /* Southern neighbor is fluid*/
-          if(flagp[IX(i,j-1,k)]==FLUID) {
-            an[IX(i,j-1,k)] = 0;
-            D = 0.5 * length_z(para,var,i,j-1,k);
-            h = h_coef(para,var,i,j-1,k,D);
-            b[IX(i,j-1,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * azx;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j-1,k)];
-          }
-          /* Northern neighbor is fluid*/
-          if(flagp[IX(i,j+1,k)]==FLUID) {
-            as[IX(i,j+1,k)] = 0;
-            D = 0.5 * length_z(para,var,i,j+1,k);
-            h = h_coef(para,var,i,j+1,k,D);
-            b[IX(i,j+1,k)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * azx;
-            /* get the temperature of solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j+1,k)];
-          }
-        }
-        /* Floor boundary and ceiling neighbor is fluid*/
-        if(k==0) {
-          if(flagp[IX(i,j,k+1)]==FLUID) {
-            ab[IX(i,j,k+1)] = 0;
-            D = 0.5 * length_z(para,var,i,j,k+1);
-            h = h_coef(para,var,i,j,k+1,D);
-            b[IX(i,j,k+1)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * axy;
-            /* Get the temperature on the solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j,k+1)];
-          }
-        }
-        /* Ceiling boundary and floor neighbor is fluid*/
-        else if(k==kmax+1) {
-          if(flagp[IX(i,j,k-1)]==FLUID) {
-            af[IX(i,j,k-1)] = 0;
-            D = 0.5 * length_z(para,var,i,j,k-1);
-            h = h_coef(para,var,i,j,k-1,D);
-            b[IX(i,j,k-1)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * axy;
-            /* Get the temperature on the solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j,k-1)];
-          }
-        }
-        /* Between Floor and Ceiling*/
-        else {
-          /* Ceiling neighbor is fluid*/
-          if(flagp[IX(i,j,k+1)]==FLUID) {
-            ab[IX(i,j,k+1)] = 0;
-            D = 0.5 * length_z(para,var,i,j,k+1);
-            h = h_coef(para,var,i,j,k+1,D);
-            b[IX(i,j,k+1)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * axy;
-            /* Get the temperature on the solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j,k+1)];
-          }
-          /* Floor neighbor is fluid*/
-          if(flagp[IX(i,j,k-1)]==FLUID) {
-            af[IX(i,j,k-1)] = 0;
-            D = 0.5 * length_z(para,var,i,j,k-1);
-            h = h_coef(para,var,i,j,k-1,D);
-            b[IX(i,j,k-1)] += rhoCp_1 * qfluxbc[IX(i,j,k)] * axy;
-            /* Get the temperature on the solid surface*/
-            psi[IX(i,j,k)] = qfluxbc[IX(i,j,k)]/h + psi[IX(i,j,k-1)];
-          }
-        }
-      } /* End of constant heat flux*/
-    } /* End of wall boundary*/
-
+    if(BINDEX[3][wall->it[c]]==1) {
+      psi[n] = tempbc[n];
+      for(f=wall->first[c]; f<wall->first[c+1]; f++) {
+        m = wall->nbr[f];
+        k = m/IJMAX;
+        j = (m-k*IJMAX)/IMAX;
+        i = m-k*IJMAX-j*IMAX;
+        h = h_coef(para, var, i, j, k, wall->dist[f]);
+        coef[wall->dir[f]][m] = h * rhoCp_1 * wall->area[f];
+        qflux[n] = h * (psi[m]-psi[n]);
+      }
+    }
     /*-------------------------------------------------------------------------
-    | Outlet boundary
+    | Constant heat flux
+    | The distance to the wall is the half width in z-direction for all faces.
     -------------------------------------------------------------------------*/
-    if(flagp[IX(i,j,k)]==OUTLET) {
-      /* West*/
-      if(i==0) {
-        aw[IX(i+1,j,k)] = 0;
-        psi[IX(i,j,k)] = psi[IX(i+1,j,k)];
-      }
-      /* North*/
-      if(i==imax+1) {
-        ae[IX(i-1,j,k)] = 0;
-        psi[IX(i,j,k)] = psi[IX(i-1,j,k)];
+    else if(BINDEX[3][wall->it[c]]==0) {
+      for(f=wall->first[c]; f<wall->first[c+1]; f++) {
+        m = wall->nbr[f];
+        k = m/IJMAX;
+        j = (m-k*IJMAX)/IMAX;
+        i = m-k*IJMAX-j*IMAX;
+        coef[wall->dir[f]][m] = 0;
+        h = h_coef(para, var, i, j, k, wall->dist_z[f]);
+        b[m] += rhoCp_1 * qfluxbc[n] * wall->area[f];
+        /* Get the temperature on the solid surface*/
+        psi[n] = qfluxbc[n]/h + psi[m];
       }
-      /* South*/
-      if(j==0) {
-        as[IX(i,j+1,k)] = 0;
-        psi[IX(i,j,k)] = psi[IX(i,j+1,k)];
-      }
-      /* North*/
-      if(j==jmax+1) {
-        an[IX(i,j-1,k)] = 0;
-        psi[IX(i,j,k)] = psi[IX(i,j-1,k)];
-      }
-      /* Floor*/
-      if(k==0) {
-        ab[IX(i,j,k+1)] = 0;
-        psi[IX(i,j,k)] = psi[IX(i,j,k+1)];
-      }
-      /* Ceiling*/
-      if(k==kmax+1) {
-        af[IX(i,j,k-1)] = 0;
-        psi[IX(i,j,k)] = psi[IX(i,j,k-1)];
+    }
+  }
+
+  /****************************************************************************
+  | Inlet and outlet boundary
+  ****************************************************************************/
+  for(c=0; c<port->nb_cell; c++) {
+    n = port->cell[c];
+    if(flagp[n]==INLET)
+      psi[n] = tempbc[n];
+    else if(flagp[n]==OUTLET)
+      for(f=port->first[c]; f<port->first[c+1]; f++) {
+        coef[port->dir[f]][port->nbr[f]] = 0;
+        psi[n] = psi[port->nbr[f]];
       }
-    } /* End of boundary for outlet*/
-  } /* End of for() loop for go through the index*/
+  }
 
   return 0;
 } /* End of set_bnd_temp()*/
@@ -710,6 +459,7 @@ int set_bnd_pressure(PARA_DATA *para, REAL **var, REAL *p, int **BINDEX) {
 
   REAL *flagp = var[FLAGP];
 
+  phase_start(para, PHASE_BOUNDARY);
   for(it=0;it<index;it++) {
     i = BINDEX[0][it];
     j = BINDEX[1][it];
@@ -761,6 +511,7 @@ int set_bnd_pressure(PARA_DATA *para, REAL **var, REAL *p, int **BINDEX) {
       }
     }
   }
+  phase_end(para, PHASE_BOUNDARY);
 
   return 0;
 } /* End of set_bnd_pressure()*/
@@ -780,32 +531,29 @@ int set_bnd_pressure(PARA_DATA *para, REAL **var, REAL *p, int **BINDEX) {
 	* @return 0 if no error occurred
 	*/
 int mass_conservation(PARA_DATA *para, REAL **var, int **BINDEX) {
-  int i, j, k;
-  int it;
-  int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
-  int index= para->geom->index;
-  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  int c, f, d;
+  REAL *vel[3];
   REAL dvel;
   REAL *flagp = var[FLAGP];
+  FACE_LIST *port = para->geom->port_face;
+
+  vel[0] = var[VX]; vel[1] = var[VY]; vel[2] = var[VZ];
 
   dvel = adjust_velocity(para, var, BINDEX); /*(mass_in-mass_out)/area_out*/
 
   /*---------------------------------------------------------------------------
   | Adjust the outflow
+  | The velocity of a face at the lower end of an axis is stored in the
+  | boundary cell, the one at the upper end in the neighbor.
   ---------------------------------------------------------------------------*/
-  for(it=0;it<index;it++) {
-    i = BINDEX[0][it];
-    j = BINDEX[1][it];
-    k = BINDEX[2][it];
-    if(flagp[IX(i,j,k)]==2) {
-      if(i==0) u[IX(i,j,k)] -= dvel;
-      if(i==imax+1) u[IX(i-1,j,k)]+= dvel;
-      if(j==0) v[IX(i,j,k)] -= dvel;
-      if(j==jmax+1) v[IX(i,j-1,k)] += dvel;
-      if(k==0) w[IX(i,j,k)] -= dvel;
-      if(k==kmax+1) w[IX(i,j,k-1)] += dvel;
+  for(c=0; c<port->nb_cell; c++) {
+    if(flagp[port->cell[c]]!=OUTLET) continue;
+    for(f=port->first[c]; f<port->first[c+1]; f++) {
+      d = port->dir[f];
+      if(d%2==0)
+        vel[d/2][port->cell[c]] -= dvel;
+      else
+        vel[d/2][port->nbr[f]] += dvel;
     }
   }
 
@@ -827,77 +575,41 @@ int mass_conservation(PARA_DATA *para, REAL **var, int **BINDEX) {
 	* @return Mass flow difference divided by the outflow area
 	*/
 REAL adjust_velocity(PARA_DATA *para, REAL **var, int **BINDEX) {
-  int i, j, k;
-  int it;
-  int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
-  int index= para->geom->index;
-  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  int c, f, d, n;
+  REAL *vel[3];
   REAL mass_in = (REAL) 0.0, mass_out = (REAL) 0.00000001;
   REAL area_out=0;
   REAL *flagp = var[FLAGP];
-  REAL axy, ayz, azx;
+  FACE_LIST *port = para->geom->port_face;
 
-  /* Go through all the inlets and outlets*/
-  for(it=0; it<index; it++) {
-    i = BINDEX[0][it];
-    j = BINDEX[1][it];
-    k = BINDEX[2][it];
+  vel[0] = var[VX]; vel[1] = var[VY]; vel[2] = var[VZ];
 
-    axy = area_xy(para, var, i, j, k);
-    ayz = area_yz(para, var, i, j, k);
-    azx = area_zx(para, var, i, j, k);
+  /* Go through all the inlets and outlets*/
+  for(c=0; c<port->nb_cell; c++) {
+    n = port->cell[c];
     /*-------------------------------------------------------------------------
     | Compute the total inflow
     -------------------------------------------------------------------------*/
-    if(flagp[IX(i,j,k)]==0) {
-      /* West*/
-      if(i==0) mass_in += u[IX(i,j,k)] * ayz;
-      /* East*/
-      if(i==imax+1) mass_in += (-u[IX(i,j,k)]) * ayz;
-      /* South*/
-      if(j==0) mass_in += v[IX(i,j,k)] * azx;
-      /* North*/
-      if(j==jmax+1) mass_in += (-v[IX(i,j,k)]) * azx;
-      /* Floor*/
-      if(k==0) mass_in += w[IX(i,j,k)] * axy;
-      /* Ceiling*/
-      if(k==kmax+1) mass_in += (-w[IX(i,j,k)]) * axy;
+    if(flagp[n]==INLET) {
+      for(f=port->first[c]; f<port->first[c+1]; f++) {
+        d = port->dir[f];
+        if(d%2==0)
+          mass_in += vel[d/2][n] * port->area[f];
+        else
+          mass_in += (-vel[d/2][n]) * port->area[f];
+      }
     }
     /*-------------------------------------------------------------------------
     | Compute the total outflow
     -------------------------------------------------------------------------*/
-    if(flagp[IX(i,j,k)]==2) {
-      /* West*/
-      if(i==0) {
-        mass_out += (-u[IX(i,j,k)]) * ayz;
-        area_out +=  ayz;
-      }
-      /* East*/
-      if(i==imax+1) {
-        mass_out += u[IX(i-1,j,k)] * ayz;
-        area_out += ayz;
-      }
-      /* South*/
-      if(j==0) {
-        mass_out += (-v[IX(i,j,k)]) * azx;
-        area_out += azx;
-      }
-      /* North*/
-      if(j==jmax+1) {
-        mass_out += v[IX(i,j-1,k)] * azx;
-        area_out += azx;
-      }
-      /* Floor*/
-      if(k==0) {
-        mass_out += (-w[IX(i,j,k)]) * axy;
-        area_out += axy;
-      }
-      /* Ceiling*/
-      if(k==kmax+1) {
-        mass_out += w[IX(i,j,k-1)] * axy;
-        area_out += axy;
+    else if(flagp[n]==OUTLET) {
+      for(f=port->first[c]; f<port->first[c+1]; f++) {
+        d = port->dir[f];
+        if(d%2==0)
+          mass_out += (-vel[d/2][n]) * port->area[f];
+        else
+          mass_out += vel[d/2][port->nbr[f]] * port->area[f];
+        area_out += port->area[f];
       }
     } /* End of computing outflow*/
   } /* End of for loop for going through all the inlets and outlets*/
@@ -945,3 +657,251 @@ REAL h_coef(PARA_DATA *para, REAL **var, int i, int j, int k, REAL D) {
   return h;
 
 } /* End of h_coef()*/
+
+/*
+	* Add the face between a boundary cell and its neighbor to a list
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param list Pointer to the list
+	* @param i I-index of the boundary cell
+	* @param j J-index of the boundary cell
+	* @param k K-index of the boundary cell
+	* @param dir Direction from the boundary cell to the neighbor
+	* @param fluid 1: Only add the face if the neighbor is fluid
+	*
+	* @return No return needed
+	*/
+static void add_face(PARA_DATA *para, REAL **var, FACE_LIST *list,
+                     int i, int j, int k, DIRECTION dir, int fluid) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int ii = i, jj = j, kk = k;
+  int f = list->nb_face;
+
+  switch(dir) {
+    case EAST: ii++; break;
+    case WEST: ii--; break;
+    case NORTH: jj++; break;
+    case SOUTH: jj--; break;
+    case CEILING: kk++; break;
+    case FLOOR: kk--; break;
+  }
+
+  if(fluid==1 && var[FLAGP][IX(ii,jj,kk)]!=FLUID)
+    return;
+
+  list->nbr[f] = IX(ii,jj,kk);
+  list->dir[f] = dir;
+  if(dir==EAST || dir==WEST) {
+    list->area[f] = area_yz(para, var, i, j, k);
+    list->dist[f] = (REAL) 0.5 * length_x(para, var, ii, jj, kk);
+  }
+  else if(dir==NORTH || dir==SOUTH) {
+    list->area[f] = area_zx(para, var, i, j, k);
+    list->dist[f] = (REAL) 0.5 * length_y(para, var, ii, jj, kk);
+  }
+  else {
+    list->area[f] = area_xy(para, var, i, j, k);
+    list->dist[f] = (REAL) 0.5 * length_z(para, var, ii, jj, kk);
+  }
+  list->dist_z[f] = (REAL) 0.5 * length_z(para, var, ii, jj, kk);
+  list->nb_face++;
+} /* End of add_face()*/
+
+/*
+	* Allocate a list of boundary cells and faces
+	*
+	* @param nb_cell Number of cells
+	*
+	* @return Pointer to the list, or NULL if an error occurred
+	*/
+static FACE_LIST *allocate_face_list(int nb_cell) {
+  FACE_LIST *list = (FACE_LIST *) calloc(1, sizeof(FACE_LIST));
+  int nb_face = 6*nb_cell; /* Upper bound of the number of faces*/
+
+  if(list==NULL)
+    return NULL;
+
+  list->cell = (int *) malloc((6*nb_cell+1+2*nb_face)*sizeof(int));
+  list->area = (REAL *) malloc((nb_cell+3*nb_face+1)*sizeof(REAL));
+  if(list->cell==NULL || list->area==NULL) {
+    free(list->cell);
+    free(list->area);
+    free(list);
+    return NULL;
+  }
+
+  list->it = list->cell + nb_cell;
+  list->id = list->it + nb_cell;
+  list->sur_cell = list->id + nb_cell;
+  list->sur_var = list->sur_cell + nb_cell;
+  list->first = list->sur_var + nb_cell;
+  list->nbr = list->first + nb_cell+1;
+  list->dir = list->nbr + nb_face;
+  list->dist = list->area + nb_face;
+  list->dist_z = list->dist + nb_face;
+  list->sur_area = list->dist_z + nb_face;
+  list->first[0] = 0;
+
+  return list;
+} /* End of allocate_face_list()*/
+
+/*
+	* Build the lists of the boundary cells and their faces
+	*
+	* The flags of the cells and BINDEX do not change during the simulation,
+	* except that a port can switch between inlet and outlet. So the faces,
+	* their areas and the distances to the walls are computed once instead
+	* of in every call of the boundary conditions.
+	*
+	* surface_integrate() uses one face of each cell on the boundary of the
+	* domain. Cells inside the domain, such as the cells of blocks, use the
+	* face of the previous cell in BINDEX.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param BINDEX Pointer to boundary index
+	*
+	* @return 0 if no error occurred
+	*/
+int build_face_list(PARA_DATA *para, REAL **var, int **BINDEX) {
+  int i, j, k, it, c, nb_wall = 0;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int index = para->geom->index;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int sur_cell = 0, sur_var = VX;
+  REAL sur_area = 0;
+  REAL *flagp = var[FLAGP];
+  FACE_LIST *list;
+
+  for(it=0; it<index; it++)
+    if(flagp[IX(BINDEX[0][it],BINDEX[1][it],BINDEX[2][it])]==SOLID)
+      nb_wall++;
+
+  para->geom->wall_face = allocate_face_list(nb_wall);
+  para->geom->port_face = allocate_face_list(index-nb_wall);
+  if(para->geom->wall_face==NULL || para->geom->port_face==NULL) {
+    ffd_log("build_face_list(): Could not allocate memory for the faces.",
+            FFD_ERROR);
+    free_face_list(para);
+    return 1;
+  }
+
+  for(it=0; it<index; it++) {
+    i = BINDEX[0][it];
+    j = BINDEX[1][it];
+    k = BINDEX[2][it];
+
+    /* Face integrated by surface_integrate()*/
+    if(i==0 || i==imax+1) {
+      sur_cell = IX(i,j,k);
+      sur_var = VX;
+      sur_area = area_yz(para, var, i, j, k);
+    }
+    else if(j==0 || j==jmax+1) {
+      sur_cell = IX(i,j,k);
+      sur_var = VY;
+      sur_area = area_zx(para, var, i, j, k);
+    }
+    else if(k==0 || k==kmax+1) {
+      sur_cell = IX(i,j,k);
+      sur_var = VZ;
+      sur_area = area_xy(para, var, i, j, k);
+    }
+
+    if(flagp[IX(i,j,k)]==SOLID)
+      list = para->geom->wall_face;
+    else
+      list = para->geom->port_face;
+
+    c = list->nb_cell++;
+    list->cell[c] = IX(i,j,k);
+    list->it[c] = it;
+    list->id[c] = BINDEX[4][it];
+    list->sur_cell[c] = sur_cell;
+    list->sur_var[c] = sur_var;
+    list->sur_area[c] = sur_area;
+
+    /*-------------------------------------------------------------------------
+    | Solid wall or block: faces to the fluid neighbors
+    -------------------------------------------------------------------------*/
+    if(flagp[IX(i,j,k)]==SOLID) {
+      if(i==0)
+        add_face(para, var, list, i, j, k, EAST, 1);
+      else if(i==imax+1)
+        add_face(para, var, list, i, j, k, WEST, 1);
+      else {
+        add_face(para, var, list, i, j, k, EAST, 1);
+        add_face(para, var, list, i, j, k, WEST, 1);
+      }
+
+      if(j==0)
+        add_face(para, var, list, i, j, k, NORTH, 1);
+      else if(j==jmax+1)
+        add_face(para, var, list, i, j, k, SOUTH, 1);
+      else {
+        add_face(para, var, list, i, j, k, SOUTH, 1);
+        add_face(para, var, list, i, j, k, NORTH, 1);
+      }
+
+      if(k==0)
+        add_face(para, var, list, i, j, k, CEILING, 1);
+      else if(k==kmax+1)
+        add_face(para, var, list, i, j, k, FLOOR, 1);
+      else {
+        add_face(para, var, list, i, j, k, CEILING, 1);
+        add_face(para, var, list, i, j, k, FLOOR, 1);
+      }
+    }
+    /*-------------------------------------------------------------------------
+    | Inlet and outlet: faces to the inside of the domain
+    -------------------------------------------------------------------------*/
+    else {
+      if(i==0) add_face(para, var, list, i, j, k, EAST, 0);
+      if(i==imax+1) add_face(para, var, list, i, j, k, WEST, 0);
+      if(j==0) add_face(para, var, list, i, j, k, NORTH, 0);
+      if(j==jmax+1) add_face(para, var, list, i, j, k, SOUTH, 0);
+      if(k==0) add_face(para, var, list, i, j, k, CEILING, 0);
+      if(k==kmax+1) add_face(para, var, list, i, j, k, FLOOR, 0);
+    }
+
+    list->first[c+1] = list->nb_face;
+  }
+
+  if(para->outp->version==DEBUG) {
+    sprintf(msg, "build_face_list(): %d faces of %d wall cells and %d faces "
+            "of %d inlet and outlet cells.", para->geom->wall_face->nb_face,
+            para->geom->wall_face->nb_cell, para->geom->port_face->nb_face,
+            para->geom->port_face->nb_cell);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
+  return 0;
+} /* End of build_face_list()*/
+
+/*
+	* Free the lists of the boundary cells and their faces
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_face_list(PARA_DATA *para) {
+  FACE_LIST *list[2];
+  int n;
+
+  list[0] = para->geom->wall_face;
+  list[1] = para->geom->port_face;
+
+  for(n=0; n<2; n++) {
+    if(list[n]==NULL) continue;
+    free(list[n]->cell);
+    free(list[n]->area);
+    free(list[n]);
+  }
+
+  para->geom->wall_face = NULL;
+  para->geom->port_face = NULL;
+} /* End of free_face_list()*/
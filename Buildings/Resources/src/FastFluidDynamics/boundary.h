@@ -39,6 +39,11 @@
 #include "utility.h"
 #endif
 
+#ifndef _TIMING_H
+#define _TIMING_H
+#include "timing.h"
+#endif
+
 #ifndef _CHEN_ZERO_EQU_MODEL_H
 #define _CHEN_ZERO_EQU_MODEL_H
 #include "chen_zero_equ_model.h"
@@ -161,3 +166,26 @@ REAL adjust_velocity(PARA_DATA *para, REAL **var, int **BINDEX);
 	* @return Mass flow difference divided by the outflow area
 	*/
 REAL h_coef(PARA_DATA *para, REAL **var, int i, int j, int k, REAL D);
+
+/*
+	* Build the lists of the boundary cells and their faces
+	*
+	* The lists are used by set_bnd_temp(), mass_conservation(),
+	* adjust_velocity() and surface_integrate().
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param BINDEX Pointer to boundary index
+	*
+	* @return 0 if no error occurred
+	*/
+int build_face_list(PARA_DATA *para, REAL **var, int **BINDEX);
+
+/*
+	* Free the lists of the boundary cells and their faces
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_face_list(PARA_DATA *para);
@@ -0,0 +1,390 @@
+/*
+	*
+	* \file   checkpoint.c
+	*
+	* \brief  Write and read the FFD fields in a binary checkpoint file
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "checkpoint.h"
+
+/* Magic number at the beginning of a checkpoint file*/
+static const char checkpoint_magic[8] = {'F','F','D','C','H','K','P','T'};
+
+/* Variables that are needed to restart a simulation, in addition to the
+   species and trace substances*/
+static const int checkpoint_var[] = {VX, VY, VZ, IP, TEMP};
+
+#define CHECKPOINT_NB_VAR (int) (sizeof(checkpoint_var)/sizeof(checkpoint_var[0]))
+
+/* Size of the fixed part of the header in bytes*/
+#define CHECKPOINT_HEAD_SIZE 32
+
+	/*
+		* Check the byte order of the host
+		*
+		* @return 1 if the host is big-endian, 0 if it is little-endian
+		*/
+static int host_is_big_endian() {
+  unsigned int one = 1;
+
+  return *((unsigned char *) &one)==0;
+} /* End of host_is_big_endian()*/
+
+	/*
+		* Store an integer as 4 bytes in little-endian byte order
+		*
+		* @param p Pointer to the bytes
+		* @param value Value between 0 and 2^31-1
+		*
+		* @return No return needed
+		*/
+static void put_int(unsigned char *p, unsigned long value) {
+  p[0] = (unsigned char) (value & 0xFF);
+  p[1] = (unsigned char) ((value>>8) & 0xFF);
+  p[2] = (unsigned char) ((value>>16) & 0xFF);
+  p[3] = (unsigned char) ((value>>24) & 0xFF);
+} /* End of put_int()*/
+
+	/*
+		* Load an integer that is stored as 4 bytes in little-endian byte order
+		*
+		* @param p Pointer to the bytes
+		*
+		* @return Value of the integer
+		*/
+static unsigned long get_int(const unsigned char *p) {
+  return (unsigned long) p[0] | ((unsigned long) p[1]<<8)
+         | ((unsigned long) p[2]<<16) | ((unsigned long) p[3]<<24);
+} /* End of get_int()*/
+
+	/*
+		* Reverse the byte order of an array of REAL
+		*
+		* @param a Pointer to the array
+		* @param n Number of elements
+		*
+		* @return No return needed
+		*/
+static void swap_real(REAL *a, int n) {
+  int i, b;
+  unsigned char *p, tmp;
+
+  for(i=0; i<n; i++) {
+    p = (unsigned char *) &a[i];
+    for(b=0; b<(int) sizeof(REAL)/2; b++) {
+      tmp = p[b];
+      p[b] = p[sizeof(REAL)-1-b];
+      p[sizeof(REAL)-1-b] = tmp;
+    }
+  }
+} /* End of swap_real()*/
+
+	/*
+		* Count the variables of a checkpoint file
+		*
+		* Xi1, Xi2, C1 and C2 are always stored. Species and trace substances
+		* beyond them are stored if the simulation has them.
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return Number of variables
+		*/
+static int checkpoint_nb_var(PARA_DATA *para) {
+  return CHECKPOINT_NB_VAR + 4 + NB_EXTRA(para->bc->nb_Xi)
+         + NB_EXTRA(para->bc->nb_C);
+} /* End of checkpoint_nb_var()*/
+
+	/*
+		* Get the index in var of a variable of a checkpoint file
+		*
+		* @param para Pointer to FFD parameters
+		* @param n Number of the variable in the file
+		*
+		* @return Index of the variable in var
+		*/
+static int checkpoint_id(PARA_DATA *para, int n) {
+  int nb_Xi = 2 + NB_EXTRA(para->bc->nb_Xi);
+
+  if(n<CHECKPOINT_NB_VAR)
+    return checkpoint_var[n];
+  n -= CHECKPOINT_NB_VAR;
+  if(n<nb_Xi)
+    return XI_VAR(para, n, SPECIES_VALUE);
+  return C_VAR(para, n-nb_Xi, SPECIES_VALUE);
+} /* End of checkpoint_id()*/
+
+	/*
+		* Check if a variable can be restored from a checkpoint file
+		*
+		* @param para Pointer to FFD parameters
+		* @param id Index of the variable
+		*
+		* @return 1 if the variable is restored, 0 otherwise
+		*/
+static int is_checkpoint_var(PARA_DATA *para, unsigned long id) {
+  int n;
+
+  for(n=0; n<checkpoint_nb_var(para); n++)
+    if((unsigned long) checkpoint_id(para, n)==id) return 1;
+
+  return 0;
+} /* End of is_checkpoint_var()*/
+
+	/*
+		* Compute the size of the header
+		*
+		* The header is padded so that the first block starts at a multiple
+		* of 8 bytes.
+		*
+		* @param nb_var Number of variables
+		*
+		* @return Size of the header in bytes
+		*/
+static int header_size(int nb_var) {
+  int size = CHECKPOINT_HEAD_SIZE + (int) sizeof(REAL) + 4*nb_var;
+
+  return (size+7)/8*8;
+} /* End of header_size()*/
+
+	/*
+		* Write the flow field in a binary checkpoint file
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param name Pointer to the file name without extension
+		*
+		* @return 0 if no error occurred
+		*/
+int write_checkpoint(PARA_DATA *para, REAL **var, char *name) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int size = (imax+2)*(jmax+2)*(kmax+2);
+  int n, id, nb_var = checkpoint_nb_var(para);
+  int nb_head = header_size(nb_var);
+  int swap = host_is_big_endian();
+  unsigned char *head;
+  REAL t = para->mytime->t;
+  char *filename;
+  FILE *file;
+
+  filename = (char *) malloc((strlen(name)+5)*sizeof(char));
+  head = (unsigned char *) calloc(nb_head, sizeof(unsigned char));
+  if(filename==NULL || head==NULL) {
+    ffd_log("write_checkpoint(): Failed to allocate memory for the header.",
+            FFD_ERROR);
+    free(filename);
+    free(head);
+    return 1;
+  }
+
+  strcpy(filename, name);
+  strcat(filename, ".chk");
+
+  /****************************************************************************
+  | Assemble the header
+  ****************************************************************************/
+  memcpy(head, checkpoint_magic, 8);
+  put_int(head+8, CHECKPOINT_VERSION);
+  put_int(head+12, sizeof(REAL));
+  put_int(head+16, imax);
+  put_int(head+20, jmax);
+  put_int(head+24, kmax);
+  put_int(head+28, nb_var);
+  if(swap) swap_real(&t, 1);
+  memcpy(head+CHECKPOINT_HEAD_SIZE, &t, sizeof(REAL));
+  for(n=0; n<nb_var; n++)
+    put_int(head+CHECKPOINT_HEAD_SIZE+sizeof(REAL)+4*n,
+            checkpoint_id(para, n));
+
+  if((file=fopen(filename, "wb"))==NULL) {
+    sprintf(msg, "write_checkpoint(): Failed to open file %s.", filename);
+    ffd_log(msg, FFD_ERROR);
+    free(filename);
+    free(head);
+    return 1;
+  }
+
+  /****************************************************************************
+  | Write the header and one block per variable
+  ****************************************************************************/
+  if(fwrite(head, 1, nb_head, file)!=(size_t) nb_head) {
+    sprintf(msg, "write_checkpoint(): Failed to write the header of %s.",
+            filename);
+    ffd_log(msg, FFD_ERROR);
+    fclose(file);
+    free(filename);
+    free(head);
+    return 1;
+  }
+
+  for(n=0; n<nb_var; n++) {
+    id = checkpoint_id(para, n);
+    /* The blocks are swapped in place and restored after writing*/
+    if(swap) swap_real(var[id], size);
+    if(fwrite(var[id], sizeof(REAL), size, file)!=(size_t) size) {
+      if(swap) swap_real(var[id], size);
+      sprintf(msg, "write_checkpoint(): Failed to write variable %d to %s.",
+              id, filename);
+      ffd_log(msg, FFD_ERROR);
+      fclose(file);
+      free(filename);
+      free(head);
+      return 1;
+    }
+    if(swap) swap_real(var[id], size);
+  }
+
+  if(fclose(file)!=0) {
+    sprintf(msg, "write_checkpoint(): Failed to close file %s.", filename);
+    ffd_log(msg, FFD_ERROR);
+    free(filename);
+    free(head);
+    return 1;
+  }
+
+  sprintf(msg, "write_checkpoint(): Wrote the checkpoint file %s at t=%f[s].",
+          filename, para->mytime->t);
+  ffd_log(msg, FFD_NORMAL);
+
+  free(filename);
+  free(head);
+  return 0;
+} /* End of write_checkpoint()*/
+
+	/*
+		* Read the flow field from a binary checkpoint file
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		*
+		* @return 0 if no error occurred
+		*/
+int read_checkpoint(PARA_DATA *para, REAL **var) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int size = (imax+2)*(jmax+2)*(kmax+2);
+  int n, nb_var, nb_head;
+  int swap = host_is_big_endian();
+  unsigned char fixed[CHECKPOINT_HEAD_SIZE], *head;
+  unsigned long id;
+  REAL t;
+  char *filename = para->inpu->old_ffd_file_name;
+  FILE *file;
+
+  if((file=fopen(filename, "rb"))==NULL) {
+    sprintf(msg, "read_checkpoint(): Can not open file \"%s\".", filename);
+    ffd_log(msg, FFD_ERROR);
+    return 1;
+  }
+
+  /****************************************************************************
+  | Check the fixed part of the header
+  ****************************************************************************/
+  if(fread(fixed, 1, CHECKPOINT_HEAD_SIZE, file)!=CHECKPOINT_HEAD_SIZE
+     || memcmp(fixed, checkpoint_magic, 8)!=0) {
+    sprintf(msg, "read_checkpoint(): File \"%s\" is not a checkpoint file.",
+            filename);
+    ffd_log(msg, FFD_ERROR);
+    fclose(file);
+    return 1;
+  }
+
+  if(get_int(fixed+8)!=CHECKPOINT_VERSION) {
+    sprintf(msg, "read_checkpoint(): Version %lu of file \"%s\" is not "
+            "supported. Expected version %d.",
+            get_int(fixed+8), filename, CHECKPOINT_VERSION);
+    ffd_log(msg, FFD_ERROR);
+    fclose(file);
+    return 1;
+  }
+
+  if(get_int(fixed+12)!=sizeof(REAL)) {
+    sprintf(msg, "read_checkpoint(): File \"%s\" stores %lu bytes per value "
+            "while FFD uses %d bytes.",
+            filename, get_int(fixed+12), (int) sizeof(REAL));
+    ffd_log(msg, FFD_ERROR);
+    fclose(file);
+    return 1;
+  }
+
+  if(get_int(fixed+16)!=(unsigned long) imax
+     || get_int(fixed+20)!=(unsigned long) jmax
+     || get_int(fixed+24)!=(unsigned long) kmax) {
+    sprintf(msg, "read_checkpoint(): Grid %lux%lux%lu of file \"%s\" does not "
+            "match the grid %dx%dx%d of the simulation.",
+            get_int(fixed+16), get_int(fixed+20), get_int(fixed+24), filename,
+            imax, jmax, kmax);
+    ffd_log(msg, FFD_ERROR);
+    fclose(file);
+    return 1;
+  }
+
+  if(get_int(fixed+28)<1 || get_int(fixed+28)>(unsigned long) NB_VAR(para)) {
+    sprintf(msg, "read_checkpoint(): Invalid number of variables %lu in file "
+            "\"%s\".", get_int(fixed+28), filename);
+    ffd_log(msg, FFD_ERROR);
+    fclose(file);
+    return 1;
+  }
+  nb_var = (int) get_int(fixed+28);
+
+  /****************************************************************************
+  | Read the simulation time and the list of variables
+  ****************************************************************************/
+  nb_head = header_size(nb_var);
+  head = (unsigned char *) malloc(nb_head);
+  if(head==NULL) {
+    ffd_log("read_checkpoint(): Failed to allocate memory for the header.",
+            FFD_ERROR);
+    fclose(file);
+    return 1;
+  }
+
+  if(fread(head+CHECKPOINT_HEAD_SIZE, 1, nb_head-CHECKPOINT_HEAD_SIZE, file)
+     !=(size_t) (nb_head-CHECKPOINT_HEAD_SIZE)) {
+    sprintf(msg, "read_checkpoint(): Failed to read the header of \"%s\".",
+            filename);
+    ffd_log(msg, FFD_ERROR);
+    free(head);
+    fclose(file);
+    return 1;
+  }
+  memcpy(&t, head+CHECKPOINT_HEAD_SIZE, sizeof(REAL));
+  if(swap) swap_real(&t, 1);
+
+  /****************************************************************************
+  | Read the blocks of the variables
+  ****************************************************************************/
+  for(n=0; n<nb_var; n++) {
+    id = get_int(head+CHECKPOINT_HEAD_SIZE+sizeof(REAL)+4*n);
+
+    if(!is_checkpoint_var(para, id)) {
+      sprintf(msg, "read_checkpoint(): Skipped unknown variable %lu in file "
+              "\"%s\".", id, filename);
+      ffd_log(msg, FFD_WARNING);
+      if(fseek(file, (long) size*sizeof(REAL), SEEK_CUR)==0) continue;
+    }
+    else if(fread(var[id], sizeof(REAL), size, file)==(size_t) size) {
+      if(swap) swap_real(var[id], size);
+      continue;
+    }
+
+    sprintf(msg, "read_checkpoint(): Failed to read variable %lu from \"%s\".",
+            id, filename);
+    ffd_log(msg, FFD_ERROR);
+    free(head);
+    fclose(file);
+    return 1;
+  }
+
+  free(head);
+  fclose(file);
+
+  sprintf(msg, "read_checkpoint(): Read %d variables of the checkpoint file "
+          "%s written at t=%f[s].", nb_var, filename, t);
+  ffd_log(msg, FFD_NORMAL);
+  return 0;
+} /* End of read_checkpoint()*/
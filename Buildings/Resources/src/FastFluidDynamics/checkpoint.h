@@ -0,0 +1,67 @@
+/*
+	*
+	* @file   checkpoint.h
+	*
+	* @brief  Write and read the FFD fields in a binary checkpoint file
+	*
+	* @date   10/18/2026
+	*
+	* A checkpoint file starts with a header followed by one block per
+	* variable. All numbers are stored in little-endian byte order.
+	*
+	*   char    magic[8]      "FFDCHKPT"
+	*   int32   version       CHECKPOINT_VERSION
+	*   int32   real_size     Size of REAL in bytes
+	*   int32   imax, jmax, kmax
+	*   int32   nb_var        Number of variable blocks
+	*   REAL    t             Simulation time when the file was written
+	*   int32   id[nb_var]    Index of the variables in var, e.g. VX or TEMP
+	*                         (padded with zeros to a multiple of 8 bytes)
+	*   REAL    block[nb_var][(imax+2)*(jmax+2)*(kmax+2)]
+	*
+	* The blocks include the ghost cells and use the layout of var, so that
+	* each block is read with a single call and starts at an aligned offset
+	* of the file.
+	*
+	*/
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+/* Version of the checkpoint file format*/
+#define CHECKPOINT_VERSION 1
+
+/*
+	* Write the flow field in a binary checkpoint file
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param name Pointer to the file name without extension
+	*
+	* @return 0 if no error occurred
+	*/
+int write_checkpoint(PARA_DATA *para, REAL **var, char *name);
+
+/*
+	* Read the flow field from a binary checkpoint file
+	*
+	* The grid of the file must match the grid of the simulation. Variables
+	* that are not stored in the file keep their initial values.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return 0 if no error occurred
+	*/
+int read_checkpoint(PARA_DATA *para, REAL **var);
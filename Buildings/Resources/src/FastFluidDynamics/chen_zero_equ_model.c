@@ -20,42 +20,88 @@
 #include "chen_zero_equ_model.h"
 
 /*
-	* Computes turbulent viscosity using Chen's zero equation model
+	* Computes the distance of each cell to the nearest wall
+	*
+	* The walls are fixed, so the distance is computed once before the
+	* simulation and stored in var[DIST].
 	*
 	* @param para Pointer to FFD parameters
 	* @param var Pointer to FFD simulation variables
-	* @param i I-index of the control volume
-	* @param j J-index of the control volume
-	* @param k K-index of the control volume
 	*
-	* @return Turbulent Kinematic viscosity
+	* @return No return needed
 	*/
-REAL nu_t_chen_zero_equ(PARA_DATA *para, REAL **var, int i, int j, int k) {
-  REAL nu_t, l, lx, lx1, lx2, ly, ly1, ly2, lz, lz1, lz2;
+void wall_distance_chen(PARA_DATA *para, REAL **var) {
+  REAL l, lx, lx1, lx2, ly, ly1, ly2, lz, lz1, lz2;
   REAL *x = var[X], *y = var[Y], *z = var[Z];
-  REAL *u = var[VX], *v = var[VY], *w = var[Z];
+  REAL *dist = var[DIST];
   int imax = para->geom->imax, jmax = para->geom->jmax,
       kmax = para->geom->kmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+
+  FOR_ALL_CELL
+    lx1 = x[IX(i,j,k)] - x[IX(0,j,k)];
+    lx2 = x[IX(imax+1,j,k)] - x[IX(i,j,k)];
+    lx = lx1 < lx2 ? lx1 : lx2;
+
+    ly1 = y[IX(i,j,k)] - y[IX(i,0,k)];
+    ly2 = y[IX(i,jmax,k)] - y[IX(i,j,k)];
+    ly = ly1 < ly2 ? ly1 : ly2;
 
-  lx1 = x[IX(i,j,k)] - x[IX(0,j,k)];
-  lx2 = x[IX(imax+1,j,k)] - x[IX(i,j,k)];
-  lx = lx1 < lx2 ? lx1 : lx2;
+    lz1 = z[IX(i,j,k)] - z[IX(i,j,0)];
+    lz2 = z[IX(i,j,kmax+1)] - z[IX(i,j,k)];
+    lz = lz1 < lz2 ? lz1 : lz2;
+
+    l = lx < ly ? lx : ly;
+    dist[IX(i,j,k)] = lz < l ? lz : l;
+  END_FOR
+} /* End of wall_distance_chen()*/
+
+/*
+	* Computes turbulent viscosity using Chen's zero equation model
+	*
+	* The result is stored in var[NUT] for all the cells. The distance to
+	* the wall must have been computed by wall_distance_chen().
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return No return needed
+	*/
+void nu_t_chen_zero_equ_all(PARA_DATA *para, REAL **var) {
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  REAL *dist = var[DIST], *nu_t = var[NUT];
+  REAL chen_a = para->prob->chen_a;
+  int n = (para->geom->imax+2) * (para->geom->jmax+2)
+        * (para->geom->kmax+2);
+  int c;
 
-  ly1 = y[IX(i,j,k)] - y[IX(i,0,k)];
-  ly2 = y[IX(i,jmax,k)] - y[IX(i,j,k)];
-  ly = ly1 < ly2 ? ly1 : ly2;
+  for(c=0; c<n; c++)
+    nu_t[c] = chen_a * dist[c]
+            * (REAL)sqrt(u[c]*u[c] + v[c]*v[c] + w[c]*w[c]);
+} /* End of nu_t_chen_zero_equ_all()*/
 
-  lz1 = z[IX(i,j,k)] - z[IX(i,j,0)];
-  lz2 = z[IX(i,j,kmax+1)] - z[IX(i,j,k)];
-  lz = lz1 < lz2 ? lz1 : lz2;
+/*
+	* Computes turbulent viscosity using Chen's zero equation model
+	*
+	* The distance to the wall must have been computed by
+	* wall_distance_chen().
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param i I-index of the control volume
+	* @param j J-index of the control volume
+	* @param k K-index of the control volume
+	*
+	* @return Turbulent Kinematic viscosity
+	*/
+REAL nu_t_chen_zero_equ(PARA_DATA *para, REAL **var, int i, int j, int k) {
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ];
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
 
-  l = lx < ly ? lx : ly;
-  l = lz < l ? lz : l;
-  nu_t = para->prob->chen_a * l
+  return para->prob->chen_a * var[DIST][IX(i,j,k)]
        * (REAL)sqrt( u[IX(i,j,k)]*u[IX(i,j,k)]
                     +v[IX(i,j,k)]*v[IX(i,j,k)]
                     +w[IX(i,j,k)]*w[IX(i,j,k)] );
-
-  return nu_t;
 } /* End of nu_t_chen_zero_equ()*/
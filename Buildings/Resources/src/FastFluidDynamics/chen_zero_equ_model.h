@@ -26,6 +26,27 @@
 #include "data_structure.h"
 #endif
 
+/*
+	* Computes the distance of each cell to the nearest wall
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return No return needed
+	*/
+void wall_distance_chen(PARA_DATA *para, REAL **var);
+
+/*
+	* Computes turbulent viscosity using Chen's zero equation model
+	* for all the cells and stores it in var[NUT]
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return No return needed
+	*/
+void nu_t_chen_zero_equ_all(PARA_DATA *para, REAL **var);
+
 /*
 	* Computes turbulent viscosity using Chen's zero equation model
 	*
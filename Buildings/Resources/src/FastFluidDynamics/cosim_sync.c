@@ -0,0 +1,257 @@
+/*
+	*
+	* \file   cosim_sync.c
+	*
+	* \brief  Synchronization of the data exchange between Modelica and FFD
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+/* clock_gettime() is not declared in strict C89 mode*/
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "cosim_sync.h"
+
+/* Lock and condition variable of one coupled simulation*/
+typedef struct {
+#ifdef _MSC_VER /*Windows*/
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE cond;
+#else /*Linux*/
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+#endif
+} COSIM_SYNC;
+
+/* Number of FFD instances that have not been released, and ID of the next
+   instance. They are shared by all coupled simulations of the process.*/
+static int cosim_num_instances = 0;
+static int cosim_next_id = 0;
+#ifdef _MSC_VER /*Windows*/
+static SRWLOCK cosim_id_lock = SRWLOCK_INIT;
+#else /*Linux*/
+static pthread_mutex_t cosim_id_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+	/*
+		* Allocate and initialize the lock of the coupled simulation
+		*
+		* @param cosim Pointer to the coupled simulation data
+		*
+		* @return 0 if no error occurred
+		*/
+int cosim_sync_init(CosimulationData *cosim) {
+  COSIM_SYNC *sync;
+
+  sync = (COSIM_SYNC *) malloc(sizeof(COSIM_SYNC));
+  if(sync==NULL) {
+    cosim->sync = NULL;
+    return 1;
+  }
+
+#ifdef _MSC_VER /*Windows*/
+  InitializeCriticalSection(&sync->lock);
+  InitializeConditionVariable(&sync->cond);
+#else /*Linux*/
+  pthread_mutex_init(&sync->lock, NULL);
+  pthread_cond_init(&sync->cond, NULL);
+#endif
+
+  cosim->sync = (void *) sync;
+  return 0;
+} /* End of cosim_sync_init()*/
+
+	/*
+		* Free the lock of the coupled simulation
+		*
+		* @param cosim Pointer to the coupled simulation data
+		*
+		* @return No return needed
+		*/
+void cosim_sync_free(CosimulationData *cosim) {
+  COSIM_SYNC *sync = (COSIM_SYNC *) cosim->sync;
+
+  if(sync==NULL) return;
+
+#ifdef _MSC_VER /*Windows*/
+  DeleteCriticalSection(&sync->lock);
+#else /*Linux*/
+  pthread_mutex_destroy(&sync->lock);
+  pthread_cond_destroy(&sync->cond);
+#endif
+  free(sync);
+  cosim->sync = NULL;
+} /* End of cosim_sync_free()*/
+
+	/*
+		* Acquire the lock of the coupled simulation
+		*
+		* @param cosim Pointer to the coupled simulation data
+		*
+		* @return No return needed
+		*/
+void cosim_lock(CosimulationData *cosim) {
+  COSIM_SYNC *sync = (COSIM_SYNC *) cosim->sync;
+
+#ifdef _MSC_VER /*Windows*/
+  EnterCriticalSection(&sync->lock);
+#else /*Linux*/
+  pthread_mutex_lock(&sync->lock);
+#endif
+} /* End of cosim_lock()*/
+
+	/*
+		* Release the lock of the coupled simulation
+		*
+		* @param cosim Pointer to the coupled simulation data
+		*
+		* @return No return needed
+		*/
+void cosim_unlock(CosimulationData *cosim) {
+  COSIM_SYNC *sync = (COSIM_SYNC *) cosim->sync;
+
+#ifdef _MSC_VER /*Windows*/
+  LeaveCriticalSection(&sync->lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&sync->lock);
+#endif
+} /* End of cosim_unlock()*/
+
+	/*
+		* Wait until the shared data changed or the time out elapsed
+		*
+		* @param cosim Pointer to the coupled simulation data
+		* @param timeout Maximum waiting time in milliseconds
+		*
+		* @return 0 if the thread was woken up, 1 if the time out elapsed
+		*/
+int cosim_wait(CosimulationData *cosim, int timeout) {
+  COSIM_SYNC *sync = (COSIM_SYNC *) cosim->sync;
+#ifdef _MSC_VER /*Windows*/
+  if(SleepConditionVariableCS(&sync->cond, &sync->lock, (DWORD) timeout))
+    return 0;
+  else
+    return 1;
+#else /*Linux*/
+  struct timespec deadline;
+
+  /* The condition variable uses the real time clock by default*/
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout / 1000;
+  deadline.tv_nsec += (long) (timeout % 1000) * 1000000L;
+  if(deadline.tv_nsec>=1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  if(pthread_cond_timedwait(&sync->cond, &sync->lock, &deadline)==0)
+    return 0;
+  else
+    return 1;
+#endif
+} /* End of cosim_wait()*/
+
+	/*
+		* Wake up all threads that wait for the shared data
+		*
+		* @param cosim Pointer to the coupled simulation data
+		*
+		* @return No return needed
+		*/
+void cosim_notify(CosimulationData *cosim) {
+  COSIM_SYNC *sync = (COSIM_SYNC *) cosim->sync;
+
+#ifdef _MSC_VER /*Windows*/
+  WakeAllConditionVariable(&sync->cond);
+#else /*Linux*/
+  pthread_cond_broadcast(&sync->cond);
+#endif
+} /* End of cosim_notify()*/
+
+	/*
+		* Set a flag of the shared data and wake up the waiting threads
+		*
+		* The data that is published by the flag must be written before
+		* calling this function. The lock makes it visible to the thread that
+		* reads the flag.
+		*
+		* @param cosim Pointer to the coupled simulation data
+		* @param flag Pointer to the flag
+		* @param value New value of the flag
+		*
+		* @return No return needed
+		*/
+void cosim_set_flag(CosimulationData *cosim, volatile int *flag, int value) {
+  cosim_lock(cosim);
+  *flag = value;
+  cosim_notify(cosim);
+  cosim_unlock(cosim);
+} /* End of cosim_set_flag()*/
+
+	/*
+		* Read a flag of the shared data
+		*
+		* @param cosim Pointer to the coupled simulation data
+		* @param flag Pointer to the flag
+		*
+		* @return Value of the flag
+		*/
+int cosim_get_flag(CosimulationData *cosim, volatile int *flag) {
+  int value;
+
+  cosim_lock(cosim);
+  value = *flag;
+  cosim_unlock(cosim);
+
+  return value;
+} /* End of cosim_get_flag()*/
+
+	/*
+		* Assign the ID of a new FFD instance
+		*
+		* @return ID of the instance
+		*/
+int cosim_acquire_id(void) {
+  int id;
+
+#ifdef _MSC_VER /*Windows*/
+  AcquireSRWLockExclusive(&cosim_id_lock);
+#else /*Linux*/
+  pthread_mutex_lock(&cosim_id_lock);
+#endif
+  if(cosim_num_instances==0)
+    cosim_next_id = 0;
+  id = cosim_next_id;
+  cosim_next_id++;
+  cosim_num_instances++;
+#ifdef _MSC_VER /*Windows*/
+  ReleaseSRWLockExclusive(&cosim_id_lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&cosim_id_lock);
+#endif
+
+  return id;
+} /* End of cosim_acquire_id()*/
+
+	/*
+		* Release the ID of an FFD instance that has been stopped
+		*
+		* @return No return needed
+		*/
+void cosim_release_id(void) {
+#ifdef _MSC_VER /*Windows*/
+  AcquireSRWLockExclusive(&cosim_id_lock);
+#else /*Linux*/
+  pthread_mutex_lock(&cosim_id_lock);
+#endif
+  if(cosim_num_instances>0)
+    cosim_num_instances--;
+#ifdef _MSC_VER /*Windows*/
+  ReleaseSRWLockExclusive(&cosim_id_lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&cosim_id_lock);
+#endif
+} /* End of cosim_release_id()*/
@@ -0,0 +1,132 @@
+/*
+	*
+	* @file   cosim_sync.h
+	*
+	* @brief  Synchronization of the data exchange between Modelica and FFD
+	*
+	* @date   10/18/2026
+	*
+	* The flags of the shared data are read and written while holding the lock
+	* of the coupled simulation. A thread that changes a flag wakes up the
+	* threads that wait for it, so that the exchange does not depend on a
+	* polling interval. The functions are also called by the C-Sources of
+	* Modelica and are thus exported by the library.
+	*
+	*/
+
+#ifndef _COSIM_SYNC_H
+#define _COSIM_SYNC_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifdef _MSC_VER /*Windows*/
+#define COSIM_SYNC_API __declspec(dllexport)
+#else /*Linux*/
+#include <pthread.h>
+#define COSIM_SYNC_API
+#endif
+
+/*
+	* Allocate and initialize the lock of the coupled simulation
+	*
+	* @param cosim Pointer to the coupled simulation data
+	*
+	* @return 0 if no error occurred
+	*/
+COSIM_SYNC_API int cosim_sync_init(CosimulationData *cosim);
+
+/*
+	* Free the lock of the coupled simulation
+	*
+	* No other thread may use the lock when it is freed.
+	*
+	* @param cosim Pointer to the coupled simulation data
+	*
+	* @return No return needed
+	*/
+COSIM_SYNC_API void cosim_sync_free(CosimulationData *cosim);
+
+/*
+	* Acquire the lock of the coupled simulation
+	*
+	* @param cosim Pointer to the coupled simulation data
+	*
+	* @return No return needed
+	*/
+COSIM_SYNC_API void cosim_lock(CosimulationData *cosim);
+
+/*
+	* Release the lock of the coupled simulation
+	*
+	* @param cosim Pointer to the coupled simulation data
+	*
+	* @return No return needed
+	*/
+COSIM_SYNC_API void cosim_unlock(CosimulationData *cosim);
+
+/*
+	* Wait until the shared data changed or the time out elapsed
+	*
+	* The lock must be held by the caller. It is released while waiting and
+	* acquired again before returning. The caller has to check its condition
+	* again after the return since the thread may wake up spuriously.
+	*
+	* @param cosim Pointer to the coupled simulation data
+	* @param timeout Maximum waiting time in milliseconds
+	*
+	* @return 0 if the thread was woken up, 1 if the time out elapsed
+	*/
+COSIM_SYNC_API int cosim_wait(CosimulationData *cosim, int timeout);
+
+/*
+	* Wake up all threads that wait for the shared data
+	*
+	* The lock must be held by the caller.
+	*
+	* @param cosim Pointer to the coupled simulation data
+	*
+	* @return No return needed
+	*/
+COSIM_SYNC_API void cosim_notify(CosimulationData *cosim);
+
+/*
+	* Set a flag of the shared data and wake up the waiting threads
+	*
+	* @param cosim Pointer to the coupled simulation data
+	* @param flag Pointer to the flag
+	* @param value New value of the flag
+	*
+	* @return No return needed
+	*/
+COSIM_SYNC_API void cosim_set_flag(CosimulationData *cosim, volatile int *flag,
+                                   int value);
+
+/*
+	* Read a flag of the shared data
+	*
+	* @param cosim Pointer to the coupled simulation data
+	* @param flag Pointer to the flag
+	*
+	* @return Value of the flag
+	*/
+COSIM_SYNC_API int cosim_get_flag(CosimulationData *cosim, volatile int *flag);
+
+/*
+	* Assign the ID of a new FFD instance
+	*
+	* The IDs start again from 0 once all instances have been released.
+	*
+	* @return ID of the instance
+	*/
+COSIM_SYNC_API int cosim_acquire_id(void);
+
+/*
+	* Release the ID of an FFD instance that has been stopped
+	*
+	* @return No return needed
+	*/
+COSIM_SYNC_API void cosim_release_id(void);
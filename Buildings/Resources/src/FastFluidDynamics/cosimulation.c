@@ -194,7 +194,9 @@ int read_cosim_parameter(PARA_DATA *para, REAL **var, int **BINDEX) {
   /****************************************************************************
   | Get the start time of co-simulation
   ****************************************************************************/
+  cosim_lock(para->cosim);
   para->mytime->t = para->cosim->modelica->t;
+  cosim_unlock(para->cosim);
   sprintf(msg, "read_cosim_parameter(): Simulation starts at %fs",
           para->mytime->t);
   ffd_log(msg, FFD_NORMAL);
@@ -234,23 +236,25 @@ int read_cosim_data(PARA_DATA *para, REAL **var, int **BINDEX) {
   /****************************************************************************
   | Wait for data to be updated by the other program
   ****************************************************************************/
-  while(para->cosim->modelica->flag==0) {
-    if(para->outp->version==DEBUG) {
-      sprintf(msg,
-              "read_cosim_data(): Data is not ready with "
-              "para->cosim->modelica->flag=%d",
-              para->cosim->modelica->flag);
-      ffd_log(msg, FFD_NORMAL);
-    }
-		/*return when detecting stop command*/
-		if (para->cosim->para->flag==0){
-				return 0;
-		}		
-		
-    Sleep(10);
-    if(para->outp->version==DEBUG)
-      ffd_log("read_cosim_data(): Sleep for 0.01s.", FFD_NORMAL);
+  cosim_lock(para->cosim);
+  if(para->outp->version==DEBUG) {
+    sprintf(msg,
+            "read_cosim_data(): Wait for data with "
+            "para->cosim->modelica->flag=%d",
+            para->cosim->modelica->flag);
+    ffd_log(msg, FFD_NORMAL);
   }
+  /* Modelica wakes up this thread when it writes new data or the stop
+     command. The time out only bounds a single wait.*/
+  while(para->cosim->modelica->flag==0 && para->cosim->para->flag!=0)
+    cosim_wait(para->cosim, 1000);
+
+  /*return when detecting stop command*/
+  if(para->cosim->modelica->flag==0) {
+    cosim_unlock(para->cosim);
+    return 0;
+  }
+  cosim_unlock(para->cosim);
 
   if(para->outp->version==DEBUG) {
     ffd_log("read_cosim_data(): Modelica data is ready.", FFD_NORMAL);
@@ -307,8 +311,7 @@ int read_cosim_data(PARA_DATA *para, REAL **var, int **BINDEX) {
   | Post-Process after reading the data
   ****************************************************************************/
   /* Change the flag to indicate that the data has been read*/
-  para->cosim->modelica->flag = 0;
-  /*printf("para->cosim->modelica->flag=%d\n", para->cosim->modelica->flag);*/
+  cosim_set_flag(para->cosim, &para->cosim->modelica->flag, 0);
   if(para->outp->version==DEBUG) {
     ffd_log("read_cosim_data(): Ended reading data from Modelica.",
             FFD_NORMAL);
@@ -320,6 +323,9 @@ int read_cosim_data(PARA_DATA *para, REAL **var, int **BINDEX) {
 	/*
 		* Write the FFD data for Modelica
 		*
+		* The data is written in the back buffer, which is then swapped with
+		* the buffer that is read by Modelica.
+		*
 		* @param para Pointer to FFD parameters
 		* @param var Pointer to FFD simulation variables
 		*
@@ -327,6 +333,7 @@ int read_cosim_data(PARA_DATA *para, REAL **var, int **BINDEX) {
 		*/
 int write_cosim_data(PARA_DATA *para, REAL **var) {
   int i, j, id;
+  ffdSharedData *ffd = para->cosim->ffdBack;
 
   ffd_log("-------------------------------------------------------------------",
           FFD_NORMAL);
@@ -337,31 +344,22 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
   }
 
   /****************************************************************************
-  | Wait if the previous data has not been read by Modelica
+  | Start to write new data in the back buffer, which is not read by Modelica
   ****************************************************************************/
-  while(para->cosim->ffd->flag==1) {
-    ffd_log("write_cosim_data(): Wait since previous data is not taken "
-            "by Modelica", FFD_NORMAL);
-    Sleep(10);
-  }
-
-  /****************************************************************************
-  | Start to write new data
-  ****************************************************************************/
-  para->cosim->ffd->t = para->mytime->t;
+  ffd->t = para->mytime->t;
 
   sprintf(msg, "write_cosim_data(): Start to write FFD data to Modelica "
                "at t=%f[s]",
-          para->cosim->ffd->t);
+          ffd->t);
   ffd_log(msg, FFD_NORMAL);
 
   /****************************************************************************
   | Set the time and space averaged temperature of space
   | Convert T from degC to K
   ****************************************************************************/
-  para->cosim->ffd->TRoo = average_volume(para, var, var[TEMPM]);
-  sprintf(msg, "\tAveraged room temperature %f[degC]", para->cosim->ffd->TRoo);
-  para->cosim->ffd->TRoo += 273.15;
+  ffd->TRoo = average_volume(para, var, var[TEMPM]);
+  sprintf(msg, "\tAveraged room temperature %f[degC]", ffd->TRoo);
+  ffd->TRoo += 273.15;
   ffd_log(msg, FFD_NORMAL);
 
   /****************************************************************************
@@ -371,9 +369,9 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
     ffd_log("\tTemperature of the shade:", FFD_NORMAL);
     for(i=0; i<para->cosim->para->nConExtWin; i++) {
       /*Note: The shade feature is to be implemented*/
-      para->cosim->ffd->TSha[i] = 20 + 273.15;
+      ffd->TSha[i] = 20 + 273.15;
       sprintf(msg, "\t\tSurface %d: %f[K]\n",
-              i, para->cosim->ffd->TSha[i]);
+              i, ffd->TSha[i]);
       ffd_log(msg, FFD_NORMAL);
     }
   }
@@ -388,11 +386,11 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
     /*-------------------------------------------------------------------------
     | Assign the temperature
     -------------------------------------------------------------------------*/
-    para->cosim->ffd->TPor[id] = para->bc->TPortMean[i]/para->bc->APort[i]
-                                 + 273.15;
+    ffd->TPor[id] = para->bc->TPortMean[i]/para->bc->APort[i]
+                    + 273.15;
     sprintf(msg, "\t\t%s: TPor[%d]=%f",
             para->cosim->para->portName[id], i,
-            para->cosim->ffd->TPor[id]);
+            ffd->TPor[id]);
     ffd_log(msg, FFD_NORMAL);
     /*-------------------------------------------------------------------------
     | Assign the Xi
@@ -404,12 +402,12 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
 
     for(j=0; j<para->bc->nb_Xi; j++) {
       para->bc->velPortMean[i] = fabs(para->bc->velPortMean[i]) + SMALL;
-      para->cosim->ffd->XiPor[id][j] = para->bc->XiPortMean[i][j]
-                                      / para->bc->velPortMean[i];
+      ffd->XiPor[id][j] = para->bc->XiPortMean[i][j]
+                          / para->bc->velPortMean[i];
 
       sprintf(msg, "\t\t%s: Xi[%d]=%f",
               para->cosim->para->portName[id], j,
-              para->cosim->ffd->XiPor[id][j]);
+              ffd->XiPor[id][j]);
       ffd_log(msg, FFD_NORMAL);
     }
     /*-------------------------------------------------------------------------
@@ -417,11 +415,11 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
     -------------------------------------------------------------------------*/
     for(j=0; j<para->bc->nb_C; j++) {
       para->bc->velPortMean[i] = fabs(para->bc->velPortMean[i]) + SMALL;
-      para->cosim->ffd->CPor[id][j] = para->bc->CPortMean[i][j]
-                                    / para->bc->velPortMean[i];
+      ffd->CPor[id][j] = para->bc->CPortMean[i][j]
+                         / para->bc->velPortMean[i];
       sprintf(msg, "\t\t%s: C[%d]=%f",
               para->cosim->para->portName[id], j,
-              para->cosim->ffd->CPor[id][j]);
+              ffd->CPor[id][j]);
       ffd_log(msg, FFD_NORMAL);
     }
   }
@@ -435,16 +433,16 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
 
     /* Set the B.C. Temperature*/
     if(para->cosim->para->bouCon[id]==2) {
-      para->cosim->ffd->temHea[id] = para->bc->temHeaMean[i]
-                                  / para->bc->AWall[i] + 273.15;
+      ffd->temHea[id] = para->bc->temHeaMean[i]
+                        / para->bc->AWall[i] + 273.15;
       sprintf(msg, "\t\t%s: %f[K]",
-              para->cosim->para->name[id], para->cosim->ffd->temHea[id]);
+              para->cosim->para->name[id], ffd->temHea[id]);
     }
     /* Set the heat flux*/
     else {
-      para->cosim->ffd->temHea[id] = para->bc->temHeaMean[i];
+      ffd->temHea[id] = para->bc->temHeaMean[i];
       sprintf(msg, "\t\t%s: %f[W]",
-              para->cosim->para->name[id], para->cosim->ffd->temHea[id]);
+              para->cosim->para->name[id], ffd->temHea[id]);
     }
     ffd_log(msg, FFD_NORMAL);
   }
@@ -460,16 +458,34 @@ int write_cosim_data(PARA_DATA *para, REAL **var) {
     ffd_log("\tSensor Information:", FFD_NORMAL);
 
   for(i=0; i<para->cosim->para->nSen; i++) {
-    para->cosim->ffd->senVal[i] = para->sens->senVal[i];
+    ffd->senVal[i] = para->sens->senVal[i];
     sprintf(msg, "\t\t%s: %f",
-            para->cosim->para->sensorName[i], para->cosim->ffd->senVal[i]);
+            para->cosim->para->sensorName[i], ffd->senVal[i]);
     ffd_log(msg, FFD_NORMAL);
   }
 
   /****************************************************************************
-  | Inform Modelica that the FFD data is updated
+  | Wait if the previous data has not been read by Modelica
   ****************************************************************************/
-  para->cosim->ffd->flag = 1;
+  cosim_lock(para->cosim);
+  if(para->cosim->ffd->flag==1)
+    ffd_log("write_cosim_data(): Wait since previous data is not taken "
+            "by Modelica", FFD_NORMAL);
+  while(para->cosim->ffd->flag==1 && para->cosim->para->flag!=0)
+    cosim_wait(para->cosim, 1000);
+
+  /****************************************************************************
+  | Inform Modelica that the FFD data is updated by swapping the buffers.
+  | The data is not published if Modelica stopped before taking the previous
+  | data.
+  ****************************************************************************/
+  if(para->cosim->ffd->flag==0) {
+    para->cosim->ffdBack = para->cosim->ffd;
+    para->cosim->ffd = ffd;
+    para->cosim->ffd->flag = 1;
+    cosim_notify(para->cosim);
+  }
+  cosim_unlock(para->cosim);
 
   return 0;
 } /* End of write_cosim_data()*/
@@ -822,9 +838,11 @@ int assign_port_bc(PARA_DATA *para, REAL **var, int **BINDEX) {
         var[FLAGP][IX(i,j,k)] = INLET;
         var[TEMPBC][IX(i,j,k)] = para->bc->TPort[id];
         for(Xid=0; Xid<para->cosim->para->nXi; Xid++)
-          var[Xi1BC+Xid][IX(i,j,k)] = para->bc->XiPort[id][Xid];
+          var[XI_VAR(para, Xid, SPECIES_BC)][IX(i,j,k)]
+            = para->bc->XiPort[id][Xid];
         for(Cid=0; Cid<para->cosim->para->nC; Cid++)
-          var[C1BC+Cid][IX(i,j,k)] = para->bc->CPort[id][Cid];
+          var[C_VAR(para, Cid, SPECIES_BC)][IX(i,j,k)]
+            = para->bc->CPort[id][Cid];
 
 
         if(i==0)
@@ -855,13 +873,16 @@ int assign_port_bc(PARA_DATA *para, REAL **var, int **BINDEX) {
 		* Integrate the coupled simulation exchange data over the surfaces
 		*
 		* Fluid port:
-		*   - T/Xi/C: sum(u*T*dA)
+		*   - T/Xi/C: sum(T*dA)
 		*   - m_dot:  sum(u*dA)
 		*
 		* Solid Surface Boundary:
 		*   - T:      sum(T*dA)
 		*   - Q_dot:  sum(q_dot*dA)
 		*
+		* The cells and their areas are taken from the face lists built by
+		* build_face_list().
+		*
 		* @param para Pointer to FFD parameters
 		* @param var Pointer to FFD simulation variables
 		* @param BINDEX Pointer to the boundary index
@@ -869,11 +890,9 @@ int assign_port_bc(PARA_DATA *para, REAL **var, int **BINDEX) {
 		* @return 0 if no error occurred
 		*/
 int surface_integrate(PARA_DATA *para, REAL **var, int **BINDEX) {
-  int imax = para->geom->imax, jmax = para->geom->jmax;
-  int kmax = para->geom->kmax;
-  int i, j, k, it, bcid;
-  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  REAL vel_tmp, A_tmp;
+  int c, n, it, bcid, cell;
+  REAL A_tmp;
+  FACE_LIST *wall = para->geom->wall_face, *port = para->geom->port_face;
 
   /****************************************************************************
   | Set the variable to 0
@@ -882,16 +901,16 @@ int surface_integrate(PARA_DATA *para, REAL **var, int **BINDEX) {
     ffd_log("surface_integrate(): Start to set the variable to 0",
             FFD_NORMAL);
 
-  for(i=0; i<para->bc->nb_wall; i++)
-    para->bc->temHeaAve[i] = 0;
+  for(c=0; c<para->bc->nb_wall; c++)
+    para->bc->temHeaAve[c] = 0;
 
-  for(i=0; i<para->bc->nb_port; i++) {
-    para->bc->TPortAve[i] = 0;
-    para->bc->velPortAve[i] = 0;
-    for(j=0; j<para->bc->nb_Xi; j++)
-      para->bc->XiPortAve[i][j] = 0;
-    for(j=0; j<para->bc->nb_C; j++)
-      para->bc->CPortAve[i][j] = 0;
+  for(c=0; c<para->bc->nb_port; c++) {
+    para->bc->TPortAve[c] = 0;
+    para->bc->velPortAve[c] = 0;
+    for(n=0; n<para->bc->nb_Xi; n++)
+      para->bc->XiPortAve[c][n] = 0;
+    for(n=0; n<para->bc->nb_C; n++)
+      para->bc->CPortAve[c][n] = 0;
   }
 
   /****************************************************************************
@@ -900,97 +919,90 @@ int surface_integrate(PARA_DATA *para, REAL **var, int **BINDEX) {
   if(para->outp->version==DEBUG)
     ffd_log("surface_integrate(): Start to sum all the cells", FFD_NORMAL);
 
-  for(it=0; it<para->geom->index; it++) {
-    i = BINDEX[0][it];
-    j = BINDEX[1][it];
-    k = BINDEX[2][it];
-    bcid = BINDEX[4][it];
-
-    if(i==0 || i==imax+1) {
-      vel_tmp = var[VX][IX(i,j,k)];
-      A_tmp = area_yz(para, var, i, j, k);
-    }
-    else if(j==0 || j==jmax+1) {
-      vel_tmp = var[VY][IX(i,j,k)];
-      A_tmp = area_zx(para, var, i, j, k);
-    }
-    else if(k==0 || k==kmax+1) {
-      vel_tmp = var[VZ][IX(i,j,k)];
-      A_tmp = area_xy(para, var, i, j, k);
+  /*---------------------------------------------------------------------------
+  | Set the thermal conditions data for Modelica.
+  | In FFD simulation, the BINDEX[3][it] indicates: 1->T, 0->Heat Flux.
+  | Those BINDEX[3][it] will be reset according to the Modelica data
+  | para->comsim->para->bouCon (1->Heat Flux, 2->T).
+  | Here is to give the Modelica the missing data (For instance, if Modelica
+  | send FFD Temperature, FFD should then send Modelica Heat Flux).
+  ---------------------------------------------------------------------------*/
+  /*---------------------------------------------------------------------------
+  | Solid Wall
+  ---------------------------------------------------------------------------*/
+  for(c=0; c<wall->nb_cell; c++) {
+    it = wall->it[c];
+    cell = wall->cell[c];
+    bcid = wall->id[c];
+    A_tmp = wall->sur_area[c];
+
+    switch(BINDEX[3][it]) {
+      /* FFD uses heat flux as BC to compute temperature*/
+      /* Then send Modelica the temperature*/
+      case 0:
+        para->bc->temHeaAve[bcid] += var[TEMP][cell] * A_tmp;
+        break;
+      /* FFD uses temperature as BC to compute heat flux*/
+      /* Then send Modelica the heat flux*/
+      case 1:
+        para->bc->temHeaAve[bcid] += var[QFLUX][cell] * A_tmp;
+        break;
+      default:
+        sprintf(msg, "average_bc_area(): Thermal boundary (%d)"
+               "for cell (%d,%d,%d) was not defined",
+               BINDEX[3][it], BINDEX[0][it], BINDEX[1][it], BINDEX[2][it]);
+        ffd_log(msg, FFD_ERROR);
+        return 1;
     }
+  }
+
+  for(c=0; c<port->nb_cell; c++) {
+    it = port->it[c];
+    cell = port->cell[c];
+    bcid = port->id[c];
+    A_tmp = port->sur_area[c];
 
-    /*-------------------------------------------------------------------------
-    | Set the thermal conditions data for Modelica.
-    | In FFD simulation, the BINDEX[3][it] indicates: 1->T, 0->Heat Flux.
-    | Those BINDEX[3][it] will be reset according to the Modelica data
-    | para->comsim->para->bouCon (1->Heat Flux, 2->T).
-    | Here is to give the Modelica the missing data (For instance, if Modelica
-    | send FFD Temperature, FFD should then send Modelica Heat Flux).
-    -------------------------------------------------------------------------*/
-    /*-------------------------------------------------------------------------
-    | Solid Wall
-    --------------------------------------------------------------------------*/
-    if(var[FLAGP][IX(i,j,k)]==SOLID) {
-      switch(BINDEX[3][it]) {
-        /* FFD uses heat flux as BC to compute temperature*/
-        /* Then send Modelica the temperature*/
-        case 0:
-          para->bc->temHeaAve[bcid] += var[TEMP][IX(i,j,k)] * A_tmp;
-          break;
-        /* FFD uses temperature as BC to compute heat flux*/
-        /* Then send Modelica the heat flux*/
-        case 1:
-          para->bc->temHeaAve[bcid] += var[QFLUX][IX(i,j,k)] * A_tmp;
-          /*sprintf(msg, "Cell(%d,%d,%d):\tQFLUX=%f,\tA=%f", i,j,k,var[QFLUX][IX(i,j,k)], A_tmp);*/
-          /*ffd_log(msg, FFD_NORMAL);*/
-          break;
-        default:
-          sprintf(msg, "average_bc_area(): Thermal boundary (%d)"
-                 "for cell (%d,%d,%d) was not defined",
-                 BINDEX[3][it], i, j, k);
-          ffd_log(msg, FFD_ERROR);
-          return 1;
-      }
-    }
     /*-------------------------------------------------------------------------
     | Outlet
     -------------------------------------------------------------------------*/
-    else if(var[FLAGP][IX(i,j,k)]==OUTLET) {
+    if(var[FLAGP][cell]==OUTLET) {
       if(para->outp->version==DEBUG) {
         sprintf(msg, "surface_integrate(): Set the outlet[%d, %d, %d]",
-                i, j, k);
+                BINDEX[0][it], BINDEX[1][it], BINDEX[2][it]);
         ffd_log(msg, FFD_NORMAL);
       }
 
-      para->bc->TPortAve[bcid] += var[TEMP][IX(i,j,k)] * A_tmp;
-      para->bc->velPortAve[bcid] += vel_tmp * A_tmp;
-      for(j=0; j<para->bc->nb_Xi; j++)
-        para->bc->XiPortAve[bcid][j] += var[Xi1+j][IX(i,j,k)] * A_tmp;
+      para->bc->TPortAve[bcid] += var[TEMP][cell] * A_tmp;
+      para->bc->velPortAve[bcid]
+        += var[port->sur_var[c]][port->sur_cell[c]] * A_tmp;
+      for(n=0; n<para->bc->nb_Xi; n++)
+        para->bc->XiPortAve[bcid][n]
+          += var[XI_VAR(para, n, SPECIES_VALUE)][cell] * A_tmp;
 
-      for(j=0; j<para->bc->nb_C; j++)
-        para->bc->CPortAve[bcid][j] += var[C1+j][IX(i,j,k)] * A_tmp;
+      for(n=0; n<para->bc->nb_C; n++)
+        para->bc->CPortAve[bcid][n]
+          += var[C_VAR(para, n, SPECIES_VALUE)][cell] * A_tmp;
 
     }
     /*-------------------------------------------------------------------------
     | Inlet
     -------------------------------------------------------------------------*/
-    else if(var[FLAGP][IX(i,j,k)]==INLET) {
+    else if(var[FLAGP][cell]==INLET) {
       if(para->outp->version==DEBUG) {
         sprintf(msg, "surface_integrate(): Set 0 for inlet [%d,%d,%d].",
-                i, j, k);
+                BINDEX[0][it], BINDEX[1][it], BINDEX[2][it]);
         ffd_log(msg, FFD_NORMAL);
       }
 
       para->bc->TPortAve[bcid] = 0;
       para->bc->velPortAve[bcid] = 0;
-      for(j=0; j<para->bc->nb_Xi; j++)
-        para->bc->XiPortAve[bcid][j] = 0;
+      for(n=0; n<para->bc->nb_Xi; n++)
+        para->bc->XiPortAve[bcid][n] = 0;
 
-      for(j=0; j<para->bc->nb_C; j++)
-        para->bc->CPortAve[bcid][j] = 0;
+      for(n=0; n<para->bc->nb_C; n++)
+        para->bc->CPortAve[bcid][n] = 0;
     }
-
-  } /* End of for(it=0; it<para->geom->index; it++)*/
+  } /* End of for(c=0; c<port->nb_cell; c++)*/
 
   return 0;
 } /* End of surface_integrate()*/
@@ -1012,7 +1024,7 @@ int set_sensor_data(PARA_DATA *para, REAL **var) {
        w = var[VZ][IX(imax/2,jmax/2,kmax/2)];
 
   /* Averaged room temperature*/
-  para->sens->senVal[0] = para->cosim->ffd->TRoo;
+  para->sens->senVal[0] = para->cosim->ffdBack->TRoo;
 
   /*Velocity at the center of the space*/
   para->sens->senVal[1] = sqrt(u*u + v*v + w*w);
@@ -33,12 +33,11 @@
 #include "geometry.h"
 #endif
 
-#ifndef _MSC_VER /*Linux*/
-/* Use usleep (microseconds) to avoid integer division truncation.
- * The original sleep(x/1000) truncates to sleep(0) for x < 1000,
- * turning the polling loop into a busy-wait. */
-#define Sleep(x) usleep((unsigned int)((x) * 1000U))
+#ifndef _COSIM_SYNC_H
+#define _COSIM_SYNC_H
+#include "cosim_sync.h"
 #endif
+
 /*
 	* Read the coupled simulation parameters defined by Modelica
 	*
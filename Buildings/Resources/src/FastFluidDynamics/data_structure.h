@@ -34,6 +34,18 @@
 #include "modelica_ffd_common.h"
 #endif
 
+/*-----------------------------------------------------------------------------
+Thread local storage
+Each FFD instance runs in its own thread. The variables that are shared by
+the functions of one instance, such as the message buffer, are thus
+allocated once per thread.
+-----------------------------------------------------------------------------*/
+#ifdef _MSC_VER
+#define FFD_THREAD_LOCAL __declspec(thread)
+#else
+#define FFD_THREAD_LOCAL __thread
+#endif
+
 /*-----------------------------------------------------------------------------
 Problem with windows version
 The stdlib.h which ships with the recent versions of Visual Studio has a
@@ -50,12 +62,14 @@ Place the stdlib.h line above the glut.h line in the code.
 /*#include <GL/glut.h>*/
 /*#endif*/
 
+/* i has the stride 1 in IX(i,j,k). Thus, the loops over the cells run in the
+   order k-j-i to access the memory contiguously.*/
 #define IX(i,j,k) ((i)+(IMAX)*(j)+(IJMAX)*(k))
-#define FOR_EACH_CELL for(i=1; i<=imax; i++) { for(j=1; j<=jmax; j++) { for(k=1; k<=kmax; k++) {
+#define FOR_EACH_CELL for(k=1; k<=kmax; k++) { for(j=1; j<=jmax; j++) { for(i=1; i<=imax; i++) {
 #define FOR_ALL_CELL for(k=0; k<=kmax+1; k++) { for(j=0; j<=jmax+1; j++) { for(i=0; i<=imax+1; i++) {
 #define FOR_U_CELL for(k=1; k<=kmax; k++) { for(j=1; j<=jmax; j++) { for(i=1; i<=imax-1; i++) {
-#define FOR_V_CELL for(i=1; i<=imax; i++) { for(j=1; j<=jmax-1; j++) { for(k=1; k<=kmax; k++) {
-#define FOR_W_CELL for(i=1; i<=imax; i++) { for(j=1; j<=jmax; j++) { for(k=1; k<=kmax-1; k++) {
+#define FOR_V_CELL for(k=1; k<=kmax; k++) { for(j=1; j<=jmax-1; j++) { for(i=1; i<=imax; i++) {
+#define FOR_W_CELL for(k=1; k<=kmax-1; k++) { for(j=1; j<=jmax; j++) { for(i=1; i<=imax; i++) {
 
 #define FOR_KI for(i=1; i<=imax; i++) { for(k=1; k<=kmax; k++) {{
 #define FOR_IJ for(i=1; i<=imax; i++) { for(j=1; j<=jmax; j++) {{
@@ -64,6 +78,9 @@ Place the stdlib.h line above the glut.h line in the code.
 
 #define SMALL 0.00001
 
+/* Alignment in bytes of the memory of the variables (one cache line)*/
+#define FFD_ALIGNMENT 64
+
 #ifndef max
 	#define max( a, b ) ( ((a) > (b)) ? (a) : (b) )
 #endif
@@ -125,7 +142,25 @@ Place the stdlib.h line above the glut.h line in the code.
 #define C1S 52
 #define C2S 53
 #define C1BC 54
-#define C2BC 55  /* Last variable*/
+#define C2BC 55
+#define DIST 56 /* Distance to the nearest wall for Chen's model*/
+#define NUT  57 /* Turbulent viscosity of Chen's model*/
+#define LAST_VAR NUT /* Last variable*/
+
+/* Species and trace substances beyond Xi2 and C2 are stored after LAST_VAR.
+   Each of them has three variables: value, source and boundary value.*/
+#define SPECIES_VALUE 0
+#define SPECIES_SOURCE 1
+#define SPECIES_BC 2
+#define NB_EXTRA(n) ((n)>2 ? (n)-2 : 0)
+/* Index of variable t of species n in var*/
+#define XI_VAR(para, n, t) ((n)<2 ? Xi1+2*(t)+(n) : LAST_VAR+1+3*((n)-2)+(t))
+/* Index of variable t of trace substance n in var*/
+#define C_VAR(para, n, t) ((n)<2 ? C1+2*(t)+(n) \
+  : LAST_VAR+1+3*(NB_EXTRA((para)->bc->nb_Xi)+(n)-2)+(t))
+/* Number of variables in var*/
+#define NB_VAR(para) (LAST_VAR+1 \
+  + 3*(NB_EXTRA((para)->bc->nb_Xi)+NB_EXTRA((para)->bc->nb_C)))
 
 typedef enum{NOSLIP, SLIP, INFLOW, OUTFLOW, PERIODIC, SYMMETRY} BCTYPE;
 
@@ -136,7 +171,22 @@ typedef enum{NOSLIP, SLIP, INFLOW, OUTFLOW, PERIODIC, SYMMETRY} BCTYPE;
 
 typedef enum{TCONST, QCONST, ADIBATIC} BCTTYPE;
 
-typedef enum{GS, TDMA} SOLVERTYPE;
+typedef enum{GS, TDMA, RBGS, MG, PCG} SOLVERTYPE;
+
+#define NB_SOLVER 5 /* Number of solver types*/
+
+/* Phases of the solver whose wall time is measured*/
+typedef enum{PHASE_SOLVER, PHASE_VEL, PHASE_TEMP, PHASE_DEN, PHASE_PROJECT,
+             PHASE_ADVECT, PHASE_DIFFUSE, PHASE_BOUNDARY, PHASE_EQUATION,
+             NB_PHASE} PHASE;
+
+/* Equations with an own iteration budget of the GS and RBGS solvers*/
+typedef enum{EQU_PRESSURE, EQU_VELOCITY, EQU_TEMPERATURE, EQU_SPECIES,
+             NB_EQU} EQUATION;
+
+typedef enum{V_CYCLE, W_CYCLE} MG_CYCLE;
+
+typedef enum{JACOBI, IC} PRECONDITIONER;
 
 typedef enum{SEMI, LAX, UPWIND, UPWIND_NEW} ADVECTION;
 
@@ -146,12 +196,60 @@ typedef enum{BILINEAR, FSJ, HYBRID} INTERPOLATION;
 
 typedef enum{DEMO, DEBUG, RUN} VERSION;
 
-typedef enum{FFD, SCI, TECPLOT} FILE_FORMAT;
+typedef enum{FFD, SCI, TECPLOT, BINARY, VTK} FILE_FORMAT;
 
 typedef enum{FFD_WARNING, FFD_ERROR, FFD_NORMAL, FFD_NEW} FFD_MSG_TYPE;
 
+/* Minimum level of the logged messages*/
+typedef enum{LOG_NORMAL, LOG_WARNING, LOG_ERROR} LOG_LEVEL;
+
+/* Maximum length of the name of a log file*/
+#define FFD_LOG_NAME_LENGTH 400
+
 typedef enum{XY, YZ, ZX} PLANETYPE;
 
+/* Metrics of the mesh. The mesh is a tensor product, so the metrics of a
+   cell (i,j,k) are given by the metrics of i in X, j in Y and k in Z.*/
+typedef struct {
+  REAL *dx; /* dx[i]: Width of cell i, gx[i]-gx[i-1], 0 for i=0*/
+  REAL *dy; /* dy[j]: Width of cell j, gy[j]-gy[j-1], 0 for j=0*/
+  REAL *dz; /* dz[k]: Width of cell k, gz[k]-gz[k-1], 0 for k=0*/
+  REAL *rdx; /* rdx[i]: 1/dx[i], 0 for zero width*/
+  REAL *rdy; /* rdy[j]: 1/dy[j], 0 for zero width*/
+  REAL *rdz; /* rdz[k]: 1/dz[k], 0 for zero width*/
+  REAL *dxc; /* dxc[i]: Distance of the centers, x[i+1]-x[i]*/
+  REAL *dyc; /* dyc[j]: Distance of the centers, y[j+1]-y[j]*/
+  REAL *dzc; /* dzc[k]: Distance of the centers, z[k+1]-z[k]*/
+  REAL *rdxc; /* rdxc[i]: 1/dxc[i]*/
+  REAL *rdyc; /* rdyc[j]: 1/dyc[j]*/
+  REAL *rdzc; /* rdzc[k]: 1/dzc[k]*/
+} METRIC_DATA;
+
+/* Direction from a boundary cell to its neighbor: +x, -x, +y, -y, +z, -z.
+   The axis of the direction d is d/2.*/
+typedef enum{EAST, WEST, NORTH, SOUTH, CEILING, FLOOR} DIRECTION;
+
+/* Boundary cells and their faces to the neighbor cells, built once by
+   build_face_list(). The cells are in the order of BINDEX. A solid cell has
+   a face to each fluid neighbor. The other boundary cells have a face to the
+   neighbor inside the domain.*/
+typedef struct {
+  int nb_cell; /* Number of cells*/
+  int nb_face; /* Number of faces*/
+  int *cell; /* cell[c]: Index IX of cell c*/
+  int *it; /* it[c]: Index of cell c in BINDEX*/
+  int *id; /* id[c]: ID of the wall or port of cell c, BINDEX[4]*/
+  int *first; /* The faces of cell c are first[c] to first[c+1]-1*/
+  int *sur_cell; /* sur_cell[c]: Index IX of the velocity integrated for cell c*/
+  int *sur_var; /* sur_var[c]: Velocity VX, VY or VZ integrated for cell c*/
+  REAL *sur_area; /* sur_area[c]: Area integrated for cell c*/
+  int *nbr; /* nbr[f]: Index IX of the neighbor of face f*/
+  int *dir; /* dir[f]: DIRECTION from the cell to the neighbor of face f*/
+  REAL *area; /* area[f]: Area of face f*/
+  REAL *dist; /* dist[f]: Half width of the neighbor normal to face f*/
+  REAL *dist_z; /* dist_z[f]: Half width of the neighbor in z-direction*/
+} FACE_LIST;
+
 /* Parameter for geometry and mesh*/
 typedef struct {
   REAL  Lx; /* Domain size in x-direction (meter)*/
@@ -168,6 +266,9 @@ typedef struct {
   REAL  dz; /* Length delta_z of one cell in z-direction for uniform grid only*/
   REAL  volFlu; /* Total volume of fluid cells*/
   int   uniform; /* Only for generating grid by FFD. 1: uniform grid; 0: non-uniform grid*/
+  METRIC_DATA *metric; /* Internal: metrics of the mesh, NULL before build_metric()*/
+  FACE_LIST *wall_face; /* Internal: solid boundary cells, NULL before build_face_list()*/
+  FACE_LIST *port_face; /* Internal: other boundary cells, NULL before build_face_list()*/
 } GEOM_DATA;
 
 /* Parameter for the data output control*/
@@ -194,14 +295,25 @@ typedef struct{
   VERSION version; /* DEMO, DEBUG, RUN*/
   int screen; /* Screen for display: 1 velocity; 2: temperature; 3: contaminant*/
   int tstep_display; /* Number of time steps to update the visualization*/
+  LOG_LEVEL log_level; /* LOG_NORMAL, LOG_WARNING or LOG_ERROR*/
+  int log_step; /* Number of time steps to log the time step information*/
+  int checkpoint; /* 1: Write a binary checkpoint at the end; 0: False*/
+  FILE_FORMAT transient_format; /* Format of the transient output: VTK*/
+  int transient_step; /* Number of time steps between transient outputs; 0: No output*/
+  void *vtk; /* Internal: writer of the transient VTK files*/
+  int profile; /* 1: Write the wall time of the solver phases at the end; 0: False*/
 } OUTP_DATA;
 
 typedef struct{
   FILE_FORMAT parameter_file_format; /* Format of extra parameter file*/
   char parameter_file_name[1024]; /* Name of extra parameter file*/
   char block_file_name[1024]; /* Name of file stores block information*/
+  int sci_cache; /* 1: Read and write the binary cache of the SCI geometry; 0: False*/
   int read_old_ffd_file; /* 1: Read previous FFD file; 0: False*/
   char old_ffd_file_name[100]; /* Name of previous FFD simulation data file*/
+  FILE_FORMAT old_ffd_file_format; /* FFD: Text file; BINARY: Checkpoint file*/
+  char ffd_file_name[400]; /* Name of the FFD parameter file of a single simulation*/
+  char ffd_file_path[400]; /* Internal: directory of ffd_file_name*/
 } INPU_DATA;
 
 typedef struct{
@@ -288,10 +400,42 @@ typedef struct {
   int step_mean; /* Internal: steps for time average*/
   double t_start; /* Internal: clock time when simulation starts*/
   double t_end; /* Internal: clock time when simulation ends*/
+  int adaptive; /* 1: Adapt the time step size; 0: Use the constant dt*/
+  REAL cfl; /* Maximum CFL number of the adaptive time step*/
+  REAL dT_step; /* Maximum temperature change per adaptive time step; 0: No limit*/
+  double dt_min; /* Minimum size of the adaptive time step*/
+  double dt_max; /* Maximum size of the adaptive time step; 0: 10 times dt*/
+  double dt_next; /* Internal: adaptive step size before aligning it to the synchronization*/
+  double dt_smallest; /* Internal: smallest time step size used*/
+  double dt_largest; /* Internal: largest time step size used*/
+  REAL *T_old; /* Internal: temperature at the beginning of the last time step*/
+  double phase_time[NB_PHASE]; /* Internal: wall time spent in the phases*/
+  double phase_begin[NB_PHASE]; /* Internal: wall clock time when the phases started*/
+  long phase_calls[NB_PHASE]; /* Internal: number of times the phases ran*/
+  long solver_calls[NB_SOLVER]; /* Internal: number of calls of the solvers*/
+  long solver_it[NB_SOLVER]; /* Internal: number of iterations of the solvers*/
+  long equ_calls[NB_EQU]; /* Internal: number of GS and RBGS calls of the equations*/
+  long equ_it[NB_EQU]; /* Internal: number of GS iterations of the equations*/
+  int equ_it_most[NB_EQU]; /* Internal: largest number of GS iterations in one call*/
+  long equ_missed[NB_EQU]; /* Internal: number of calls that did not reach gs_tol*/
 }TIME_DATA;
 
 typedef struct {
-  SOLVERTYPE solver;  /* Solver type: GS, TDMA*/
+  SOLVERTYPE solver;  /* Solver type: GS, TDMA, RBGS, MG, PCG*/
+  int nb_thread; /* Number of threads used by the RBGS solver*/
+  MG_CYCLE mg_cycle; /* Cycle of the MG solver: V_CYCLE, W_CYCLE*/
+  PRECONDITIONER pcg_precond; /* Preconditioner of the PCG solver: JACOBI, IC*/
+  REAL p_tol; /* Reduction of the pressure residual at which MG and PCG stop*/
+  int p_it_max; /* Maximum number of MG cycles or PCG iterations for pressure*/
+  REAL tol; /* Reduction of the residual at which PCG stops for other equations*/
+  int it_max; /* Maximum number of PCG iterations for other equations*/
+  REAL gs_tol[NB_EQU]; /* Residual at which GS and RBGS stop; 0: do all gs_it_max iterations*/
+  int gs_it_max[NB_EQU]; /* Maximum number of GS iterations of the equations*/
+  int gs_check; /* Number of GS iterations between two checks of the residual*/
+  void *mg; /* Internal: grid hierarchy of the MG solver*/
+  void *pcg; /* Internal: work space of the PCG solver*/
+  void *team; /* Internal: team of solv.nb_thread threads, see thread_team.h*/
+  void *species; /* Internal: work space of the species transport*/
   int check_residual; /* 1: check, 0: donot check*/
   ADVECTION advection_solver; /* Type of advection solver: SEMI, LAX, UPWIND, UPWIND_NEW*/
   INTERPOLATION interpolation; /* Interpolation in semi-Lagrangian method: BILINEAR, FSJ, HYBRID*/
@@ -319,6 +463,24 @@ typedef struct {
   INIT_DATA *init;
 }PARA_DATA;
 
+typedef struct {
+  PARA_DATA para; /* FFD parameters pointing to the data below*/
+  GEOM_DATA geom;
+  INPU_DATA inpu;
+  OUTP_DATA outp;
+  PROB_DATA prob;
+  TIME_DATA mytime;
+  BC_DATA bc;
+  SOLV_DATA solv;
+  SENSOR_DATA sens;
+  INIT_DATA init;
+  REAL **var; /* FFD simulation variables*/
+  int **BINDEX; /* Boundary index*/
+  int id; /* ID of the instance. 0: first instance*/
+  char log_file_name[FFD_LOG_NAME_LENGTH]; /* Name of the log file of the instance*/
+  void *logger; /* Buffered log file of the instance, see logger.h*/
+}FFD_INSTANCE;
+
 typedef struct {
   double number0;
   double number1;
@@ -339,4 +501,5 @@ typedef struct {
   int feedback;
 }ReceivedCommand;
 
-extern char msg[1000];
+extern FFD_THREAD_LOCAL char msg[1000];
+extern FFD_THREAD_LOCAL FFD_INSTANCE *ffd_instance;
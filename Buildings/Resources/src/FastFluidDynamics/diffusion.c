@@ -122,16 +122,20 @@ int coef_diff(PARA_DATA *para, REAL **var, REAL *psi, REAL *psi0,
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
   REAL *aw = var[AW], *ae = var[AE], *as = var[AS], *an = var[AN];
   REAL *af = var[AF], *ab = var[AB], *ap = var[AP], *ap0 = var[AP0], *b = var[B];
-  REAL *x = var[X], *y = var[Y], *z = var[Z];
-  REAL *gx = var[GX], *gy = var[GY], *gz = var[GZ];
   REAL *pp = var[PP];
   REAL *Temp = var[TEMP];
-  REAL dxe, dxw, dyn, dys, dzf, dzb, Dx, Dy, Dz;
+  METRIC_DATA *m = para->geom->metric;
+  REAL Dx, Dy, Dz;
   REAL dt = para->mytime->dt, beta = para->prob->beta;
   REAL Temp_Buoyancy = para->prob->Temp_Buoyancy;
   REAL gravx = para->prob->gravx, gravy = para->prob->gravy,
        gravz = para->prob->gravz;
   REAL kapa;
+  REAL *nu_t = var[NUT];
+
+  /* Turbulent viscosity of Chen's model for all the cells*/
+  if(para->prob->tur_model==CHEN)
+    nu_t_chen_zero_equ_all(para, var);
 
   /* define kapa*/
   switch(var_type) {
@@ -145,25 +149,19 @@ int coef_diff(PARA_DATA *para, REAL **var, REAL *psi, REAL *psi0,
         kapa = (REAL) 101.0 * para->prob->nu;
 
       FOR_U_CELL
-        dxe = gx[IX(i+1,j  ,k)] - gx[IX(i  ,j,k)];
-        dxw = gx[IX(i  ,j  ,k)] - gx[IX(i-1,j,k)];
-        dyn =  y[IX(i  ,j+1,k)] -  y[IX(i  ,j,k)];
-        dys =  y[IX(i,j,k)] -      y[IX(i,j-1,k)];
-        dzf =  z[IX(i,j,k+1)] -    z[IX(i,j,k)];
-        dzb =  z[IX(i,j,k)] -      z[IX(i,j,k-1)];
-        Dx =   x[IX(i+1,j,k)] -    x[IX(i,j,k)];
-        Dy =  gy[IX(i,j,k)] -     gy[IX(i,j-1,k)];
-        Dz =  gz[IX(i,j,k)] -     gz[IX(i,j,k-1)];
+        Dx = m->dxc[i];
+        Dy = m->dy[j];
+        Dz = m->dz[k];
 
         if(para->prob->tur_model==CHEN)
-          kapa = nu_t_chen_zero_equ(para, var, i, j, k);
+          kapa = nu_t[IX(i,j,k)];
 
-        aw[IX(i,j,k)] = kapa*Dy*Dz/dxw;
-        ae[IX(i,j,k)] = kapa*Dy*Dz/dxe;
-        an[IX(i,j,k)] = kapa*Dx*Dz/dyn;
-        as[IX(i,j,k)] = kapa*Dx*Dz/dys;
-        af[IX(i,j,k)] = kapa*Dx*Dy/dzf;
-        ab[IX(i,j,k)] = kapa*Dx*Dy/dzb;
+        aw[IX(i,j,k)] = kapa*Dy*Dz*m->rdx[i];
+        ae[IX(i,j,k)] = kapa*Dy*Dz*m->rdx[i+1];
+        an[IX(i,j,k)] = kapa*Dx*Dz*m->rdyc[j];
+        as[IX(i,j,k)] = kapa*Dx*Dz*m->rdyc[j-1];
+        af[IX(i,j,k)] = kapa*Dx*Dy*m->rdzc[k];
+        ab[IX(i,j,k)] = kapa*Dx*Dy*m->rdzc[k-1];
         ap0[IX(i,j,k)] = Dx*Dy*Dz/dt;
         b[IX(i,j,k)] = psi0[IX(i,j,k)]*ap0[IX(i,j,k)]
                      - beta*gravx*(Temp[IX(i,j,k)]-Temp_Buoyancy)*Dx*Dy*Dz
@@ -187,25 +185,19 @@ int coef_diff(PARA_DATA *para, REAL **var, REAL *psi, REAL *psi0,
         kapa = (REAL) 101.0 * para->prob->nu;
 
       FOR_V_CELL
-        dxe = x[IX(i+1,j,k)] - x[IX(i,j,k)];
-        dxw = x[IX(i,j,k)] - x[IX(i-1,j,k)];
-        dyn = gy[IX(i,j+1,k)] - gy[IX(i,j,k)];
-        dys = gy[IX(i,j,k)] - gy[IX(i,j-1,k)];
-        dzf = z[IX(i,j,k+1)] - z[IX(i,j,k)];
-        dzb = z[IX(i,j,k)] - z[IX(i,j,k-1)];
-        Dx = gx[IX(i,j,k)] - gx[IX(i-1,j,k)];
-        Dy = y[IX(i,j+1,k)] - y[IX(i,j,k)];
-        Dz = gz[IX(i,j,k)] - gz[IX(i,j,k-1)];
+        Dx = m->dx[i];
+        Dy = m->dyc[j];
+        Dz = m->dz[k];
 
         if(para->prob->tur_model==CHEN)
-          kapa = nu_t_chen_zero_equ(para, var, i, j, k);
+          kapa = nu_t[IX(i,j,k)];
 
-        aw[IX(i,j,k)] = kapa*Dy*Dz/dxw;
-        ae[IX(i,j,k)] = kapa*Dy*Dz/dxe;
-        an[IX(i,j,k)] = kapa*Dx*Dz/dyn;
-        as[IX(i,j,k)] = kapa*Dx*Dz/dys;
-        af[IX(i,j,k)] = kapa*Dx*Dy/dzf;
-        ab[IX(i,j,k)] = kapa*Dx*Dy/dzb;
+        aw[IX(i,j,k)] = kapa*Dy*Dz*m->rdxc[i-1];
+        ae[IX(i,j,k)] = kapa*Dy*Dz*m->rdxc[i];
+        an[IX(i,j,k)] = kapa*Dx*Dz*m->rdy[j+1];
+        as[IX(i,j,k)] = kapa*Dx*Dz*m->rdy[j];
+        af[IX(i,j,k)] = kapa*Dx*Dy*m->rdzc[k];
+        ab[IX(i,j,k)] = kapa*Dx*Dy*m->rdzc[k-1];
         ap0[IX(i,j,k)] = Dx*Dy*Dz/dt;
         b[IX(i,j,k)] = psi0[IX(i,j,k)]*ap0[IX(i,j,k)]
                      - beta*gravy*(Temp[IX(i,j,k)]-Temp_Buoyancy)*Dx*Dy*Dz
@@ -229,25 +221,19 @@ int coef_diff(PARA_DATA *para, REAL **var, REAL *psi, REAL *psi0,
         kapa = (REAL) 101.0 * para->prob->nu;
 
       FOR_W_CELL
-        dxe = x[IX(i+1,j,k)] - x[IX(i,j,k)];
-        dxw = x[IX(i,j,k)] - x[IX(i-1,j,k)];
-        dyn = y[IX(i,j+1,k)] - y[IX(i,j,k)];
-        dys = y[IX(i,j,k)] - y[IX(i,j-1,k)];
-        dzf = gz[IX(i,j,k+1)] - gz[IX(i,j,k)];
-        dzb = gz[IX(i,j,k)] - gz[IX(i,j,k-1)];
-        Dx = gx[IX(i,j,k)] - gx[IX(i-1,j,k)];
-        Dy = gy[IX(i,j,k)] - gy[IX(i,j-1,k)];
-        Dz = z[IX(i,j,k+1)] - z[IX(i,j,k)];
+        Dx = m->dx[i];
+        Dy = m->dy[j];
+        Dz = m->dzc[k];
 
         if(para->prob->tur_model==CHEN)
-          kapa = nu_t_chen_zero_equ(para, var, i, j, k);
+          kapa = nu_t[IX(i,j,k)];
 
-        aw[IX(i,j,k)] = kapa*Dy*Dz/dxw;
-        ae[IX(i,j,k)] = kapa*Dy*Dz/dxe;
-        an[IX(i,j,k)] = kapa*Dx*Dz/dyn;
-        as[IX(i,j,k)] = kapa*Dx*Dz/dys;
-        af[IX(i,j,k)] = kapa*Dx*Dy/dzf;
-        ab[IX(i,j,k)] = kapa*Dx*Dy/dzb;
+        aw[IX(i,j,k)] = kapa*Dy*Dz*m->rdxc[i-1];
+        ae[IX(i,j,k)] = kapa*Dy*Dz*m->rdxc[i];
+        an[IX(i,j,k)] = kapa*Dx*Dz*m->rdyc[j];
+        as[IX(i,j,k)] = kapa*Dx*Dz*m->rdyc[j-1];
+        af[IX(i,j,k)] = kapa*Dx*Dy*m->rdz[k+1];
+        ab[IX(i,j,k)] = kapa*Dx*Dy*m->rdz[k];
         ap0[IX(i,j,k)] = Dx*Dy*Dz/dt;
         b[IX(i,j,k)] = psi0[IX(i,j,k)]*ap0[IX(i,j,k)]
                      - beta*gravz*(Temp[IX(i,j,k)]-Temp_Buoyancy)*Dx*Dy*Dz
@@ -276,25 +262,19 @@ int coef_diff(PARA_DATA *para, REAL **var, REAL *psi, REAL *psi0,
         kapa = (REAL) 101.0 * para->prob->alpha;
 
       FOR_EACH_CELL
-        dxe = x[IX(i+1,j,k)] - x[IX(i,j,k)];
-        dxw = x[IX(i,j,k)] - x[IX(i-1,j,k)];
-        dyn = y[IX(i,j+1,k)] - y[IX(i,j,k)];
-        dys = y[IX(i,j,k)] - y[IX(i,j-1,k)];
-        dzf = z[IX(i,j,k+1)] - z[IX(i,j,k)];
-        dzb = z[IX(i,j,k)] - z[IX(i,j,k-1)];
-        Dx = gx[IX(i,j,k)] - gx[IX(i-1,j,k)];
-        Dy = gy[IX(i,j,k)] - gy[IX(i,j-1,k)];
-        Dz = gz[IX(i,j,k)] - gz[IX(i,j,k-1)];
+        Dx = m->dx[i];
+        Dy = m->dy[j];
+        Dz = m->dz[k];
 
         if(para->prob->tur_model==CHEN)
-          kapa = nu_t_chen_zero_equ(para, var, i, j, k);
+          kapa = nu_t[IX(i,j,k)];
 
-        aw[IX(i,j,k)] = kapa*Dy*Dz/dxw;
-        ae[IX(i,j,k)] = kapa*Dy*Dz/dxe;
-        an[IX(i,j,k)] = kapa*Dx*Dz/dyn;
-        as[IX(i,j,k)] = kapa*Dx*Dz/dys;
-        af[IX(i,j,k)] = kapa*Dx*Dy/dzf;
-        ab[IX(i,j,k)] = kapa*Dx*Dy/dzb;
+        aw[IX(i,j,k)] = kapa*Dy*Dz*m->rdxc[i-1];
+        ae[IX(i,j,k)] = kapa*Dy*Dz*m->rdxc[i];
+        an[IX(i,j,k)] = kapa*Dx*Dz*m->rdyc[j];
+        as[IX(i,j,k)] = kapa*Dx*Dz*m->rdyc[j-1];
+        af[IX(i,j,k)] = kapa*Dx*Dy*m->rdzc[k];
+        ab[IX(i,j,k)] = kapa*Dx*Dy*m->rdzc[k-1];
         ap0[IX(i,j,k)] = Dx*Dy*Dz/dt;
         b[IX(i,j,k)] = psi0[IX(i,j,k)]*ap0[IX(i,j,k)];
       END_FOR
@@ -351,11 +331,11 @@ int source_diff(PARA_DATA *para, REAL **var, int var_type, int index) {
         break;
       case C1:
       case C2:
-        b[IX(i,j,k)] += var[C1S+index][IX(i,j,k)];
+        b[IX(i,j,k)] += var[C_VAR(para, index, SPECIES_SOURCE)][IX(i,j,k)];
         break;
       case Xi1:
       case Xi2:
-        b[IX(i,j,k)] += var[Xi1S+index][IX(i,j,k)];
+        b[IX(i,j,k)] += var[XI_VAR(para, index, SPECIES_SOURCE)][IX(i,j,k)];
         break;
     }
   END_FOR
@@ -18,56 +18,54 @@
 #include "ffd.h"
 #include <string.h>
 
-/* global variables */
-REAL **var;
-int  **BINDEX;
-REAL *locmin,*locmax;
-static PARA_DATA para;
-static GEOM_DATA geom;
-static PROB_DATA prob;
-static TIME_DATA mytime;
-static INPU_DATA inpu;
-static OUTP_DATA outp1;
-static BC_DATA bc;
-static SOLV_DATA solv;
-static SENSOR_DATA sens;
-static INIT_DATA init;
-
-clock_t start, end;
+/* Instance that is run by the current thread*/
+FFD_THREAD_LOCAL FFD_INSTANCE *ffd_instance = NULL;
 
 /*
 	* Allcoate memory for variables
 	*
-	* @param para Pointer to FFD parameters
+	* @param inst Pointer to FFD instance
 	*
 	* @return No return needed
 	*/
-int allocate_memory (PARA_DATA *para) {
+int allocate_memory (FFD_INSTANCE *inst) {
 
   int nb_var, i;
-  int size = (geom.imax+2) * (geom.jmax+2) * (geom.kmax+2);
+  int size = (inst->geom.imax+2) * (inst->geom.jmax+2) * (inst->geom.kmax+2);
+  size_t stride;
+  REAL **var;
+  int **BINDEX;
 
   /****************************************************************************
   | Allocate memory for variables
+  | All variables are stored in one block of memory. The length of each
+  | variable is rounded up to a multiple of FFD_ALIGNMENT so that every
+  | var[i] starts at an aligned address. Species and trace substances beyond
+  | Xi2 and C2 are stored after LAST_VAR.
   ****************************************************************************/
-  nb_var = C2BC+1;
-  var       = (REAL **) malloc ( nb_var*sizeof(REAL*) );
+  nb_var = NB_VAR(&inst->para);
+  var = inst->var = (REAL **) malloc ( nb_var*sizeof(REAL*) );
   if(var==NULL) {
     ffd_log("allocate_memory(): Could not allocate memory for var.",
             FFD_ERROR);
     return 1;
   }
 
-  for(i=0; i<nb_var; i++) {
-    var[i] = (REAL *) calloc(size, sizeof(REAL));
-    if(var[i]==NULL) {
-      sprintf(msg,
-              "allocate_memory(): Could not allocate memory for var[%d]", i);
-      ffd_log(msg, FFD_ERROR);
-      return 1;
-    }
+  stride = (size*sizeof(REAL) + FFD_ALIGNMENT - 1) / FFD_ALIGNMENT
+         * FFD_ALIGNMENT / sizeof(REAL);
+
+  var[0] = (REAL *) aligned_calloc(nb_var*stride, sizeof(REAL));
+  if(var[0]==NULL) {
+    sprintf(msg,
+            "allocate_memory(): Could not allocate memory for %d variables "
+            "with %d cells", nb_var, size);
+    ffd_log(msg, FFD_ERROR);
+    return 1;
   }
 
+  for(i=1; i<nb_var; i++)
+    var[i] = var[0] + i*stride;
+
   /****************************************************************************
   | Allocate memory for boundary cells
   | BINDEX[0]: i of global coordinate in IX(i,j,k)
@@ -76,77 +74,85 @@ int allocate_memory (PARA_DATA *para) {
   | BINDEX[3]: Fixed temperature or fixed heat flux
   | BINDEX[4]: Boundary ID to identify which boundary it belongs to
   ****************************************************************************/
-  BINDEX = (int **) malloc(5*sizeof(int*));
+  BINDEX = inst->BINDEX = (int **) malloc(5*sizeof(int*));
   if(BINDEX==NULL) {
     ffd_log("allocate_memory(): Could not allocate memory for BINDEX.",
             FFD_ERROR);
     return 1;
   }
 
-  BINDEX[0] = (int *) malloc(size*sizeof(int));
+  BINDEX[0] = (int *) malloc(5*size*sizeof(int));
   if(BINDEX[0]==NULL) {
     sprintf(msg,
             "allocate_memory(): Could not allocate memory for BINDEX[0]");
     ffd_log(msg, FFD_ERROR);
     return 1;
   }
-  BINDEX[1] = (int *) malloc(size*sizeof(int));
-  if(BINDEX[1]==NULL) {
-    sprintf(msg,
-            "allocate_memory(): Could not allocate memory for BINDEX[1]");
-    ffd_log(msg, FFD_ERROR);
-    return 1;
-  }
-  BINDEX[2] = (int *) malloc(size*sizeof(int));
-  if(BINDEX[2]==NULL) {
-    sprintf(msg,
-            "allocate_memory(): Could not allocate memory for BINDEX[2]");
-    ffd_log(msg, FFD_ERROR);
-    return 1;
-  }
-  BINDEX[3] = (int *) malloc(size*sizeof(int));
-  if(BINDEX[3]==NULL) {
-    sprintf(msg,
-            "allocate_memory(): Could not allocate memory for BINDEX[3]");
-    ffd_log(msg, FFD_ERROR);
-    return 1;
-  }
-  BINDEX[4] = (int *) malloc(size*sizeof(int));
-  if(BINDEX[4]==NULL) {
-    sprintf(msg,
-            "allocate_memory(): Could not allocate memory for BINDEX[4]");
-    ffd_log(msg, FFD_ERROR);
-    return 1;
-  }
 
-  /*
-  for(i=0; i<5; i++) {
-    BINDEX[i] = (int *) malloc(size*sizeof(int));
-    if(BINDEX[i]==NULL) {
-      sprintf(msg,
-              "allocate_memory(): Could not allocate memory for BINDEX[%d]", i);
-      ffd_log(msg, FFD_ERROR);
-      return 1;
-    }
-  }
-  */
+  for(i=1; i<5; i++)
+    BINDEX[i] = BINDEX[0] + i*size;
+
   return 0;
 } /* End of allocate_memory()*/
 
 
+	/*
+		* Create an FFD instance for a coupled simulation
+		*
+		* @param cosim Pointer to the coupled simulation parameters
+		*
+		* @return Pointer to the instance, or NULL if an error occurred
+		*/
+FFD_INSTANCE *create_instance(CosimulationData *cosim) {
+  FFD_INSTANCE *inst = (FFD_INSTANCE *) calloc(1, sizeof(FFD_INSTANCE));
+
+  if(inst==NULL)
+    return NULL;
+
+  inst->para.cosim = cosim;
+  inst->id = cosim==NULL ? 0 : cosim->id;
+
+  /* The first instance keeps the name ffd.log*/
+  if(inst->id==0)
+    strcpy(inst->log_file_name, "ffd.log");
+  else
+    sprintf(inst->log_file_name, "ffd_%d.log", inst->id);
+
+  return inst;
+} /* End of create_instance()*/
+
+	/*
+		* Get the name of an output file of the instance
+		*
+		* The first instance writes to the file name, the others append
+		* their ID, such as result_1.
+		*
+		* @param inst Pointer to FFD instance
+		* @param base Pointer to the file name
+		* @param name Pointer to the name of the instance's file
+		*
+		* @return Pointer to the name of the instance's file
+		*/
+static char *instance_file_name(FFD_INSTANCE *inst, const char *base,
+                                char *name) {
+  if(inst->id==0)
+    strcpy(name, base);
+  else
+    sprintf(name, "%s_%d", base, inst->id);
+
+  return name;
+} /* End of instance_file_name()*/
+
 	/*
 		* Assign the parameter for coupled simulation
 		*
-		* @para cosim Pointer to the coupled simulation parameters
+		* @para inst Pointer to FFD instance
 		*
 		* @return 0 if no error occurred
 		*/
-int ffd_cosimulation(CosimulationData *cosim) {
-  /* para.cosim = (CosimulationData *) malloc(sizeof(CosimulationData)); */
-  para.cosim = cosim;
-
-  if(ffd(1)!=0) {
-    cosim->para->ffdError = 1;
+int ffd_cosimulation(FFD_INSTANCE *inst) {
+  if(ffd(inst, 1)!=0) {
+    cosim_set_flag(inst->para.cosim, &inst->para.cosim->para->ffdError, 1);
     return 1;
   }
   else
@@ -156,11 +162,14 @@ int ffd_cosimulation(CosimulationData *cosim) {
 	/*
 		* Main routine of FFD
 		*
+		* @para inst Pointer to FFD instance
 		* @para coupled simulation Integer to identify the simulation type
 		*
 		* @return 0 if no error occurred
 		*/
-int ffd(int cosimulation) {
+int ffd(FFD_INSTANCE *inst, int cosimulation) {
+  PARA_DATA *para = &inst->para;
+  char name[64];
 /*#ifndef _MSC_VER //Linux*/
 /*  //Initialize glut library*/
 /*  char fakeParam[] = "fake";*/
@@ -170,57 +179,98 @@ int ffd(int cosimulation) {
 /*#endif*/
 
   /* Initialize the parameters*/
-  para.geom = &geom;
-  para.inpu = &inpu;
-  para.outp = &outp1;
-  para.prob = &prob;
-  para.mytime = &mytime;
-  para.bc     = &bc;
-  para.solv   = &solv;
-  para.sens   = &sens;
-  para.init   = &init;
+  para->geom = &inst->geom;
+  para->inpu = &inst->inpu;
+  para->outp = &inst->outp;
+  para->prob = &inst->prob;
+  para->mytime = &inst->mytime;
+  para->bc     = &inst->bc;
+  para->solv   = &inst->solv;
+  para->sens   = &inst->sens;
+  para->init   = &inst->init;
   /* Stand alone simulation: 0; Cosimulaiton: 1*/
-  para.solv->cosimulation = cosimulation;
+  para->solv->cosimulation = cosimulation;
 
-  if(initialize(&para)!=0) {
+  if(initialize(para)!=0) {
     ffd_log("ffd(): Could not initialize simulation parameters.", FFD_ERROR);
     return 1;
   }
 
+  /* The parameter file can not change the type of the simulation*/
+  if(para->solv->cosimulation!=cosimulation) {
+    sprintf(msg, "ffd(): Ignored solv.cosimulation=%d of the parameter file.",
+            para->solv->cosimulation);
+    ffd_log(msg, FFD_WARNING);
+    para->solv->cosimulation = cosimulation;
+  }
+
   /* Overwrite the mesh and simulation data using SCI generated file*/
-  if(para.inpu->parameter_file_format == SCI) {
-    if(read_sci_max(&para, var)!=0) {
+  if(para->inpu->parameter_file_format == SCI) {
+    if(read_sci_max(para, inst->var)!=0) {
       ffd_log("ffd(): Could not read SCI data.", FFD_ERROR);
       return 1;
     }
   }
 
   /* Allocate memory for the variables*/
-  if(allocate_memory(&para)!=0) {
+  if(allocate_memory(inst)!=0) {
     ffd_log("ffd(): Could not allocate memory for the simulation.", FFD_ERROR);
     return 1;
   }
 
   /* Set the initial values for the simulation data*/
-  if(set_initial_data(&para, var, BINDEX)) {
+  if(set_initial_data(para, inst->var, inst->BINDEX)) {
     ffd_log("ffd(): Could not set initial data.", FFD_ERROR);
     return 1;
   }
 
   /* Read previous simulation data as initial values*/
-  if(para.inpu->read_old_ffd_file==1) read_ffd_data(&para, var);
+  if(para->inpu->read_old_ffd_file==1) {
+    if(para->inpu->old_ffd_file_format==BINARY) {
+      if(read_checkpoint(para, inst->var)!=0) {
+        ffd_log("ffd(): Could not read the checkpoint file.", FFD_ERROR);
+        return 1;
+      }
+    }
+    else
+      read_ffd_data(para, inst->var);
+  }
+
+  /* Start the writer of the transient flow field*/
+  if(para->outp->transient_step>0
+     && open_vtk_writer(para, inst->var,
+                        instance_file_name(inst, "transient", name))!=0) {
+    ffd_log("ffd(): Could not open the transient output.", FFD_ERROR);
+    return 1;
+  }
 
   ffd_log("ffd.c: Start FFD solver.", FFD_NORMAL);
-  /*write_tecplot_data(&para, var, "initial");*/
+  /*write_tecplot_data(para, inst->var, "initial");*/
 
   /* Solve the problem*/
-  /*if(para.outp->version==DEMO) {*/
+  /*if(para->outp->version==DEMO) {*/
   /*  open_glut_window();*/
   /*  glutMainLoop();*/
   /*}*/
   /*else*/
-  if(FFD_solver(&para, var, BINDEX)!=0) {
+  /* The threads of the parallel solvers are created once for the solver*/
+  para->solv->team = (void *) team_create(para->solv->nb_thread);
+
+  phase_start(para, PHASE_SOLVER);
+  if(FFD_solver(para, inst->var, inst->BINDEX)!=0) {
     ffd_log("ffd(): FFD solver failed.", FFD_ERROR);
+    team_free((THREAD_TEAM *) para->solv->team);
+    para->solv->team = NULL;
+    close_vtk_writer(para);
+    return 1;
+  }
+  phase_end(para, PHASE_SOLVER);
+
+  team_free((THREAD_TEAM *) para->solv->team);
+  para->solv->team = NULL;
+
+  if(close_vtk_writer(para)!=0) {
+    ffd_log("ffd(): Could not write the transient flow field.", FFD_ERROR);
     return 1;
   }
 
@@ -228,34 +278,58 @@ int ffd(int cosimulation) {
   | Post Process
   ---------------------------------------------------------------------------*/
   /* Calculate mean value*/
-  if(para.outp->cal_mean == 1)
-    average_time(&para, var);
+  if(para->outp->cal_mean == 1)
+    average_time(para, inst->var);
 
-  if(write_unsteady(&para, var, "unsteady")!=0) {
+  if(write_unsteady(para, inst->var,
+                    instance_file_name(inst, "unsteady", name))!=0) {
     ffd_log("FFD_solver(): Could not write the file unsteady.plt.", FFD_ERROR);
     return 1;
   }
 
-  if(write_tecplot_data(&para, var, "result")!=0) {
+  if(write_tecplot_data(para, inst->var,
+                        instance_file_name(inst, "result", name))!=0) {
     ffd_log("FFD_solver(): Could not write the file result.plt.", FFD_ERROR);
     return 1;
   }
 
-  if(para.outp->version == DEBUG)
-    write_tecplot_all_data(&para, var, "result_all");
+  if(para->outp->version == DEBUG)
+    write_tecplot_all_data(para, inst->var,
+                           instance_file_name(inst, "result_all", name));
+
+  if(para->outp->checkpoint==1
+     && write_checkpoint(para, inst->var,
+                         instance_file_name(inst, "checkpoint", name))!=0) {
+    ffd_log("FFD_solver(): Could not write the checkpoint file.", FFD_ERROR);
+    return 1;
+  }
+
+  if(para->outp->profile==1
+     && write_profile(para, instance_file_name(inst, "profile", name))!=0) {
+    ffd_log("FFD_solver(): Could not write the profile.", FFD_ERROR);
+    return 1;
+  }
 
   /* Write the data in SCI format*/
-  write_SCI(&para, var, "output");
+  write_SCI(para, inst->var, instance_file_name(inst, "output", name));
 
   /* Free the memory*/
-  free_data(var);
-  free_index(BINDEX);
-  free_para(&para);
-
-  /* Inform Modelica the stopping command has been received*/
-  if(para.solv->cosimulation==1) {
-    para.cosim->para->flag = 2;
+  free_data(inst->var);
+  free_index(inst->BINDEX);
+  free_multigrid(para);
+  free_pcg(para);
+  free_species(para);
+  free_time_step(para);
+  free_face_list(para);
+  free_metric(para);
+  free_para(para);
+
+  /* Inform Modelica the stopping command has been received.
+     Modelica may end the process afterwards, so the log is written first.*/
+  if(para->solv->cosimulation==1) {
     ffd_log("ffd(): Sent stopping signal to Modelica", FFD_NORMAL);
+    ffd_log_flush();
+    cosim_set_flag(para->cosim, &para->cosim->para->flag, 2);
   }
 
   return 0;
@@ -264,15 +338,27 @@ int ffd(int cosimulation) {
 	/*
 		* Write error message to Modelica
 		*
+		* The message is sent to the coupled simulation of the instance
+		* that is run by the current thread.
+		*
 		* @para msg Pointer to message to be written.
 		*
 		* @return no return
 		*/
 void modelicaError(char *errMsg) {
-  strcpy(para.cosim->ffd->msg, errMsg);
+  CosimulationData *cosim;
+
+  if(ffd_instance==NULL || ffd_instance->para.cosim==NULL)
+    return;
+
+  cosim = ffd_instance->para.cosim;
+  cosim_lock(cosim);
+  strcpy(cosim->ffd->msg, errMsg);
   /* Write the command to stop the cosimulation*/
-  para.cosim->para->flag = 2;
+  cosim->para->flag = 2;
   /* Indicate there is an error*/
-  para.cosim->para->ffdError = 1;
+  cosim->para->ffdError = 1;
+  cosim_notify(cosim);
+  cosim_unlock(cosim);
 
 } /* End of modelicaError*/
@@ -48,37 +48,52 @@
 #include "data_writer.h"
 #endif
 
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+#include "checkpoint.h"
+#endif
+
 #ifndef _INITIALIZATION_H
 #define _INITIALIZATION_H
 #include "initialization.h"
 #endif
 
+/*
+	* Create an FFD instance for a coupled simulation
+	*
+	* @param cosim Pointer to the coupled simulation parameters
+	*
+	* @return Pointer to the instance, or NULL if an error occurred
+	*/
+FFD_INSTANCE *create_instance(CosimulationData *cosim);
+
 /*
 	* Assign the parameter for coupled simulation
 	*
-	* @para cosim Pointer to the coupled simulation parameters
+	* @para inst Pointer to FFD instance
 	*
 	* @return 0 if no error occurred
 	*/
-int ffd_cosimulation(CosimulationData *cosim);
+int ffd_cosimulation(FFD_INSTANCE *inst);
 
 /*
 	* Main routine of FFD
 	*
+	* @para inst Pointer to FFD instance
 	* @para coupled simulation Integer to identify the simulation type
 	*
 	* @return 0 if no error occurred
 	*/
-int ffd(int cosimulation);
+int ffd(FFD_INSTANCE *inst, int cosimulation);
 
 /*
 	* Allocate memory for variables
 	*
-	* @param para Pointer to FFD parameters
+	* @param inst Pointer to FFD instance
 	*
 	* @return No return needed
 	*/
-int allocate_memory (PARA_DATA *para);
+int allocate_memory (FFD_INSTANCE *inst);
 
 /*
 	* Write error message to Modelica
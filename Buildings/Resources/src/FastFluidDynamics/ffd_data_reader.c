@@ -16,7 +16,7 @@
 	*/
 
 #include "ffd_data_reader.h"
-FILE *file_old_ffd;
+FFD_THREAD_LOCAL FILE *file_old_ffd;
 
 /*
 	* Read the previous FFD simulation data in a format of standard output
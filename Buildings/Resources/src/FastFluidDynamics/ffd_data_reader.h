@@ -26,7 +26,7 @@
 
 #include "utility.h"
 
-extern FILE *file_old_ffd;
+extern FFD_THREAD_LOCAL FILE *file_old_ffd;
 
 /*
 	* Read the previous FFD simulation data in a format of standard output
@@ -22,6 +22,7 @@
 | Called by the other program
 ******************************************************************************/
 void *ffd_dll(CosimulationData *cosim) {
+  FFD_INSTANCE *inst;
 /* Windows*/
 #ifdef _MSC_VER
   DWORD dummy;
@@ -51,11 +52,23 @@ void *ffd_dll(CosimulationData *cosim) {
   }
 #endif
 
+  /* Each call launches a new instance with its own data*/
+  inst = create_instance(cosim);
+  if (inst == NULL) {
+    ffd_log("ffd_dll(): Failed to allocate memory for FFD instance.", FFD_ERROR);
+#ifdef _MSC_VER
+    free(workerThreadHandle);
+#else
+    free(thread1);
+#endif
+    return NULL;
+  }
+
   /*printf("ffd_dll():Start to launch FFD\n");*/
 
 /* Windows*/
 #ifdef _MSC_VER
-  *workerThreadHandle = CreateThread(NULL, 0, ffd_thread, (void *)cosim, 0, &dummy);
+  *workerThreadHandle = CreateThread(NULL, 0, ffd_thread, (void *)inst, 0, &dummy);
   /* Close the Windows thread HANDLE immediately.  The thread itself
    * continues to run independently; closing the handle only releases the
    * kernel reference so it does not leak.  The malloc'd pointer is what
@@ -66,7 +79,7 @@ void *ffd_dll(CosimulationData *cosim) {
   {
     void * (*foo) (void *);
     foo = &ffd_thread;
-    pthread_create(thread1, NULL, foo, (void *)cosim);
+    pthread_create(thread1, NULL, foo, (void *)inst);
     /* Detach so the thread cleans up automatically when it exits,
      * avoiding resource leaks when the thread handle is freed by the caller. */
     pthread_detach(*thread1);
@@ -85,39 +98,51 @@ void *ffd_dll(CosimulationData *cosim) {
 /*
 * Launch the FFD simulation through a thread
 *
-* @param p Pointer to the coupled simulation data
+* The thread owns the instance and frees it when the simulation ends.
+*
+* @param p Pointer to the FFD instance
 *
 * @return 0 if no error occurred
 */
 #ifdef _MSC_VER /*Windows*/
 DWORD WINAPI ffd_thread(void *p){
-  ULONG workerID = (ULONG)(ULONG_PTR)p;
 #else /*Linux*/
 void *ffd_thread(void* p){
 #endif
-int pthread_ret = 0;
-  CosimulationData *cosim = (CosimulationData *) p;
+  FFD_INSTANCE *inst = (FFD_INSTANCE *) p;
+  int flag;
+
+  /* Messages of this thread belong to the instance*/
+  ffd_instance = inst;
 
 #ifdef _MSC_VER /*Windows*/
-  sprintf(msg, "Start Fast Fluid Dynamics Simulation with Thread ID %lu", workerID);
+  sprintf(msg, "Start Fast Fluid Dynamics Simulation %d with Thread ID %lu",
+          inst->id, (unsigned long) GetCurrentThreadId());
 #else /*Linux*/
-  sprintf(msg, "Start Fast Fluid Dynamics Simulation with Thread");
+  sprintf(msg, "Start Fast Fluid Dynamics Simulation %d with Thread", inst->id);
 #endif
 
   printf("%s\n", msg);
   ffd_log(msg, FFD_NEW);
 
-  sprintf(msg, "fileName=\"%s\"", cosim->para->fileName);
+  sprintf(msg, "fileName=\"%s\"", inst->para.cosim->para->fileName);
   ffd_log(msg, FFD_NORMAL);
 
-  if(ffd_cosimulation(cosim)!=0) {
+  flag = ffd_cosimulation(inst);
+  if(flag!=0) {
     ffd_log("ffd_thread(): Cosimulation failed", FFD_ERROR);
-		#ifdef _MSC_VER
-			return 1;
-		#endif
   }
   else {
     ffd_log("Successfully exit FFD.", FFD_NORMAL);
-		return 0;
   }
-} /* End of ffd_thread()*/
\ No newline at end of file
+
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+#ifdef _MSC_VER
+  return flag;
+#else
+  return NULL;
+#endif
+} /* End of ffd_thread()*/
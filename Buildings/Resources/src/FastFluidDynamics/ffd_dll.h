@@ -41,7 +41,9 @@ void *ffd_dll(CosimulationData *cosim);
 /*
 	* Launch the FFD simulation through a thread
 	*
-	* @param p Pointer to the coupled simulation data
+	* The thread owns the instance and frees it when the simulation ends.
+	*
+	* @param p Pointer to the FFD instance
 	*
 	* @return 0 if no error occurred
 	*/
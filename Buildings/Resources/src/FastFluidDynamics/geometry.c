@@ -123,6 +123,9 @@ REAL length_x(PARA_DATA *para, REAL **var, int i, int j, int k) {
   int imax = para->geom->imax, jmax = para->geom->jmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
 
+  if(para->geom->metric!=NULL)
+    return para->geom->metric->dx[i];
+
   if(i==0)
     return 0;
   else
@@ -144,6 +147,9 @@ REAL length_y(PARA_DATA *para, REAL **var, int i, int j, int k) {
   int imax = para->geom->imax, jmax = para->geom->jmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
 
+  if(para->geom->metric!=NULL)
+    return para->geom->metric->dy[j];
+
   if(j==0)
     return 0;
   else
@@ -165,6 +171,9 @@ REAL length_z(PARA_DATA *para, REAL **var, int i, int j, int k) {
   int imax = para->geom->imax, jmax = para->geom->jmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
 
+  if(para->geom->metric!=NULL)
+    return para->geom->metric->dz[k];
+
   if(k==0)
     return 0;
   else
@@ -295,3 +304,111 @@ int bounary_area(PARA_DATA *para, REAL **var, int **BINDEX) {
   }
   return 0;
 } /* End of bounary_area()*/
+
+	/*
+		* Build the metrics of the mesh
+		*
+		* The metrics are computed once in set_initial_data() since the
+		* mesh does not change. The kernels, such as coef_diff() and project(),
+		* read the cell widths and the inverse distances from the metrics
+		* instead of computing them from the coordinates in every time step.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		*
+		* @return 0 if no error occurred
+		*/
+int build_metric(PARA_DATA *para, REAL **var) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+  int n = (imax+2) + (jmax+2) + (kmax+2);
+  REAL *x = var[X], *y = var[Y], *z = var[Z];
+  REAL *gx = var[GX], *gy = var[GY], *gz = var[GZ];
+  METRIC_DATA *m;
+  REAL *mem;
+
+  /****************************************************************************
+  | Check that the mesh is a tensor product
+  ****************************************************************************/
+  FOR_ALL_CELL
+    if(gx[IX(i,j,k)]!=gx[IX(i,0,0)] || x[IX(i,j,k)]!=x[IX(i,0,0)]
+     ||gy[IX(i,j,k)]!=gy[IX(0,j,0)] || y[IX(i,j,k)]!=y[IX(0,j,0)]
+     ||gz[IX(i,j,k)]!=gz[IX(0,0,k)] || z[IX(i,j,k)]!=z[IX(0,0,k)]) {
+      sprintf(msg, "build_metric(): The mesh is not a tensor product at "
+              "cell (%d, %d, %d).", i, j, k);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+  END_FOR
+
+  /****************************************************************************
+  | Allocate memory
+  ****************************************************************************/
+  m = (METRIC_DATA *) malloc(sizeof(METRIC_DATA));
+  mem = (REAL *) calloc(4*n, sizeof(REAL));
+  if(m==NULL || mem==NULL) {
+    ffd_log("build_metric(): Could not allocate memory for the metrics.",
+            FFD_ERROR);
+    free(m);
+    free(mem);
+    return 1;
+  }
+
+  m->dx = mem;           m->dy = m->dx + imax+2;   m->dz = m->dy + jmax+2;
+  m->rdx = m->dz + kmax+2;  m->rdy = m->rdx + imax+2; m->rdz = m->rdy + jmax+2;
+  m->dxc = m->rdz + kmax+2; m->dyc = m->dxc + imax+2; m->dzc = m->dyc + jmax+2;
+  m->rdxc = m->dzc + kmax+2; m->rdyc = m->rdxc + imax+2;
+  m->rdzc = m->rdyc + jmax+2;
+
+  /****************************************************************************
+  | Compute the metrics in each direction
+  ****************************************************************************/
+  for(i=1; i<=imax+1; i++) {
+    m->dx[i] = gx[IX(i,0,0)] - gx[IX(i-1,0,0)];
+    m->rdx[i] = m->dx[i]>0 ? 1/m->dx[i] : 0;
+  }
+  for(i=0; i<=imax; i++) {
+    m->dxc[i] = x[IX(i+1,0,0)] - x[IX(i,0,0)];
+    m->rdxc[i] = 1/m->dxc[i];
+  }
+
+  for(j=1; j<=jmax+1; j++) {
+    m->dy[j] = gy[IX(0,j,0)] - gy[IX(0,j-1,0)];
+    m->rdy[j] = m->dy[j]>0 ? 1/m->dy[j] : 0;
+  }
+  for(j=0; j<=jmax; j++) {
+    m->dyc[j] = y[IX(0,j+1,0)] - y[IX(0,j,0)];
+    m->rdyc[j] = 1/m->dyc[j];
+  }
+
+  for(k=1; k<=kmax+1; k++) {
+    m->dz[k] = gz[IX(0,0,k)] - gz[IX(0,0,k-1)];
+    m->rdz[k] = m->dz[k]>0 ? 1/m->dz[k] : 0;
+  }
+  for(k=0; k<=kmax; k++) {
+    m->dzc[k] = z[IX(0,0,k+1)] - z[IX(0,0,k)];
+    m->rdzc[k] = 1/m->dzc[k];
+  }
+
+  para->geom->metric = m;
+
+  return 0;
+} /* End of build_metric()*/
+
+	/*
+		* Free the memory of the metrics of the mesh
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return No return needed
+		*/
+void free_metric(PARA_DATA *para) {
+  if(para->geom->metric==NULL)
+    return;
+
+  free(para->geom->metric->dx);
+  free(para->geom->metric);
+  para->geom->metric = NULL;
+} /* End of free_metric()*/
@@ -138,3 +138,25 @@ REAL length_z(PARA_DATA *para, REAL **var, int i, int j, int k);
 	* @return 0 if no error occurred
 	*/
 int bounary_area(PARA_DATA *para, REAL **var, int **BINDEX);
+
+/*
+	* Build the metrics of the mesh
+	*
+	* The metrics are computed once in set_initial_data() since the
+	* mesh does not change.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return 0 if no error occurred
+	*/
+int build_metric(PARA_DATA *para, REAL **var);
+
+/*
+	* Free the memory of the metrics of the mesh
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_metric(PARA_DATA *para);
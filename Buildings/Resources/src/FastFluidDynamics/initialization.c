@@ -67,6 +67,15 @@ void set_default_parameter(PARA_DATA *para) {
   para->mytime->t  = 0.0;
   para->mytime->step_current = 0;
   para->mytime->t_start = clock();
+  para->mytime->adaptive = 0; /* Constant time step size*/
+  para->mytime->cfl = 5.0; /* Semi-Lagrangian advection is stable beyond CFL 1*/
+  para->mytime->dT_step = 1.0; /* Temperature change per time step in K*/
+  para->mytime->dt_min = 0.001;
+  para->mytime->dt_max = 0; /* 10 times the time step size dt*/
+  para->mytime->dt_next = 0;
+  para->mytime->dt_smallest = 0;
+  para->mytime->dt_largest = 0;
+  para->mytime->T_old = NULL;
 
   para->prob->alpha = (REAL) 2.376e-5; /* Thermal diffusity*/
   para->prob->diff = 0.00001;
@@ -81,10 +90,32 @@ void set_default_parameter(PARA_DATA *para) {
 
   para->solv->check_residual = 0;
   para->solv->solver = GS; /* Gauss-Seidel Solver*/
+  para->solv->nb_thread = 1; /* Single thread for RBGS solver*/
+  para->solv->mg_cycle = V_CYCLE; /* V-cycle for MG solver*/
+  para->solv->pcg_precond = IC; /* Incomplete Cholesky for PCG solver*/
+  para->solv->p_tol = (REAL) 1e-6; /* Reduction of pressure residual*/
+  para->solv->p_it_max = 100; /* Maximum number of MG cycles or PCG iterations*/
+  para->solv->tol = (REAL) 1e-6; /* Reduction of residual*/
+  para->solv->it_max = 100; /* Maximum number of PCG iterations*/
+  para->solv->gs_tol[EQU_PRESSURE] = 0; /* Fixed number of GS iterations*/
+  para->solv->gs_tol[EQU_VELOCITY] = 0;
+  para->solv->gs_tol[EQU_TEMPERATURE] = 0;
+  para->solv->gs_tol[EQU_SPECIES] = 0;
+  para->solv->gs_it_max[EQU_PRESSURE] = 5; /* 5 iterations of 4 sweeps*/
+  para->solv->gs_it_max[EQU_VELOCITY] = 20; /* 20 iterations of 2 sweeps*/
+  para->solv->gs_it_max[EQU_TEMPERATURE] = 20;
+  para->solv->gs_it_max[EQU_SPECIES] = 20;
+  para->solv->gs_check = 2; /* Check the residual every second iteration*/
+  para->solv->mg = NULL;
+  para->solv->pcg = NULL;
+  para->solv->team = NULL;
+  para->solv->species = NULL;
   para->solv->interpolation = BILINEAR; /* Bilinear interpolation*/
 
   /* Default values for Input*/
+  para->inpu->sci_cache = 1; /* Cache the geometry defined by SCI*/
   para->inpu->read_old_ffd_file = 0; /* Do not read the old FFD data as initial value*/
+  para->inpu->old_ffd_file_format = FFD; /* Text file written by write_unsteady()*/
 
   /* Default values for Output*/
   para->outp->Temp_ref   = 0;/*35.5f;//10.25f;*/
@@ -99,6 +130,13 @@ void set_default_parameter(PARA_DATA *para) {
   para->outp->j_N        = 1;
   para->outp->k_N        = 1;
   para->outp->tstep_display = 10; /* Update the display for every 10 time steps*/
+  para->outp->log_level  = LOG_NORMAL; /* Log all messages*/
+  para->outp->log_step   = 1; /* Log every time step*/
+  para->outp->checkpoint = 0; /* Do not write a checkpoint file*/
+  para->outp->transient_format = VTK; /* Binary VTK files*/
+  para->outp->transient_step = 0; /* Do not write the transient flow field*/
+  para->outp->vtk = NULL;
+  para->outp->profile = 0; /* Do not write the wall time of the solver phases*/
   para->outp->screen     = 1; /* Draw velocity*/
   para->geom->plane      = ZX; /* Draw ZX plane*/
   para->bc->nb_port = 0;
@@ -125,6 +163,16 @@ int set_initial_data(PARA_DATA *para, REAL **var, int **BINDEX) {
   para->mytime->step_current = 0;
   para->outp->cal_mean = 0;
 
+  /* Reset the measurements of the solver phases*/
+  memset(para->mytime->phase_time, 0, sizeof(para->mytime->phase_time));
+  memset(para->mytime->phase_calls, 0, sizeof(para->mytime->phase_calls));
+  memset(para->mytime->solver_calls, 0, sizeof(para->mytime->solver_calls));
+  memset(para->mytime->solver_it, 0, sizeof(para->mytime->solver_it));
+  memset(para->mytime->equ_calls, 0, sizeof(para->mytime->equ_calls));
+  memset(para->mytime->equ_it, 0, sizeof(para->mytime->equ_it));
+  memset(para->mytime->equ_it_most, 0, sizeof(para->mytime->equ_it_most));
+  memset(para->mytime->equ_missed, 0, sizeof(para->mytime->equ_missed));
+
   /****************************************************************************
   | Set initial value for FFD variables
   ****************************************************************************/
@@ -182,6 +230,11 @@ int set_initial_data(PARA_DATA *para, REAL **var, int **BINDEX) {
     var[C2BC][i]    = 0.0;
   }
 
+  /* Species and trace substances beyond Xi2 and C2*/
+  for(j=LAST_VAR+1; j<NB_VAR(para); j++)
+    for(i=0; i<size; i++)
+      var[j][i] = 0.0;
+
   /* Calculate the thermal diffusivity*/
   para->prob->alpha = para->prob->cond / (para->prob->rho*para->prob->Cp);
 
@@ -189,6 +242,17 @@ int set_initial_data(PARA_DATA *para, REAL **var, int **BINDEX) {
   | Read the configurations defined by SCI
   ****************************************************************************/
   if(para->inpu->parameter_file_format == SCI) {
+    flag = 1;
+    if(para->inpu->sci_cache==1) {
+      flag = read_sci_cache(para, var, BINDEX);
+      if(flag<0) {
+        ffd_log("set_inital_data(): Could not read the SCI cache", FFD_ERROR);
+        return flag;
+      }
+    }
+  }
+
+  if(para->inpu->parameter_file_format == SCI && flag!=0) {
     flag = read_sci_input(para, var, BINDEX);
     if(flag != 0) {
       sprintf(msg, "set_inital_data(): Could not read file %s",
@@ -203,8 +267,34 @@ int set_initial_data(PARA_DATA *para, REAL **var, int **BINDEX) {
       return flag;
     }
     mark_cell(para, var);
+
+    /* A failure to write the cache does not stop the simulation*/
+    if(para->inpu->sci_cache==1)
+      write_sci_cache(para, var, BINDEX);
+  }
+
+  /****************************************************************************
+  | Compute the metrics of the mesh used by the solver
+  ****************************************************************************/
+  flag = build_metric(para, var);
+  if(flag != 0) {
+    ffd_log("set_initial_data(): Could not build the metrics of the mesh.",
+            FFD_ERROR);
+    return flag;
   }
 
+  /* The faces of the boundary cells do not change either*/
+  flag = build_face_list(para, var, BINDEX);
+  if(flag != 0) {
+    ffd_log("set_initial_data(): Could not build the faces of the boundary.",
+            FFD_ERROR);
+    return flag;
+  }
+
+  /* The walls are fixed, so the wall distance is only computed once*/
+  if(para->prob->tur_model==CHEN)
+    wall_distance_chen(para, var);
+
   /****************************************************************************
   | Allocate memory for sensor data if there is at least one sensor
   ****************************************************************************/
@@ -38,6 +38,11 @@
 #include "sci_reader.h"
 #endif
 
+#ifndef _SCI_CACHE_H
+#define _SCI_CACHE_H
+#include "sci_cache.h"
+#endif
+
 #ifndef _UTILITY_H
 #define _UTILITY_H
 #include "utility.h"
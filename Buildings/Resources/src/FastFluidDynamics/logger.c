@@ -0,0 +1,349 @@
+/*
+	*
+	* \file   logger.c
+	*
+	* \brief  Buffered log file of an FFD instance
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+/* clock_gettime() is not declared in strict C89 mode*/
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "logger.h"
+
+	/*
+		* Acquire the lock of the logger
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+static void logger_lock(LOGGER *logger) {
+#ifdef _MSC_VER /*Windows*/
+  EnterCriticalSection(&logger->lock);
+#else /*Linux*/
+  pthread_mutex_lock(&logger->lock);
+#endif
+} /* End of logger_lock()*/
+
+	/*
+		* Release the lock of the logger
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+static void logger_unlock(LOGGER *logger) {
+#ifdef _MSC_VER /*Windows*/
+  LeaveCriticalSection(&logger->lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&logger->lock);
+#endif
+} /* End of logger_unlock()*/
+
+	/*
+		* Wake up all threads that wait for the logger
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+static void logger_notify(LOGGER *logger) {
+#ifdef _MSC_VER /*Windows*/
+  WakeAllConditionVariable(&logger->cond);
+#else /*Linux*/
+  pthread_cond_broadcast(&logger->cond);
+#endif
+} /* End of logger_notify()*/
+
+	/*
+		* Wait until the logger changed or the time out elapsed
+		*
+		* The lock must be held by the caller.
+		*
+		* @param logger Pointer to the logger
+		* @param timeout Maximum waiting time in milliseconds, or 0 to wait
+		*        without time out
+		*
+		* @return No return needed
+		*/
+static void logger_wait(LOGGER *logger, int timeout) {
+#ifdef _MSC_VER /*Windows*/
+  SleepConditionVariableCS(&logger->cond, &logger->lock,
+                           timeout>0 ? (DWORD) timeout : INFINITE);
+#else /*Linux*/
+  struct timespec deadline;
+
+  if(timeout<=0) {
+    pthread_cond_wait(&logger->cond, &logger->lock);
+    return;
+  }
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout / 1000;
+  deadline.tv_nsec += (long) (timeout % 1000) * 1000000L;
+  if(deadline.tv_nsec>=1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  pthread_cond_timedwait(&logger->cond, &logger->lock, &deadline);
+#endif
+} /* End of logger_wait()*/
+
+	/*
+		* Write the buffer that is filled to the log file
+		*
+		* The lock must be held by the caller. It is released while writing,
+		* so that other threads can fill the other buffer.
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+static void logger_write_buffer(LOGGER *logger) {
+  char *buf = logger->buf[logger->cur];
+  int len = logger->len;
+
+  logger->cur = 1 - logger->cur;
+  logger->len = 0;
+  logger->flush = 0;
+  logger_notify(logger);
+  logger_unlock(logger);
+
+  if(logger->file!=NULL) {
+    fwrite(buf, 1, len, logger->file);
+    fflush(logger->file);
+  }
+
+  logger_lock(logger);
+  logger->nb_out += len;
+  logger_notify(logger);
+} /* End of logger_write_buffer()*/
+
+	/*
+		* Run the background thread that writes the buffers
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+static void logger_run(LOGGER *logger) {
+  logger_lock(logger);
+  while(logger->stop==0 || logger->len>0) {
+    if(logger->len>0 && (logger->flush==1 || logger->stop==1
+       || logger->len>=LOGGER_BUFFER_SIZE/2))
+      logger_write_buffer(logger);
+    else {
+      logger_wait(logger, 1000);
+      /* Write the messages at least once per second*/
+      if(logger->len>0)
+        logger->flush = 1;
+    }
+  }
+  logger_unlock(logger);
+} /* End of logger_run()*/
+
+	/*
+		* Entry of the background thread
+		*
+		* @param p Pointer to the logger
+		*
+		* @return 0
+		*/
+#ifdef _MSC_VER /*Windows*/
+static DWORD WINAPI logger_thread(LPVOID p) {
+  logger_run((LOGGER *) p);
+  return 0;
+}
+#else /*Linux*/
+static void *logger_thread(void *p) {
+  logger_run((LOGGER *) p);
+  return NULL;
+}
+#endif
+
+	/*
+		* Open a log file and start its background thread
+		*
+		* @param name Name of the log file
+		* @param mode Mode of fopen(), "w" to start a new file or "a" to append
+		*
+		* @return Pointer to the logger, or NULL if the file could not be opened
+		*/
+LOGGER *logger_open(const char *name, const char *mode) {
+  LOGGER *logger = (LOGGER *) calloc(1, sizeof(LOGGER));
+
+  if(logger==NULL)
+    return NULL;
+
+  logger->buf[0] = (char *) malloc(2*LOGGER_BUFFER_SIZE);
+  logger->file = fopen(name, mode);
+  if(logger->buf[0]==NULL || logger->file==NULL) {
+    if(logger->file!=NULL)
+      fclose(logger->file);
+    free(logger->buf[0]);
+    free(logger);
+    return NULL;
+  }
+  logger->buf[1] = logger->buf[0] + LOGGER_BUFFER_SIZE;
+  strncpy(logger->name, name, FFD_LOG_NAME_LENGTH-1);
+
+#ifdef _MSC_VER /*Windows*/
+  InitializeCriticalSection(&logger->lock);
+  InitializeConditionVariable(&logger->cond);
+  logger->thread = CreateThread(NULL, 0, logger_thread, (LPVOID) logger, 0,
+                                NULL);
+  logger->threaded = logger->thread!=NULL;
+#else /*Linux*/
+  pthread_mutex_init(&logger->lock, NULL);
+  pthread_cond_init(&logger->cond, NULL);
+  logger->threaded = pthread_create(&logger->thread, NULL, logger_thread,
+                                    (void *) logger)==0;
+#endif
+
+  return logger;
+} /* End of logger_open()*/
+
+	/*
+		* Append a message to the log
+		*
+		* @param logger Pointer to the logger
+		* @param text Message, including the line break
+		*
+		* @return No return needed
+		*/
+void logger_write(LOGGER *logger, const char *text) {
+  int n = (int) strlen(text);
+
+  if(n>LOGGER_BUFFER_SIZE)
+    n = LOGGER_BUFFER_SIZE;
+
+  logger_lock(logger);
+  /* Without background thread, the messages are written directly*/
+  if(logger->threaded==0) {
+    if(logger->file!=NULL) {
+      fwrite(text, 1, n, logger->file);
+      fflush(logger->file);
+    }
+    logger_unlock(logger);
+    return;
+  }
+
+  while(logger->len+n>LOGGER_BUFFER_SIZE) {
+    logger->flush = 1;
+    logger_notify(logger);
+    logger_wait(logger, 0);
+  }
+  memcpy(logger->buf[logger->cur]+logger->len, text, n);
+  logger->len += n;
+  logger->nb_in += n;
+  if(logger->len>=LOGGER_BUFFER_SIZE/2)
+    logger_notify(logger);
+  logger_unlock(logger);
+} /* End of logger_write()*/
+
+	/*
+		* Write all messages of the buffer to the log file
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+void logger_flush(LOGGER *logger) {
+  unsigned long target;
+
+  logger_lock(logger);
+  if(logger->threaded==1) {
+    target = logger->nb_in;
+    /* The counters may wrap around on long runs*/
+    while((long) (target-logger->nb_out)>0) {
+      logger->flush = 1;
+      logger_notify(logger);
+      logger_wait(logger, 0);
+    }
+  }
+  logger_unlock(logger);
+} /* End of logger_flush()*/
+
+	/*
+		* Move the log to another file
+		*
+		* @param logger Pointer to the logger
+		* @param name New name of the log file
+		*
+		* @return 0 if no error occurred
+		*/
+int logger_rename(LOGGER *logger, const char *name) {
+  FILE *file;
+  int flag = 0;
+
+  logger_flush(logger);
+
+  /* The background thread does not use the file while the buffer is empty
+     and the lock is held*/
+  logger_lock(logger);
+  while(logger->nb_out!=logger->nb_in)
+    logger_wait(logger, 0);
+
+  if(logger->file!=NULL)
+    fclose(logger->file);
+  if(rename(logger->name, name)==0)
+    file = fopen(name, "a");
+  else {
+    flag = 1;
+    file = fopen(name, "w");
+  }
+
+  if(file==NULL) {
+    /* Keep writing to the old file*/
+    logger->file = fopen(logger->name, "a");
+    logger_unlock(logger);
+    return 1;
+  }
+
+  logger->file = file;
+  strncpy(logger->name, name, FFD_LOG_NAME_LENGTH-1);
+  logger_unlock(logger);
+
+  return flag;
+} /* End of logger_rename()*/
+
+	/*
+		* Write the remaining messages, stop the background thread and close the
+		* log file
+		*
+		* @param logger Pointer to the logger
+		*
+		* @return No return needed
+		*/
+void logger_close(LOGGER *logger) {
+  if(logger==NULL) return;
+
+  if(logger->threaded==1) {
+    logger_lock(logger);
+    logger->stop = 1;
+    logger_notify(logger);
+    logger_unlock(logger);
+#ifdef _MSC_VER /*Windows*/
+    WaitForSingleObject(logger->thread, INFINITE);
+    CloseHandle(logger->thread);
+#else /*Linux*/
+    pthread_join(logger->thread, NULL);
+#endif
+  }
+
+#ifdef _MSC_VER /*Windows*/
+  DeleteCriticalSection(&logger->lock);
+#else /*Linux*/
+  pthread_mutex_destroy(&logger->lock);
+  pthread_cond_destroy(&logger->cond);
+#endif
+  if(logger->file!=NULL)
+    fclose(logger->file);
+  free(logger->buf[0]);
+  free(logger);
+} /* End of logger_close()*/
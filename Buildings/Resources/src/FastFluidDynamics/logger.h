@@ -0,0 +1,109 @@
+/*
+	*
+	* @file   logger.h
+	*
+	* @brief  Buffered log file of an FFD instance
+	*
+	* @date   10/18/2026
+	*
+	* The messages are appended to a buffer in memory. A background thread
+	* writes the buffer to the log file when it is half full, once per second,
+	* or when a flush is requested. The file is kept open while the instance
+	* runs.
+	*
+	*/
+
+#ifndef _LOGGER_H
+#define _LOGGER_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _MSC_VER /*Linux*/
+#include <pthread.h>
+#endif
+
+/* Size of each of the two buffers in bytes*/
+#define LOGGER_BUFFER_SIZE 65536
+
+/* Log file with its buffers*/
+typedef struct {
+  FILE *file; /* Log file*/
+  char name[FFD_LOG_NAME_LENGTH]; /* Name of the log file*/
+  char *buf[2]; /* Buffers, one is filled while the other one is written*/
+  int cur; /* Index of the buffer that is filled*/
+  int len; /* Number of bytes in the buffer that is filled*/
+  unsigned long nb_in; /* Number of bytes appended since the file was opened*/
+  unsigned long nb_out; /* Number of bytes written since the file was opened*/
+  int flush; /* 1: Write the buffer now*/
+  int stop; /* 1: Stop the background thread*/
+  int threaded; /* 1: The buffer is written by the background thread*/
+#ifdef _MSC_VER /*Windows*/
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE cond;
+  HANDLE thread;
+#else /*Linux*/
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  pthread_t thread;
+#endif
+} LOGGER;
+
+/*
+	* Open a log file and start its background thread
+	*
+	* If the thread cannot be created, the messages are written directly.
+	*
+	* @param name Name of the log file
+	* @param mode Mode of fopen(), "w" to start a new file or "a" to append
+	*
+	* @return Pointer to the logger, or NULL if the file could not be opened
+	*/
+LOGGER *logger_open(const char *name, const char *mode);
+
+/*
+	* Append a message to the log
+	*
+	* The caller waits only if both buffers are full.
+	*
+	* @param logger Pointer to the logger
+	* @param text Message, including the line break
+	*
+	* @return No return needed
+	*/
+void logger_write(LOGGER *logger, const char *text);
+
+/*
+	* Write all messages of the buffer to the log file
+	*
+	* @param logger Pointer to the logger
+	*
+	* @return No return needed
+	*/
+void logger_flush(LOGGER *logger);
+
+/*
+	* Move the log to another file
+	*
+	* The messages that are already logged are moved with the file. If the file
+	* cannot be renamed, the log continues in a new file.
+	*
+	* @param logger Pointer to the logger
+	* @param name New name of the log file
+	*
+	* @return 0 if no error occurred
+	*/
+int logger_rename(LOGGER *logger, const char *name);
+
+/*
+	* Write the remaining messages, stop the background thread and close the
+	* log file
+	*
+	* @param logger Pointer to the logger
+	*
+	* @return No return needed
+	*/
+void logger_close(LOGGER *logger);
@@ -21,6 +21,8 @@ typedef struct {
   int nPorts; /* Number of fluid ports*/
   int nXi; /* Number of species*/
   int nC; /* Number of trace substances*/
+  int nU; /* Number of inputs from Modelica to FFD*/
+  int nY; /* Number of outputs from FFD to Modelica*/
   int sha; /* 1: have shade ; 0: no shade*/
   REAL rho_start; /* Density at initial state*/
   char *fileName; /* Name of FFD input file*/
@@ -54,6 +56,7 @@ typedef struct {
   REAL **XiPor; /* XiPor[nPorts][Medium.nXi]: species concentration of inflowing medium at the port*/
              /* First Medium.nXi elements are for port 1*/
   REAL **CPor; /* CPor[nPorts][Medium.nC]: the trace substances of the inflowing medium*/
+  REAL *u; /* u[nU]: Inputs in the order of cfdExchangeData(). The arrays above point into it*/
 }ModelicaSharedData;
 
 typedef struct {
@@ -68,12 +71,17 @@ typedef struct {
              /* First Medium.nXi elements are for port 1*/
   REAL **CPor; /* CPor[nPorts][medium.nC]: the trace substances of medium at the port*/
   REAL *senVal; /* senVal[nSen]: value of sensor data*/
+  REAL *y; /* y[nY]: Outputs in the order of cfdExchangeData(). The arrays above point into it*/
   char *msg; /* Message to be passed to Modelica*/
 }ffdSharedData;
 
 typedef struct{
   int started; /* Flag to indicate if the Co-simulation has started or not. */
+  int id; /* ID of the FFD instance. 0: first instance*/
+  void *sync; /* Lock of the flags, see cosim_sync.h*/
   ParameterSharedData *para;
-  ffdSharedData *ffd;
-  ModelicaSharedData *modelica;
+  ffdSharedData *ffd; /* Data published by FFD*/
+  ModelicaSharedData *modelica; /* Data published by Modelica*/
+  ffdSharedData *ffdBack; /* Buffer in which FFD writes its next data*/
+  ModelicaSharedData *modelicaBack; /* Buffer in which Modelica writes its next data*/
 } CosimulationData;
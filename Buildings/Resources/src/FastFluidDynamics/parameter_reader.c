@@ -14,7 +14,7 @@
 
 #include <string.h>
 #include "parameter_reader.h"
-FILE *file_para;
+FFD_THREAD_LOCAL FILE *file_para;
 
 #ifdef _WIN32
   #define DIR_SEP '\\'
@@ -22,6 +22,22 @@ FILE *file_para;
   #define DIR_SEP '/'
 #endif
 
+	/*
+		* Get the directory of the FFD parameter file
+		*
+		* The names of the other input files are relative to this directory.
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return Pointer to the directory, including the separator at the end
+		*/
+static const char *file_path(PARA_DATA *para) {
+  if(para->cosim!=NULL)
+    return para->cosim->para->filePath;
+  else
+    return para->inpu->ffd_file_path;
+} /* End of file_path()*/
+
 
 	/*
 		* Assign the FFD parameters
@@ -37,7 +53,7 @@ int assign_parameter(PARA_DATA *para, char *string) {
   /* tmp2 needs to be initialized to avoid crash*/
   /* when the input for tmp2 is empty*/
   char tmp2[100] = "";
-  static int senId = -1;
+  static FFD_THREAD_LOCAL int senId = -1;
 
 
   /****************************************************************************
@@ -161,6 +177,63 @@ int assign_parameter(PARA_DATA *para, char *string) {
     }
     ffd_log(msg, FFD_NORMAL);
   }
+  else if(!strcmp(tmp, "outp.log_level")) {
+    sscanf(string, "%s%s", tmp, tmp2);
+    sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
+    if(!strcmp(tmp2, "NORMAL"))
+      para->outp->log_level = LOG_NORMAL;
+    else if(!strcmp(tmp2, "WARNING"))
+      para->outp->log_level = LOG_WARNING;
+    else if(!strcmp(tmp2, "ERROR"))
+      para->outp->log_level = LOG_ERROR;
+    else {
+      sprintf(msg, "assign_parameter(): %s is not valid input for %s", tmp2, tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "outp.log_step")) {
+    sscanf(string, "%s%d", tmp, &para->outp->log_step);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->outp->log_step);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "outp.log_file_name")) {
+    sscanf(string, "%s%s", tmp, tmp_par);
+    sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp_par);
+    ffd_log(msg, FFD_NORMAL);
+    if(ffd_log_rename(tmp_par)!=0) {
+      sprintf(msg, "assign_parameter(): Could not move the log to %s", tmp_par);
+      ffd_log(msg, FFD_WARNING);
+    }
+  }
+  else if(!strcmp(tmp, "outp.checkpoint")) {
+    sscanf(string, "%s%d", tmp, &para->outp->checkpoint);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->outp->checkpoint);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "outp.transient_format")) {
+    sscanf(string, "%s%s", tmp, tmp2);
+    sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
+    if(!strcmp(tmp2, "VTK"))
+      para->outp->transient_format = VTK;
+    else {
+      sprintf(msg, "assign_parameter(): %s is not valid input for %s", tmp2, tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "outp.transient_step")) {
+    sscanf(string, "%s%d", tmp, &para->outp->transient_step);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->outp->transient_step);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "outp.profile")) {
+    sscanf(string, "%s%d", tmp, &para->outp->profile);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->outp->profile);
+    ffd_log(msg, FFD_NORMAL);
+  }
   else if(!strcmp(tmp, "inpu.parameter_file_format")) {
     sscanf(string, "%s%s", tmp, tmp2);
     sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
@@ -175,16 +248,21 @@ int assign_parameter(PARA_DATA *para, char *string) {
   }
   else if(!strcmp(tmp, "inpu.parameter_file_name")) {
     sscanf(string, "%s%s", tmp, tmp_par);
-    sprintf (para->inpu->parameter_file_name, "%s%s", para->cosim->para->filePath, tmp_par);
+    sprintf (para->inpu->parameter_file_name, "%s%s", file_path(para), tmp_par);
     sprintf(msg, "assign_parameter(): %s=%s", tmp, para->inpu->parameter_file_name);
     ffd_log(msg, FFD_NORMAL);
   }
   else if(!strcmp(tmp, "inpu.block_file_name")) {
     sscanf(string, "%s%s", tmp, tmp_par);
-    sprintf (para->inpu->block_file_name, "%s%s", para->cosim->para->filePath, tmp_par);
+    sprintf (para->inpu->block_file_name, "%s%s", file_path(para), tmp_par);
     sprintf(msg, "assign_parameter(): %s=%s", tmp, para->inpu->block_file_name);
     ffd_log(msg, FFD_NORMAL);
   }
+  else if(!strcmp(tmp, "inpu.sci_cache")) {
+    sscanf(string, "%s%d", tmp, &para->inpu->sci_cache);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->inpu->sci_cache);
+    ffd_log(msg, FFD_NORMAL);
+  }
   else if(!strcmp(tmp, "inpu.read_old_ffd_file")) {
     sscanf(string, "%s%d", tmp, &para->inpu->read_old_ffd_file);
     sprintf(msg, "assign_parameter(): %s=%d", tmp, para->inpu->read_old_ffd_file);
@@ -195,6 +273,20 @@ int assign_parameter(PARA_DATA *para, char *string) {
     sprintf(msg, "assign_parameter(): %s=%s", tmp, para->inpu->old_ffd_file_name);
     ffd_log(msg, FFD_NORMAL);
   }
+  else if(!strcmp(tmp, "inpu.old_ffd_file_format")) {
+    sscanf(string, "%s%s", tmp, tmp2);
+    sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
+    if(!strcmp(tmp2, "FFD"))
+      para->inpu->old_ffd_file_format = FFD;
+    else if(!strcmp(tmp2, "BINARY"))
+      para->inpu->old_ffd_file_format = BINARY;
+    else {
+      sprintf(msg, "assign_parameter(): %s is not valid input for %s", tmp2, tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
   else if(!strcmp(tmp, "prob.nu")) {
     sscanf(string, "%s%lf", tmp, &para->prob->nu);
     sprintf(msg, "assign_parameter(): %s=%f", tmp, para->prob->nu);
@@ -296,6 +388,31 @@ int assign_parameter(PARA_DATA *para, char *string) {
     sprintf(msg, "assign_parameter(): %s=%f", tmp, para->mytime->t_steady);
     ffd_log(msg, FFD_NORMAL);
   }
+  else if(!strcmp(tmp, "mytime.adaptive")) {
+    sscanf(string, "%s%d", tmp, &para->mytime->adaptive);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->mytime->adaptive);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "mytime.cfl")) {
+    sscanf(string, "%s%lf", tmp, &para->mytime->cfl);
+    sprintf(msg, "assign_parameter(): %s=%f", tmp, para->mytime->cfl);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "mytime.dT_step")) {
+    sscanf(string, "%s%lf", tmp, &para->mytime->dT_step);
+    sprintf(msg, "assign_parameter(): %s=%f", tmp, para->mytime->dT_step);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "mytime.dt_min")) {
+    sscanf(string, "%s%lf", tmp, &para->mytime->dt_min);
+    sprintf(msg, "assign_parameter(): %s=%f", tmp, para->mytime->dt_min);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "mytime.dt_max")) {
+    sscanf(string, "%s%lf", tmp, &para->mytime->dt_max);
+    sprintf(msg, "assign_parameter(): %s=%f", tmp, para->mytime->dt_max);
+    ffd_log(msg, FFD_NORMAL);
+  }
   else if(!strcmp(tmp, "solv.solver")) {
     sscanf(string, "%s%s", tmp, tmp2);
     sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
@@ -303,6 +420,31 @@ int assign_parameter(PARA_DATA *para, char *string) {
       para->solv->solver = GS;
     else if(!strcmp(tmp2, "TDMA"))
       para->solv->solver = TDMA;
+    else if(!strcmp(tmp2, "RBGS"))
+      para->solv->solver = RBGS;
+    else if(!strcmp(tmp2, "MG"))
+      para->solv->solver = MG;
+    else if(!strcmp(tmp2, "PCG"))
+      para->solv->solver = PCG;
+    else {
+      sprintf(msg, "assign_parameter(): %s is not valid input for %s", tmp2, tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.nb_thread")) {
+    sscanf(string, "%s%d", tmp, &para->solv->nb_thread);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->nb_thread);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.mg_cycle")) {
+    sscanf(string, "%s%s", tmp, tmp2);
+    sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
+    if(!strcmp(tmp2, "V"))
+      para->solv->mg_cycle = V_CYCLE;
+    else if(!strcmp(tmp2, "W"))
+      para->solv->mg_cycle = W_CYCLE;
     else {
       sprintf(msg, "assign_parameter(): %s is not valid input for %s", tmp2, tmp);
       ffd_log(msg, FFD_ERROR);
@@ -310,6 +452,110 @@ int assign_parameter(PARA_DATA *para, char *string) {
     }
     ffd_log(msg, FFD_NORMAL);
   }
+  else if(!strcmp(tmp, "solv.pcg_precond")) {
+    sscanf(string, "%s%s", tmp, tmp2);
+    sprintf(msg, "assign_parameter(): %s=%s", tmp, tmp2);
+    if(!strcmp(tmp2, "JACOBI"))
+      para->solv->pcg_precond = JACOBI;
+    else if(!strcmp(tmp2, "IC"))
+      para->solv->pcg_precond = IC;
+    else {
+      sprintf(msg, "assign_parameter(): %s is not valid input for %s", tmp2, tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.p_tol")) {
+    sscanf(string, "%s%lf", tmp, &para->solv->p_tol);
+    sprintf(msg, "assign_parameter(): %s=%e", tmp, para->solv->p_tol);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.p_it_max")) {
+    sscanf(string, "%s%d", tmp, &para->solv->p_it_max);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->p_it_max);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.tol")) {
+    sscanf(string, "%s%lf", tmp, &para->solv->tol);
+    sprintf(msg, "assign_parameter(): %s=%e", tmp, para->solv->tol);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.it_max")) {
+    sscanf(string, "%s%d", tmp, &para->solv->it_max);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->it_max);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_tol_p")) {
+    sscanf(string, "%s%lf", tmp, &para->solv->gs_tol[EQU_PRESSURE]);
+    sprintf(msg, "assign_parameter(): %s=%e", tmp, para->solv->gs_tol[EQU_PRESSURE]);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_tol_vel")) {
+    sscanf(string, "%s%lf", tmp, &para->solv->gs_tol[EQU_VELOCITY]);
+    sprintf(msg, "assign_parameter(): %s=%e", tmp, para->solv->gs_tol[EQU_VELOCITY]);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_tol_T")) {
+    sscanf(string, "%s%lf", tmp, &para->solv->gs_tol[EQU_TEMPERATURE]);
+    sprintf(msg, "assign_parameter(): %s=%e", tmp, para->solv->gs_tol[EQU_TEMPERATURE]);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_tol_species")) {
+    sscanf(string, "%s%lf", tmp, &para->solv->gs_tol[EQU_SPECIES]);
+    sprintf(msg, "assign_parameter(): %s=%e", tmp, para->solv->gs_tol[EQU_SPECIES]);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_it_max_p")) {
+    sscanf(string, "%s%d", tmp, &para->solv->gs_it_max[EQU_PRESSURE]);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->gs_it_max[EQU_PRESSURE]);
+    if(para->solv->gs_it_max[EQU_PRESSURE]<1) {
+      sprintf(msg, "assign_parameter(): %s must be at least 1", tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_it_max_vel")) {
+    sscanf(string, "%s%d", tmp, &para->solv->gs_it_max[EQU_VELOCITY]);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->gs_it_max[EQU_VELOCITY]);
+    if(para->solv->gs_it_max[EQU_VELOCITY]<1) {
+      sprintf(msg, "assign_parameter(): %s must be at least 1", tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_it_max_T")) {
+    sscanf(string, "%s%d", tmp, &para->solv->gs_it_max[EQU_TEMPERATURE]);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->gs_it_max[EQU_TEMPERATURE]);
+    if(para->solv->gs_it_max[EQU_TEMPERATURE]<1) {
+      sprintf(msg, "assign_parameter(): %s must be at least 1", tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_it_max_species")) {
+    sscanf(string, "%s%d", tmp, &para->solv->gs_it_max[EQU_SPECIES]);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->gs_it_max[EQU_SPECIES]);
+    if(para->solv->gs_it_max[EQU_SPECIES]<1) {
+      sprintf(msg, "assign_parameter(): %s must be at least 1", tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
+  else if(!strcmp(tmp, "solv.gs_check")) {
+    sscanf(string, "%s%d", tmp, &para->solv->gs_check);
+    sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->gs_check);
+    if(para->solv->gs_check<1) {
+      sprintf(msg, "assign_parameter(): %s must be at least 1", tmp);
+      ffd_log(msg, FFD_ERROR);
+      return 1;
+    }
+    ffd_log(msg, FFD_NORMAL);
+  }
   else if(!strcmp(tmp, "solv.check_residual")) {
     sscanf(string, "%s%d", tmp, &para->solv->check_residual);
     sprintf(msg, "assign_parameter(): %s=%d", tmp, para->solv->check_residual);
@@ -488,6 +734,7 @@ int assign_parameter(PARA_DATA *para, char *string) {
 		*/
 int read_parameter(PARA_DATA *para) {
   char string[400];
+  char *file_name, *last_slash;
 
   /****************************************************************************
   | Open the FFD parameter file
@@ -496,14 +743,27 @@ int read_parameter(PARA_DATA *para) {
   | Stand alone simulation
   ---------------------------------------------------------------------------*/
   if(para->solv->cosimulation==0) {
-    if((file_para=fopen("input.ffd","r"))==NULL) {
+    /* The default is input.ffd in the current directory*/
+    file_name = para->inpu->ffd_file_name;
+    if(file_name[0]=='\0')
+      strcpy(file_name, "input.ffd");
+
+    if((file_para=fopen(file_name,"r"))==NULL) {
       sprintf(msg, "read_parameter(): "
-                   "Could not open the default FFD parameter file input.ffd");
+                   "Could not open the FFD parameter file %s", file_name);
       ffd_log(msg, FFD_ERROR);
       return 1;
     }
     else {
-      sprintf(msg, "read_parameter(): Opened input.ffd for FFD parameters");
+      /* The other input files are relative to the directory of the file*/
+      last_slash = strrchr(file_name, DIR_SEP);
+      if(last_slash==NULL)
+        para->inpu->ffd_file_path[0] = '\0';
+      else {
+        strncpy(para->inpu->ffd_file_path, file_name, last_slash-file_name+1);
+        para->inpu->ffd_file_path[last_slash-file_name+1] = '\0';
+      }
+      sprintf(msg, "read_parameter(): Opened %s for FFD parameters", file_name);
       ffd_log(msg, FFD_NORMAL);
     }
   }
@@ -511,6 +771,7 @@ int read_parameter(PARA_DATA *para) {
   | Co-simulation
   ---------------------------------------------------------------------------*/
   else {
+    file_name = para->cosim->para->fileName;
     if((file_para=fopen(para->cosim->para->fileName,"r"))==NULL) {
       sprintf(msg, "read_parameter(): Could not open the FFD parameter file \"%s\"",
               para->cosim->para->fileName == NULL ? "(null)" : para->cosim->para->fileName);
@@ -553,7 +814,7 @@ int read_parameter(PARA_DATA *para) {
   while(fgets(string, 400, file_para) != NULL) {
     if(assign_parameter(para, string)) {
       sprintf(msg, "read_parameter(): Could not read data from file %s",
-            para->cosim->para->fileName);
+            file_name);
       ffd_log(msg, FFD_ERROR);
       return 1;
     }
@@ -564,7 +825,7 @@ int read_parameter(PARA_DATA *para) {
   /*Do not use feof() as condition of while loop. It will read one more time after last line.*/
   if (!feof(file_para)){
       sprintf(msg, "read_parameter(): Could not read data from file %s",
-            para->cosim->para->fileName);
+            file_name);
       ffd_log(msg, FFD_ERROR);
   }
 
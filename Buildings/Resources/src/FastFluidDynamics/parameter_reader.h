@@ -23,7 +23,7 @@
 
 #include "utility.h"
 
-extern FILE *file_para;
+extern FFD_THREAD_LOCAL FILE *file_para;
 
 /*
 	* Assign the FFD parameters
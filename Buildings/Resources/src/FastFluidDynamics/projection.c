@@ -32,37 +32,30 @@ int project(PARA_DATA *para, REAL **var, int **BINDEX) {
   int kmax = para->geom->kmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
   REAL dt= para->mytime->dt;
-  REAL *x = var[X], *y = var[Y], *z = var[Z];
-  REAL *gx = var[GX], *gy = var[GY], *gz = var[GZ];
   REAL *u = var[VX], *v = var[VY], *w = var[VZ];
   REAL *p = var[IP], *b = var[B], *ap = var[AP], *ab = var[AB], *af = var[AF];
   REAL *ae = var[AE], *aw =var[AW], *an = var[AN], *as = var[AS];
-  REAL dxe,dxw, dyn,dys,dzf,dzb,Dx,Dy,Dz;
+  METRIC_DATA *m = para->geom->metric;
+  REAL Dx, Dy, Dz;
   REAL *flagu = var[FLAGU],*flagv = var[FLAGV],*flagw = var[FLAGW];
 
   /****************************************************************************
   | Calculate all coefficients
   ****************************************************************************/
   FOR_EACH_CELL
-    dxe =  x[IX(i+1,j,  k)]   -  x[IX(i,  j,  k)];
-    dxw =  x[IX(i,  j,  k)]   -  x[IX(i-1,j,  k)];
-    dyn =  y[IX(i,  j+1,k)]   -  y[IX(i,  j,  k)];
-    dys =  y[IX(i,  j,  k)]   -  y[IX(i,  j-1,k)];
-    dzf =  z[IX(i,  j,  k+1)] -  z[IX(i,  j,  k)];
-    dzb =  z[IX(i,  j,  k)]   -  z[IX(i,  j,  k-1)];
-    Dx  = gx[IX(i,  j,  k)]   - gx[IX(i-1,j,  k)];
-    Dy  = gy[IX(i,  j,  k)]   - gy[IX(i,  j-1,k)];
-    Dz  = gz[IX(i,  j,  k)]   - gz[IX(i,  j,  k-1)];
+    Dx = m->dx[i];
+    Dy = m->dy[j];
+    Dz = m->dz[k];
 
-    ae[IX(i,j,k)] = Dy*Dz/dxe;
-    aw[IX(i,j,k)] = Dy*Dz/dxw;
-    an[IX(i,j,k)] = Dx*Dz/dyn;
-    as[IX(i,j,k)] = Dx*Dz/dys;
-    af[IX(i,j,k)] = Dx*Dy/dzf;
-    ab[IX(i,j,k)] = Dx*Dy/dzb;
-    b[IX(i,j,k)] = Dx*Dy*Dz/dt*((u[IX(i-1,j,k)]-u[IX(i,j,k)])/Dx
-                 + (v[IX(i,j-1,k)]-v[IX(i,j,k)])/Dy
-                 + (w[IX(i,j,k-1)]-w[IX(i,j,k)])/Dz);
+    ae[IX(i,j,k)] = Dy*Dz*m->rdxc[i];
+    aw[IX(i,j,k)] = Dy*Dz*m->rdxc[i-1];
+    an[IX(i,j,k)] = Dx*Dz*m->rdyc[j];
+    as[IX(i,j,k)] = Dx*Dz*m->rdyc[j-1];
+    af[IX(i,j,k)] = Dx*Dy*m->rdzc[k];
+    ab[IX(i,j,k)] = Dx*Dy*m->rdzc[k-1];
+    b[IX(i,j,k)] = ((u[IX(i-1,j,k)]-u[IX(i,j,k)])*Dy*Dz
+                 + (v[IX(i,j-1,k)]-v[IX(i,j,k)])*Dx*Dz
+                 + (w[IX(i,j,k-1)]-w[IX(i,j,k)])*Dx*Dy) / dt;
   END_FOR
 
   /****************************************************************************
@@ -75,7 +68,20 @@ int project(PARA_DATA *para, REAL **var, int **BINDEX) {
                   + af[IX(i,j,k)] + ab[IX(i,j,k)];
   END_FOR
 
-  GS_P(para, var, IP, p);
+  phase_start(para, PHASE_EQUATION);
+  if(para->solv->solver==RBGS)
+    RBGS_P(para, var, IP, p);
+  else if(para->solv->solver==MG) {
+    balance_pressure(para, var);
+    MG_P(para, var, IP, p);
+  }
+  else if(para->solv->solver==PCG) {
+    balance_pressure(para, var);
+    PCG_P(para, var, IP, p);
+  }
+  else
+    GS_P(para, var, IP, p);
+  phase_end(para, PHASE_EQUATION);
   set_bnd_pressure(para, var, p,BINDEX);
 
   /****************************************************************************
@@ -83,18 +89,70 @@ int project(PARA_DATA *para, REAL **var, int **BINDEX) {
   ****************************************************************************/
   FOR_U_CELL
     if (flagu[IX(i,j,k)]>=0) continue;
-    u[IX(i,j,k)] -= dt*(p[IX(i+1,j,k)]-p[IX(i,j,k)]) / (x[IX(i+1,j,k)]-x[IX(i,j,k)]);
+    u[IX(i,j,k)] -= dt*(p[IX(i+1,j,k)]-p[IX(i,j,k)]) * m->rdxc[i];
   END_FOR
 
   FOR_V_CELL
     if (flagv[IX(i,j,k)]>=0) continue;
-    v[IX(i,j,k)] -= dt*(p[IX(i,j+1,k)]-p[IX(i,j,k)]) / (y[IX(i,j+1,k)]-y[IX(i,j,k)]);
+    v[IX(i,j,k)] -= dt*(p[IX(i,j+1,k)]-p[IX(i,j,k)]) * m->rdyc[j];
   END_FOR
 
   FOR_W_CELL
     if (flagw[IX(i,j,k)]>=0) continue;
-    w[IX(i,j,k)] -= dt*(p[IX(i,j,k+1)]-p[IX(i,j,k)]) / (z[IX(i,j,k+1)]-z[IX(i,j,k)]);
+    w[IX(i,j,k)] -= dt*(p[IX(i,j,k+1)]-p[IX(i,j,k)]) * m->rdzc[k];
   END_FOR
 
   return 0;
 } /* End of project( )*/
+
+/*
+	* Remove the imbalance of the right hand side of the pressure equation
+	*
+	* set_bnd_pressure() decouples the fluid cells from all boundaries.
+	* The equations are then singular and only have a solution if the
+	* right hand side sums up to zero. Otherwise the residual of a solver
+	* that iterates to a tolerance stagnates and the pressure drifts.
+	* The imbalance is spread evenly over the fluid cells. It does not change
+	* the velocity correction, and mass_conservation() corrects the outflow
+	* afterwards.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return No return needed
+	*/
+void balance_pressure(PARA_DATA *para, REAL **var) {
+  int i, j, k, nb_fluid = 0;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  REAL *ap = var[AP], *ae = var[AE], *aw = var[AW], *an = var[AN];
+  REAL *as = var[AS], *af = var[AF], *ab = var[AB], *b = var[B];
+  REAL *flagp = var[FLAGP];
+  REAL sum = 0, tmp;
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flagp[IX(i,j,k)]>=0) continue;
+        /* A coupling to a fixed value makes the equations regular*/
+        tmp = ap[IX(i,j,k)];
+        if(flagp[IX(i+1,j,k)]<0) tmp -= ae[IX(i,j,k)];
+        if(flagp[IX(i-1,j,k)]<0) tmp -= aw[IX(i,j,k)];
+        if(flagp[IX(i,j+1,k)]<0) tmp -= an[IX(i,j,k)];
+        if(flagp[IX(i,j-1,k)]<0) tmp -= as[IX(i,j,k)];
+        if(flagp[IX(i,j,k+1)]<0) tmp -= af[IX(i,j,k)];
+        if(flagp[IX(i,j,k-1)]<0) tmp -= ab[IX(i,j,k)];
+        if(fabs(tmp)>1e-10*ap[IX(i,j,k)]) return;
+        sum += b[IX(i,j,k)];
+        nb_fluid++;
+      }
+
+  if(nb_fluid==0) return;
+  sum /= nb_fluid;
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++)
+        if(flagp[IX(i,j,k)]<0) b[IX(i,j,k)] -= sum;
+} /* End of balance_pressure()*/
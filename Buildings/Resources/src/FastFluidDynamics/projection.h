@@ -28,6 +28,21 @@
 #include "solver_gs.h"
 #endif
 
+#ifndef _SOLVER_RBGS_H
+#define _SOLVER_RBGS_H
+#include "solver_rbgs.h"
+#endif
+
+#ifndef _SOLVER_MG_H
+#define _SOLVER_MG_H
+#include "solver_mg.h"
+#endif
+
+#ifndef _SOLVER_PCG_H
+#define _SOLVER_PCG_H
+#include "solver_pcg.h"
+#endif
+
 #ifndef _SOLVER_TDMA_H
 #define _SOLVER_TDMA_H
 #include "solver_tdma.h"
@@ -53,3 +68,13 @@
 	* @return 0 if no error occurred
 	*/
 int project(PARA_DATA *para, REAL **var, int **BINDEX);
+
+/*
+	* Remove the imbalance of the right hand side of the pressure equation
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return No return needed
+	*/
+void balance_pressure(PARA_DATA *para, REAL **var);
@@ -0,0 +1,660 @@
+/*
+	*
+	* \file   sci_cache.c
+	*
+	* \brief  Binary cache of the geometry defined by SCI
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+/* getpid() and stat() are not declared in strict C89 mode*/
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "sci_cache.h"
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _MSC_VER /*Windows*/
+#include <process.h>
+#else /*Linux*/
+#include <unistd.h>
+#endif
+
+/* Magic number at the beginning of a cache file*/
+static const char cache_magic[8] = {'F','F','D','S','C','I','C','H'};
+
+#define SCI_CACHE_VERSION 1
+
+/* Variables with boundary values in the cells of BINDEX*/
+static const int cache_bc_var[] = {TEMPBC, QFLUXBC, VXBC, VYBC, VZBC, Xi1BC};
+
+#define CACHE_NB_BC_VAR (int) (sizeof(cache_bc_var)/sizeof(cache_bc_var[0]))
+
+/* Flags of the cells*/
+static const int cache_flag_var[] = {FLAGP, FLAGU, FLAGV, FLAGW};
+
+#define CACHE_NB_FLAG_VAR (int) (sizeof(cache_flag_var)/sizeof(cache_flag_var[0]))
+
+/* Signature of a source file*/
+typedef struct {
+  long size; /* Size in bytes*/
+  long mtime; /* Time of the last modification*/
+  unsigned long hash[2]; /* FNV-1a and sdbm hash of the content*/
+} SOURCE_SIGNATURE;
+
+/* Fixed part at the beginning of a cache file*/
+typedef struct {
+  char magic[8]; /* cache_magic*/
+  int head_size; /* Size of CACHE_HEAD*/
+  int version; /* SCI_CACHE_VERSION*/
+  int real_size; /* Size of REAL*/
+  long byte_order; /* 0x01020304 in the byte order of the writer*/
+  long written; /* Time when the cache was written*/
+  SOURCE_SIGNATURE source[2]; /* Parameter file and block file*/
+  long payload_size; /* Size of the payload in bytes*/
+  unsigned long payload_hash[2]; /* Hash of the payload*/
+} CACHE_HEAD;
+
+/* Payload that is read*/
+typedef struct {
+  unsigned char *p; /* Next byte*/
+  long left; /* Number of bytes left*/
+} CURSOR;
+
+/* Payload that is written*/
+typedef struct {
+  unsigned char *data; /* Bytes, NULL if the size is only measured*/
+  long size; /* Number of bytes*/
+} BUFFER;
+
+	/*
+		* Update the hashes with a block of bytes
+		*
+		* The first hash is the 32 bit FNV-1a hash, the second one the sdbm
+		* hash. hash[0] must start with 2166136261 and hash[1] with 0.
+		*
+		* @param hash Pointer to the two hashes
+		* @param p Pointer to the bytes
+		* @param n Number of bytes
+		*
+		* @return No return needed
+		*/
+static void hash_bytes(unsigned long *hash, const unsigned char *p, long n) {
+  long i;
+
+  for(i=0; i<n; i++) {
+    hash[0] = ((hash[0]^p[i])*16777619UL) & 0xFFFFFFFFUL;
+    hash[1] = (p[i] + (hash[1]<<6) + (hash[1]<<16) - hash[1]) & 0xFFFFFFFFUL;
+  }
+} /* End of hash_bytes()*/
+
+	/*
+		* Compute the hashes of the content of a file
+		*
+		* @param name Pointer to the file name
+		* @param hash Pointer to the two hashes
+		*
+		* @return 0 if no error occurred
+		*/
+static int hash_file(char *name, unsigned long *hash) {
+  unsigned char block[8192];
+  size_t n;
+  FILE *file;
+
+  file = fopen(name, "rb");
+  if(file==NULL) return 1;
+
+  hash[0] = 2166136261UL;
+  hash[1] = 0;
+  while((n=fread(block, 1, sizeof(block), file))>0)
+    hash_bytes(hash, block, (long) n);
+
+  if(ferror(file)) {
+    fclose(file);
+    return 1;
+  }
+  fclose(file);
+  return 0;
+} /* End of hash_file()*/
+
+	/*
+		* Get the size and the modification time of a file
+		*
+		* @param name Pointer to the file name
+		* @param size Pointer to the size in bytes
+		* @param mtime Pointer to the modification time
+		*
+		* @return 0 if no error occurred
+		*/
+static int file_status(char *name, long *size, long *mtime) {
+#ifdef _MSC_VER /*Windows*/
+  struct _stat st;
+
+  if(_stat(name, &st)!=0) return 1;
+#else /*Linux*/
+  struct stat st;
+
+  if(stat(name, &st)!=0) return 1;
+#endif
+  *size = (long) st.st_size;
+  *mtime = (long) st.st_mtime;
+  return 0;
+} /* End of file_status()*/
+
+	/*
+		* Get the signature of a source file
+		*
+		* @param name Pointer to the file name
+		* @param sig Pointer to the signature
+		*
+		* @return 0 if no error occurred
+		*/
+static int file_signature(char *name, SOURCE_SIGNATURE *sig) {
+  if(file_status(name, &sig->size, &sig->mtime)!=0) return 1;
+  return hash_file(name, sig->hash);
+} /* End of file_signature()*/
+
+	/*
+		* Check if a source file is unchanged since the cache was written
+		*
+		* The content is only hashed if the modification time differs, or if
+		* it is not older than the cache, since the file may have been changed
+		* in the same second as the cache was written.
+		*
+		* @param name Pointer to the file name
+		* @param sig Pointer to the signature stored in the cache
+		* @param written Time when the cache was written
+		*
+		* @return 1 if the file is unchanged, 0 otherwise
+		*/
+static int source_unchanged(char *name, SOURCE_SIGNATURE *sig, long written) {
+  long size, mtime;
+  unsigned long hash[2];
+
+  if(file_status(name, &size, &mtime)!=0 || size!=sig->size) return 0;
+  if(mtime==sig->mtime && mtime<written) return 1;
+  if(hash_file(name, hash)!=0) return 0;
+
+  return hash[0]==sig->hash[0] && hash[1]==sig->hash[1];
+} /* End of source_unchanged()*/
+
+	/*
+		* Get the name of the cache file
+		*
+		* @param para Pointer to FFD parameters
+		* @param name Pointer to the name, at least 1100 characters
+		*
+		* @return No return needed
+		*/
+static void cache_file_name(PARA_DATA *para, char *name) {
+  sprintf(name, "%s.cache", para->inpu->parameter_file_name);
+} /* End of cache_file_name()*/
+
+	/*
+		* Take bytes from the payload
+		*
+		* @param c Pointer to the cursor
+		* @param dst Pointer to the destination, NULL to skip the bytes
+		* @param n Number of bytes
+		*
+		* @return 0 if the payload has n more bytes
+		*/
+static int take(CURSOR *c, void *dst, long n) {
+  if(n<0 || n>c->left) return 1;
+  if(dst!=NULL) memcpy(dst, c->p, (size_t) n);
+  c->p += n;
+  c->left -= n;
+  return 0;
+} /* End of take()*/
+
+	/*
+		* Append bytes to the payload
+		*
+		* @param buf Pointer to the buffer
+		* @param src Pointer to the bytes
+		* @param n Number of bytes
+		*
+		* @return No return needed
+		*/
+static void put(BUFFER *buf, const void *src, long n) {
+  if(buf->data!=NULL) memcpy(buf->data+buf->size, src, (size_t) n);
+  buf->size += n;
+} /* End of put()*/
+
+	/*
+		* Write the geometry to the payload
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param BINDEX Pointer to boundary index
+		* @param buf Pointer to the buffer
+		*
+		* @return No return needed
+		*/
+static void store_payload(PARA_DATA *para, REAL **var, int **BINDEX,
+                          BUFFER *buf) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int size = (imax+2)*(jmax+2)*(kmax+2);
+  int index = para->geom->index;
+  int dim[3], nb[7], len, i, n, m, r;
+  REAL L[3];
+  char **name[4];
+  signed char flag;
+
+  dim[0] = imax;
+  dim[1] = jmax;
+  dim[2] = kmax;
+  L[0] = para->geom->Lx;
+  L[1] = para->geom->Ly;
+  L[2] = para->geom->Lz;
+  put(buf, dim, 3*sizeof(int));
+  put(buf, L, 3*sizeof(REAL));
+
+  /* The surfaces are the same in all rows of GX, GY and GZ*/
+  for(i=0; i<=imax+1; i++) put(buf, &var[GX][IX(i,0,0)], sizeof(REAL));
+  for(i=0; i<=jmax+1; i++) put(buf, &var[GY][IX(0,i,0)], sizeof(REAL));
+  for(i=0; i<=kmax+1; i++) put(buf, &var[GZ][IX(0,0,i)], sizeof(REAL));
+
+  nb[0] = para->bc->nb_bc;
+  nb[1] = para->bc->nb_inlet;
+  nb[2] = para->bc->nb_outlet;
+  nb[3] = para->bc->nb_block;
+  nb[4] = para->bc->nb_wall;
+  nb[5] = para->bc->nb_source;
+  nb[6] = index;
+  put(buf, nb, 7*sizeof(int));
+  put(buf, &para->mytime->step_total, sizeof(int));
+  put(buf, &para->mytime->t_start, sizeof(double));
+  put(buf, &para->mytime->dt, sizeof(double));
+
+  name[0] = para->bc->inletName;
+  name[1] = para->bc->outletName;
+  name[2] = para->bc->blockName;
+  name[3] = para->bc->wallName;
+  for(n=0; n<4; n++)
+    for(m=0; m<nb[n+1]; m++) {
+      len = (int) strlen(name[n][m]);
+      put(buf, &len, sizeof(int));
+      put(buf, name[n][m], len);
+    }
+
+  for(r=0; r<5; r++)
+    put(buf, BINDEX[r], (long) index*sizeof(int));
+
+  for(n=0; n<CACHE_NB_BC_VAR; n++)
+    for(m=0; m<index; m++)
+      put(buf, &var[cache_bc_var[n]][IX(BINDEX[0][m],BINDEX[1][m],BINDEX[2][m])],
+          sizeof(REAL));
+
+  for(n=0; n<CACHE_NB_FLAG_VAR; n++)
+    for(m=0; m<size; m++) {
+      flag = (signed char) var[cache_flag_var[n]][m];
+      put(buf, &flag, 1);
+    }
+} /* End of store_payload()*/
+
+	/*
+		* Read the geometry from the payload
+		*
+		* The payload is read twice. The first pass only checks that it
+		* matches the mesh and that it is complete, so that nothing is changed
+		* if the cache cannot be used. The second pass sets the data.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param BINDEX Pointer to boundary index
+		* @param c Cursor at the beginning of the payload
+		* @param apply 0: check the payload; 1: set the data
+		*
+		* @return 0 if no error occurred, 1 if the payload does not fit,
+		*         -1 if memory could not be allocated
+		*/
+static int load_payload(PARA_DATA *para, REAL **var, int **BINDEX, CURSOR c,
+                        int apply) {
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int size = (imax+2)*(jmax+2)*(kmax+2);
+  int dim[3], nb[7], step_total, len, n, m, r;
+  REAL L[3], value;
+  double t[2];
+  REAL *surf = NULL;
+  char **list;
+  char ***name[4];
+  signed char flag;
+
+  /****************************************************************************
+  | Mesh
+  ****************************************************************************/
+  if(take(&c, dim, 3*sizeof(int))!=0 || take(&c, L, 3*sizeof(REAL))!=0)
+    return 1;
+  if(dim[0]!=imax || dim[1]!=jmax || dim[2]!=kmax || L[0]!=para->geom->Lx
+     || L[1]!=para->geom->Ly || L[2]!=para->geom->Lz)
+    return 1;
+
+  if(apply) {
+    surf = (REAL *) malloc((imax+jmax+kmax+6)*sizeof(REAL));
+    if(surf==NULL) return -1;
+  }
+  if(take(&c, surf, (long) (imax+jmax+kmax+6)*sizeof(REAL))!=0) {
+    free(surf);
+    return 1;
+  }
+  if(apply) {
+    set_sci_coordinates(para, var, surf, surf+imax+2, surf+imax+jmax+4);
+    free(surf);
+  }
+
+  /****************************************************************************
+  | Numbers of boundaries and time settings
+  ****************************************************************************/
+  if(take(&c, nb, 7*sizeof(int))!=0 || take(&c, &step_total, sizeof(int))!=0
+     || take(&c, t, 2*sizeof(double))!=0)
+    return 1;
+  for(n=0; n<7; n++)
+    if(nb[n]<0) return 1;
+  if(nb[6]>size) return 1;
+
+  if(apply) {
+    para->bc->nb_bc = nb[0];
+    para->bc->nb_inlet = nb[1];
+    para->bc->nb_outlet = nb[2];
+    para->bc->nb_block = nb[3];
+    para->bc->nb_wall = nb[4];
+    para->bc->nb_source = nb[5];
+    para->geom->index = nb[6];
+    para->mytime->step_total = step_total;
+    para->mytime->t_start = t[0];
+    para->mytime->dt = t[1];
+  }
+
+  /****************************************************************************
+  | Names of the boundaries
+  ****************************************************************************/
+  name[0] = &para->bc->inletName;
+  name[1] = &para->bc->outletName;
+  name[2] = &para->bc->blockName;
+  name[3] = &para->bc->wallName;
+  for(n=0; n<4; n++) {
+    list = NULL;
+    if(apply && nb[n+1]>0) {
+      list = (char **) malloc(nb[n+1]*sizeof(char *));
+      if(list==NULL) return -1;
+      *name[n] = list;
+    }
+    for(m=0; m<nb[n+1]; m++) {
+      if(take(&c, &len, sizeof(int))!=0 || len<0 || len>c.left) return 1;
+      if(apply) {
+        list[m] = (char *) malloc((len+1)*sizeof(char));
+        if(list[m]==NULL) return -1;
+        take(&c, list[m], len);
+        list[m][len] = '\0';
+      }
+      else
+        take(&c, NULL, len);
+    }
+  }
+
+  if(apply) {
+    if(allocate_sci_port(para)!=0 || allocate_sci_wall(para)!=0)
+      return -1;
+  }
+
+  /****************************************************************************
+  | Boundary cells and their values
+  ****************************************************************************/
+  for(r=0; r<5; r++)
+    if(take(&c, apply ? BINDEX[r] : NULL, (long) nb[6]*sizeof(int))!=0)
+      return 1;
+
+  for(n=0; n<CACHE_NB_BC_VAR; n++) {
+    if(!apply) {
+      if(take(&c, NULL, (long) nb[6]*sizeof(REAL))!=0) return 1;
+      continue;
+    }
+    for(m=0; m<nb[6]; m++) {
+      take(&c, &value, sizeof(REAL));
+      var[cache_bc_var[n]][IX(BINDEX[0][m],BINDEX[1][m],BINDEX[2][m])] = value;
+    }
+  }
+
+  /****************************************************************************
+  | Flags of the cells
+  ****************************************************************************/
+  for(n=0; n<CACHE_NB_FLAG_VAR; n++) {
+    if(!apply) {
+      if(take(&c, NULL, size)!=0) return 1;
+      continue;
+    }
+    for(m=0; m<size; m++) {
+      take(&c, &flag, 1);
+      var[cache_flag_var[n]][m] = (REAL) flag;
+    }
+  }
+
+  return c.left==0 ? 0 : 1;
+} /* End of load_payload()*/
+
+	/*
+		* Read the geometry defined by SCI from the cache
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param BINDEX Pointer to boundary index
+		*
+		* @return 0 if the geometry was read, 1 if the cache cannot be used,
+		*         -1 if an error occurred after the cache was validated
+		*/
+int read_sci_cache(PARA_DATA *para, REAL **var, int **BINDEX) {
+  char name[1100];
+  FILE *file;
+  CACHE_HEAD head;
+  unsigned char *payload;
+  unsigned long hash[2];
+  CURSOR c;
+  int flag;
+
+  cache_file_name(para, name);
+  file = fopen(name, "rb");
+  if(file==NULL) {
+    sprintf(msg, "read_sci_cache(): No cache file %.900s.", name);
+    ffd_log(msg, FFD_NORMAL);
+    return 1;
+  }
+
+  /****************************************************************************
+  | Check the header and the source files
+  ****************************************************************************/
+  if(fread(&head, sizeof(CACHE_HEAD), 1, file)!=1
+     || memcmp(head.magic, cache_magic, sizeof(cache_magic))!=0
+     || head.head_size!=(int) sizeof(CACHE_HEAD)
+     || head.version!=SCI_CACHE_VERSION
+     || head.real_size!=(int) sizeof(REAL)
+     || head.byte_order!=0x01020304L || head.payload_size<=0) {
+    fclose(file);
+    sprintf(msg, "read_sci_cache(): The cache file %.900s was not written by "
+            "this version of FFD.", name);
+    ffd_log(msg, FFD_NORMAL);
+    return 1;
+  }
+
+  if(!source_unchanged(para->inpu->parameter_file_name, &head.source[0],
+                       head.written)
+     || !source_unchanged(para->inpu->block_file_name, &head.source[1],
+                          head.written)) {
+    fclose(file);
+    sprintf(msg, "read_sci_cache(): The cache file %.900s is out of date.", name);
+    ffd_log(msg, FFD_NORMAL);
+    return 1;
+  }
+
+  /****************************************************************************
+  | Read and check the payload
+  ****************************************************************************/
+  payload = (unsigned char *) malloc((size_t) head.payload_size);
+  if(payload==NULL) {
+    fclose(file);
+    ffd_log("read_sci_cache(): Could not allocate memory for the cache.",
+            FFD_WARNING);
+    return 1;
+  }
+
+  if(fread(payload, 1, (size_t) head.payload_size, file)
+     !=(size_t) head.payload_size) {
+    fclose(file);
+    free(payload);
+    sprintf(msg, "read_sci_cache(): The cache file %.900s is incomplete.", name);
+    ffd_log(msg, FFD_NORMAL);
+    return 1;
+  }
+  fclose(file);
+
+  hash[0] = 2166136261UL;
+  hash[1] = 0;
+  hash_bytes(hash, payload, head.payload_size);
+
+  c.p = payload;
+  c.left = head.payload_size;
+  if(hash[0]!=head.payload_hash[0] || hash[1]!=head.payload_hash[1]
+     || load_payload(para, var, BINDEX, c, 0)!=0) {
+    free(payload);
+    sprintf(msg, "read_sci_cache(): The cache file %.900s does not fit the "
+            "simulation.", name);
+    ffd_log(msg, FFD_NORMAL);
+    return 1;
+  }
+
+  /****************************************************************************
+  | Set the data
+  ****************************************************************************/
+  flag = load_payload(para, var, BINDEX, c, 1);
+  free(payload);
+  if(flag!=0) {
+    sprintf(msg, "read_sci_cache(): Could not set the data of the cache "
+            "file %.900s.", name);
+    ffd_log(msg, FFD_ERROR);
+    return -1;
+  }
+
+  sprintf(msg, "read_sci_cache(): Read the geometry from %.900s", name);
+  ffd_log(msg, FFD_NORMAL);
+
+  /* Free the filePath allocated in parameter_reader.c, as read_sci_input()
+     does*/
+  if(para->cosim!=NULL && para->cosim->para->filePath!=NULL) {
+    free(para->cosim->para->filePath);
+    para->cosim->para->filePath = NULL;
+  }
+
+  return 0;
+} /* End of read_sci_cache()*/
+
+	/*
+		* Write the geometry defined by SCI to the cache
+		*
+		* The cache is written to a temporary file that replaces the cache
+		* file at the end, so that other simulations never read an incomplete
+		* cache.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param BINDEX Pointer to boundary index
+		*
+		* @return 0 if the cache was written
+		*/
+int write_sci_cache(PARA_DATA *para, REAL **var, int **BINDEX) {
+  char name[1100], tmp_name[1200];
+  FILE *file;
+  CACHE_HEAD head;
+  BUFFER buf;
+  int flag;
+
+  cache_file_name(para, name);
+
+  /****************************************************************************
+  | Build the payload
+  ****************************************************************************/
+  buf.data = NULL;
+  buf.size = 0;
+  store_payload(para, var, BINDEX, &buf);
+
+  buf.data = (unsigned char *) malloc((size_t) buf.size);
+  if(buf.data==NULL) {
+    ffd_log("write_sci_cache(): Could not allocate memory for the cache.",
+            FFD_WARNING);
+    return 1;
+  }
+  buf.size = 0;
+  store_payload(para, var, BINDEX, &buf);
+
+  /****************************************************************************
+  | Build the header
+  ****************************************************************************/
+  memset(&head, 0, sizeof(CACHE_HEAD));
+  memcpy(head.magic, cache_magic, sizeof(cache_magic));
+  head.head_size = (int) sizeof(CACHE_HEAD);
+  head.version = SCI_CACHE_VERSION;
+  head.real_size = (int) sizeof(REAL);
+  head.byte_order = 0x01020304L;
+  head.payload_size = buf.size;
+  head.payload_hash[0] = 2166136261UL;
+  head.payload_hash[1] = 0;
+  hash_bytes(head.payload_hash, buf.data, buf.size);
+
+  if(file_signature(para->inpu->parameter_file_name, &head.source[0])!=0
+     || file_signature(para->inpu->block_file_name, &head.source[1])!=0) {
+    free(buf.data);
+    ffd_log("write_sci_cache(): Could not get the signature of the SCI files.",
+            FFD_WARNING);
+    return 1;
+  }
+  head.written = (long) time(NULL);
+
+  /****************************************************************************
+  | Write the temporary file and replace the cache file
+  ****************************************************************************/
+#ifdef _MSC_VER /*Windows*/
+  sprintf(tmp_name, "%s.%d", name, _getpid());
+#else /*Linux*/
+  sprintf(tmp_name, "%s.%ld", name, (long) getpid());
+#endif
+  file = fopen(tmp_name, "wb");
+  if(file==NULL) {
+    free(buf.data);
+    sprintf(msg, "write_sci_cache(): Could not open the file %.900s, the cache "
+            "is not used.", tmp_name);
+    ffd_log(msg, FFD_NORMAL);
+    return 1;
+  }
+
+  flag = fwrite(&head, sizeof(CACHE_HEAD), 1, file)!=1
+         || fwrite(buf.data, 1, (size_t) buf.size, file)!=(size_t) buf.size;
+  flag = fclose(file)!=0 || flag;
+  free(buf.data);
+
+  if(flag==0) {
+#ifdef _MSC_VER /*Windows*/
+    /* rename() does not replace an existing file*/
+    remove(name);
+#endif
+    flag = rename(tmp_name, name)!=0;
+  }
+  if(flag!=0) {
+    remove(tmp_name);
+    sprintf(msg, "write_sci_cache(): Could not write the cache file %.900s.", name);
+    ffd_log(msg, FFD_WARNING);
+    return 1;
+  }
+
+  sprintf(msg, "write_sci_cache(): Wrote the geometry to %.900s", name);
+  ffd_log(msg, FFD_NORMAL);
+
+  return 0;
+} /* End of write_sci_cache()*/
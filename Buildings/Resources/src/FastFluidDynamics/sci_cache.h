@@ -0,0 +1,85 @@
+/*
+	*
+	* @file   sci_cache.h
+	*
+	* @brief  Binary cache of the geometry defined by SCI
+	*
+	* @date   10/18/2026
+	*
+	* After the SCI parameter file and the block file were read, the parsed
+	* geometry is written to the cache file "<parameter_file_name>.cache".
+	* The next run of the same room reads the cache instead of parsing the
+	* text files. The cache contains the coordinates of the cell surfaces,
+	* the boundary names and counts, the time settings of the SCI file,
+	* BINDEX with the boundary values of its cells, and FLAGP, FLAGU, FLAGV
+	* and FLAGW after mark_cell().
+	*
+	* The cache is only used if it was written by a build with the same
+	* sizes of REAL, int and long and the same byte order, and if both
+	* source files are unchanged. A source file is unchanged if its size is
+	* the same and either its modification time is the same and older than
+	* the cache, or the hash of its content is the same. The payload is
+	* protected by its own hash. An unusable cache is ignored and rewritten.
+	*
+	*   CACHE_HEAD  head          See sci_cache.c
+	*   int32   imax, jmax, kmax
+	*   REAL    Lx, Ly, Lz
+	*   REAL    surfx[imax+2], surfy[jmax+2], surfz[kmax+2]
+	*   int32   nb_bc, nb_inlet, nb_outlet, nb_block, nb_wall, nb_source
+	*   int32   index         Number of entries of BINDEX
+	*   int32   step_total
+	*   double  t_start, dt
+	*   names   int32 length followed by the characters, for the inlets,
+	*           outlets, blocks and walls
+	*   int32   BINDEX[5][index]
+	*   REAL    TEMPBC, QFLUXBC, VXBC, VYBC, VZBC, Xi1BC of the BINDEX cells
+	*   int8    FLAGP, FLAGU, FLAGV, FLAGW[(imax+2)*(jmax+2)*(kmax+2)]
+	*
+	* The cache is written with inpu.sci_cache 1 in the *.ffd file, which is
+	* the default.
+	*
+	*/
+
+#ifndef _SCI_CACHE_H
+#define _SCI_CACHE_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _SCI_READER_H
+#define _SCI_READER_H
+#include "sci_reader.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+/*
+	* Read the geometry defined by SCI from the cache
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param BINDEX Pointer to boundary index
+	*
+	* @return 0 if the geometry was read, 1 if the cache cannot be used,
+	*         -1 if an error occurred after the cache was validated
+	*/
+int read_sci_cache(PARA_DATA *para, REAL **var, int **BINDEX);
+
+/*
+	* Write the geometry defined by SCI to the cache
+	*
+	* A failure is logged, but the simulation continues without the cache.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param BINDEX Pointer to boundary index
+	*
+	* @return 0 if the cache was written
+	*/
+int write_sci_cache(PARA_DATA *para, REAL **var, int **BINDEX);
@@ -17,7 +17,7 @@
 
 #include <string.h>
 #include "sci_reader.h"
-FILE *file_params;
+FFD_THREAD_LOCAL FILE *file_params;
 
 /*
 	* Read the basic index information from input.cfd
@@ -71,8 +71,6 @@ int read_sci_input(PARA_DATA *para, REAL **var, int **BINDEX) {
   REAL Lx = para->geom->Lx;
   REAL Ly = para->geom->Ly;
   REAL Lz = para->geom->Lz;
-  REAL *gx = var[GX], *gy = var[GY], *gz = var[GZ];
-  REAL *x = var[X], *y = var[Y], *z = var[Z];
   int IWWALL,IEWALL,ISWALL,INWALL,IBWALL,ITWALL;
   int SI,SJ,SK,EI,EJ,EK,FLTMP;
   REAL TMP,MASS,U,V,W;
@@ -129,55 +127,27 @@ int read_sci_input(PARA_DATA *para, REAL **var, int **BINDEX) {
   for(k=1; k<=kmax; k++) fscanf(file_params, "%lf", &delz[k]);
   fscanf(file_params,"\n");
 
-  /* Store the locations of grid cell surfaces*/
+  /* Convert the cell dimensions to the locations of the cell surfaces*/
   tempx = 0.0; tempy = 0.0; tempz = 0.0;
   for(i=0; i<=imax+1; i++) {
     tempx += delx[i];
     if(i>=imax) tempx = Lx;
-    for(j=0; j<=jmax+1; j++)
-      for(k=0; k<=kmax+1; k++) var[GX][IX(i,j,k)]=tempx;
+    delx[i] = tempx;
   }
 
   for(j=0; j<=jmax+1; j++) {
     tempy += dely[j];
     if(j>=jmax) tempy = Ly;
-    for(i=0; i<=imax+1; i++)
-      for(k=0; k<=kmax+1; k++) var[GY][IX(i,j,k)] = tempy;
+    dely[j] = tempy;
   }
 
   for(k=0; k<=kmax+1; k++) {
     tempz += delz[k];
     if(k>=kmax) tempz = Lz;
-    for(i=0; i<=imax+1; i++)
-      for(j=0; j<=jmax+1; j++) var[GZ][IX(i,j,k)] = tempz;
+    delz[k] = tempz;
   }
 
-  /*****************************************************************************
-  | Convert the coordinates for cell surfaces to
-  | the coordinates for the cell center
-  *****************************************************************************/
-  FOR_ALL_CELL
-    if(i<1)
-      x[IX(i,j,k)] = 0;
-    else if(i>imax)
-      x[IX(i,j,k)] = Lx;
-    else
-      x[IX(i,j,k)] = (REAL) 0.5 * (gx[IX(i,j,k)]+gx[IX(i-1,j,k)]);
-
-    if(j<1)
-      y[IX(i,j,k)] = 0;
-    else if(j>jmax)
-      y[IX(i,j,k)] = Ly;
-    else
-      y[IX(i,j,k)] = (REAL) 0.5 * (gy[IX(i,j,k)]+gy[IX(i,j-1,k)]);
-
-    if(k<1)
-      z[IX(i,j,k)] = 0;
-    else if(k>kmax)
-      z[IX(i,j,k)] = Lz;
-    else
-      z[IX(i,j,k)] = (REAL) 0.5 * (gz[IX(i,j,k)]+gz[IX(i,j,k-1)]);
-  END_FOR
+  set_sci_coordinates(para, var, delx, dely, delz);
 
   /* Get the wall property*/
   fgets(string, 400, file_params);
@@ -398,150 +368,9 @@ int read_sci_input(PARA_DATA *para, REAL **var, int **BINDEX) {
     } /* End of loop for each outlet boundary*/
   } /* End of setting outlet boundary*/
 
-  /*****************************************************************************
-  | - Copy the inlet and outlet information to ports
-  | - Allocate memory for related port variables
-  *****************************************************************************/
-  para->bc->nb_port = para->bc->nb_inlet+para->bc->nb_outlet;
-
-  if(para->bc->nb_port>0) {
-    /* Allocate memory for the array of ports' names*/
-    para->bc->portName = (char**) malloc(para->bc->nb_port*sizeof(char*));
-    if(para->bc->portName==NULL) {
-      ffd_log("read_sci_input(): Could not allocate memory for para->bc->portName.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Copy the inlet names to ports' names
-    --------------------------------------------------------------------------*/
-    for(i=0; i<para->bc->nb_inlet; i++) {
-      /* Allocate memory for inlet name*/
-      para->bc->portName[i] =
-        (char*) malloc(sizeof(char)*(strlen(para->bc->inletName[i])+1));
-
-      if(para->bc->portName[i]==NULL) {
-        ffd_log("read_sci_input():"
-                "Could not allocate memory for para->bc->portName.",
-        FFD_ERROR);
-        return 1;
-      }
-
-      /* Copy the inlet name*/
-      strcpy(para->bc->portName[i], para->bc->inletName[i]);
-      sprintf(msg, "read_sci_input(): Port[%d]:%s",
-              i, para->bc->portName[i]);
-      ffd_log(msg, FFD_NORMAL);
-    }
+  if(allocate_sci_port(para)!=0)
+    return 1;
 
-    /*--------------------------------------------------------------------------
-    | Copy the outlet names to ports' names
-    --------------------------------------------------------------------------*/
-    j = para->bc->nb_inlet;
-     for(i=0; i<para->bc->nb_outlet; i++) {
-       /* Allocate memory for outlet name*/
-       para->bc->portName[i+j] =
-         (char*) malloc(sizeof(char)*(strlen(para->bc->outletName[i])+1));
-       if(para->bc->portName[i+j]==NULL) {
-        ffd_log("read_sci_input(): "
-                "Could not allocate memory for para->bc->portName.",
-        FFD_ERROR);
-        return 1;
-      }
-      else {
-        strcpy(para->bc->portName[i+j], para->bc->outletName[i]);
-        sprintf(msg, "read_sci_input(): Port[%d]:%s",
-                i+j, para->bc->portName[i+j]);
-        ffd_log(msg, FFD_NORMAL);
-      }
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for the surface area
-    --------------------------------------------------------------------------*/
-    para->bc->APort = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->APort==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->APort.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for the velocity (used for inlet only)
-    --------------------------------------------------------------------------*/
-    para->bc->velPort = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->velPort==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->velPort.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for the averaged velocity
-    --------------------------------------------------------------------------*/
-    para->bc->velPortAve = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->velPortAve==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->velAve.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for mean velocity
-    --------------------------------------------------------------------------*/
-    para->bc->velPortMean = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->velPortMean==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->velPortMean.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for the temperature (used for inlet only)
-    --------------------------------------------------------------------------*/
-    para->bc->TPort = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->TPort==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->TPort.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for the averaged temperature
-    --------------------------------------------------------------------------*/
-    para->bc->TPortAve = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->TPortAve==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->TPortAve.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for the mean velocity
-    --------------------------------------------------------------------------*/
-    para->bc->TPortMean = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
-    if(para->bc->TPortMean==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->TPortMean.",
-      FFD_ERROR);
-      return 1;
-    }
-    /*--------------------------------------------------------------------------
-    | Allocate memory for port ID
-    --------------------------------------------------------------------------*/
-    para->bc->portId = (int*) malloc(para->bc->nb_port*sizeof(int));
-    if(para->bc->portId==NULL) {
-      ffd_log("read_sci_input(): "
-              "Could not allocate memory for para->bc->portId.",
-      FFD_ERROR);
-      return 1;
-    }
-  }
-  /*****************************************************************************
-  | initialize the para->bc->portID
-  *****************************************************************************/
-  for (i = 0; i < para->bc->nb_port; i++) {
-	  para->bc->portId[i] = 0;
-  }
   /*****************************************************************************
   | Read the internal solid block boundary conditions
   *****************************************************************************/
@@ -669,43 +498,8 @@ int read_sci_input(PARA_DATA *para, REAL **var, int **BINDEX) {
       return 1;
     }
 
-    para->bc->wallId = (int *) malloc(sizeof(int)*para->bc->nb_wall);
-    if(para->bc->wallId==NULL) {
-      ffd_log("read_sci_input(): Could not allocate memory for "
-      "para->bc->wallId.", FFD_ERROR);
+    if(allocate_sci_wall(para)!=0)
       return 1;
-    }
-
-    for(i=0; i<para->bc->nb_wall; i++)
-      para->bc->wallId[i] = -1;
-
-    para->bc->AWall = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
-    if(para->bc->AWall==NULL) {
-      ffd_log("read_sci_input(): Could not allocate memory for "
-      "para->bc->AWall.", FFD_ERROR);
-      return 1;
-    }
-
-    para->bc->temHea = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
-    if(para->bc->temHea==NULL) {
-      ffd_log("read_sci_input(): Could not allocate memory for "
-      "para->bc->heaTem.", FFD_ERROR);
-      return 1;
-    }
-
-    para->bc->temHeaAve = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
-    if(para->bc->temHeaAve==NULL) {
-      ffd_log("read_sci_input(): Could not allocate memory for "
-      "para->bc->temHeaAve.", FFD_ERROR);
-    return 1;
-    }
-
-    para->bc->temHeaMean = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
-    if(para->bc->temHeaMean==NULL) {
-      ffd_log("read_sci_input(): Could not allocate memory for "
-      "para->bc->temHeaMean.", FFD_ERROR);
-      return 1;
-    }
 
     /*-------------------------------------------------------------------------
     | Read wall conditions for each wall
@@ -916,7 +710,7 @@ int read_sci_input(PARA_DATA *para, REAL **var, int **BINDEX) {
           para->inpu->parameter_file_name);
   ffd_log(msg, FFD_NORMAL);
   /* Free the filePath allocated in parameter_reader.c*/
-  if (para->cosim->para->filePath != NULL){
+  if (para->cosim!=NULL && para->cosim->para->filePath != NULL){
     free(para->cosim->para->filePath);
     para->cosim->para->filePath = NULL;
   }
@@ -1059,3 +853,276 @@ void mark_cell(PARA_DATA *para, REAL **var) {
 
   END_FOR
 } /* End of mark_cell()*/
+
+	/*
+		* Set the coordinates of the cell surfaces and cell centers
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param surfx Pointer to the X coordinates of the cell surfaces
+		* @param surfy Pointer to the Y coordinates of the cell surfaces
+		* @param surfz Pointer to the Z coordinates of the cell surfaces
+		*
+		* @return No return needed
+		*/
+void set_sci_coordinates(PARA_DATA *para, REAL **var, REAL *surfx,
+                         REAL *surfy, REAL *surfz) {
+  int i, j, k;
+  int imax = para->geom->imax;
+  int jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  REAL Lx = para->geom->Lx;
+  REAL Ly = para->geom->Ly;
+  REAL Lz = para->geom->Lz;
+  REAL *gx = var[GX], *gy = var[GY], *gz = var[GZ];
+  REAL *x = var[X], *y = var[Y], *z = var[Z];
+
+  /* Store the locations of grid cell surfaces*/
+  FOR_ALL_CELL
+    gx[IX(i,j,k)] = surfx[i];
+    gy[IX(i,j,k)] = surfy[j];
+    gz[IX(i,j,k)] = surfz[k];
+  END_FOR
+
+  /*****************************************************************************
+  | Convert the coordinates for cell surfaces to
+  | the coordinates for the cell center
+  *****************************************************************************/
+  FOR_ALL_CELL
+    if(i<1)
+      x[IX(i,j,k)] = 0;
+    else if(i>imax)
+      x[IX(i,j,k)] = Lx;
+    else
+      x[IX(i,j,k)] = (REAL) 0.5 * (gx[IX(i,j,k)]+gx[IX(i-1,j,k)]);
+
+    if(j<1)
+      y[IX(i,j,k)] = 0;
+    else if(j>jmax)
+      y[IX(i,j,k)] = Ly;
+    else
+      y[IX(i,j,k)] = (REAL) 0.5 * (gy[IX(i,j,k)]+gy[IX(i,j-1,k)]);
+
+    if(k<1)
+      z[IX(i,j,k)] = 0;
+    else if(k>kmax)
+      z[IX(i,j,k)] = Lz;
+    else
+      z[IX(i,j,k)] = (REAL) 0.5 * (gz[IX(i,j,k)]+gz[IX(i,j,k-1)]);
+  END_FOR
+} /* End of set_sci_coordinates()*/
+
+
+	/*
+		* Copy the inlet and outlet names to the ports and allocate the port data
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return 0 if no error occurred
+		*/
+int allocate_sci_port(PARA_DATA *para) {
+  int i, j;
+
+  /*****************************************************************************
+  | - Copy the inlet and outlet information to ports
+  | - Allocate memory for related port variables
+  *****************************************************************************/
+  para->bc->nb_port = para->bc->nb_inlet+para->bc->nb_outlet;
+
+  if(para->bc->nb_port>0) {
+    /* Allocate memory for the array of ports' names*/
+    para->bc->portName = (char**) malloc(para->bc->nb_port*sizeof(char*));
+    if(para->bc->portName==NULL) {
+      ffd_log("allocate_sci_port(): Could not allocate memory for para->bc->portName.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Copy the inlet names to ports' names
+    --------------------------------------------------------------------------*/
+    for(i=0; i<para->bc->nb_inlet; i++) {
+      /* Allocate memory for inlet name*/
+      para->bc->portName[i] =
+        (char*) malloc(sizeof(char)*(strlen(para->bc->inletName[i])+1));
+
+      if(para->bc->portName[i]==NULL) {
+        ffd_log("allocate_sci_port():"
+                "Could not allocate memory for para->bc->portName.",
+        FFD_ERROR);
+        return 1;
+      }
+
+      /* Copy the inlet name*/
+      strcpy(para->bc->portName[i], para->bc->inletName[i]);
+      sprintf(msg, "allocate_sci_port(): Port[%d]:%s",
+              i, para->bc->portName[i]);
+      ffd_log(msg, FFD_NORMAL);
+    }
+
+    /*--------------------------------------------------------------------------
+    | Copy the outlet names to ports' names
+    --------------------------------------------------------------------------*/
+    j = para->bc->nb_inlet;
+     for(i=0; i<para->bc->nb_outlet; i++) {
+       /* Allocate memory for outlet name*/
+       para->bc->portName[i+j] =
+         (char*) malloc(sizeof(char)*(strlen(para->bc->outletName[i])+1));
+       if(para->bc->portName[i+j]==NULL) {
+        ffd_log("allocate_sci_port(): "
+                "Could not allocate memory for para->bc->portName.",
+        FFD_ERROR);
+        return 1;
+      }
+      else {
+        strcpy(para->bc->portName[i+j], para->bc->outletName[i]);
+        sprintf(msg, "allocate_sci_port(): Port[%d]:%s",
+                i+j, para->bc->portName[i+j]);
+        ffd_log(msg, FFD_NORMAL);
+      }
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for the surface area
+    --------------------------------------------------------------------------*/
+    para->bc->APort = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->APort==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->APort.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for the velocity (used for inlet only)
+    --------------------------------------------------------------------------*/
+    para->bc->velPort = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->velPort==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->velPort.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for the averaged velocity
+    --------------------------------------------------------------------------*/
+    para->bc->velPortAve = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->velPortAve==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->velAve.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for mean velocity
+    --------------------------------------------------------------------------*/
+    para->bc->velPortMean = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->velPortMean==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->velPortMean.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for the temperature (used for inlet only)
+    --------------------------------------------------------------------------*/
+    para->bc->TPort = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->TPort==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->TPort.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for the averaged temperature
+    --------------------------------------------------------------------------*/
+    para->bc->TPortAve = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->TPortAve==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->TPortAve.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for the mean velocity
+    --------------------------------------------------------------------------*/
+    para->bc->TPortMean = (REAL*) malloc(para->bc->nb_port*sizeof(REAL));
+    if(para->bc->TPortMean==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->TPortMean.",
+      FFD_ERROR);
+      return 1;
+    }
+    /*--------------------------------------------------------------------------
+    | Allocate memory for port ID
+    --------------------------------------------------------------------------*/
+    para->bc->portId = (int*) malloc(para->bc->nb_port*sizeof(int));
+    if(para->bc->portId==NULL) {
+      ffd_log("allocate_sci_port(): "
+              "Could not allocate memory for para->bc->portId.",
+      FFD_ERROR);
+      return 1;
+    }
+  }
+  /*****************************************************************************
+  | initialize the para->bc->portID
+  *****************************************************************************/
+  for (i = 0; i < para->bc->nb_port; i++) {
+	  para->bc->portId[i] = 0;
+  }
+
+  return 0;
+} /* End of allocate_sci_port()*/
+
+
+	/*
+		* Allocate the data of the walls
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return 0 if no error occurred
+		*/
+int allocate_sci_wall(PARA_DATA *para) {
+  int i;
+
+  if(para->bc->nb_wall==0)
+    return 0;
+
+  para->bc->wallId = (int *) malloc(sizeof(int)*para->bc->nb_wall);
+  if(para->bc->wallId==NULL) {
+    ffd_log("allocate_sci_wall(): Could not allocate memory for "
+    "para->bc->wallId.", FFD_ERROR);
+    return 1;
+  }
+
+  for(i=0; i<para->bc->nb_wall; i++)
+    para->bc->wallId[i] = -1;
+
+  para->bc->AWall = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
+  if(para->bc->AWall==NULL) {
+    ffd_log("allocate_sci_wall(): Could not allocate memory for "
+    "para->bc->AWall.", FFD_ERROR);
+    return 1;
+  }
+
+  para->bc->temHea = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
+  if(para->bc->temHea==NULL) {
+    ffd_log("allocate_sci_wall(): Could not allocate memory for "
+    "para->bc->heaTem.", FFD_ERROR);
+    return 1;
+  }
+
+  para->bc->temHeaAve = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
+  if(para->bc->temHeaAve==NULL) {
+    ffd_log("allocate_sci_wall(): Could not allocate memory for "
+    "para->bc->temHeaAve.", FFD_ERROR);
+    return 1;
+  }
+
+  para->bc->temHeaMean = (REAL*) malloc(para->bc->nb_wall*sizeof(REAL));
+  if(para->bc->temHeaMean==NULL) {
+    ffd_log("allocate_sci_wall(): Could not allocate memory for "
+    "para->bc->temHeaMean.", FFD_ERROR);
+    return 1;
+  }
+
+  return 0;
+} /* End of allocate_sci_wall()*/
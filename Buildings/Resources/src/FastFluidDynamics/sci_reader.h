@@ -34,7 +34,7 @@
 #include "utility.h"
 #endif
 
-extern FILE *file_params;
+extern FFD_THREAD_LOCAL FILE *file_params;
 
 /*
 * Read the basic index information from input.cfd
@@ -81,3 +81,35 @@ int read_sci_zeroone(PARA_DATA *para, REAL **var, int **BINDEX);
 	* @return 0 if no error occurred
 	*/
 void mark_cell(PARA_DATA *para, REAL **var);
+
+/*
+	* Set the coordinates of the cell surfaces and cell centers
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param surfx Pointer to the X coordinates of the cell surfaces
+	* @param surfy Pointer to the Y coordinates of the cell surfaces
+	* @param surfz Pointer to the Z coordinates of the cell surfaces
+	*
+	* @return No return needed
+	*/
+void set_sci_coordinates(PARA_DATA *para, REAL **var, REAL *surfx,
+                         REAL *surfy, REAL *surfz);
+
+/*
+	* Copy the inlet and outlet names to the ports and allocate the port data
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return 0 if no error occurred
+	*/
+int allocate_sci_port(PARA_DATA *para);
+
+/*
+	* Allocate the data of the walls
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return 0 if no error occurred
+	*/
+int allocate_sci_wall(PARA_DATA *para);
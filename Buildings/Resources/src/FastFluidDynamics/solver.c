@@ -35,7 +35,7 @@
 int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
   int step_total = para->mytime->step_total;
   REAL t_steady = para->mytime->t_steady;
-  double t_cosim;
+  double t_cosim = -1; /* No synchronization point in a single simulation*/
   int flag, next;
 
   if(para->solv->cosimulation == 1) {
@@ -45,10 +45,11 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
      * Without this wait, FFD_solver() reads an uninitialized (garbage) dt,
      * which causes the synchronization point t_cosim to be wrong, making the
      * FFD thread run indefinitely without ever synchronizing with Modelica. */
-    while(para->cosim->modelica->dt <= 0.0 && para->cosim->para->flag != 0) {
-      Sleep(10);
-    }
+    cosim_lock(para->cosim);
+    while(para->cosim->modelica->dt <= 0.0 && para->cosim->para->flag != 0)
+      cosim_wait(para->cosim, 1000);
     t_cosim = para->mytime->t + para->cosim->modelica->dt;
+    cosim_unlock(para->cosim);
   }
 
   /***************************************************************************
@@ -59,7 +60,17 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
     /*-------------------------------------------------------------------------*/
     /* Integration*/
     /*-------------------------------------------------------------------------*/
+    if(para->mytime->adaptive==1) {
+      flag = adapt_time_step(para, var, t_cosim);
+      if(flag != 0) {
+        ffd_log("FFD_solver(): Could not adapt the time step.", FFD_ERROR);
+        return flag;
+      }
+    }
+
+    phase_start(para, PHASE_VEL);
     flag = vel_step(para, var, BINDEX);
+    phase_end(para, PHASE_VEL);
     if(flag != 0) {
       ffd_log("FFD_solver(): Could not solve velocity.", FFD_ERROR);
       return flag;
@@ -67,7 +78,9 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
     else if(para->outp->version==DEBUG)
       ffd_log("FFD_solver(): solved velocity step.", FFD_NORMAL);
 
+    phase_start(para, PHASE_TEMP);
     flag = temp_step(para, var, BINDEX);
+    phase_end(para, PHASE_TEMP);
     if(flag != 0) {
       ffd_log("FFD_solver(): Could not solve temperature.", FFD_ERROR);
       return flag;
@@ -75,7 +88,9 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
     else if(para->outp->version==DEBUG)
       ffd_log("FFD_solver(): solved temperature step.", FFD_NORMAL);
 
+    phase_start(para, PHASE_DEN);
     flag = den_step(para, var, BINDEX);
+    phase_end(para, PHASE_DEN);
     if(flag != 0) {
       ffd_log("FFD_solver(): Could not solve trace substance.", FFD_ERROR);
       return flag;
@@ -85,6 +100,17 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
 
     timing(para);
 
+    /* Hand the transient flow field to the writer*/
+    if(para->outp->transient_step>0
+       && para->mytime->step_current%para->outp->transient_step==0) {
+      flag = write_vtk_snapshot(para, var);
+      if(flag != 0) {
+        ffd_log("FFD_solver(): Could not write the transient flow field.",
+                FFD_ERROR);
+        return flag;
+      }
+    }
+
     /*-------------------------------------------------------------------------*/
     /* Process for Coupled simulation*/
     /*-------------------------------------------------------------------------*/
@@ -109,7 +135,7 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
         /*.......................................................................
         | Check if Modelica asks to stop the simulation
         .......................................................................*/
-        if(para->cosim->para->flag==0) {
+        if(cosim_get_flag(para->cosim, &para->cosim->para->flag)==0) {
           /* Stop the solver*/
           next = 0;
           sprintf(msg,
@@ -129,7 +155,7 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
         /*.......................................................................
         | Check if Modelica asks to stop the simulation
         .......................................................................*/
-        if(para->cosim->para->flag==0) {
+        if(cosim_get_flag(para->cosim, &para->cosim->para->flag)==0) {
           /* Stop the solver*/
           next = 0;
           sprintf(msg,
@@ -149,7 +175,9 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
         ffd_log(msg, FFD_NORMAL);
 				}
         /* Set the next synchronization time*/
+        cosim_lock(para->cosim);
         t_cosim += para->cosim->modelica->dt;
+        cosim_unlock(para->cosim);
         /* Reset all the averaged data to 0*/
         flag = reset_time_averaged_data(para, var);
         if(flag != 0) {
@@ -245,6 +273,14 @@ int FFD_solver(PARA_DATA *para, REAL **var, int **BINDEX) {
     }
   } /* End of While loop*/
 
+  if(para->mytime->adaptive==1) {
+    sprintf(msg, "FFD_solver(): Ran %d time steps with dt from %f[s] to %f[s], "
+            "mean %f[s].", para->mytime->step_current,
+            para->mytime->dt_smallest, para->mytime->dt_largest,
+            para->mytime->t/para->mytime->step_current);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
   return flag;
 } /* End of FFD_solver( )*/
 
@@ -261,13 +297,17 @@ int temp_step(PARA_DATA *para, REAL **var, int **BINDEX) {
   REAL *T = var[TEMP], *T0 = var[TMP1];
   int flag = 0;
 
+  phase_start(para, PHASE_ADVECT);
   flag = advect(para, var, TEMP, 0, T0, T, BINDEX);
+  phase_end(para, PHASE_ADVECT);
   if(flag!=0) {
     ffd_log("temp_step(): Could not advect temperature.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_DIFFUSE);
   flag = diffusion(para, var, TEMP, 0, T, T0, BINDEX);
+  phase_end(para, PHASE_DIFFUSE);
   if(flag!=0) {
     ffd_log("temp_step(): Could not diffuse temperature.", FFD_ERROR);
     return flag;
@@ -286,56 +326,21 @@ int temp_step(PARA_DATA *para, REAL **var, int **BINDEX) {
 		* @return 0 if no error occurred
 		*/
 int den_step(PARA_DATA *para, REAL **var, int **BINDEX) {
-  REAL *den, *den0 = var[TMP1];
-  int i, flag = 0;
+  int flag = 0;
 
   /****************************************************************************
-  | Solve the species
+  | Solve the species and trace substances together
   ****************************************************************************/
-  for(i=0; i<para->bc->nb_Xi; i++) {
-    if(para->outp->version==DEBUG) {
-      sprintf(msg, "den_step(): start to solve Xi%d", i+1);
-      ffd_log(msg, FFD_NORMAL);
-    }
-    den = var[Xi1+i];
-    flag = advect(para, var, Xi1+i, i, den0, den, BINDEX);
-    if(flag!=0) {
-      sprintf(msg, "den_step(): Could not advect species %d", i+1);
-      ffd_log(msg, FFD_ERROR);
-      return flag;
-    }
-
-    flag = diffusion(para, var, Xi1+i, i, den, den0, BINDEX);
-    if(flag!=0) {
-      sprintf(msg, "den_step(): Could not diffuse species %d", i+1);
-      ffd_log(msg, FFD_ERROR);
-      return flag;
-    }
+  if(para->outp->version==DEBUG) {
+    sprintf(msg, "den_step(): start to solve %d species and %d trace "
+            "substances", para->bc->nb_Xi, para->bc->nb_C);
+    ffd_log(msg, FFD_NORMAL);
   }
 
-  /****************************************************************************
-  | Solve the trace substances
-  ****************************************************************************/
-  for(i=0; i<para->bc->nb_C; i++) {
-    if(para->outp->version==DEBUG) {
-      sprintf(msg, "den_step(): start to solve C%d", i+1);
-      ffd_log(msg, FFD_NORMAL);
-    }
-    den = var[C1+i];
-    flag = advect(para, var, Xi1, i, den0, den, BINDEX);
-    if(flag!=0) {
-      sprintf(msg, "den_step(): Could not advect trace substance %d", i+1);
-      ffd_log(msg, FFD_ERROR);
-      return flag;
-    }
-
-    flag = diffusion(para, var, Xi1, i, den, den0, BINDEX);
-    if(flag!=0) {
-      sprintf(msg, "den_step(): Could not diffuse trace substance %d", i+1);
-      ffd_log(msg, FFD_ERROR);
-      return flag;
-    }
-  }
+  flag = species_step(para, var, BINDEX);
+  if(flag!=0)
+    ffd_log("den_step(): Could not solve the species and trace substances",
+            FFD_ERROR);
 
   return flag;
 } /* End of den_step( )*/
@@ -354,43 +359,57 @@ int vel_step(PARA_DATA *para, REAL **var,int **BINDEX) {
   REAL *u0 = var[TMP1], *v0 = var[TMP2], *w0 = var[TMP3];
   int flag = 0;
 
+  phase_start(para, PHASE_ADVECT);
   flag = advect(para, var, VX, 0, u0, u, BINDEX);
+  phase_end(para, PHASE_ADVECT);
   if(flag!=0) {
     ffd_log("vel_step(): Could not advect for velocity X.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_ADVECT);
   flag = advect(para, var, VY, 0, v0, v, BINDEX);
+  phase_end(para, PHASE_ADVECT);
   if(flag!=0) {
     ffd_log("vel_step(): Could not advect for velocity Y.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_ADVECT);
   flag = advect(para, var, VZ, 0, w0, w, BINDEX);
+  phase_end(para, PHASE_ADVECT);
   if(flag!=0) {
     ffd_log("vel_step(): Could not advect for velocity Z.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_DIFFUSE);
   flag = diffusion(para, var, VX, 0, u, u0, BINDEX);
+  phase_end(para, PHASE_DIFFUSE);
   if(flag!=0) {
     ffd_log("vel_step(): Could not diffuse velocity X.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_DIFFUSE);
   flag = diffusion(para, var, VY, 0, v, v0, BINDEX);
+  phase_end(para, PHASE_DIFFUSE);
   if(flag!=0) {
     ffd_log("vel_step(): Could not diffuse velocity Y.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_DIFFUSE);
   flag = diffusion(para, var, VZ, 0, w, w0, BINDEX);
+  phase_end(para, PHASE_DIFFUSE);
   if(flag!=0) {
     ffd_log("vel_step(): Could not diffuse velocity Z.", FFD_ERROR);
     return flag;
   }
 
+  phase_start(para, PHASE_PROJECT);
   flag = project(para, var,BINDEX);
+  phase_end(para, PHASE_PROJECT);
   if(flag!=0) {
     ffd_log("vel_step(): Could not project velocity.", FFD_ERROR);
     return flag;
@@ -419,17 +438,17 @@ int vel_step(PARA_DATA *para, REAL **var,int **BINDEX) {
 int equ_solver(PARA_DATA *para, REAL **var, int var_type, REAL *psi) {
   REAL *flagp = var[FLAGP], *flagu = var[FLAGU],
        *flagv = var[FLAGV], *flagw = var[FLAGW];
-  int flag = 0;
+  REAL *flag;
 
   switch(var_type) {
     case VX:
-      Gauss_Seidel(para, var, flagu, psi);
+      flag = flagu;
       break;
     case VY:
-      Gauss_Seidel(para, var, flagv, psi);
+      flag = flagv;
       break;
     case VZ:
-      Gauss_Seidel(para, var, flagw, psi);
+      flag = flagw;
       break;
     case TEMP:
     case IP:
@@ -437,15 +456,23 @@ int equ_solver(PARA_DATA *para, REAL **var, int var_type, REAL *psi) {
     case Xi2:
     case C1:
     case C2:
-      Gauss_Seidel(para, var, flagp, psi);
+      flag = flagp;
       break;
     default:
       sprintf(msg, "equ_solver(): Solver for variable type %d is not defined.",
               var_type);
       ffd_log(msg, FFD_ERROR);
-      flag = 1;
-      break;
+      return 1;
   }
 
-  return flag;
+  phase_start(para, PHASE_EQUATION);
+  if(para->solv->solver==RBGS)
+    RB_Gauss_Seidel(para, var, flag, psi, var_type);
+  else if(para->solv->solver==PCG)
+    Conjugate_Gradient(para, var, flag, psi, var_type);
+  else
+    Gauss_Seidel(para, var, flag, psi, var_type);
+  phase_end(para, PHASE_EQUATION);
+
+  return 0;
 }/* end of equ_solver*/
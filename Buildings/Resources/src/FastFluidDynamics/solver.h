@@ -53,6 +53,21 @@
 #include "solver_gs.h"
 #endif
 
+#ifndef _SOLVER_RBGS_H
+#define _SOLVER_RBGS_H
+#include "solver_rbgs.h"
+#endif
+
+#ifndef _SOLVER_MG_H
+#define _SOLVER_MG_H
+#include "solver_mg.h"
+#endif
+
+#ifndef _SOLVER_PCG_H
+#define _SOLVER_PCG_H
+#include "solver_pcg.h"
+#endif
+
 #ifndef _SOLVER_TDMA_H
 #define _SOLVER_TDMA_H
 #include "solver_tdma.h"
@@ -63,11 +78,21 @@
 #include "boundary.h"
 #endif
 
+#ifndef _SPECIES_H
+#define _SPECIES_H
+#include "species.h"
+#endif
+
 #ifndef _UTILITY_H
 #define _UTILITY_H
 #include "utility.h"
 #endif
 
+#ifndef _VTK_WRITER_H
+#define _VTK_WRITER_H
+#include "vtk_writer.h"
+#endif
+
 #ifndef _COSIMULATION_H
 #define _COSIMULATION_H
 #include "cosimulation.h"
@@ -17,9 +17,135 @@
 
 #include "solver_gs.h"
 
+	/*
+		* Get the equation of a variable type
+		*
+		* @param var_type Type of variable
+		*
+		* @return Equation whose iteration budget is used
+		*/
+EQUATION equation_type(int var_type) {
+  switch(var_type) {
+    case IP:
+      return EQU_PRESSURE;
+    case VX:
+    case VY:
+    case VZ:
+      return EQU_VELOCITY;
+    case TEMP:
+      return EQU_TEMPERATURE;
+    default:
+      return EQU_SPECIES;
+  }
+} /* End of equation_type()*/
+
+	/*
+		* Calculate the residual of the equation of a variable
+		*
+		* The residual is the sum of the absolute residuals of the fluid cells
+		* divided by the sum of the absolute values of ap*x.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param x Pointer to variable
+		*
+		* @return Residual
+		*/
+REAL GS_residual(PARA_DATA *para, REAL **var, REAL *flag, REAL *x) {
+  REAL *as = var[AS], *aw = var[AW], *ae = var[AE], *an = var[AN];
+  REAL *ap = var[AP], *af = var[AF], *ab = var[AB], *b = var[B];
+  int imax = para->geom->imax, jmax= para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+  REAL tmp1, tmp2;
+
+  tmp1 = 0;
+  tmp2 = (REAL)0.0000000001;
+
+  FOR_EACH_CELL
+    if (flag[IX(i,j,k)]>=0) continue;
+    tmp1 += (REAL) fabs(ap[IX(i,j,k)]*x[IX(i,j,k)]
+        - ae[IX(i,j,k)]*x[IX(i+1,j,k)] - aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+        - an[IX(i,j,k)]*x[IX(i,j+1,k)] - as[IX(i,j,k)]*x[IX(i,j-1,k)]
+        - af[IX(i,j,k)]*x[IX(i,j,k+1)] - ab[IX(i,j,k)]*x[IX(i,j,k-1)]
+        - b[IX(i,j,k)]);
+    tmp2 += (REAL) fabs(ap[IX(i,j,k)]*x[IX(i,j,k)]);
+  END_FOR
+
+  return tmp1 / tmp2;
+} /* End of GS_residual()*/
+
+	/*
+		* Calculate the residual of the equations with several right hand sides
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param nb Number of equations
+		* @param x Pointer to the variables, x[IX(i,j,k)*nb+n] for equation n
+		* @param b Pointer to the right hand sides, stored like x
+		*
+		* @return Residual of all equations
+		*/
+static REAL residual_multi(PARA_DATA *para, REAL **var, REAL *flag, int nb,
+                           REAL *x, REAL *b) {
+  REAL *as = var[AS], *aw = var[AW], *ae = var[AE], *an = var[AN];
+  REAL *ap = var[AP], *af = var[AF], *ab = var[AB];
+  int imax = para->geom->imax, jmax= para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k, n, c;
+  int si = nb, sj = nb*IMAX, sk = nb*IJMAX;
+  REAL *xc;
+  REAL tmp1, tmp2;
+
+  tmp1 = 0;
+  tmp2 = (REAL)0.0000000001;
+
+  FOR_EACH_CELL
+    c = IX(i,j,k);
+    if (flag[c]>=0) continue;
+    xc = x + c*nb;
+    for(n=0; n<nb; n++) {
+      tmp1 += (REAL) fabs(ap[c]*xc[n]
+          - ae[c]*xc[n+si] - aw[c]*xc[n-si]
+          - an[c]*xc[n+sj] - as[c]*xc[n-sj]
+          - af[c]*xc[n+sk] - ab[c]*xc[n-sk]
+          - b[c*nb+n]);
+      tmp2 += (REAL) fabs(ap[c]*xc[n]);
+    }
+  END_FOR
+
+  return tmp1 / tmp2;
+} /* End of residual_multi()*/
+
+	/*
+		* Check whether the residual is checked after an iteration
+		*
+		* The residual is checked every solv.gs_check iterations if a tolerance
+		* is set for the equation. It is not checked after the last iteration,
+		* since it is computed after the iterations anyway.
+		*
+		* @param para Pointer to FFD parameters
+		* @param equ Equation
+		* @param it Number of iterations done so far
+		*
+		* @return 1 if the residual is checked, 0 otherwise
+		*/
+static int check_now(PARA_DATA *para, EQUATION equ, int it) {
+  return para->solv->gs_tol[equ]>0 && it<para->solv->gs_it_max[equ]
+         && it%para->solv->gs_check==0;
+} /* End of check_now()*/
+
 	/*
 		* Gauss-Seidel solver for pressure
 		*
+		* An iteration consists of 4 sweeps. The solver does solv.gs_it_max_p
+		* iterations, or stops earlier when the residual is below
+		* solv.gs_tol_p.
+		*
 		* @param para Pointer to FFD parameters
 		* @param var Pointer to FFD simulation variables
 		* @param Type Type of variable
@@ -33,107 +159,71 @@ REAL GS_P(PARA_DATA *para, REAL **var, int Type, REAL *x) {
   int imax = para->geom->imax, jmax= para->geom->jmax;
   int kmax = para->geom->kmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  int i, j, k, it;
-  REAL tmp1, tmp2, residual;
+  int i, j, k, it, sweep, converged = 0;
+  REAL residual = 0;
   REAL *flagp = var[FLAGP];
 
   /****************************************************************************
-  | Solve the space using G-S sovler for 5 * 6 = 30 times
+  | Solve the space using G-S sovler until the residual is small enough
   ****************************************************************************/
-  for(it=0; it<5; it++) {
+  for(it=0; it<para->solv->gs_it_max[EQU_PRESSURE] && !converged; ) {
     /*-------------------------------------------------------------------------
     | Solve in X(1->imax), Y(1->jmax), Z(1->kmax)
+    | For the seven-point stencil, the result of a sweep only depends on the
+    | direction in each coordinate, but not on the order of the loops.
+    | Thus, the sweeps in the order X-Y and Y-X are both done in the order
+    | Z-Y-X of the memory.
     -------------------------------------------------------------------------*/
-    for(i=1; i<=imax; i++)
-      for(j=1; j<=jmax; j++)
-        for(k=1; k<=kmax; k++) {
-          if (flagp[IX(i,j,k)]>=0) continue;
-          /*if (i==imax && j==jmax && k==kmax) continue;*/
-
-          x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
-                          + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
-                          + an[IX(i,j,k)]*x[IX(i,j+1,k)]
-                          + as[IX(i,j,k)]*x[IX(i,j-1,k)]
-                          + af[IX(i,j,k)]*x[IX(i,j,k+1)]
-                          + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
-                          + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
-    }
+    for(sweep=0; sweep<2; sweep++)
+      for(k=1; k<=kmax; k++)
+        for(j=1; j<=jmax; j++)
+          for(i=1; i<=imax; i++) {
+            if (flagp[IX(i,j,k)]>=0) continue;
+            /*if (i==imax && j==jmax && k==kmax) continue;*/
 
-    /*-------------------------------------------------------------------------
-    | Solve in Y(1->kmax), X(1->imax), Z(1->kmax)
-    -------------------------------------------------------------------------*/
-    for(j=1; j<=jmax; j++)
-      for(i=1; i<=imax; i++)
-        for(k=1; k<=kmax; k++) {
-          if (flagp[IX(i,j,k)]>=0) continue;
-          /*if (i==imax && j==jmax && k==kmax) continue;*/
+            x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
+                            + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                            + an[IX(i,j,k)]*x[IX(i,j+1,k)]
+                            + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                            + af[IX(i,j,k)]*x[IX(i,j,k+1)]
+                            + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
+                            + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
+          }
 
-          x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
-                          + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
-                          + an[IX(i,j,k)]*x[IX(i,j+1,k)]
-                          + as[IX(i,j,k)]*x[IX(i,j-1,k)]
-                          + af[IX(i,j,k)]*x[IX(i,j,k+1)]
-                          + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
-                          + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
-    }
     /*-------------------------------------------------------------------------
-    | Solve in X(imax->), Y(jmax->1), Z(1->kmax)
+    | Solve in X(imax->1), Y(jmax->1), Z(1->kmax)
     -------------------------------------------------------------------------*/
-    for(i=imax; i>=1; i--)
-      for(j=jmax; j>=1; j--)
-        for(k=1; k<=kmax; k++) {
-          if (flagp[IX(i,j,k)]>=0) continue;
-          /*if (i==imax && j==jmax && k==kmax) continue;*/
+    for(sweep=0; sweep<2; sweep++)
+      for(k=1; k<=kmax; k++)
+        for(j=jmax; j>=1; j--)
+          for(i=imax; i>=1; i--) {
+            if (flagp[IX(i,j,k)]>=0) continue;
+            /*if (i==imax && j==jmax && k==kmax) continue;*/
 
-          x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
-                          + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
-                          + an[IX(i,j,k)]*x[IX(i,j+1,k)]
-                          + as[IX(i,j,k)]*x[IX(i,j-1,k)]
-                          + af[IX(i,j,k)]*x[IX(i,j,k+1)]
-                          + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
-                          + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
-    }
-    /*-------------------------------------------------------------------------
-    | Solve in Y(jmax->1), X(imax->1), Z(1->kmax)
-    -------------------------------------------------------------------------*/
-    for(j=jmax; j>=1; j--)
-      for(i=imax; i>=1; i--)
-        for(k=1; k<=kmax; k++) {
-          if (flagp[IX(i,j,k)]>=0) continue;
-          /*if (i==imax && j==jmax && k==kmax) continue;*/
+            x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
+                            + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                            + an[IX(i,j,k)]*x[IX(i,j+1,k)]
+                            + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                            + af[IX(i,j,k)]*x[IX(i,j,k+1)]
+                            + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
+                            + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
+          }
 
-          x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
-                          + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
-                          + an[IX(i,j,k)]*x[IX(i,j+1,k)]
-                          + as[IX(i,j,k)]*x[IX(i,j-1,k)]
-                          + af[IX(i,j,k)]*x[IX(i,j,k+1)]
-                          + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
-                          + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
+    it++;
+    if(check_now(para, EQU_PRESSURE, it)) {
+      residual = GS_residual(para, var, flagp, x);
+      converged = residual<=para->solv->gs_tol[EQU_PRESSURE];
     }
   }
+  count_iterations(para, GS, it);
 
   /****************************************************************************
   | Calculate residual
   ****************************************************************************/
-  tmp1 = 0;
-  tmp2 = (REAL)0.0000000001;
-
-  FOR_EACH_CELL
-    if (flagp[IX(i,j,k)]>=0) continue;
-    /*if (i==imax && j==jmax && k==kmax) continue;*/
-    tmp1 += (REAL) fabs(ap[IX(i,j,k)]*x[IX(i,j,k)]
-        - ae[IX(i,j,k)]*x[IX(i+1,j,k)] - aw[IX(i,j,k)]*x[IX(i-1,j,k)]
-        - an[IX(i,j,k)]*x[IX(i,j+1,k)] - as[IX(i,j,k)]*x[IX(i,j-1,k)]
-        - af[IX(i,j,k)]*x[IX(i,j,k+1)] - ab[IX(i,j,k)]*x[IX(i,j,k-1)]
-        - b[IX(i,j,k)]);
-    tmp2 += (REAL) fabs(ap[IX(i,j,k)]*x[IX(i,j,k)]);
-  END_FOR
+  if(!converged)
+    residual = GS_residual(para, var, flagp, x);
+  count_equation(para, EQU_PRESSURE, it, residual);
 
-  residual = tmp1 /tmp2;
-  /*printf ("the pressure of cell[imax,jmax,kmax] is %f\n", x[IX(imax,jmax,kmax)]);*/
-  /*printf ("the average pressure residual is %.12f\n", residual);*/
-  /*printf ("it is %d \n", it);*/
-  /*}*/
   return residual;
 
 } /* End of GS_P()*/
@@ -141,29 +231,36 @@ REAL GS_P(PARA_DATA *para, REAL **var, int Type, REAL *x) {
 	/*
 		* Gauss-Seidel solver
 		*
+		* An iteration consists of a forward and a backward sweep. The number
+		* of iterations and the tolerance depend on the equation of var_type.
+		*
 		* @param para Pointer to FFD parameters
 		* @param var Pointer to FFD simulation variables
 		* @param flag Pointer to the cell property flag
 		* @param x Pointer to variable
+		* @param var_type Type of variable
 		*
 		* @return Residual
 		*/
-REAL Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flag, REAL *x) {
+REAL Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                  int var_type) {
   REAL *as = var[AS], *aw = var[AW], *ae = var[AE], *an = var[AN];
   REAL *ap = var[AP], *af = var[AF], *ab = var[AB], *b = var[B];
   int imax = para->geom->imax, jmax= para->geom->jmax;
   int kmax = para->geom->kmax;
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
-  int i, j, k, it=0;
-  REAL tmp1, tmp2, residual;
+  int i, j, k, it, converged = 0;
+  EQUATION equ = equation_type(var_type);
+  REAL residual = 0;
 
   /****************************************************************************
   | Gauss-Seidel solver
   ****************************************************************************/
-  for(it=0; it<20; it++) {
-    for(i=1; i<=imax; i++)
+  for(it=0; it<para->solv->gs_it_max[equ] && !converged; ) {
+    /* Sweep forward and backward in the order of the memory*/
+    for(k=1; k<=kmax; k++)
       for(j=1; j<=jmax; j++)
-        for(k=1; k<=kmax; k++) {
+        for(i=1; i<=imax; i++) {
           if (flag[IX(i,j,k)]>=0) continue;
 
 
@@ -177,9 +274,9 @@ REAL Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flag, REAL *x) {
 
         }
 
-    for(i=imax; i>=1; i--)
+    for(k=kmax; k>=1; k--)
       for(j=jmax; j>=1; j--)
-        for(k=kmax; k>=1; k--) {
+        for(i=imax; i>=1; i--) {
           if (flag[IX(i,j,k)]>=0) continue;
 
           x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
@@ -190,26 +287,106 @@ REAL Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flag, REAL *x) {
                           + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
                           + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
         }
+
+    it++;
+    if(check_now(para, equ, it)) {
+      residual = GS_residual(para, var, flag, x);
+      converged = residual<=para->solv->gs_tol[equ];
+    }
   }
+  count_iterations(para, GS, it);
 
   /****************************************************************************
   | Calculate residual
   ****************************************************************************/
-  tmp1 = 0;
-  tmp2 = (REAL)0.0000000001;
+  if(!converged)
+    residual = GS_residual(para, var, flag, x);
+  count_equation(para, equ, it, residual);
 
-  FOR_EACH_CELL
-    if (flag[IX(i,j,k)]>=0) continue;
-    tmp1 += (REAL) fabs(ap[IX(i,j,k)]*x[IX(i,j,k)]
-        - ae[IX(i,j,k)]*x[IX(i+1,j,k)] - aw[IX(i,j,k)]*x[IX(i-1,j,k)]
-        - an[IX(i,j,k)]*x[IX(i,j+1,k)] - as[IX(i,j,k)]*x[IX(i,j-1,k)]
-        - af[IX(i,j,k)]*x[IX(i,j,k+1)] - ab[IX(i,j,k)]*x[IX(i,j,k-1)]
-        - b[IX(i,j,k)]);
-    tmp2 += (REAL) fabs(ap[IX(i,j,k)]*x[IX(i,j,k)]);
-  END_FOR
-
-  residual = tmp1 /tmp2;
-  /*printf ("the average residual for velocity/T is %.12f\n", tmp1/(imax*jmax*kmax));*/
   return residual;
 
 } /* End of Gauss-Seidel( )*/
+
+	/*
+		* Gauss-Seidel solver for several right hand sides
+		*
+		* The equations share the coefficients in var. The variables and the
+		* right hand sides are interleaved, so that the coefficients of a cell
+		* are loaded once for all equations. Each equation is swept in the same
+		* order as in Gauss_Seidel() and gets the same result for the same number
+		* of iterations. The solver
+		* uses the iteration budget of the species. It stops earlier when the
+		* residual of all equations is below solv.gs_tol_species.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param nb Number of equations
+		* @param x Pointer to the variables, x[IX(i,j,k)*nb+n] for equation n
+		* @param b Pointer to the right hand sides, stored like x
+		*
+		* @return Residual of all equations
+		*/
+REAL Gauss_Seidel_multi(PARA_DATA *para, REAL **var, REAL *flag, int nb,
+                        REAL *x, REAL *b) {
+  REAL *as = var[AS], *aw = var[AW], *ae = var[AE], *an = var[AN];
+  REAL *ap = var[AP], *af = var[AF], *ab = var[AB];
+  int imax = para->geom->imax, jmax= para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k, n, it, c, converged = 0;
+  int si = nb, sj = nb*IMAX, sk = nb*IJMAX;
+  REAL *xc;
+  REAL residual = 0;
+
+  /****************************************************************************
+  | Gauss-Seidel solver
+  ****************************************************************************/
+  for(it=0; it<para->solv->gs_it_max[EQU_SPECIES] && !converged; ) {
+    /* Sweep forward and backward in the order of the memory*/
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++) {
+          c = IX(i,j,k);
+          if (flag[c]>=0) continue;
+
+          xc = x + c*nb;
+          for(n=0; n<nb; n++)
+            xc[n] = (  ae[c]*xc[n+si] + aw[c]*xc[n-si]
+                     + an[c]*xc[n+sj] + as[c]*xc[n-sj]
+                     + af[c]*xc[n+sk] + ab[c]*xc[n-sk]
+                     + b[c*nb+n] ) / ap[c];
+        }
+
+    for(k=kmax; k>=1; k--)
+      for(j=jmax; j>=1; j--)
+        for(i=imax; i>=1; i--) {
+          c = IX(i,j,k);
+          if (flag[c]>=0) continue;
+
+          xc = x + c*nb;
+          for(n=0; n<nb; n++)
+            xc[n] = (  ae[c]*xc[n+si] + aw[c]*xc[n-si]
+                     + an[c]*xc[n+sj] + as[c]*xc[n-sj]
+                     + af[c]*xc[n+sk] + ab[c]*xc[n-sk]
+                     + b[c*nb+n] ) / ap[c];
+        }
+
+    it++;
+    if(check_now(para, EQU_SPECIES, it)) {
+      residual = residual_multi(para, var, flag, nb, x, b);
+      converged = residual<=para->solv->gs_tol[EQU_SPECIES];
+    }
+  }
+  count_iterations(para, GS, it);
+
+  /****************************************************************************
+  | Calculate residual
+  ****************************************************************************/
+  if(!converged)
+    residual = residual_multi(para, var, flag, nb, x, b);
+  count_equation(para, EQU_SPECIES, it, residual);
+
+  return residual;
+
+} /* End of Gauss_Seidel_multi( )*/
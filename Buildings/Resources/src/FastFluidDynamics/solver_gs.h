@@ -34,6 +34,32 @@
 #include "utility.h"
 #endif
 
+#ifndef _TIMING_H
+#define _TIMING_H
+#include "timing.h"
+#endif
+
+/*
+	* Get the equation of a variable type
+	*
+	* @param var_type Type of variable
+	*
+	* @return Equation whose iteration budget is used
+	*/
+EQUATION equation_type(int var_type);
+
+/*
+	* Calculate the residual of the equation of a variable
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param flag Pointer to the cell property flag
+	* @param x Pointer to variable
+	*
+	* @return Residual
+	*/
+REAL GS_residual(PARA_DATA *para, REAL **var, REAL *flag, REAL *x);
+
 /*
 	* Gauss-Seidel solver for pressure
 	*
@@ -53,7 +79,24 @@ REAL GS_P(PARA_DATA *para, REAL **var, int Type, REAL *x);
 	* @param var Pointer to FFD simulation variables
 	* @param flag Pointer to the cell property flag
 	* @param x Pointer to variable
+	* @param var_type Type of variable
 	*
 	* @return Residual
 	*/
-REAL Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flagp, REAL *x);
+REAL Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flagp, REAL *x,
+                  int var_type);
+
+/*
+	* Gauss-Seidel solver for several right hand sides
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param flag Pointer to the cell property flag
+	* @param nb Number of equations
+	* @param x Pointer to the variables, x[IX(i,j,k)*nb+n] for equation n
+	* @param b Pointer to the right hand sides, stored like x
+	*
+	* @return Residual of all equations
+	*/
+REAL Gauss_Seidel_multi(PARA_DATA *para, REAL **var, REAL *flag, int nb,
+                        REAL *x, REAL *b);
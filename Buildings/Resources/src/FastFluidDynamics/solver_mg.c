@@ -0,0 +1,426 @@
+/*
+	*
+	* \file   solver_mg.c
+	*
+	* \brief  Geometric multigrid solver for the pressure equation
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "solver_mg.h"
+
+#define MG_LEVEL_MAX 16 /* Maximum number of grid levels*/
+#define MG_CELL_MIN 64 /* Stop coarsening if a grid has fewer cells*/
+#define MG_SWEEP_COARSEST 100 /* Symmetric sweeps on the coarsest grid*/
+
+/* Equations on one grid level*/
+typedef struct {
+  int imax; /* Number of interior cells in x-direction*/
+  int jmax; /* Number of interior cells in y-direction*/
+  int kmax; /* Number of interior cells in z-direction*/
+  int cx; /* 1: merged from the finer level in x-direction; 0: not merged*/
+  int cy; /* 1: merged from the finer level in y-direction; 0: not merged*/
+  int cz; /* 1: merged from the finer level in z-direction; 0: not merged*/
+  REAL *ap, *ae, *aw, *an, *as, *af, *ab; /* Coefficients*/
+  REAL *b; /* Right hand side*/
+  REAL *x; /* Solution*/
+  REAL *r; /* Residual*/
+  REAL *flag; /* Negative for fluid cells*/
+} MG_LEVEL;
+
+typedef struct {
+  int nb_level; /* Number of grid levels*/
+  MG_LEVEL level[MG_LEVEL_MAX];
+} MG_DATA;
+
+	/*
+		* Allocate the hierarchy of grids
+		*
+		* The finest level points to the arrays in var and only owns the
+		* residual.
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return Pointer to the hierarchy, NULL if memory could not be allocated
+		*/
+static MG_DATA *mg_allocate(PARA_DATA *para) {
+  MG_DATA *mg;
+  MG_LEVEL *lv;
+  int l, size;
+
+  mg = (MG_DATA *) calloc(1, sizeof(MG_DATA));
+  if(mg==NULL) return NULL;
+
+  mg->level[0].imax = para->geom->imax;
+  mg->level[0].jmax = para->geom->jmax;
+  mg->level[0].kmax = para->geom->kmax;
+  size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+  mg->level[0].r = (REAL *) calloc(size, sizeof(REAL));
+  if(mg->level[0].r==NULL) {
+    free(mg);
+    return NULL;
+  }
+  mg->nb_level = 1;
+
+  /****************************************************************************
+  | Merge cells until the grid is small enough
+  ****************************************************************************/
+  for(l=1; l<MG_LEVEL_MAX; l++) {
+    lv = &mg->level[l];
+    lv->cx = mg->level[l-1].imax>2;
+    lv->cy = mg->level[l-1].jmax>2;
+    lv->cz = mg->level[l-1].kmax>2;
+    if(!(lv->cx || lv->cy || lv->cz)) break;
+    if(mg->level[l-1].imax*mg->level[l-1].jmax*mg->level[l-1].kmax
+       <=MG_CELL_MIN) break;
+
+    lv->imax = lv->cx ? (mg->level[l-1].imax+1)/2 : mg->level[l-1].imax;
+    lv->jmax = lv->cy ? (mg->level[l-1].jmax+1)/2 : mg->level[l-1].jmax;
+    lv->kmax = lv->cz ? (mg->level[l-1].kmax+1)/2 : mg->level[l-1].kmax;
+
+    size = (lv->imax+2)*(lv->jmax+2)*(lv->kmax+2);
+    /* One block for ap, ae, aw, an, as, af, ab, b, x, r and flag*/
+    lv->ap = (REAL *) calloc(11*size, sizeof(REAL));
+    if(lv->ap==NULL) break;
+    lv->ae = lv->ap + size;
+    lv->aw = lv->ap + 2*size;
+    lv->an = lv->ap + 3*size;
+    lv->as = lv->ap + 4*size;
+    lv->af = lv->ap + 5*size;
+    lv->ab = lv->ap + 6*size;
+    lv->b = lv->ap + 7*size;
+    lv->x = lv->ap + 8*size;
+    lv->r = lv->ap + 9*size;
+    lv->flag = lv->ap + 10*size;
+    mg->nb_level++;
+  }
+
+  return mg;
+} /* End of mg_allocate()*/
+
+	/*
+		* Symmetric Gauss-Seidel sweeps on one level
+		*
+		* @param lv Pointer to the level
+		* @param nb_sweep Number of forward and backward sweeps
+		*
+		* @return No return needed
+		*/
+static void mg_smooth(MG_LEVEL *lv, int nb_sweep) {
+  REAL *ap = lv->ap, *ae = lv->ae, *aw = lv->aw, *an = lv->an;
+  REAL *as = lv->as, *af = lv->af, *ab = lv->ab, *b = lv->b;
+  REAL *x = lv->x, *flag = lv->flag;
+  int imax = lv->imax, jmax = lv->jmax, kmax = lv->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k, it;
+
+  for(it=0; it<nb_sweep; it++) {
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++) {
+          if(flag[IX(i,j,k)]>=0 || ap[IX(i,j,k)]==0) continue;
+          x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
+                          + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                          + an[IX(i,j,k)]*x[IX(i,j+1,k)]
+                          + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                          + af[IX(i,j,k)]*x[IX(i,j,k+1)]
+                          + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
+                          + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
+        }
+
+    for(k=kmax; k>=1; k--)
+      for(j=jmax; j>=1; j--)
+        for(i=imax; i>=1; i--) {
+          if(flag[IX(i,j,k)]>=0 || ap[IX(i,j,k)]==0) continue;
+          x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
+                          + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                          + an[IX(i,j,k)]*x[IX(i,j+1,k)]
+                          + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                          + af[IX(i,j,k)]*x[IX(i,j,k+1)]
+                          + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
+                          + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
+        }
+  }
+} /* End of mg_smooth()*/
+
+	/*
+		* Compute the residual of the fluid cells on one level
+		*
+		* @param lv Pointer to the level
+		*
+		* @return No return needed
+		*/
+static void mg_residual(MG_LEVEL *lv) {
+  REAL *ap = lv->ap, *ae = lv->ae, *aw = lv->aw, *an = lv->an;
+  REAL *as = lv->as, *af = lv->af, *ab = lv->ab, *b = lv->b;
+  REAL *x = lv->x, *r = lv->r, *flag = lv->flag;
+  int imax = lv->imax, jmax = lv->jmax, kmax = lv->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flag[IX(i,j,k)]>=0) {
+          r[IX(i,j,k)] = 0;
+          continue;
+        }
+        r[IX(i,j,k)] = b[IX(i,j,k)] - ap[IX(i,j,k)]*x[IX(i,j,k)]
+                     + ae[IX(i,j,k)]*x[IX(i+1,j,k)] + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                     + an[IX(i,j,k)]*x[IX(i,j+1,k)] + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                     + af[IX(i,j,k)]*x[IX(i,j,k+1)] + ab[IX(i,j,k)]*x[IX(i,j,k-1)];
+      }
+} /* End of mg_residual()*/
+
+	/*
+		* Build the coarse equations by summing the fine equations
+		*
+		* A fine cell (i,j,k) belongs to the coarse cell (I,J,K) with
+		* I=(i+1)/2 if the x-direction is merged, otherwise I=i.
+		* The coupling between two fine cells in the same coarse cell is
+		* moved to the diagonal. The coupling to a non-fluid cell is dropped
+		* since the correction is zero there.
+		*
+		* @param fine Pointer to the fine level
+		* @param coarse Pointer to the coarse level
+		*
+		* @return No return needed
+		*/
+static void mg_coarsen(MG_LEVEL *fine, MG_LEVEL *coarse) {
+  int imax = fine->imax, jmax = fine->jmax, kmax = fine->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int CMAX = coarse->imax+2, CJMAX = (coarse->imax+2)*(coarse->jmax+2);
+  int size = (coarse->imax+2)*(coarse->jmax+2)*(coarse->kmax+2);
+  int i, j, k, n, c, cn;
+  REAL *flag = fine->flag;
+
+  for(n=0; n<size; n++) {
+    coarse->ap[n] = 0;
+    coarse->ae[n] = 0;
+    coarse->aw[n] = 0;
+    coarse->an[n] = 0;
+    coarse->as[n] = 0;
+    coarse->af[n] = 0;
+    coarse->ab[n] = 0;
+    coarse->flag[n] = 1;
+  }
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flag[IX(i,j,k)]>=0) continue;
+
+        c = (coarse->cx ? (i+1)/2 : i) + CMAX*(coarse->cy ? (j+1)/2 : j)
+          + CJMAX*(coarse->cz ? (k+1)/2 : k);
+        coarse->flag[c] = -1;
+        coarse->ap[c] += fine->ap[IX(i,j,k)];
+
+        /*.....................................................................
+        | Merged neighbor: coupling goes to the diagonal
+        | Other neighbor: coupling goes to the same direction
+        .....................................................................*/
+        if(i<imax && flag[IX(i+1,j,k)]<0) {
+          cn = (coarse->cx && i%2==1) ? c : c+1;
+          if(cn==c) coarse->ap[c] -= fine->ae[IX(i,j,k)];
+          else coarse->ae[c] += fine->ae[IX(i,j,k)];
+        }
+        if(i>1 && flag[IX(i-1,j,k)]<0) {
+          cn = (coarse->cx && i%2==0) ? c : c-1;
+          if(cn==c) coarse->ap[c] -= fine->aw[IX(i,j,k)];
+          else coarse->aw[c] += fine->aw[IX(i,j,k)];
+        }
+        if(j<jmax && flag[IX(i,j+1,k)]<0) {
+          cn = (coarse->cy && j%2==1) ? c : c+CMAX;
+          if(cn==c) coarse->ap[c] -= fine->an[IX(i,j,k)];
+          else coarse->an[c] += fine->an[IX(i,j,k)];
+        }
+        if(j>1 && flag[IX(i,j-1,k)]<0) {
+          cn = (coarse->cy && j%2==0) ? c : c-CMAX;
+          if(cn==c) coarse->ap[c] -= fine->as[IX(i,j,k)];
+          else coarse->as[c] += fine->as[IX(i,j,k)];
+        }
+        if(k<kmax && flag[IX(i,j,k+1)]<0) {
+          cn = (coarse->cz && k%2==1) ? c : c+CJMAX;
+          if(cn==c) coarse->ap[c] -= fine->af[IX(i,j,k)];
+          else coarse->af[c] += fine->af[IX(i,j,k)];
+        }
+        if(k>1 && flag[IX(i,j,k-1)]<0) {
+          cn = (coarse->cz && k%2==0) ? c : c-CJMAX;
+          if(cn==c) coarse->ap[c] -= fine->ab[IX(i,j,k)];
+          else coarse->ab[c] += fine->ab[IX(i,j,k)];
+        }
+      }
+} /* End of mg_coarsen()*/
+
+	/*
+		* Restrict the residual of the fine level to the right hand side of
+		* the coarse level and reset the coarse solution
+		*
+		* @param fine Pointer to the fine level
+		* @param coarse Pointer to the coarse level
+		*
+		* @return No return needed
+		*/
+static void mg_restrict(MG_LEVEL *fine, MG_LEVEL *coarse) {
+  int imax = fine->imax, jmax = fine->jmax, kmax = fine->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int CMAX = coarse->imax+2, CJMAX = (coarse->imax+2)*(coarse->jmax+2);
+  int size = (coarse->imax+2)*(coarse->jmax+2)*(coarse->kmax+2);
+  int i, j, k, n;
+
+  for(n=0; n<size; n++) {
+    coarse->b[n] = 0;
+    coarse->x[n] = 0;
+  }
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++)
+        coarse->b[(coarse->cx ? (i+1)/2 : i) + CMAX*(coarse->cy ? (j+1)/2 : j)
+                  + CJMAX*(coarse->cz ? (k+1)/2 : k)] += fine->r[IX(i,j,k)];
+} /* End of mg_restrict()*/
+
+	/*
+		* Add the coarse correction to the fine solution
+		*
+		* @param fine Pointer to the fine level
+		* @param coarse Pointer to the coarse level
+		*
+		* @return No return needed
+		*/
+static void mg_prolong(MG_LEVEL *fine, MG_LEVEL *coarse) {
+  int imax = fine->imax, jmax = fine->jmax, kmax = fine->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int CMAX = coarse->imax+2, CJMAX = (coarse->imax+2)*(coarse->jmax+2);
+  int i, j, k;
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(fine->flag[IX(i,j,k)]>=0) continue;
+        fine->x[IX(i,j,k)] +=
+          coarse->x[(coarse->cx ? (i+1)/2 : i) + CMAX*(coarse->cy ? (j+1)/2 : j)
+                    + CJMAX*(coarse->cz ? (k+1)/2 : k)];
+      }
+} /* End of mg_prolong()*/
+
+	/*
+		* Perform one multigrid cycle starting from level l
+		*
+		* @param mg Pointer to the hierarchy
+		* @param l Level
+		* @param gamma 1: V-cycle; 2: W-cycle
+		*
+		* @return No return needed
+		*/
+static void mg_cycle(MG_DATA *mg, int l, int gamma) {
+  int n;
+
+  if(l==mg->nb_level-1) {
+    mg_smooth(&mg->level[l], MG_SWEEP_COARSEST);
+    return;
+  }
+
+  mg_smooth(&mg->level[l], 1);
+  mg_residual(&mg->level[l]);
+  mg_restrict(&mg->level[l], &mg->level[l+1]);
+  /* The coarsest level is solved once since it is solved almost exactly*/
+  for(n=0; n<(l+1==mg->nb_level-1 ? 1 : gamma); n++)
+    mg_cycle(mg, l+1, gamma);
+  mg_prolong(&mg->level[l], &mg->level[l+1]);
+  mg_smooth(&mg->level[l], 1);
+} /* End of mg_cycle()*/
+
+	/*
+		* Multigrid solver for pressure
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param Type Type of variable
+		* @param x Pointer to variable
+		*
+		* @return Residual
+		*/
+REAL MG_P(PARA_DATA *para, REAL **var, int Type, REAL *x) {
+  MG_DATA *mg;
+  MG_LEVEL *lv;
+  REAL residual, residual0;
+  int l, it;
+
+  /****************************************************************************
+  | Allocate the hierarchy at the first call
+  ****************************************************************************/
+  if(para->solv->mg==NULL) {
+    para->solv->mg = mg_allocate(para);
+    if(para->solv->mg==NULL) {
+      ffd_log("MG_P(): Could not allocate memory for multigrid solver.",
+              FFD_ERROR);
+      return 1;
+    }
+    sprintf(msg, "MG_P(): Multigrid solver uses %d levels.",
+            ((MG_DATA *) para->solv->mg)->nb_level);
+    ffd_log(msg, FFD_NORMAL);
+  }
+  mg = (MG_DATA *) para->solv->mg;
+
+  /****************************************************************************
+  | Link the finest level to the FFD variables and build the coarse equations
+  ****************************************************************************/
+  lv = &mg->level[0];
+  lv->ap = var[AP];
+  lv->ae = var[AE];
+  lv->aw = var[AW];
+  lv->an = var[AN];
+  lv->as = var[AS];
+  lv->af = var[AF];
+  lv->ab = var[AB];
+  lv->b = var[B];
+  lv->x = x;
+  lv->flag = var[FLAGP];
+
+  for(l=1; l<mg->nb_level; l++)
+    mg_coarsen(&mg->level[l-1], &mg->level[l]);
+
+  /****************************************************************************
+  | Cycle until the residual dropped enough
+  ****************************************************************************/
+  residual0 = check_residual(para, var, x);
+  residual = residual0;
+
+  for(it=0; it<para->solv->p_it_max; it++) {
+    if(residual<=para->solv->p_tol*residual0 || residual<1e-30) break;
+    mg_cycle(mg, 0, para->solv->mg_cycle==W_CYCLE ? 2 : 1);
+    residual = check_residual(para, var, x);
+  }
+
+  count_iterations(para, MG, it);
+
+  if(para->outp->version==DEBUG) {
+    sprintf(msg, "MG_P(): %d cycles reduced the residual from %e to %e.",
+            it, residual0, residual);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
+  return residual;
+} /* End of MG_P()*/
+
+	/*
+		* Free the memory of the multigrid hierarchy
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return No return needed
+		*/
+void free_multigrid(PARA_DATA *para) {
+  MG_DATA *mg = (MG_DATA *) para->solv->mg;
+  int l;
+
+  if(mg==NULL) return;
+
+  free(mg->level[0].r);
+  for(l=1; l<mg->nb_level; l++)
+    free(mg->level[l].ap);
+  free(mg);
+  para->solv->mg = NULL;
+} /* End of free_multigrid()*/
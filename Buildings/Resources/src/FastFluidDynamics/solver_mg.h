@@ -0,0 +1,58 @@
+/*
+	*
+	* @file   solver_mg.h
+	*
+	* @brief  Geometric multigrid solver for the pressure equation
+	*
+	* @date   10/18/2026
+	*
+	* The coarse grids are built by merging 2 cells in each direction that has
+	* more than 2 cells. The coarse equations are obtained by summing the fine
+	* equations of the merged fluid cells (additive correction). Thus the
+	* non-uniform grids and the solid cells marked by FLAGP need no special
+	* treatment.
+	*
+	*/
+
+#ifndef _SOLVER_MG_H
+#define _SOLVER_MG_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+#ifndef _TIMING_H
+#define _TIMING_H
+#include "timing.h"
+#endif
+
+/*
+	* Multigrid solver for pressure
+	*
+	* Cycles are repeated until the residual computed by check_residual()
+	* dropped by solv.p_tol or solv.p_it_max cycles were performed.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param Type Type of variable
+	* @param x Pointer to variable
+	*
+	* @return Residual
+	*/
+REAL MG_P(PARA_DATA *para, REAL **var, int Type, REAL *x);
+
+/*
+	* Free the memory of the multigrid hierarchy
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_multigrid(PARA_DATA *para);
@@ -0,0 +1,359 @@
+/*
+	*
+	* \file   solver_pcg.c
+	*
+	* \brief  Preconditioned conjugate gradient solvers
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "solver_pcg.h"
+
+/* Work space of the solver*/
+typedef struct {
+  int size; /* Number of cells including the ghost cells*/
+  REAL *r; /* Residual*/
+  REAL *z; /* Preconditioned residual*/
+  REAL *p; /* Search direction*/
+  REAL *q; /* Product of the matrix and the search direction*/
+  REAL *d; /* Diagonal of the incomplete Cholesky factorization*/
+} PCG_DATA;
+
+	/*
+		* Get the work space and allocate it at the first call
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return Pointer to the work space, NULL if memory could not be allocated
+		*/
+static PCG_DATA *pcg_workspace(PARA_DATA *para) {
+  PCG_DATA *pcg = (PCG_DATA *) para->solv->pcg;
+  int size;
+
+  if(pcg!=NULL) return pcg;
+
+  size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+  pcg = (PCG_DATA *) malloc(sizeof(PCG_DATA));
+  if(pcg==NULL) return NULL;
+  /* One block for r, z, p, q and d*/
+  pcg->r = (REAL *) calloc(5*size, sizeof(REAL));
+  if(pcg->r==NULL) {
+    free(pcg);
+    return NULL;
+  }
+  pcg->size = size;
+  pcg->z = pcg->r + size;
+  pcg->p = pcg->r + 2*size;
+  pcg->q = pcg->r + 3*size;
+  pcg->d = pcg->r + 4*size;
+
+  para->solv->pcg = pcg;
+  return pcg;
+} /* End of pcg_workspace()*/
+
+	/*
+		* Compute the diagonal of the incomplete Cholesky factorization
+		*
+		* Only the couplings between fluid cells are factorized.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param d Pointer to the diagonal
+		*
+		* @return No return needed
+		*/
+static void pcg_factorize(PARA_DATA *para, REAL **var, REAL *flag, REAL *d) {
+  REAL *ap = var[AP], *ae = var[AE], *aw = var[AW], *an = var[AN];
+  REAL *as = var[AS], *af = var[AF], *ab = var[AB];
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+  REAL tmp;
+
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flag[IX(i,j,k)]>=0) continue;
+        tmp = ap[IX(i,j,k)];
+        if(i>1 && flag[IX(i-1,j,k)]<0)
+          tmp -= aw[IX(i,j,k)]*ae[IX(i-1,j,k)]/d[IX(i-1,j,k)];
+        if(j>1 && flag[IX(i,j-1,k)]<0)
+          tmp -= as[IX(i,j,k)]*an[IX(i,j-1,k)]/d[IX(i,j-1,k)];
+        if(k>1 && flag[IX(i,j,k-1)]<0)
+          tmp -= ab[IX(i,j,k)]*af[IX(i,j,k-1)]/d[IX(i,j,k-1)];
+        /* Fall back to the diagonal if the factorization breaks down*/
+        d[IX(i,j,k)] = tmp>SMALL*ap[IX(i,j,k)] ? tmp : ap[IX(i,j,k)];
+      }
+} /* End of pcg_factorize()*/
+
+	/*
+		* Apply the preconditioner z = M^-1 r
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param pcg Pointer to the work space
+		*
+		* @return No return needed
+		*/
+static void pcg_precondition(PARA_DATA *para, REAL **var, REAL *flag,
+                             PCG_DATA *pcg) {
+  REAL *ap = var[AP], *ae = var[AE], *aw = var[AW], *an = var[AN];
+  REAL *as = var[AS], *af = var[AF], *ab = var[AB];
+  REAL *r = pcg->r, *z = pcg->z, *d = pcg->d;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+
+  if(para->solv->pcg_precond==JACOBI) {
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++)
+          if(flag[IX(i,j,k)]<0) z[IX(i,j,k)] = r[IX(i,j,k)] / ap[IX(i,j,k)];
+    return;
+  }
+
+  /****************************************************************************
+  | Forward substitution (D+L) w = r. The values of z at non-fluid cells are
+  | zero and do not contribute.
+  ****************************************************************************/
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flag[IX(i,j,k)]>=0) continue;
+        z[IX(i,j,k)] = (r[IX(i,j,k)] + aw[IX(i,j,k)]*z[IX(i-1,j,k)]
+                     + as[IX(i,j,k)]*z[IX(i,j-1,k)]
+                     + ab[IX(i,j,k)]*z[IX(i,j,k-1)]) / d[IX(i,j,k)];
+      }
+
+  /****************************************************************************
+  | Backward substitution (D+U) z = D w
+  ****************************************************************************/
+  for(k=kmax; k>=1; k--)
+    for(j=jmax; j>=1; j--)
+      for(i=imax; i>=1; i--) {
+        if(flag[IX(i,j,k)]>=0) continue;
+        z[IX(i,j,k)] += (ae[IX(i,j,k)]*z[IX(i+1,j,k)]
+                      + an[IX(i,j,k)]*z[IX(i,j+1,k)]
+                      + af[IX(i,j,k)]*z[IX(i,j,k+1)]) / d[IX(i,j,k)];
+      }
+} /* End of pcg_precondition()*/
+
+	/*
+		* Preconditioned conjugate gradient iterations
+		*
+		* The values at the non-fluid cells are fixed. Their part of the
+		* search direction is therefore zero.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param x Pointer to variable
+		* @param tol Reduction of the squared residual at which the solver stops
+		* @param it_max Maximum number of iterations
+		* @param residual Pointer to the mean squared residual at the end
+		*
+		* @return Number of iterations, -1 if the iterations broke down
+		*/
+static int pcg_solve(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                     REAL tol, int it_max, REAL *residual) {
+  REAL *ap = var[AP], *ae = var[AE], *aw = var[AW], *an = var[AN];
+  REAL *as = var[AS], *af = var[AF], *ab = var[AB], *b = var[B];
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k, n, it, nb_fluid = 0;
+  REAL rr, rr0, rz, rz_old, pq, alpha, beta;
+  REAL *r, *z, *p, *q;
+  PCG_DATA *pcg;
+
+  pcg = pcg_workspace(para);
+  if(pcg==NULL) {
+    ffd_log("pcg_solve(): Could not allocate memory for PCG solver.",
+            FFD_WARNING);
+    return -1;
+  }
+  r = pcg->r;
+  z = pcg->z;
+  p = pcg->p;
+  q = pcg->q;
+
+  for(n=0; n<pcg->size; n++) {
+    r[n] = 0;
+    z[n] = 0;
+    p[n] = 0;
+  }
+
+  /****************************************************************************
+  | Initial residual
+  ****************************************************************************/
+  rr0 = 0;
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flag[IX(i,j,k)]>=0) continue;
+        r[IX(i,j,k)] = b[IX(i,j,k)] - ap[IX(i,j,k)]*x[IX(i,j,k)]
+                     + ae[IX(i,j,k)]*x[IX(i+1,j,k)] + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                     + an[IX(i,j,k)]*x[IX(i,j+1,k)] + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                     + af[IX(i,j,k)]*x[IX(i,j,k+1)] + ab[IX(i,j,k)]*x[IX(i,j,k-1)];
+        rr0 += r[IX(i,j,k)]*r[IX(i,j,k)];
+        nb_fluid++;
+      }
+
+  *residual = nb_fluid>0 ? rr0/nb_fluid : 0;
+  if(rr0<1e-30) return 0;
+
+  if(para->solv->pcg_precond==IC) pcg_factorize(para, var, flag, pcg->d);
+
+  pcg_precondition(para, var, flag, pcg);
+  rz = 0;
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        if(flag[IX(i,j,k)]>=0) continue;
+        p[IX(i,j,k)] = z[IX(i,j,k)];
+        rz += r[IX(i,j,k)]*z[IX(i,j,k)];
+      }
+
+  /****************************************************************************
+  | Iterate
+  ****************************************************************************/
+  rr = rr0;
+  for(it=1; it<=it_max; it++) {
+    pq = 0;
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++) {
+          if(flag[IX(i,j,k)]>=0) continue;
+          q[IX(i,j,k)] = ap[IX(i,j,k)]*p[IX(i,j,k)]
+                       - ae[IX(i,j,k)]*p[IX(i+1,j,k)] - aw[IX(i,j,k)]*p[IX(i-1,j,k)]
+                       - an[IX(i,j,k)]*p[IX(i,j+1,k)] - as[IX(i,j,k)]*p[IX(i,j-1,k)]
+                       - af[IX(i,j,k)]*p[IX(i,j,k+1)] - ab[IX(i,j,k)]*p[IX(i,j,k-1)];
+          pq += p[IX(i,j,k)]*q[IX(i,j,k)];
+        }
+
+    /* Not positive definite, e.g. non-symmetric coefficients*/
+    if(pq<=0) return -1;
+
+    alpha = rz / pq;
+    rr = 0;
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++) {
+          if(flag[IX(i,j,k)]>=0) continue;
+          x[IX(i,j,k)] += alpha*p[IX(i,j,k)];
+          r[IX(i,j,k)] -= alpha*q[IX(i,j,k)];
+          rr += r[IX(i,j,k)]*r[IX(i,j,k)];
+        }
+
+    if(rr<=tol*rr0) break;
+
+    pcg_precondition(para, var, flag, pcg);
+    rz_old = rz;
+    rz = 0;
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++) {
+          if(flag[IX(i,j,k)]>=0) continue;
+          rz += r[IX(i,j,k)]*z[IX(i,j,k)];
+        }
+
+    beta = rz / rz_old;
+    for(k=1; k<=kmax; k++)
+      for(j=1; j<=jmax; j++)
+        for(i=1; i<=imax; i++) {
+          if(flag[IX(i,j,k)]>=0) continue;
+          p[IX(i,j,k)] = z[IX(i,j,k)] + beta*p[IX(i,j,k)];
+        }
+  }
+
+  *residual = rr/nb_fluid;
+  return it>it_max ? it_max : it;
+} /* End of pcg_solve()*/
+
+	/*
+		* Preconditioned conjugate gradient solver for pressure
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param Type Type of variable
+		* @param x Pointer to variable
+		*
+		* @return Residual
+		*/
+REAL PCG_P(PARA_DATA *para, REAL **var, int Type, REAL *x) {
+  REAL residual;
+  int it;
+
+  it = pcg_solve(para, var, var[FLAGP], x, para->solv->p_tol,
+                 para->solv->p_it_max, &residual);
+
+  if(it<0) {
+    ffd_log("PCG_P(): PCG solver broke down, use Gauss-Seidel solver instead.",
+            FFD_WARNING);
+    return GS_P(para, var, Type, x);
+  }
+  count_iterations(para, PCG, it);
+
+  if(para->outp->version==DEBUG) {
+    sprintf(msg, "PCG_P(): %d iterations, residual is %e.", it, residual);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
+  return residual;
+} /* End of PCG_P()*/
+
+	/*
+		* Preconditioned conjugate gradient solver
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param x Pointer to variable
+		* @param var_type Type of variable
+		*
+		* @return Residual
+		*/
+REAL Conjugate_Gradient(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                        int var_type) {
+  REAL residual;
+  int it;
+
+  it = pcg_solve(para, var, flag, x, para->solv->tol, para->solv->it_max,
+                 &residual);
+
+  if(it<0) {
+    ffd_log("Conjugate_Gradient(): PCG solver broke down, use Gauss-Seidel solver instead.",
+            FFD_WARNING);
+    return Gauss_Seidel(para, var, flag, x, var_type);
+  }
+  count_iterations(para, PCG, it);
+
+  if(para->outp->version==DEBUG) {
+    sprintf(msg, "Conjugate_Gradient(): %d iterations, residual is %e.", it, residual);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
+  return residual;
+} /* End of Conjugate_Gradient()*/
+
+	/*
+		* Free the work space of the conjugate gradient solver
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return No return needed
+		*/
+void free_pcg(PARA_DATA *para) {
+  PCG_DATA *pcg = (PCG_DATA *) para->solv->pcg;
+
+  if(pcg==NULL) return;
+
+  free(pcg->r);
+  free(pcg);
+  para->solv->pcg = NULL;
+} /* End of free_pcg()*/
@@ -0,0 +1,78 @@
+/*
+	*
+	* @file   solver_pcg.h
+	*
+	* @brief  Preconditioned conjugate gradient solvers
+	*
+	* @date   10/18/2026
+	*
+	* The solvers work on the seven-point coefficients var[AP], ..., var[AB]
+	* and var[B]. The preconditioner is either the diagonal (JACOBI) or the
+	* incomplete Cholesky factorization without fill-in (IC).
+	*
+	*/
+
+#ifndef _SOLVER_PCG_H
+#define _SOLVER_PCG_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _SOLVER_GS_H
+#define _SOLVER_GS_H
+#include "solver_gs.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+#ifndef _TIMING_H
+#define _TIMING_H
+#include "timing.h"
+#endif
+
+/*
+	* Preconditioned conjugate gradient solver for pressure
+	*
+	* Iterates until the squared residual dropped by solv.p_tol or
+	* solv.p_it_max iterations were performed.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param Type Type of variable
+	* @param x Pointer to variable
+	*
+	* @return Residual
+	*/
+REAL PCG_P(PARA_DATA *para, REAL **var, int Type, REAL *x);
+
+/*
+	* Preconditioned conjugate gradient solver
+	*
+	* Iterates until the squared residual dropped by solv.tol or
+	* solv.it_max iterations were performed.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param flag Pointer to the cell property flag
+	* @param x Pointer to variable
+	* @param var_type Type of variable
+	*
+	* @return Residual
+	*/
+REAL Conjugate_Gradient(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                        int var_type);
+
+/*
+	* Free the work space of the conjugate gradient solver
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_pcg(PARA_DATA *para);
@@ -0,0 +1,176 @@
+/*
+	*
+	* \file   solver_rbgs.c
+	*
+	* \brief  Multithreaded red-black Gauss-Seidel solvers
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "solver_rbgs.h"
+
+/* Work of the team*/
+typedef struct {
+  PARA_DATA *para;
+  REAL **var;
+  REAL *flag; /* Cell property flag*/
+  REAL *x; /* Variable to be solved*/
+  int nb_sweep; /* Number of red-black sweeps*/
+} RBGS_TASK;
+
+	/*
+		* Update all cells of one color in a slab of k-planes
+		*
+		* @param task Pointer to the task
+		* @param color 0: cells with even i+j+k; 1: cells with odd i+j+k
+		* @param k_start First k-plane of the slab
+		* @param k_end Last k-plane of the slab
+		*
+		* @return No return needed
+		*/
+static void rbgs_sweep(RBGS_TASK *task, int color, int k_start, int k_end) {
+  REAL **var = task->var;
+  REAL *as = var[AS], *aw = var[AW], *ae = var[AE], *an = var[AN];
+  REAL *ap = var[AP], *af = var[AF], *ab = var[AB], *b = var[B];
+  REAL *flag = task->flag, *x = task->x;
+  int imax = task->para->geom->imax, jmax = task->para->geom->jmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k;
+
+  for(k=k_start; k<=k_end; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1+((1+j+k+color)&1); i<=imax; i+=2) {
+        if (flag[IX(i,j,k)]>=0) continue;
+
+        x[IX(i,j,k)] = (  ae[IX(i,j,k)]*x[IX(i+1,j,k)]
+                        + aw[IX(i,j,k)]*x[IX(i-1,j,k)]
+                        + an[IX(i,j,k)]*x[IX(i,j+1,k)]
+                        + as[IX(i,j,k)]*x[IX(i,j-1,k)]
+                        + af[IX(i,j,k)]*x[IX(i,j,k+1)]
+                        + ab[IX(i,j,k)]*x[IX(i,j,k-1)]
+                        + b[IX(i,j,k)] ) / ap[IX(i,j,k)];
+      }
+} /* End of rbgs_sweep()*/
+
+	/*
+		* Run the red-black sweeps of one thread
+		*
+		* Each thread updates a slab of k-planes.
+		*
+		* @param arg Pointer to the task
+		* @param rank Rank of the thread
+		* @param size Number of threads of the team
+		* @param barrier Pointer to the barrier of the team
+		*
+		* @return No return needed
+		*/
+static void rbgs_run(void *arg, int rank, int size, TEAM_BARRIER *barrier) {
+  RBGS_TASK *task = (RBGS_TASK *) arg;
+  int kmax = task->para->geom->kmax;
+  int k_start = 1 + rank*kmax/size, k_end = (rank+1)*kmax/size;
+  int it;
+
+  for(it=0; it<task->nb_sweep; it++) {
+    rbgs_sweep(task, 0, k_start, k_end);
+    team_barrier_wait(barrier);
+    rbgs_sweep(task, 1, k_start, k_end);
+    team_barrier_wait(barrier);
+  }
+} /* End of rbgs_run()*/
+
+	/*
+		* Red-black Gauss-Seidel iterations executed by a team of threads
+		*
+		* The sweeps are run in blocks of solv.gs_check iterations if a
+		* tolerance is set for the equation. The residual is checked between
+		* the blocks.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param x Pointer to variable
+		* @param equ Equation
+		* @param nb_sweep Number of red-black sweeps of a GS iteration
+		*
+		* @return Residual
+		*/
+static REAL rbgs_solve(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                       EQUATION equ, int nb_sweep) {
+  int kmax = para->geom->kmax;
+  int it_max = para->solv->gs_it_max[equ];
+  REAL tol = para->solv->gs_tol[equ];
+  int it, nb, nb_thread, converged = 0;
+  REAL residual = 0;
+  RBGS_TASK task;
+
+  nb_thread = para->solv->nb_thread;
+  if(nb_thread>kmax) nb_thread = kmax;
+
+  task.para = para;
+  task.var = var;
+  task.flag = flag;
+  task.x = x;
+
+  /****************************************************************************
+  | Run the sweeps on a team of threads
+  ****************************************************************************/
+  for(it=0; it<it_max && !converged; it+=nb) {
+    nb = tol>0 ? para->solv->gs_check : it_max;
+    if(nb>it_max-it) nb = it_max-it;
+
+    task.nb_sweep = nb*nb_sweep;
+    team_run((THREAD_TEAM *) para->solv->team, nb_thread, rbgs_run, &task);
+
+    if(it+nb<it_max && tol>0) {
+      residual = GS_residual(para, var, flag, x);
+      converged = residual<=tol;
+    }
+  }
+  count_iterations(para, RBGS, it*nb_sweep);
+
+  /****************************************************************************
+  | Calculate residual
+  ****************************************************************************/
+  if(!converged)
+    residual = GS_residual(para, var, flag, x);
+  count_equation(para, equ, it, residual);
+
+  return residual;
+} /* End of rbgs_solve()*/
+
+	/*
+		* Red-black Gauss-Seidel solver for pressure
+		*
+		* GS_P() performs iterations of 4 sweeps. The same number of
+		* red-black sweeps is used here.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param Type Type of variable
+		* @param x Pointer to variable
+		*
+		* @return Residual
+		*/
+REAL RBGS_P(PARA_DATA *para, REAL **var, int Type, REAL *x) {
+  return rbgs_solve(para, var, var[FLAGP], x, EQU_PRESSURE, 4);
+} /* End of RBGS_P()*/
+
+	/*
+		* Red-black Gauss-Seidel solver
+		*
+		* Gauss_Seidel() performs iterations of a forward and a backward
+		* sweep. The same number of red-black sweeps is used here.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param flag Pointer to the cell property flag
+		* @param x Pointer to variable
+		* @param var_type Type of variable
+		*
+		* @return Residual
+		*/
+REAL RB_Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                     int var_type) {
+  return rbgs_solve(para, var, flag, x, equation_type(var_type), 2);
+} /* End of RB_Gauss_Seidel()*/
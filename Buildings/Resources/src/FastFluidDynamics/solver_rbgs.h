@@ -0,0 +1,75 @@
+/*
+	*
+	* @file   solver_rbgs.h
+	*
+	* @brief  Multithreaded red-black Gauss-Seidel solvers
+	*
+	* @date   10/18/2026
+	*
+	* The cells are colored by the parity of i+j+k. Cells of one color only
+	* depend on cells of the other color, so each half sweep can be split
+	* into k-slabs that are updated by a team of threads.
+	* The size of the team is set by solv.nb_thread in the *.ffd file.
+	*
+	*/
+
+#ifndef _SOLVER_RBGS_H
+#define _SOLVER_RBGS_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+#ifndef _TIMING_H
+#define _TIMING_H
+#include "timing.h"
+#endif
+
+#ifndef _SOLVER_GS_H
+#define _SOLVER_GS_H
+#include "solver_gs.h"
+#endif
+
+#ifndef _THREAD_TEAM_H
+#define _THREAD_TEAM_H
+#include "thread_team.h"
+#endif
+
+/*
+	* Red-black Gauss-Seidel solver for pressure
+	*
+	* Performs the same number of sweeps as GS_P() and uses the same
+	* tolerance
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param Type Type of variable
+	* @param x Pointer to variable
+	*
+	* @return Residual
+	*/
+REAL RBGS_P(PARA_DATA *para, REAL **var, int Type, REAL *x);
+
+/*
+	* Red-black Gauss-Seidel solver
+	*
+	* Performs the same number of sweeps as Gauss_Seidel() and uses the same
+	* tolerance
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param flag Pointer to the cell property flag
+	* @param x Pointer to variable
+	* @param var_type Type of variable
+	*
+	* @return Residual
+	*/
+REAL RB_Gauss_Seidel(PARA_DATA *para, REAL **var, REAL *flag, REAL *x,
+                     int var_type);
@@ -342,6 +342,9 @@ int TDMA_1D(REAL *ap, REAL *ae, REAL *aw, REAL *b, REAL *psi,
     ffd_log("TDMA_1D(): Could not allocate memory for Q.", FFD_ERROR);
     return 1;
   }
+  /* The recursion reads P[0] and Q[0]*/
+  P[0] = 0;
+  Q[0] = 0;
   for(i=1; i<=LENGTH-1; i++) {
     P[i] = ae[i] / (ap[i] - aw[i]*P[i-1]);
     Q[i] = (b[i] + aw[i]*Q[i-1]) / (ap[i] - aw[i]*P[i-1]);
@@ -0,0 +1,233 @@
+/*
+	*
+	* \file   species.c
+	*
+	* \brief  Transport of the species and trace substances
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "species.h"
+
+/* Work space of the species transport*/
+typedef struct {
+  int nb; /* Number of species and trace substances*/
+  int *var_type; /* Xi1 for a species, C1 for a trace substance*/
+  int *index; /* Index of the species or trace substance*/
+  int *source; /* Index of the source term in var*/
+  REAL **psi; /* Variables in var*/
+  REAL **psi0; /* Advected variables*/
+  REAL *x; /* Interleaved variables of the GS solver*/
+  REAL *b; /* Interleaved right hand sides of the diffusion equations*/
+  REAL *mem; /* Internal: memory of psi0, x and b*/
+} SPECIES_DATA;
+
+	/*
+		* Allocate the work space of the species transport
+		*
+		* The work space is allocated once and is kept until free_species()
+		* is called.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		*
+		* @return Pointer to the work space, or NULL if an error occurred
+		*/
+static SPECIES_DATA *species_workspace(PARA_DATA *para, REAL **var) {
+  SPECIES_DATA *spec = (SPECIES_DATA *) para->solv->species;
+  int size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+  int nb_Xi = para->bc->nb_Xi;
+  int n;
+
+  if(spec!=NULL) return spec;
+
+  spec = (SPECIES_DATA *) calloc(1, sizeof(SPECIES_DATA));
+  if(spec==NULL) return NULL;
+
+  spec->nb = nb_Xi + para->bc->nb_C;
+  spec->var_type = (int *) malloc(3*spec->nb*sizeof(int));
+  spec->psi = (REAL **) malloc(2*spec->nb*sizeof(REAL *));
+  spec->mem = (REAL *) calloc(3*(size_t) spec->nb*size, sizeof(REAL));
+  if(spec->var_type==NULL || spec->psi==NULL || spec->mem==NULL) {
+    free(spec->var_type);
+    free(spec->psi);
+    free(spec->mem);
+    free(spec);
+    return NULL;
+  }
+  spec->index = spec->var_type + spec->nb;
+  spec->source = spec->var_type + 2*spec->nb;
+  spec->psi0 = spec->psi + spec->nb;
+  spec->x = spec->mem + (size_t) spec->nb*size;
+  spec->b = spec->mem + 2*(size_t) spec->nb*size;
+
+  for(n=0; n<spec->nb; n++) {
+    if(n<nb_Xi) {
+      spec->var_type[n] = Xi1;
+      spec->index[n] = n;
+      spec->psi[n] = var[XI_VAR(para, n, SPECIES_VALUE)];
+      spec->source[n] = XI_VAR(para, n, SPECIES_SOURCE);
+    }
+    else {
+      spec->var_type[n] = C1;
+      spec->index[n] = n - nb_Xi;
+      spec->psi[n] = var[C_VAR(para, n-nb_Xi, SPECIES_VALUE)];
+      spec->source[n] = C_VAR(para, n-nb_Xi, SPECIES_SOURCE);
+    }
+    spec->psi0[n] = spec->mem + (size_t) n*size;
+  }
+
+  para->solv->species = spec;
+  return spec;
+} /* End of species_workspace()*/
+
+	/*
+		* Advect and diffuse all species and trace substances
+		*
+		* The equations of all variables have the same coefficients. They are
+		* computed by coef_diff() for the first variable, which also sets its
+		* right hand side. The right hand sides of the other variables only
+		* differ by the advected value and the source term.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param BINDEX Pointer to boundary index
+		*
+		* @return 0 if no error occurred
+		*/
+int species_step(PARA_DATA *para, REAL **var, int **BINDEX) {
+  int i, j, k, n, c, nb, flag;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int size = (imax+2)*(jmax+2)*(kmax+2);
+  REAL *ap0 = var[AP0], *b = var[B];
+  REAL *x, *bs, *src;
+  SPECIES_DATA *spec;
+
+  if(para->bc->nb_Xi+para->bc->nb_C<1)
+    return 0;
+
+  spec = species_workspace(para, var);
+  if(spec==NULL) {
+    ffd_log("species_step(): Could not allocate memory for the species.",
+            FFD_ERROR);
+    return 1;
+  }
+  nb = spec->nb;
+  x = spec->x;
+  bs = spec->b;
+
+  /****************************************************************************
+  | Advect all variables with the same departure points
+  ****************************************************************************/
+  phase_start(para, PHASE_ADVECT);
+  flag = trace_species(para, var, nb, spec->var_type, spec->index, spec->psi0,
+                       spec->psi, BINDEX);
+  phase_end(para, PHASE_ADVECT);
+  if(flag!=0) {
+    ffd_log("species_step(): Could not advect the species.", FFD_ERROR);
+    return 1;
+  }
+
+  /****************************************************************************
+  | Coefficients of the diffusion equation
+  ****************************************************************************/
+  phase_start(para, PHASE_DIFFUSE);
+  if(coef_diff(para, var, spec->psi[0], spec->psi0[0], spec->var_type[0],
+               spec->index[0], BINDEX)!=0) {
+    ffd_log("species_step(): Could not calculate coefficients for "
+            "diffusion equation.", FFD_ERROR);
+    phase_end(para, PHASE_DIFFUSE);
+    return 1;
+  }
+
+  /* Right hand sides of all variables*/
+  FOR_EACH_CELL
+    bs[IX(i,j,k)*nb] = b[IX(i,j,k)];
+  END_FOR
+
+  for(n=1; n<nb; n++) {
+    src = var[spec->source[n]];
+    FOR_EACH_CELL
+      bs[IX(i,j,k)*nb+n] = spec->psi0[n][IX(i,j,k)]*ap0[IX(i,j,k)]
+                         + src[IX(i,j,k)];
+    END_FOR
+    /* The coefficients are already set, only the ghost cells are changed*/
+    set_bnd(para, var, spec->var_type[n], spec->index[n], spec->psi[n],
+            BINDEX);
+  }
+
+  /****************************************************************************
+  | Solve the equations
+  ****************************************************************************/
+  if(para->solv->solver==GS && nb>1) {
+    for(c=0; c<size; c++)
+      for(n=0; n<nb; n++)
+        x[c*nb+n] = spec->psi[n][c];
+
+    phase_start(para, PHASE_EQUATION);
+    Gauss_Seidel_multi(para, var, var[FLAGP], nb, x, bs);
+    phase_end(para, PHASE_EQUATION);
+
+    for(c=0; c<size; c++)
+      for(n=0; n<nb; n++)
+        spec->psi[n][c] = x[c*nb+n];
+  }
+  else {
+    for(n=0; n<nb; n++) {
+      if(n>0) {
+        FOR_EACH_CELL
+          b[IX(i,j,k)] = bs[IX(i,j,k)*nb+n];
+        END_FOR
+      }
+      if(equ_solver(para, var, spec->var_type[n], spec->psi[n])!=0) {
+        ffd_log("species_step(): failed to solve the equation", FFD_ERROR);
+        phase_end(para, PHASE_DIFFUSE);
+        return 1;
+      }
+    }
+  }
+
+  /****************************************************************************
+  | Define B.C. and check residual
+  ****************************************************************************/
+  for(n=0; n<nb; n++) {
+    set_bnd(para, var, spec->var_type[n], spec->index[n], spec->psi[n],
+            BINDEX);
+
+    if(para->solv->check_residual==1) {
+      FOR_EACH_CELL
+        b[IX(i,j,k)] = bs[IX(i,j,k)*nb+n];
+      END_FOR
+      sprintf(msg, "species_step(): Residual of %s%d is %f",
+              spec->var_type[n]==Xi1 ? "Xi" : "C", spec->index[n]+1,
+              check_residual(para, var, spec->psi[n]));
+      ffd_log(msg, FFD_NORMAL);
+    }
+  }
+  phase_end(para, PHASE_DIFFUSE);
+
+  return 0;
+} /* End of species_step()*/
+
+	/*
+		* Free the work space of the species transport
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return No return needed
+		*/
+void free_species(PARA_DATA *para) {
+  SPECIES_DATA *spec = (SPECIES_DATA *) para->solv->species;
+
+  if(spec==NULL)
+    return;
+
+  free(spec->var_type);
+  free(spec->psi);
+  free(spec->mem);
+  free(spec);
+  para->solv->species = NULL;
+} /* End of free_species()*/
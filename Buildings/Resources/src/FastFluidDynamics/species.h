@@ -0,0 +1,71 @@
+/*
+	*
+	* @file   species.h
+	*
+	* @brief  Transport of the species and trace substances
+	*
+	* @date   10/18/2026
+	*
+	* All species and trace substances are transported in one step. The
+	* departure points of the semi-Lagrangian advection are traced once for
+	* all of them, and the coefficients of the diffusion equation are computed
+	* once, since they only depend on the flow field. With the GS solver, the
+	* diffusion equations are solved together with interleaved right hand
+	* sides. The first two species and trace substances are stored in Xi1, Xi2,
+	* C1 and C2, the others after LAST_VAR (see XI_VAR() and C_VAR()).
+	*
+	*/
+
+#ifndef _SPECIES_H
+#define _SPECIES_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _ADVECTION_H
+#define _ADVECTION_H
+#include "advection.h"
+#endif
+
+#ifndef _DIFFUSION_H
+#define _DIFFUSION_H
+#include "diffusion.h"
+#endif
+
+#ifndef _BOUNDARY_H
+#define _BOUNDARY_H
+#include "boundary.h"
+#endif
+
+#ifndef _SOLVER_GS_H
+#define _SOLVER_GS_H
+#include "solver_gs.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+/*
+	* Advect and diffuse all species and trace substances
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param BINDEX Pointer to boundary index
+	*
+	* @return 0 if no error occurred
+	*/
+int species_step(PARA_DATA *para, REAL **var, int **BINDEX);
+
+/*
+	* Free the work space of the species transport
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_species(PARA_DATA *para);
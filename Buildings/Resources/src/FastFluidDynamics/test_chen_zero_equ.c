@@ -0,0 +1,227 @@
+/*
+	*
+	* \file   test_chen_zero_equ.c
+	*
+	* \brief  Check the turbulent viscosity of Chen's zero equation model
+	*
+	* \date   10/18/2026
+	*
+	* The driver is not part of the FFD library. It is built and run with
+	* "make test". It reads the mesh of the FFD parameter file given on the
+	* command line, e.g.
+	*
+	*   ./test_chen_zero_equ ForcedConvection.ffd
+	*
+	* and sets a velocity field in which var[VZ] differs from var[Z]. Then it
+	* compares var[NUT] of nu_t_chen_zero_equ_all() and the values of
+	* nu_t_chen_zero_equ() with the model that computes the wall distance in
+	* each call. The values must be identical. The driver also checks that
+	* the model with the z-coordinate as z-velocity gives other values, so
+	* that the check would detect a regression of this bug.
+	*
+	*/
+
+#include "ffd.h"
+#include <string.h>
+
+#ifndef _CHEN_ZERO_EQU_MODEL_H
+#define _CHEN_ZERO_EQU_MODEL_H
+#include "chen_zero_equ_model.h"
+#endif
+
+	/*
+		* Computes turbulent viscosity as Chen's zero equation model did before
+		* the wall distance was stored in var[DIST]
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param w Pointer to the z-velocity
+		* @param i I-index of the control volume
+		* @param j J-index of the control volume
+		* @param k K-index of the control volume
+		*
+		* @return Turbulent Kinematic viscosity
+		*/
+static REAL nu_t_reference(PARA_DATA *para, REAL **var, REAL *w,
+                           int i, int j, int k) {
+  REAL nu_t, l, lx, lx1, lx2, ly, ly1, ly2, lz, lz1, lz2;
+  REAL *x = var[X], *y = var[Y], *z = var[Z];
+  REAL *u = var[VX], *v = var[VY];
+  int imax = para->geom->imax, jmax = para->geom->jmax,
+      kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+
+  lx1 = x[IX(i,j,k)] - x[IX(0,j,k)];
+  lx2 = x[IX(imax+1,j,k)] - x[IX(i,j,k)];
+  lx = lx1 < lx2 ? lx1 : lx2;
+
+  ly1 = y[IX(i,j,k)] - y[IX(i,0,k)];
+  ly2 = y[IX(i,jmax,k)] - y[IX(i,j,k)];
+  ly = ly1 < ly2 ? ly1 : ly2;
+
+  lz1 = z[IX(i,j,k)] - z[IX(i,j,0)];
+  lz2 = z[IX(i,j,kmax+1)] - z[IX(i,j,k)];
+  lz = lz1 < lz2 ? lz1 : lz2;
+
+  l = lx < ly ? lx : ly;
+  l = lz < l ? lz : l;
+  nu_t = para->prob->chen_a * l
+       * (REAL)sqrt( u[IX(i,j,k)]*u[IX(i,j,k)]
+                    +v[IX(i,j,k)]*v[IX(i,j,k)]
+                    +w[IX(i,j,k)]*w[IX(i,j,k)] );
+
+  return nu_t;
+} /* End of nu_t_reference()*/
+
+	/*
+		* Read the mesh of a case and set its initial data as ffd() does
+		*
+		* @param inst Pointer to FFD instance
+		*
+		* @return 0 if no error occurred
+		*/
+static int set_up_case(FFD_INSTANCE *inst) {
+  PARA_DATA *para = &inst->para;
+
+  para->geom = &inst->geom;
+  para->inpu = &inst->inpu;
+  para->outp = &inst->outp;
+  para->prob = &inst->prob;
+  para->mytime = &inst->mytime;
+  para->bc     = &inst->bc;
+  para->solv   = &inst->solv;
+  para->sens   = &inst->sens;
+  para->init   = &inst->init;
+
+  if(initialize(para)!=0)
+    return 1;
+
+  /* The case is not coupled to Modelica and uses Chen's model*/
+  para->solv->cosimulation = 0;
+  para->prob->tur_model = CHEN;
+
+  if(para->inpu->parameter_file_format==SCI
+     && read_sci_max(para, inst->var)!=0)
+    return 1;
+
+  if(allocate_memory(inst)!=0)
+    return 1;
+
+  return set_initial_data(para, inst->var, inst->BINDEX);
+} /* End of set_up_case()*/
+
+	/*
+		* Compare the turbulent viscosity of one case
+		*
+		* @param file_name Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if the check passed
+		*/
+static int check_case(char *file_name) {
+  FFD_INSTANCE *inst;
+  PARA_DATA *para;
+  REAL **var;
+  REAL nu_t;
+  int imax, jmax, kmax, IMAX, IJMAX;
+  int i, j, k, c, size;
+  int nb_cell = 0, nb_wrong = 0, nb_bug = 0;
+
+  inst = create_instance(NULL);
+  if(inst==NULL) {
+    fprintf(stderr, "Could not allocate memory for the FFD instance.\n");
+    return 1;
+  }
+  if(strlen(file_name)>=sizeof(inst->inpu.ffd_file_name)) {
+    fprintf(stderr, "The file name %s is too long.\n", file_name);
+    free(inst);
+    return 1;
+  }
+  strcpy(inst->inpu.ffd_file_name, file_name);
+
+  ffd_instance = inst;
+  sprintf(msg, "Start check of Chen's model for %s", file_name);
+  ffd_log(msg, FFD_NEW);
+
+  if(set_up_case(inst)!=0) {
+    printf("%-40s failed, see %s\n", file_name, inst->log_file_name);
+    ffd_log_close();
+    ffd_instance = NULL;
+    free(inst);
+    return 1;
+  }
+
+  para = &inst->para;
+  var = inst->var;
+  imax = para->geom->imax;
+  jmax = para->geom->jmax;
+  kmax = para->geom->kmax;
+  IMAX = imax+2;
+  IJMAX = (imax+2)*(jmax+2);
+  size = (imax+2)*(jmax+2)*(kmax+2);
+
+  /****************************************************************************
+  | Velocity field that is not uniform and differs from the coordinates
+  ****************************************************************************/
+  for(c=0; c<size; c++) {
+    var[VX][c] = (REAL) (0.1*sin(0.37*c));
+    var[VY][c] = (REAL) (0.2*cos(0.11*c));
+    var[VZ][c] = (REAL) (0.05*(c%7) - 0.15);
+  }
+
+  nu_t_chen_zero_equ_all(para, var);
+
+  FOR_EACH_CELL
+    nb_cell++;
+    nu_t = nu_t_reference(para, var, var[VZ], i, j, k);
+    if(var[NUT][IX(i,j,k)]!=nu_t
+       || nu_t_chen_zero_equ(para, var, i, j, k)!=nu_t) {
+      if(nb_wrong==0)
+        printf("Cell (%d,%d,%d): nu_t=%e, var[NUT]=%e, "
+               "nu_t_chen_zero_equ()=%e\n", i, j, k, nu_t,
+               var[NUT][IX(i,j,k)], nu_t_chen_zero_equ(para, var, i, j, k));
+      nb_wrong++;
+    }
+    if(var[NUT][IX(i,j,k)]!=nu_t_reference(para, var, var[Z], i, j, k))
+      nb_bug++;
+  END_FOR
+
+  printf("%-40s %10d %10d %10d\n", file_name, nb_cell, nb_wrong, nb_bug);
+
+  free_data(inst->var);
+  free_index(inst->BINDEX);
+  free_species(para);
+  free_time_step(para);
+  free_face_list(para);
+  free_metric(para);
+  free_para(para);
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+  /* The z-velocity must not be confused with the z-coordinate*/
+  return nb_cell==0 || nb_wrong>0 || nb_bug==0;
+} /* End of check_case()*/
+
+	/*
+		* Main routine of the check
+		*
+		* @param argc Number of arguments
+		* @param argv Pointer to the names of the FFD parameter files
+		*
+		* @return 0 if all checks passed
+		*/
+int main(int argc, char **argv) {
+  int i, nb_error = 0;
+
+  if(argc<2) {
+    fprintf(stderr, "Usage: %s input.ffd [input.ffd ...]\n", argv[0]);
+    return 2;
+  }
+
+  printf("%-40s %10s %10s %10s\n", "case", "cells", "different",
+         "w=z differs");
+  for(i=1; i<argc; i++)
+    nb_error += check_case(argv[i]);
+
+  return nb_error>0 ? 1 : 0;
+} /* End of main()*/
@@ -0,0 +1,99 @@
+/*
+	*
+	* \file   test_cosimulation.c
+	*
+	* \brief  Run a coupled simulation without Modelica and print the outputs
+	*
+	* \date   10/18/2026
+	*
+	* The driver is not part of the FFD library. It is built and run with
+	* "make test". It takes the place of Modelica for the FFD parameter file
+	* given on the command line, e.g.
+	*
+	*   ./test_cosimulation ForcedConvection.ffd
+	*
+	* The case must have the six walls, the two ports, one species and the
+	* two sensors of ForcedConvection.ffd. The driver calls the functions of
+	* Buildings/Resources/C-Sources as the model CFDExchange does, with
+	* fixed inputs and a synchronization every 6 s. At each synchronization,
+	* it prints the time and the outputs y to Modelica, such as the
+	* temperature and the mass fraction at the ports. "make test" compares the
+	* output with test_cosimulation.txt, so that a change of the results is
+	* found.
+	*
+	*/
+
+#include "cfdcosim.c"
+#include "cfdStartCosimulation.c"
+#include "cfdExchangeData.c"
+#include "cfdSendStopCommand.c"
+
+#define NB_SUR 6
+#define NB_PORT 2
+#define NB_XI 1
+#define NB_C 0
+#define NB_SEN 2
+#define NB_SYNC 10
+#define NU (NB_SUR+3+NB_PORT*(2+NB_XI+NB_C))
+#define NY (NB_SUR+1+NB_PORT*(1+NB_XI+NB_C)+NB_SEN)
+
+	/*
+		* Main routine of the driver
+		*
+		* @param argc Number of arguments
+		* @param argv Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if no error occurred
+		*/
+int main(int argc, char **argv) {
+  const char *name[NB_SUR] = {"East Wall", "West Wall", "North Wall",
+                              "South Wall", "Ceiling", "Floor"};
+  const double A[NB_SUR] = {0.9, 0.9, 1, 1, 1, 1};
+  const double til[NB_SUR] = {90, 90, 90, 90, 0, 180};
+  const int bouCon[NB_SUR] = {1, 1, 1, 1, 1, 1};
+  const char *portName[NB_PORT] = {"Inlet", "Outlet"};
+  const char *sensorName[NB_SEN] = {"OccupiedZoneAirTemperature",
+                                    "Velocity"};
+  double u[NU], y[NY], t1;
+  void *cosim;
+  int i, n;
+
+  if(argc!=2) {
+    fprintf(stderr, "Usage: %s input.ffd\n", argv[0]);
+    return 2;
+  }
+
+  /****************************************************************************
+  | Inputs: wall temperatures, heat gains and pressure, then the mass flow
+  | rates, temperatures and mass fractions of the ports
+  ****************************************************************************/
+  n = 0;
+  for(i=0; i<NB_SUR; i++)
+    u[n++] = 283.15;
+  u[n++] = 0;
+  u[n++] = 0;
+  u[n++] = 101325;
+  u[n++] = 0.1;
+  u[n++] = -0.1;
+  u[n++] = 293.15;
+  u[n++] = 293.15;
+  u[n++] = 0.01;
+  u[n++] = 0.01;
+
+  cosim = cfdcosim();
+  cfdStartCosimulation(cosim, argv[1], name, A, til, bouCon, NB_PORT,
+                       portName, 1, sensorName, 0, NB_SUR, NB_SEN, 0, NB_XI,
+                       NB_C, 1.2);
+
+  for(n=0; n<NB_SYNC; n++) {
+    cfdExchangeData(cosim, 6.0*n, 6.0, u, NU, NY, &t1, y);
+    printf("%g", 6.0*n);
+    for(i=0; i<NY; i++)
+      printf(" %.17g", y[i]);
+    printf("\n");
+  }
+
+  cfdSendStopCommand(cosim);
+
+  return 0;
+} /* End of main()*/
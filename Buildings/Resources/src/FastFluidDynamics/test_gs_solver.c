@@ -0,0 +1,352 @@
+/*
+	*
+	* \file   test_gs_solver.c
+	*
+	* \brief  Check the iterations and the tolerance of the Gauss-Seidel solvers
+	*
+	* \date   10/18/2026
+	*
+	* The driver is not part of the FFD library. It is built and run with
+	* "make test". It reads the mesh of the FFD parameter file given on the
+	* command line, e.g.
+	*
+	*   ./test_gs_solver ForcedConvection.ffd
+	*
+	* and sets up a diagonally dominant equation on the fluid cells. Then it
+	* checks that
+	*
+	*   1. GS_P() and Gauss_Seidel() with gs_tol=0 do exactly gs_it_max
+	*      iterations and give the same values as the solvers did before the
+	*      tolerance was introduced, which are copied below,
+	*   2. GS_P() and Gauss_Seidel() with a tolerance stop before gs_it_max
+	*      with a residual that is not larger than the tolerance,
+	*   3. Gauss_Seidel_multi() gives the same values as Gauss_Seidel() for
+	*      each right hand side, with and without a tolerance.
+	*
+	*/
+
+#include "ffd.h"
+#include <string.h>
+
+#define NB_RHS 3 /* Number of right hand sides of Gauss_Seidel_multi()*/
+
+	/*
+		* Update the variable of a cell as the Gauss-Seidel solvers do
+		*
+		* @param var Pointer to FFD simulation variables
+		* @param x Pointer to variable
+		* @param c Index of the cell
+		* @param si Distance of the cells in x-direction
+		* @param sj Distance of the cells in y-direction
+		* @param sk Distance of the cells in z-direction
+		*
+		* @return No return needed
+		*/
+static void update_cell(REAL **var, REAL *x, int c, int si, int sj, int sk) {
+  x[c] = (  var[AE][c]*x[c+si] + var[AW][c]*x[c-si]
+          + var[AN][c]*x[c+sj] + var[AS][c]*x[c-sj]
+          + var[AF][c]*x[c+sk] + var[AB][c]*x[c-sk]
+          + var[B][c] ) / var[AP][c];
+} /* End of update_cell()*/
+
+	/*
+		* Gauss-Seidel solver for pressure as it was before the tolerance was
+		* introduced: 5 iterations of 4 sweeps in the order X-Y and Y-X
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param x Pointer to variable
+		*
+		* @return No return needed
+		*/
+static void GS_P_reference(PARA_DATA *para, REAL **var, REAL *x) {
+  REAL *flagp = var[FLAGP];
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k, it;
+
+  for(it=0; it<5; it++) {
+    for(i=1; i<=imax; i++)
+      for(j=1; j<=jmax; j++)
+        for(k=1; k<=kmax; k++)
+          if(flagp[IX(i,j,k)]<0) update_cell(var, x, IX(i,j,k), 1, IMAX, IJMAX);
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++)
+        for(k=1; k<=kmax; k++)
+          if(flagp[IX(i,j,k)]<0) update_cell(var, x, IX(i,j,k), 1, IMAX, IJMAX);
+    for(i=imax; i>=1; i--)
+      for(j=jmax; j>=1; j--)
+        for(k=1; k<=kmax; k++)
+          if(flagp[IX(i,j,k)]<0) update_cell(var, x, IX(i,j,k), 1, IMAX, IJMAX);
+    for(j=jmax; j>=1; j--)
+      for(i=imax; i>=1; i--)
+        for(k=1; k<=kmax; k++)
+          if(flagp[IX(i,j,k)]<0) update_cell(var, x, IX(i,j,k), 1, IMAX, IJMAX);
+  }
+} /* End of GS_P_reference()*/
+
+	/*
+		* Gauss-Seidel solver as it was before the tolerance was introduced:
+		* 20 iterations of a forward and a backward sweep
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param x Pointer to variable
+		*
+		* @return No return needed
+		*/
+static void Gauss_Seidel_reference(PARA_DATA *para, REAL **var, REAL *x) {
+  REAL *flagp = var[FLAGP];
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int i, j, k, it;
+
+  for(it=0; it<20; it++) {
+    for(i=1; i<=imax; i++)
+      for(j=1; j<=jmax; j++)
+        for(k=1; k<=kmax; k++)
+          if(flagp[IX(i,j,k)]<0) update_cell(var, x, IX(i,j,k), 1, IMAX, IJMAX);
+    for(i=imax; i>=1; i--)
+      for(j=jmax; j>=1; j--)
+        for(k=kmax; k>=1; k--)
+          if(flagp[IX(i,j,k)]<0) update_cell(var, x, IX(i,j,k), 1, IMAX, IJMAX);
+  }
+} /* End of Gauss_Seidel_reference()*/
+
+	/*
+		* Print the result of a check
+		*
+		* @param label Pointer to the description of the check
+		* @param passed 1 if the check passed
+		*
+		* @return 1 if the check failed, 0 otherwise
+		*/
+static int check(const char *label, int passed) {
+  printf("%-60s %s\n", label, passed ? "passed" : "failed");
+  return !passed;
+} /* End of check()*/
+
+	/*
+		* Read the mesh of a case and set its initial data as ffd() does
+		*
+		* @param inst Pointer to FFD instance
+		*
+		* @return 0 if no error occurred
+		*/
+static int set_up_case(FFD_INSTANCE *inst) {
+  PARA_DATA *para = &inst->para;
+
+  para->geom = &inst->geom;
+  para->inpu = &inst->inpu;
+  para->outp = &inst->outp;
+  para->prob = &inst->prob;
+  para->mytime = &inst->mytime;
+  para->bc     = &inst->bc;
+  para->solv   = &inst->solv;
+  para->sens   = &inst->sens;
+  para->init   = &inst->init;
+
+  if(initialize(para)!=0)
+    return 1;
+
+  /* The case is not coupled to Modelica*/
+  para->solv->cosimulation = 0;
+
+  if(para->inpu->parameter_file_format==SCI
+     && read_sci_max(para, inst->var)!=0)
+    return 1;
+
+  if(allocate_memory(inst)!=0)
+    return 1;
+
+  return set_initial_data(para, inst->var, inst->BINDEX);
+} /* End of set_up_case()*/
+
+	/*
+		* Main routine of the check
+		*
+		* @param argc Number of arguments
+		* @param argv Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if all checks passed
+		*/
+int main(int argc, char **argv) {
+  FFD_INSTANCE *inst;
+  PARA_DATA *para;
+  TIME_DATA *t;
+  REAL **var;
+  REAL *x0, *x, *rhs, *xm;
+  REAL residual;
+  long it;
+  int size, c, n, m, same, nb_fluid = 0, nb_error = 0;
+
+  if(argc!=2) {
+    fprintf(stderr, "Usage: %s input.ffd\n", argv[0]);
+    return 2;
+  }
+
+  inst = create_instance(NULL);
+  if(inst==NULL || strlen(argv[1])>=sizeof(inst->inpu.ffd_file_name)) {
+    fprintf(stderr, "Could not set up the FFD instance.\n");
+    return 1;
+  }
+  strcpy(inst->inpu.ffd_file_name, argv[1]);
+  ffd_instance = inst;
+  ffd_log("Start check of the Gauss-Seidel solvers", FFD_NEW);
+
+  if(set_up_case(inst)!=0) {
+    fprintf(stderr, "Could not set up %s, see %s\n", argv[1],
+            inst->log_file_name);
+    return 1;
+  }
+
+  para = &inst->para;
+  t = para->mytime;
+  var = inst->var;
+  size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+
+  x0 = (REAL *) malloc(size*sizeof(REAL));
+  x = (REAL *) malloc(size*sizeof(REAL));
+  rhs = (REAL *) malloc(NB_RHS*size*sizeof(REAL));
+  xm = (REAL *) malloc(NB_RHS*size*sizeof(REAL));
+  if(x0==NULL || x==NULL || rhs==NULL || xm==NULL) {
+    fprintf(stderr, "Could not allocate memory for the check.\n");
+    return 1;
+  }
+
+  /****************************************************************************
+  | Equation with the coefficients of diffusion and a non-uniform field
+  ****************************************************************************/
+  for(c=0; c<size; c++) {
+    var[AE][c] = var[AW][c] = (REAL) 1.0;
+    var[AN][c] = var[AS][c] = (REAL) (0.5 + 0.1*(c%3));
+    var[AF][c] = var[AB][c] = (REAL) 0.8;
+    var[AP][c] = var[AE][c] + var[AW][c] + var[AN][c] + var[AS][c]
+               + var[AF][c] + var[AB][c] + (REAL) 0.2;
+    var[B][c] = (REAL) sin(0.37*c);
+    x0[c] = (REAL) cos(0.11*c);
+    if(var[FLAGP][c]<0) nb_fluid++;
+  }
+  printf("%-60s %d\n", "Fluid cells", nb_fluid);
+
+  /****************************************************************************
+  | Fixed number of iterations
+  ****************************************************************************/
+  para->solv->gs_tol[EQU_PRESSURE] = 0;
+  para->solv->gs_tol[EQU_TEMPERATURE] = 0;
+  para->solv->gs_it_max[EQU_PRESSURE] = 5;
+  para->solv->gs_it_max[EQU_TEMPERATURE] = 20;
+
+  memcpy(x, x0, size*sizeof(REAL));
+  memcpy(var[TMP1], x0, size*sizeof(REAL));
+  it = t->equ_it[EQU_PRESSURE];
+  residual = GS_P(para, var, IP, var[TMP1]);
+  GS_P_reference(para, var, x);
+  nb_error += check("GS_P() without tolerance does gs_it_max iterations",
+                    t->equ_it[EQU_PRESSURE]-it==5);
+  nb_error += check("GS_P() without tolerance equals 5 iterations of 4 sweeps",
+                    memcmp(x, var[TMP1], size*sizeof(REAL))==0
+                    && residual==GS_residual(para, var, var[FLAGP], x));
+
+  memcpy(x, x0, size*sizeof(REAL));
+  memcpy(var[TMP1], x0, size*sizeof(REAL));
+  it = t->equ_it[EQU_TEMPERATURE];
+  residual = Gauss_Seidel(para, var, var[FLAGP], var[TMP1], TEMP);
+  Gauss_Seidel_reference(para, var, x);
+  nb_error += check("Gauss_Seidel() without tolerance does gs_it_max "
+                    "iterations", t->equ_it[EQU_TEMPERATURE]-it==20);
+  nb_error += check("Gauss_Seidel() without tolerance equals 20 iterations",
+                    memcmp(x, var[TMP1], size*sizeof(REAL))==0
+                    && residual==GS_residual(para, var, var[FLAGP], x));
+
+  /****************************************************************************
+  | Iterations until the residual is below the tolerance
+  ****************************************************************************/
+  para->solv->gs_tol[EQU_PRESSURE] = (REAL) 1e-6;
+  para->solv->gs_tol[EQU_TEMPERATURE] = (REAL) 1e-6;
+  para->solv->gs_it_max[EQU_PRESSURE] = 1000;
+  para->solv->gs_it_max[EQU_TEMPERATURE] = 1000;
+
+  memcpy(var[TMP1], x0, size*sizeof(REAL));
+  it = t->equ_it[EQU_PRESSURE];
+  residual = GS_P(para, var, IP, var[TMP1]);
+  it = t->equ_it[EQU_PRESSURE]-it;
+  printf("%-60s %ld\n", "Iterations of GS_P() with tolerance 1e-6", it);
+  nb_error += check("GS_P() with tolerance reaches the tolerance",
+                    residual<=1e-6 && it<1000
+                    && residual==GS_residual(para, var, var[FLAGP], var[TMP1]));
+
+  memcpy(var[TMP1], x0, size*sizeof(REAL));
+  it = t->equ_it[EQU_TEMPERATURE];
+  residual = Gauss_Seidel(para, var, var[FLAGP], var[TMP1], TEMP);
+  it = t->equ_it[EQU_TEMPERATURE]-it;
+  printf("%-60s %ld\n", "Iterations of Gauss_Seidel() with tolerance 1e-6", it);
+  nb_error += check("Gauss_Seidel() with tolerance reaches the tolerance",
+                    residual<=1e-6 && it<1000
+                    && residual==GS_residual(para, var, var[FLAGP], var[TMP1]));
+  nb_error += check("Calls with tolerance are not counted as missed",
+                    t->equ_missed[EQU_PRESSURE]==0
+                    && t->equ_missed[EQU_TEMPERATURE]==0);
+
+  /****************************************************************************
+  | Several right hand sides with and without tolerance. With a tolerance,
+  | Gauss_Seidel() does the number of iterations of Gauss_Seidel_multi().
+  ****************************************************************************/
+  for(n=0; n<2; n++) {
+    para->solv->gs_tol[EQU_SPECIES] = n==0 ? 0 : (REAL) 1e-6;
+    para->solv->gs_it_max[EQU_SPECIES] = n==0 ? 20 : 1000;
+
+    for(c=0; c<size; c++)
+      for(m=0; m<NB_RHS; m++) {
+        rhs[c*NB_RHS+m] = (REAL) (var[B][c]*(m+1) + 0.1*m);
+        xm[c*NB_RHS+m] = (REAL) (x0[c] - 0.2*m);
+      }
+    it = t->equ_it[EQU_SPECIES];
+    residual = Gauss_Seidel_multi(para, var, var[FLAGP], NB_RHS, xm, rhs);
+    it = t->equ_it[EQU_SPECIES]-it;
+
+    para->solv->gs_tol[EQU_SPECIES] = 0;
+    para->solv->gs_it_max[EQU_SPECIES] = (int) it;
+    memcpy(var[TMP2], var[B], size*sizeof(REAL));
+    same = 1;
+    for(m=0; m<NB_RHS; m++) {
+      for(c=0; c<size; c++) {
+        var[B][c] = rhs[c*NB_RHS+m];
+        x[c] = (REAL) (x0[c] - 0.2*m);
+      }
+      Gauss_Seidel(para, var, var[FLAGP], x, Xi1);
+      for(c=0; c<size; c++)
+        same = same && x[c]==xm[c*NB_RHS+m];
+    }
+    memcpy(var[B], var[TMP2], size*sizeof(REAL));
+
+    if(n==0)
+      nb_error += check("Gauss_Seidel_multi() without tolerance equals "
+                        "Gauss_Seidel()", same && it==20);
+    else {
+      printf("%-60s %ld\n", "Iterations of Gauss_Seidel_multi() with "
+             "tolerance 1e-6", it);
+      nb_error += check("Gauss_Seidel_multi() with tolerance equals "
+                        "Gauss_Seidel()", same && residual<=1e-6 && it<1000);
+    }
+  }
+
+  free(x0);
+  free(x);
+  free(rhs);
+  free(xm);
+  free_data(inst->var);
+  free_index(inst->BINDEX);
+  free_species(para);
+  free_time_step(para);
+  free_face_list(para);
+  free_metric(para);
+  free_para(para);
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+  return nb_fluid==0 || nb_error>0 ? 1 : 0;
+} /* End of main()*/
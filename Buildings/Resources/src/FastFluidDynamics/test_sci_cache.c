@@ -0,0 +1,377 @@
+/*
+	*
+	* \file   test_sci_cache.c
+	*
+	* \brief  Check that the SCI cache is only used for unchanged source files
+	*
+	* \date   10/18/2026
+	*
+	* The driver is not part of the FFD library. It is built and run with
+	* "make test". It changes the SCI files of the case given on the command
+	* line, so it must run on a copy of the case, e.g.
+	*
+	*   ./test_sci_cache ForcedConvection.ffd
+	*
+	* The case must have a wall named "South Wall" with the values
+	* "1 1 1 10 0 10 1 0.000000", as in ForcedConvection.cfd. The driver sets
+	* up the case several times as ffd() does. Before each setup, it calls
+	* read_sci_cache() and checks if the cache is used. After each setup,
+	* it compares the geometry with the one read before:
+	*
+	*   1. No cache: the files are read and the cache is written.
+	*   2. Unchanged files: the cache is used.
+	*   3. SCI file with a new modification time but the same content: the
+	*      cache is used.
+	*   4. SCI file with a changed wall temperature of the same length: the
+	*      cache is out of date and the new temperature is read.
+	*   5. Unchanged files: the rewritten cache is used.
+	*   6. Block file with an additional line break: the cache is out of
+	*      date, the geometry is the same.
+	*
+	*/
+
+#include "ffd.h"
+#include <string.h>
+#include <time.h>
+#ifdef _MSC_VER /*Windows*/
+#include <sys/utime.h>
+#else /*Linux*/
+#include <utime.h>
+#endif
+
+#ifndef _SCI_CACHE_H
+#define _SCI_CACHE_H
+#include "sci_cache.h"
+#endif
+
+/* Geometry that is compared between the setups*/
+typedef struct {
+  int size; /* Number of cells*/
+  int index; /* Number of entries of BINDEX*/
+  REAL *val; /* FLAGP, TEMPBC and QFLUXBC of all cells*/
+  int *bindex; /* BINDEX[0] to BINDEX[4]*/
+} GEOMETRY;
+
+	/*
+		* Read the parameters and the mesh of a case as ffd() does
+		*
+		* @param inst Pointer to FFD instance
+		* @param file_name Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if no error occurred
+		*/
+static int open_case(FFD_INSTANCE *inst, char *file_name) {
+  PARA_DATA *para = &inst->para;
+
+  strcpy(inst->inpu.ffd_file_name, file_name);
+  para->geom = &inst->geom;
+  para->inpu = &inst->inpu;
+  para->outp = &inst->outp;
+  para->prob = &inst->prob;
+  para->mytime = &inst->mytime;
+  para->bc     = &inst->bc;
+  para->solv   = &inst->solv;
+  para->sens   = &inst->sens;
+  para->init   = &inst->init;
+
+  if(initialize(para)!=0)
+    return 1;
+
+  /* The case is not coupled to Modelica and uses the cache*/
+  para->solv->cosimulation = 0;
+  para->inpu->sci_cache = 1;
+
+  if(para->inpu->parameter_file_format!=SCI
+     || read_sci_max(para, inst->var)!=0)
+    return 1;
+
+  return allocate_memory(inst);
+} /* End of open_case()*/
+
+	/*
+		* Free the memory of a case
+		*
+		* @param inst Pointer to FFD instance
+		*
+		* @return No return needed
+		*/
+static void close_case(FFD_INSTANCE *inst) {
+  PARA_DATA *para = &inst->para;
+
+  free_data(inst->var);
+  free_index(inst->BINDEX);
+  free_species(para);
+  free_time_step(para);
+  free_face_list(para);
+  free_metric(para);
+  free_para(para);
+} /* End of close_case()*/
+
+	/*
+		* Copy the geometry of a case
+		*
+		* @param inst Pointer to FFD instance
+		* @param geo Pointer to the copy
+		*
+		* @return 0 if no error occurred
+		*/
+static int copy_geometry(FFD_INSTANCE *inst, GEOMETRY *geo) {
+  int n;
+
+  geo->size = (inst->geom.imax+2)*(inst->geom.jmax+2)*(inst->geom.kmax+2);
+  geo->index = inst->geom.index;
+  geo->val = (REAL *) malloc(3*geo->size*sizeof(REAL));
+  geo->bindex = (int *) malloc(5*geo->index*sizeof(int));
+  if(geo->val==NULL || geo->bindex==NULL)
+    return 1;
+
+  memcpy(geo->val, inst->var[FLAGP], geo->size*sizeof(REAL));
+  memcpy(geo->val+geo->size, inst->var[TEMPBC], geo->size*sizeof(REAL));
+  memcpy(geo->val+2*geo->size, inst->var[QFLUXBC], geo->size*sizeof(REAL));
+  for(n=0; n<5; n++)
+    memcpy(geo->bindex+n*geo->index, inst->BINDEX[n],
+           geo->index*sizeof(int));
+
+  return 0;
+} /* End of copy_geometry()*/
+
+	/*
+		* Compare the geometry of a case with a copy
+		*
+		* @param inst Pointer to FFD instance
+		* @param geo Pointer to the copy
+		*
+		* @return 1 if the geometry is the same, 0 otherwise
+		*/
+static int same_geometry(FFD_INSTANCE *inst, GEOMETRY *geo) {
+  REAL *var[3];
+  int n, m;
+
+  if(inst->geom.index!=geo->index)
+    return 0;
+
+  var[0] = inst->var[FLAGP];
+  var[1] = inst->var[TEMPBC];
+  var[2] = inst->var[QFLUXBC];
+  for(n=0; n<3; n++)
+    for(m=0; m<geo->size; m++)
+      if(var[n][m]!=geo->val[n*geo->size+m])
+        return 0;
+
+  for(n=0; n<5; n++)
+    for(m=0; m<geo->index; m++)
+      if(inst->BINDEX[n][m]!=geo->bindex[n*geo->index+m])
+        return 0;
+
+  return 1;
+} /* End of same_geometry()*/
+
+	/*
+		* Set up the case and check the use of the cache
+		*
+		* @param file_name Pointer to the name of the FFD parameter file
+		* @param label Pointer to the description of the step
+		* @param use_cache 1 if the cache must be used
+		* @param geo Pointer to the geometry of the previous setup, which is
+		*        replaced by the new geometry
+		* @param same 1 if the geometry must be the same as before
+		*
+		* @return 0 if the check passed
+		*/
+static int check_step(char *file_name, const char *label, int use_cache,
+                      GEOMETRY *geo, int same) {
+  FFD_INSTANCE *inst;
+  int cached = 0, unchanged = 1, flag;
+
+  inst = create_instance(NULL);
+  if(inst==NULL) {
+    fprintf(stderr, "Could not allocate memory for the FFD instance.\n");
+    return 1;
+  }
+  ffd_instance = inst;
+  sprintf(msg, "Start check of the SCI cache: %s", label);
+  ffd_log(msg, FFD_NEW);
+
+  flag = open_case(inst, file_name);
+  if(flag==0) {
+    cached = read_sci_cache(&inst->para, inst->var, inst->BINDEX)==0;
+    flag = set_initial_data(&inst->para, inst->var, inst->BINDEX);
+  }
+  if(flag!=0) {
+    printf("%-45s failed, see %s\n", label, inst->log_file_name);
+    ffd_log_close();
+    ffd_instance = NULL;
+    free(inst);
+    return 1;
+  }
+
+  if(geo->val!=NULL) {
+    unchanged = same_geometry(inst, geo);
+    free(geo->val);
+    free(geo->bindex);
+  }
+  flag = copy_geometry(inst, geo);
+
+  printf("%-45s %6s %6s %10s %10s\n", label, use_cache ? "yes" : "no",
+         cached ? "yes" : "no", same ? "yes" : "no",
+         unchanged ? "yes" : "no");
+
+  close_case(inst);
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+  return flag!=0 || cached!=use_cache || unchanged!=same;
+} /* End of check_step()*/
+
+	/*
+		* Replace a text of the same length in a file
+		*
+		* @param name Pointer to the file name
+		* @param old_text Pointer to the text to be replaced
+		* @param new_text Pointer to the new text
+		*
+		* @return 0 if no error occurred
+		*/
+static int replace_text(char *name, const char *old_text,
+                        const char *new_text) {
+  FILE *file;
+  char *text, *p;
+  long size;
+
+  file = fopen(name, "rb");
+  if(file==NULL)
+    return 1;
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  rewind(file);
+  text = (char *) malloc(size+1);
+  if(text==NULL || fread(text, 1, size, file)!=(size_t) size) {
+    fclose(file);
+    free(text);
+    return 1;
+  }
+  fclose(file);
+  text[size] = '\0';
+
+  p = strstr(text, old_text);
+  if(p==NULL || strlen(old_text)!=strlen(new_text)) {
+    free(text);
+    return 1;
+  }
+  memcpy(p, new_text, strlen(new_text));
+
+  file = fopen(name, "wb");
+  if(file==NULL || fwrite(text, 1, size, file)!=(size_t) size) {
+    if(file!=NULL) fclose(file);
+    free(text);
+    return 1;
+  }
+  fclose(file);
+  free(text);
+
+  return 0;
+} /* End of replace_text()*/
+
+	/*
+		* Set the modification time of a file after the current time
+		*
+		* @param name Pointer to the file name
+		*
+		* @return 0 if no error occurred
+		*/
+static int touch_file(char *name) {
+  struct utimbuf times;
+
+  times.actime = time(NULL) + 10;
+  times.modtime = times.actime;
+
+  return utime(name, &times);
+} /* End of touch_file()*/
+
+	/*
+		* Main routine of the check
+		*
+		* @param argc Number of arguments
+		* @param argv Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if all checks passed
+		*/
+int main(int argc, char **argv) {
+  FFD_INSTANCE *inst;
+  char sci_name[1100], block_name[1100], cache_name[1200];
+  GEOMETRY geo;
+  FILE *file;
+  int nb_error = 0;
+
+  if(argc!=2) {
+    fprintf(stderr, "Usage: %s input.ffd\n", argv[0]);
+    return 2;
+  }
+
+  /****************************************************************************
+  | Get the names of the SCI files and delete the cache
+  ****************************************************************************/
+  inst = create_instance(NULL);
+  if(inst==NULL || strlen(argv[1])>=sizeof(inst->inpu.ffd_file_name)) {
+    fprintf(stderr, "Could not set up the FFD instance.\n");
+    return 1;
+  }
+  ffd_instance = inst;
+  ffd_log("Start check of the SCI cache", FFD_NEW);
+  if(open_case(inst, argv[1])!=0) {
+    fprintf(stderr, "Could not read %s.\n", argv[1]);
+    return 1;
+  }
+  strcpy(sci_name, inst->inpu.parameter_file_name);
+  strcpy(block_name, inst->inpu.block_file_name);
+  free_data(inst->var);
+  free_index(inst->BINDEX);
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+  sprintf(cache_name, "%s.cache", sci_name);
+  remove(cache_name);
+
+  /****************************************************************************
+  | Set up the case after each change of the files
+  ****************************************************************************/
+  geo.val = NULL;
+  geo.bindex = NULL;
+
+  printf("%-45s %6s %6s %10s %10s\n", "step", "expect", "cache", "expect",
+         "same geo");
+  nb_error += check_step(argv[1], "1. No cache", 0, &geo, 1);
+  nb_error += check_step(argv[1], "2. Unchanged files", 1, &geo, 1);
+
+  if(touch_file(sci_name)!=0) {
+    fprintf(stderr, "Could not set the time of %s.\n", sci_name);
+    return 1;
+  }
+  nb_error += check_step(argv[1], "3. SCI file with new time", 1, &geo, 1);
+
+  if(replace_text(sci_name, "1 1 1 10 0 10 1 0.000000",
+                  "1 1 1 10 0 10 1 5.000000")!=0
+     || touch_file(sci_name)!=0) {
+    fprintf(stderr, "Could not change the wall of %s.\n", sci_name);
+    return 1;
+  }
+  nb_error += check_step(argv[1], "4. SCI file with new wall temperature", 0,
+                         &geo, 0);
+  nb_error += check_step(argv[1], "5. Unchanged files", 1, &geo, 1);
+
+  file = fopen(block_name, "a");
+  if(file==NULL || fputc('\n', file)==EOF) {
+    fprintf(stderr, "Could not change %s.\n", block_name);
+    return 1;
+  }
+  fclose(file);
+  nb_error += check_step(argv[1], "6. Block file with new line break", 0,
+                         &geo, 1);
+
+  free(geo.val);
+  free(geo.bindex);
+
+  return nb_error>0 ? 1 : 0;
+} /* End of main()*/
@@ -0,0 +1,234 @@
+/*
+	*
+	* \file   test_species.c
+	*
+	* \brief  Check the transport of the species and trace substances
+	*
+	* \date   10/18/2026
+	*
+	* The driver is not part of the FFD library. It is built and run with
+	* "make test". It reads the mesh of the FFD parameter file given on the
+	* command line, e.g.
+	*
+	*   ./test_species ForcedConvection.ffd
+	*
+	* with 3 species and 2 trace substances, so that a species and a trace
+	* substance are stored after LAST_VAR. It sets a velocity field, the
+	* initial values and the sources, and does some time steps with
+	* species_step(). Then it checks for the GS and the RBGS solver that
+	*
+	*   1. the results are bitwise identical to advecting and diffusing each
+	*      variable on its own with advect() and diffusion(), as den_step()
+	*      did before all variables were transported in one step,
+	*   2. the third species, which has the same initial values and sources
+	*      as the first one, has the same results as the first one.
+	*
+	*/
+
+#include "ffd.h"
+#include <string.h>
+
+#define NB_XI 3 /* Number of species*/
+#define NB_C 2 /* Number of trace substances*/
+#define NB_STEP 3 /* Number of time steps*/
+
+	/*
+		* Get the index in var of a species or trace substance
+		*
+		* @param para Pointer to FFD parameters
+		* @param n Index of the variable, the species come first
+		* @param t SPECIES_VALUE or SPECIES_SOURCE
+		*
+		* @return Index in var
+		*/
+static int var_index(PARA_DATA *para, int n, int t) {
+  return n<NB_XI ? XI_VAR(para, n, t) : C_VAR(para, n-NB_XI, t);
+} /* End of var_index()*/
+
+	/*
+		* Set the velocities, the initial values and the sources
+		*
+		* The third species has the same values and sources as the first one.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		*
+		* @return No return needed
+		*/
+static void set_fields(PARA_DATA *para, REAL **var) {
+  int size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+  int c, n, m;
+
+  for(c=0; c<size; c++) {
+    var[VX][c] = (REAL) (0.1*sin(0.37*c));
+    var[VY][c] = (REAL) (0.2*cos(0.11*c));
+    var[VZ][c] = (REAL) (0.05*(c%7) - 0.15);
+    for(n=0; n<NB_XI+NB_C; n++) {
+      m = n==2 ? 0 : n;
+      var[var_index(para, n, SPECIES_VALUE)][c]
+        = (REAL) (0.1*(m+1) + 0.05*sin(0.3*c + m));
+      var[var_index(para, n, SPECIES_SOURCE)][c]
+        = (REAL) (0.001*(m+1)*cos(0.2*c));
+    }
+  }
+} /* End of set_fields()*/
+
+	/*
+		* Read the mesh of a case and set its initial data as ffd() does
+		*
+		* @param inst Pointer to FFD instance
+		*
+		* @return 0 if no error occurred
+		*/
+static int set_up_case(FFD_INSTANCE *inst) {
+  PARA_DATA *para = &inst->para;
+
+  para->geom = &inst->geom;
+  para->inpu = &inst->inpu;
+  para->outp = &inst->outp;
+  para->prob = &inst->prob;
+  para->mytime = &inst->mytime;
+  para->bc     = &inst->bc;
+  para->solv   = &inst->solv;
+  para->sens   = &inst->sens;
+  para->init   = &inst->init;
+
+  if(initialize(para)!=0)
+    return 1;
+
+  /* The case is not coupled to Modelica and has more than 2 species*/
+  para->solv->cosimulation = 0;
+  para->bc->nb_Xi = NB_XI;
+  para->bc->nb_C = NB_C;
+
+  if(para->inpu->parameter_file_format==SCI
+     && read_sci_max(para, inst->var)!=0)
+    return 1;
+
+  if(allocate_memory(inst)!=0)
+    return 1;
+
+  return set_initial_data(para, inst->var, inst->BINDEX);
+} /* End of set_up_case()*/
+
+	/*
+		* Compare the transport in one step with the transport of each variable
+		*
+		* @param inst Pointer to FFD instance
+		* @param solver Solver of the diffusion equations
+		* @param result Pointer to the memory for the results of species_step()
+		*
+		* @return 0 if the check passed
+		*/
+static int check_solver(FFD_INSTANCE *inst, SOLVERTYPE solver, REAL *result) {
+  PARA_DATA *para = &inst->para;
+  REAL **var = inst->var;
+  REAL *psi;
+  int size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+  int n, step, var_type, index, flag = 0, nb_different = 0;
+
+  para->solv->solver = solver;
+
+  /****************************************************************************
+  | All variables in one step
+  ****************************************************************************/
+  set_fields(para, var);
+  for(step=0; step<NB_STEP && flag==0; step++)
+    flag = species_step(para, var, inst->BINDEX);
+  for(n=0; n<NB_XI+NB_C; n++)
+    memcpy(result+n*size, var[var_index(para, n, SPECIES_VALUE)],
+           size*sizeof(REAL));
+
+  /****************************************************************************
+  | Each variable on its own
+  ****************************************************************************/
+  set_fields(para, var);
+  for(step=0; step<NB_STEP && flag==0; step++)
+    for(n=0; n<NB_XI+NB_C && flag==0; n++) {
+      var_type = n<NB_XI ? Xi1 : C1;
+      index = n<NB_XI ? n : n-NB_XI;
+      psi = var[var_index(para, n, SPECIES_VALUE)];
+      flag = advect(para, var, var_type, index, var[TMP1], psi, inst->BINDEX);
+      if(flag==0)
+        flag = diffusion(para, var, var_type, index, psi, var[TMP1],
+                         inst->BINDEX);
+    }
+
+  if(flag!=0) {
+    printf("%-40s failed, see %s\n", solver==GS ? "GS" : "RBGS",
+           inst->log_file_name);
+    return 1;
+  }
+
+  for(n=0; n<NB_XI+NB_C; n++)
+    if(memcmp(result+n*size, var[var_index(para, n, SPECIES_VALUE)],
+              size*sizeof(REAL))!=0)
+      nb_different++;
+
+  printf("%-10s %30d %30s\n", solver==GS ? "GS" : "RBGS", nb_different,
+         memcmp(result, result+2*size, size*sizeof(REAL))==0 ? "yes" : "no");
+
+  return nb_different>0
+         || memcmp(result, result+2*size, size*sizeof(REAL))!=0;
+} /* End of check_solver()*/
+
+	/*
+		* Main routine of the check
+		*
+		* @param argc Number of arguments
+		* @param argv Pointer to the name of the FFD parameter file
+		*
+		* @return 0 if all checks passed
+		*/
+int main(int argc, char **argv) {
+  FFD_INSTANCE *inst;
+  PARA_DATA *para;
+  REAL *result;
+  int size, nb_error = 0;
+
+  if(argc!=2) {
+    fprintf(stderr, "Usage: %s input.ffd\n", argv[0]);
+    return 2;
+  }
+
+  inst = create_instance(NULL);
+  if(inst==NULL || strlen(argv[1])>=sizeof(inst->inpu.ffd_file_name)) {
+    fprintf(stderr, "Could not set up the FFD instance.\n");
+    return 1;
+  }
+  strcpy(inst->inpu.ffd_file_name, argv[1]);
+  ffd_instance = inst;
+  ffd_log("Start check of the species transport", FFD_NEW);
+
+  if(set_up_case(inst)!=0) {
+    fprintf(stderr, "Could not set up %s, see %s\n", argv[1],
+            inst->log_file_name);
+    return 1;
+  }
+
+  para = &inst->para;
+  size = (para->geom->imax+2)*(para->geom->jmax+2)*(para->geom->kmax+2);
+  result = (REAL *) malloc((NB_XI+NB_C)*size*sizeof(REAL));
+  if(result==NULL) {
+    fprintf(stderr, "Could not allocate memory for the check.\n");
+    return 1;
+  }
+
+  printf("%-10s %30s %30s\n", "solver", "variables different", "Xi3 equals Xi1");
+  nb_error += check_solver(inst, GS, result);
+  nb_error += check_solver(inst, RBGS, result);
+
+  free(result);
+  free_data(inst->var);
+  free_index(inst->BINDEX);
+  free_species(para);
+  free_time_step(para);
+  free_face_list(para);
+  free_metric(para);
+  free_para(para);
+  ffd_log_close();
+  ffd_instance = NULL;
+  free(inst);
+
+  return nb_error>0 ? 1 : 0;
+} /* End of main()*/
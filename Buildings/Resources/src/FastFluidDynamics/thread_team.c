@@ -0,0 +1,427 @@
+/*
+	*
+	* \file   thread_team.c
+	*
+	* \brief  Team of threads for the parallel solvers
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "thread_team.h"
+
+/* Team of threads*/
+struct THREAD_TEAM {
+#ifdef _MSC_VER /*Windows*/
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE start; /* Signaled when new work is posted*/
+  CONDITION_VARIABLE done; /* Signaled when the workers finished the work*/
+  HANDLE *thread;
+#else /*Linux*/
+  pthread_mutex_t lock;
+  pthread_cond_t start; /* Signaled when new work is posted*/
+  pthread_cond_t done; /* Signaled when the workers finished the work*/
+  pthread_t *thread;
+#endif
+  int size; /* Number of threads including the calling thread*/
+  int nb_started; /* Number of threads that were started, including rank 0*/
+  int generation; /* Incremented for each work*/
+  int nb_done; /* Number of workers that finished the current work*/
+  int quit; /* 1: the workers have to stop*/
+  TEAM_WORK work; /* Current work*/
+  void *arg; /* Argument of the current work*/
+  int nb_active; /* Number of threads that run the current work*/
+  TEAM_BARRIER barrier; /* Barrier of the threads that run the current work*/
+};
+
+/* Worker of a team*/
+typedef struct {
+  THREAD_TEAM *team;
+  int rank;
+} TEAM_WORKER;
+
+	/*
+		* Wait until all threads of the team arrived at the barrier
+		*
+		* @param barrier Pointer to the barrier
+		*
+		* @return No return needed
+		*/
+void team_barrier_wait(TEAM_BARRIER *barrier) {
+  int cycle;
+
+#ifdef _MSC_VER /*Windows*/
+  EnterCriticalSection(&barrier->lock);
+#else /*Linux*/
+  pthread_mutex_lock(&barrier->lock);
+#endif
+
+  cycle = barrier->cycle;
+  barrier->nb_arrived++;
+  if(barrier->nb_arrived>=barrier->nb_thread) {
+    barrier->nb_arrived = 0;
+    barrier->cycle++;
+#ifdef _MSC_VER /*Windows*/
+    WakeAllConditionVariable(&barrier->cond);
+#else /*Linux*/
+    pthread_cond_broadcast(&barrier->cond);
+#endif
+  }
+  else {
+    while(cycle==barrier->cycle) {
+#ifdef _MSC_VER /*Windows*/
+      SleepConditionVariableCS(&barrier->cond, &barrier->lock, INFINITE);
+#else /*Linux*/
+      pthread_cond_wait(&barrier->cond, &barrier->lock);
+#endif
+    }
+  }
+
+#ifdef _MSC_VER /*Windows*/
+  LeaveCriticalSection(&barrier->lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&barrier->lock);
+#endif
+} /* End of team_barrier_wait()*/
+
+	/*
+		* Initialize a barrier
+		*
+		* @param barrier Pointer to the barrier
+		* @param nb_thread Number of threads that have to arrive
+		*
+		* @return No return needed
+		*/
+static void team_barrier_init(TEAM_BARRIER *barrier, int nb_thread) {
+#ifdef _MSC_VER /*Windows*/
+  InitializeCriticalSection(&barrier->lock);
+  InitializeConditionVariable(&barrier->cond);
+#else /*Linux*/
+  pthread_mutex_init(&barrier->lock, NULL);
+  pthread_cond_init(&barrier->cond, NULL);
+#endif
+  barrier->nb_thread = nb_thread;
+  barrier->nb_arrived = 0;
+  barrier->cycle = 0;
+} /* End of team_barrier_init()*/
+
+	/*
+		* Free the lock of a barrier
+		*
+		* @param barrier Pointer to the barrier
+		*
+		* @return No return needed
+		*/
+static void team_barrier_free(TEAM_BARRIER *barrier) {
+#ifdef _MSC_VER /*Windows*/
+  DeleteCriticalSection(&barrier->lock);
+#else /*Linux*/
+  pthread_mutex_destroy(&barrier->lock);
+  pthread_cond_destroy(&barrier->cond);
+#endif
+} /* End of team_barrier_free()*/
+
+static void team_lock(THREAD_TEAM *team) {
+#ifdef _MSC_VER /*Windows*/
+  EnterCriticalSection(&team->lock);
+#else /*Linux*/
+  pthread_mutex_lock(&team->lock);
+#endif
+}
+
+static void team_unlock(THREAD_TEAM *team) {
+#ifdef _MSC_VER /*Windows*/
+  LeaveCriticalSection(&team->lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&team->lock);
+#endif
+}
+
+	/*
+		* Wait for work and run it until the team is freed
+		*
+		* A worker whose rank is not smaller than the number of active threads
+		* of a work does not take part in it.
+		*
+		* @param worker Pointer to the worker
+		*
+		* @return No return needed
+		*/
+static void team_worker_loop(TEAM_WORKER *worker) {
+  THREAD_TEAM *team = worker->team;
+  int generation = 0;
+  TEAM_WORK work;
+  void *arg;
+  int nb_active;
+
+  for(;;) {
+    team_lock(team);
+    while(team->generation==generation && !team->quit) {
+#ifdef _MSC_VER /*Windows*/
+      SleepConditionVariableCS(&team->start, &team->lock, INFINITE);
+#else /*Linux*/
+      pthread_cond_wait(&team->start, &team->lock);
+#endif
+    }
+    if(team->quit) {
+      team_unlock(team);
+      return;
+    }
+    generation = team->generation;
+    work = team->work;
+    arg = team->arg;
+    nb_active = team->nb_active;
+    team_unlock(team);
+
+    if(worker->rank<nb_active)
+      work(arg, worker->rank, nb_active, &team->barrier);
+
+    team_lock(team);
+    team->nb_done++;
+    if(team->nb_done==team->nb_started-1) {
+#ifdef _MSC_VER /*Windows*/
+      WakeConditionVariable(&team->done);
+#else /*Linux*/
+      pthread_cond_signal(&team->done);
+#endif
+    }
+    team_unlock(team);
+  }
+} /* End of team_worker_loop()*/
+
+	/*
+		* Entry of the worker threads
+		*
+		* @param p Pointer to the worker
+		*
+		* @return 0
+		*/
+#ifdef _MSC_VER /*Windows*/
+static DWORD WINAPI team_thread(LPVOID p) {
+  team_worker_loop((TEAM_WORKER *) p);
+  free(p);
+  return 0;
+}
+#else /*Linux*/
+static void *team_thread(void *p) {
+  team_worker_loop((TEAM_WORKER *) p);
+  free(p);
+  return NULL;
+}
+#endif
+
+	/*
+		* Get the number of processors that are online
+		*
+		* @return Number of processors, or 0 if it is not known
+		*/
+static int team_nb_processor() {
+#ifdef _MSC_VER /*Windows*/
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (int) info.dwNumberOfProcessors;
+#else /*Linux*/
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n>0 ? (int) n : 0;
+#endif
+} /* End of team_nb_processor()*/
+
+	/*
+		* Create a team of threads
+		*
+		* The team has at most one thread per processor. More threads would
+		* only take turns on the processors at each barrier, which makes the
+		* solvers slower than with one thread.
+		*
+		* @param nb_thread Number of threads of the team
+		*
+		* @return Pointer to the team, or NULL if the team has only one thread
+		*/
+THREAD_TEAM *team_create(int nb_thread) {
+  THREAD_TEAM *team;
+  TEAM_WORKER *worker;
+  int n, nb_proc;
+
+  if(nb_thread<=1)
+    return NULL;
+
+  nb_proc = team_nb_processor();
+  if(nb_proc>0 && nb_thread>nb_proc) {
+    sprintf(msg, "team_create(): Use %d instead of %d threads as there are "
+            "only %d processors.", nb_proc, nb_thread, nb_proc);
+    ffd_log(msg, FFD_NORMAL);
+    nb_thread = nb_proc;
+    if(nb_thread<=1)
+      return NULL;
+  }
+
+  team = (THREAD_TEAM *) calloc(1, sizeof(THREAD_TEAM));
+  if(team==NULL) {
+    ffd_log("team_create(): Could not allocate memory for the thread team.",
+            FFD_WARNING);
+    return NULL;
+  }
+#ifdef _MSC_VER /*Windows*/
+  team->thread = (HANDLE *) malloc(nb_thread*sizeof(HANDLE));
+#else /*Linux*/
+  team->thread = (pthread_t *) malloc(nb_thread*sizeof(pthread_t));
+#endif
+  if(team->thread==NULL) {
+    ffd_log("team_create(): Could not allocate memory for the thread team.",
+            FFD_WARNING);
+    free(team);
+    return NULL;
+  }
+
+#ifdef _MSC_VER /*Windows*/
+  InitializeCriticalSection(&team->lock);
+  InitializeConditionVariable(&team->start);
+  InitializeConditionVariable(&team->done);
+#else /*Linux*/
+  pthread_mutex_init(&team->lock, NULL);
+  pthread_cond_init(&team->start, NULL);
+  pthread_cond_init(&team->done, NULL);
+#endif
+  team_barrier_init(&team->barrier, 1);
+  team->size = nb_thread;
+
+  /****************************************************************************
+  | Launch the workers. The thread that calls team_run() works as rank 0.
+  ****************************************************************************/
+  team->nb_started = 1;
+  for(n=1; n<nb_thread; n++) {
+    worker = (TEAM_WORKER *) malloc(sizeof(TEAM_WORKER));
+    if(worker==NULL) break;
+    worker->team = team;
+    worker->rank = n;
+#ifdef _MSC_VER /*Windows*/
+    team->thread[n] = CreateThread(NULL, 0, team_thread, (LPVOID) worker, 0,
+                                   NULL);
+    if(team->thread[n]==NULL) {
+      free(worker);
+      break;
+    }
+#else /*Linux*/
+    if(pthread_create(&team->thread[n], NULL, team_thread, (void *) worker)!=0) {
+      free(worker);
+      break;
+    }
+#endif
+    team->nb_started++;
+  }
+
+  /* Shrink the team to the threads that could be created*/
+  if(team->nb_started<nb_thread) {
+    sprintf(msg, "team_create(): Only %d of %d threads could be created.",
+            team->nb_started, nb_thread);
+    ffd_log(msg, FFD_WARNING);
+    team->size = team->nb_started;
+  }
+
+  return team;
+} /* End of team_create()*/
+
+	/*
+		* Stop the worker threads and free the team
+		*
+		* @param team Pointer to the team, may be NULL
+		*
+		* @return No return needed
+		*/
+void team_free(THREAD_TEAM *team) {
+  int n;
+
+  if(team==NULL)
+    return;
+
+  team_lock(team);
+  team->quit = 1;
+#ifdef _MSC_VER /*Windows*/
+  WakeAllConditionVariable(&team->start);
+#else /*Linux*/
+  pthread_cond_broadcast(&team->start);
+#endif
+  team_unlock(team);
+
+  for(n=1; n<team->nb_started; n++) {
+#ifdef _MSC_VER /*Windows*/
+    WaitForSingleObject(team->thread[n], INFINITE);
+    CloseHandle(team->thread[n]);
+#else /*Linux*/
+    pthread_join(team->thread[n], NULL);
+#endif
+  }
+
+#ifdef _MSC_VER /*Windows*/
+  DeleteCriticalSection(&team->lock);
+#else /*Linux*/
+  pthread_mutex_destroy(&team->lock);
+  pthread_cond_destroy(&team->start);
+  pthread_cond_destroy(&team->done);
+#endif
+  team_barrier_free(&team->barrier);
+  free(team->thread);
+  free(team);
+} /* End of team_free()*/
+
+	/*
+		* Run a work function on a team of threads
+		*
+		* @param team Pointer to the team
+		* @param nb_thread Number of threads that run the work
+		* @param work Work function
+		* @param arg Argument passed to the work function
+		*
+		* @return Number of threads that ran the work
+		*/
+int team_run(THREAD_TEAM *team, int nb_thread, TEAM_WORK work, void *arg) {
+  TEAM_BARRIER single;
+
+  if(nb_thread<1) nb_thread = 1;
+
+  /****************************************************************************
+  | Run the work on the calling thread if there is no team
+  ****************************************************************************/
+  if(team==NULL || nb_thread==1) {
+    team_barrier_init(&single, 1);
+    work(arg, 0, 1, &single);
+    team_barrier_free(&single);
+    return 1;
+  }
+
+  if(nb_thread>team->size) nb_thread = team->size;
+
+  /****************************************************************************
+  | Post the work. All workers are woken up, those with a rank of at least
+  | nb_thread only confirm that they saw the work.
+  ****************************************************************************/
+  team_lock(team);
+  team->work = work;
+  team->arg = arg;
+  team->nb_active = nb_thread;
+  team->barrier.nb_thread = nb_thread;
+  team->barrier.nb_arrived = 0;
+  team->nb_done = 0;
+  team->generation++;
+#ifdef _MSC_VER /*Windows*/
+  WakeAllConditionVariable(&team->start);
+#else /*Linux*/
+  pthread_cond_broadcast(&team->start);
+#endif
+  team_unlock(team);
+
+  work(arg, 0, nb_thread, &team->barrier);
+
+  /* Wait for the workers*/
+  team_lock(team);
+  while(team->nb_done<team->nb_started-1) {
+#ifdef _MSC_VER /*Windows*/
+    SleepConditionVariableCS(&team->done, &team->lock, INFINITE);
+#else /*Linux*/
+    pthread_cond_wait(&team->done, &team->lock);
+#endif
+  }
+  team_unlock(team);
+
+  return nb_thread;
+} /* End of team_run()*/
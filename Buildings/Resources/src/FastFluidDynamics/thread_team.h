@@ -0,0 +1,105 @@
+/*
+	*
+	* @file   thread_team.h
+	*
+	* @brief  Team of threads for the parallel solvers
+	*
+	* @date   10/18/2026
+	*
+	* A team runs the same work function on several threads. The threads are
+	* identified by their rank and can be synchronized by the barrier of
+	* the team. The size of the team is set by solv.nb_thread in the *.ffd
+	* file, but is at most the number of processors. The threads are created
+	* once when the solver starts and wait for work between the calls.
+	*
+	*/
+
+#ifndef _THREAD_TEAM_H
+#define _THREAD_TEAM_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+#ifndef _MSC_VER /*Linux*/
+#include <pthread.h>
+#endif
+
+/* Barrier shared by the threads of one team*/
+typedef struct {
+#ifdef _MSC_VER /*Windows*/
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE cond;
+#else /*Linux*/
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+#endif
+  int nb_thread; /* Number of threads that have to arrive*/
+  int nb_arrived; /* Number of threads that have arrived*/
+  int cycle; /* Internal: generation of the barrier*/
+} TEAM_BARRIER;
+
+/* Work executed by each thread of a team
+   arg: Argument shared by the team
+   rank: Rank of the thread, 0, ..., size-1
+   size: Number of threads of the team
+   barrier: Barrier of the team*/
+typedef void (*TEAM_WORK)(void *arg, int rank, int size,
+                          TEAM_BARRIER *barrier);
+
+/*
+	* Wait until all threads of the team arrived at the barrier
+	*
+	* @param barrier Pointer to the barrier
+	*
+	* @return No return needed
+	*/
+void team_barrier_wait(TEAM_BARRIER *barrier);
+
+/* Team of threads that is kept for the whole simulation*/
+typedef struct THREAD_TEAM THREAD_TEAM;
+
+/*
+	* Create a team of threads
+	*
+	* The nb_thread-1 worker threads are started once and wait for work
+	* until the team is freed. The thread that calls team_run() works as
+	* rank 0. If not all threads can be created, the team is smaller.
+	*
+	* @param nb_thread Number of threads of the team
+	*
+	* @return Pointer to the team, or NULL if the team has only one thread
+	*/
+THREAD_TEAM *team_create(int nb_thread);
+
+/*
+	* Stop the worker threads and free the team
+	*
+	* @param team Pointer to the team, may be NULL
+	*
+	* @return No return needed
+	*/
+void team_free(THREAD_TEAM *team);
+
+/*
+	* Run a work function on a team of threads
+	*
+	* The work is run by min(nb_thread, size of the team) threads. The work
+	* function must thus split its work by the size that it receives. If
+	* the team is NULL, the work is run by the calling thread.
+	*
+	* @param team Pointer to the team
+	* @param nb_thread Number of threads that run the work
+	* @param work Work function
+	* @param arg Argument passed to the work function
+	*
+	* @return Number of threads that ran the work
+	*/
+int team_run(THREAD_TEAM *team, int nb_thread, TEAM_WORK work, void *arg);
@@ -15,8 +15,21 @@
 	*
 	*/
 
+/* clock_gettime() is not declared in strict C89 mode*/
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "timing.h"
 
+/* Names of the phases, solvers and equations in the profile*/
+static const char *phase_name[NB_PHASE] = {"FFD_solver", "vel_step",
+  "temp_step", "den_step", "project", "advection", "diffusion", "boundary",
+  "equation_solver"};
+static const char *solver_name[NB_SOLVER] = {"GS", "TDMA", "RBGS", "MG", "PCG"};
+static const char *equation_name[NB_EQU] = {"pressure", "velocity",
+  "temperature", "species"};
+
 	/*
 		* Calculate the simulation time and time ratio
 		*
@@ -31,10 +44,291 @@ void timing(PARA_DATA *para) {
   para->mytime->step_current += 1;
   para->mytime->t_end = clock();
 
+  /* Record the range of the time step sizes*/
+  if(para->mytime->dt_smallest<=0 || para->mytime->dt<para->mytime->dt_smallest)
+    para->mytime->dt_smallest = para->mytime->dt;
+  if(para->mytime->dt>para->mytime->dt_largest)
+    para->mytime->dt_largest = para->mytime->dt;
+
   cputime= ((double) (clock() - para->mytime->t_start) / CLOCKS_PER_SEC);
 
-  sprintf(msg, "Physical time=%.4f s, CPU time=%.4f s, Time Ratio=%.4f",
-         para->mytime->t, cputime, para->mytime->t/cputime);
-  ffd_log(msg, FFD_NORMAL);
+  /* Log only every outp.log_step time steps*/
+  if(para->outp->log_step>0
+     && para->mytime->step_current%para->outp->log_step==0) {
+    if(para->mytime->adaptive==1)
+      sprintf(msg, "Physical time=%.4f s, CPU time=%.4f s, Time Ratio=%.4f, "
+              "dt=%.4f s", para->mytime->t, cputime,
+              para->mytime->t/cputime, para->mytime->dt);
+    else
+      sprintf(msg, "Physical time=%.4f s, CPU time=%.4f s, Time Ratio=%.4f",
+             para->mytime->t, cputime, para->mytime->t/cputime);
+    ffd_log(msg, FFD_NORMAL);
+  }
 
 } /* End of timing( )*/
+
+	/*
+		* Choose the size of the next time step
+		*
+		* The CFL number of a cell is the sum of |u|dt/dx over the three
+		* directions with the velocities at the cell center. The change of the
+		* temperature is measured over the last time step and scales the step
+		* size linearly.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param t_sync Time of the next synchronization point, or a negative
+		*        value for a single simulation
+		*
+		* @return 0 if no error occurred
+		*/
+int adapt_time_step(PARA_DATA *para, REAL **var, double t_sync) {
+  int i, j, k, n;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int size = (imax+2)*(jmax+2)*(kmax+2);
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ], *T = var[TEMP];
+  REAL *T_old = para->mytime->T_old;
+  METRIC_DATA *m = para->geom->metric;
+  REAL rate, rate_max = 0, dT, dT_max = 0;
+  double dt = para->mytime->dt, dt_new, remain;
+
+  /****************************************************************************
+  | Allocate the memory and set the limits at the first call
+  ****************************************************************************/
+  if(T_old==NULL) {
+    T_old = para->mytime->T_old = (REAL *) malloc(size*sizeof(REAL));
+    if(T_old==NULL) {
+      ffd_log("adapt_time_step(): Could not allocate memory for the "
+              "temperature.", FFD_ERROR);
+      return 1;
+    }
+    if(para->mytime->dt_max<=0)
+      para->mytime->dt_max = 10*dt;
+    if(para->mytime->dt_min>para->mytime->dt_max)
+      para->mytime->dt_min = para->mytime->dt_max;
+    dt_new = para->mytime->dt_next = dt;
+  }
+  /****************************************************************************
+  | Limit the step size by the CFL number and the change of temperature
+  ****************************************************************************/
+  else {
+    FOR_EACH_CELL
+      rate = (REAL) (0.5*(fabs(u[IX(i,j,k)])+fabs(u[IX(i-1,j,k)]))*m->rdx[i]
+                   + 0.5*(fabs(v[IX(i,j,k)])+fabs(v[IX(i,j-1,k)]))*m->rdy[j]
+                   + 0.5*(fabs(w[IX(i,j,k)])+fabs(w[IX(i,j,k-1)]))*m->rdz[k]);
+      if(rate>rate_max) rate_max = rate;
+      dT = (REAL) fabs(T[IX(i,j,k)]-T_old[IX(i,j,k)]);
+      if(dT>dT_max) dT_max = dT;
+    END_FOR
+
+    /* The growth starts from the step size before the alignment*/
+    dt_new = para->mytime->dt_next*DT_GROWTH;
+    if(rate_max>0 && para->mytime->cfl/rate_max<dt_new)
+      dt_new = para->mytime->cfl/rate_max;
+    if(para->mytime->dT_step>0 && dT_max>0
+       && dt*para->mytime->dT_step/dT_max<dt_new)
+      dt_new = dt*para->mytime->dT_step/dT_max;
+
+    if(dt_new>para->mytime->dt_max) dt_new = para->mytime->dt_max;
+    if(dt_new<para->mytime->dt_min) dt_new = para->mytime->dt_min;
+    para->mytime->dt_next = dt_new;
+  }
+
+  /****************************************************************************
+  | Even out the steps to the next synchronization point
+  ****************************************************************************/
+  if(t_sync>=0) {
+    remain = t_sync - para->mytime->t;
+    if(remain>0) {
+      n = (int) ceil(remain/dt_new - 1e-6);
+      dt_new = remain / (n>1 ? n : 1);
+    }
+  }
+
+  para->mytime->dt = dt_new;
+  memcpy(T_old, T, size*sizeof(REAL));
+
+  if(para->outp->version==DEBUG) {
+    sprintf(msg, "adapt_time_step(): dt=%f[s] with CFL=%f and dT=%f[K] "
+            "in the last step.", dt_new, rate_max*dt, dT_max);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
+  return 0;
+} /* End of adapt_time_step()*/
+
+	/*
+		* Free the memory of the adaptive time step
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return No return needed
+		*/
+void free_time_step(PARA_DATA *para) {
+  free(para->mytime->T_old);
+  para->mytime->T_old = NULL;
+} /* End of free_time_step()*/
+
+	/*
+		* Read the monotonic wall clock
+		*
+		* @return Time in seconds since an arbitrary point in the past
+		*/
+double wall_clock() {
+#ifdef _MSC_VER /*Windows*/
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (double) count.QuadPart / (double) freq.QuadPart;
+#else /*Linux*/
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + 1e-9*(double) now.tv_nsec;
+#endif
+} /* End of wall_clock()*/
+
+	/*
+		* Start the timer of a phase of the solver
+		*
+		* @param para Pointer to FFD parameters
+		* @param phase Phase of the solver
+		*
+		* @return No return needed
+		*/
+void phase_start(PARA_DATA *para, PHASE phase) {
+  para->mytime->phase_begin[phase] = wall_clock();
+} /* End of phase_start()*/
+
+	/*
+		* Stop the timer of a phase of the solver
+		*
+		* @param para Pointer to FFD parameters
+		* @param phase Phase of the solver
+		*
+		* @return No return needed
+		*/
+void phase_end(PARA_DATA *para, PHASE phase) {
+  para->mytime->phase_time[phase] += wall_clock()
+                                   - para->mytime->phase_begin[phase];
+  para->mytime->phase_calls[phase]++;
+} /* End of phase_end()*/
+
+	/*
+		* Count the iterations of an equation solver
+		*
+		* @param para Pointer to FFD parameters
+		* @param solver Type of the solver
+		* @param it Number of iterations, sweeps or cycles
+		*
+		* @return No return needed
+		*/
+void count_iterations(PARA_DATA *para, SOLVERTYPE solver, int it) {
+  para->mytime->solver_calls[solver]++;
+  para->mytime->solver_it[solver] += it;
+} /* End of count_iterations()*/
+
+	/*
+		* Count the iterations that the GS or RBGS solver used for an equation
+		*
+		* A call misses the tolerance if solv.gs_tol is set and the residual
+		* is still larger after solv.gs_it_max iterations.
+		*
+		* @param para Pointer to FFD parameters
+		* @param equ Equation
+		* @param it Number of GS iterations
+		* @param residual Residual after the last iteration
+		*
+		* @return No return needed
+		*/
+void count_equation(PARA_DATA *para, EQUATION equ, int it, REAL residual) {
+  TIME_DATA *t = para->mytime;
+  REAL tol = para->solv->gs_tol[equ];
+
+  t->equ_calls[equ]++;
+  t->equ_it[equ] += it;
+  if(it>t->equ_it_most[equ]) t->equ_it_most[equ] = it;
+  if(tol>0 && residual>tol) t->equ_missed[equ]++;
+} /* End of count_equation()*/
+
+	/*
+		* Write the times of the phases and the iterations of the solvers
+		*
+		* The iterations of the GS and RBGS solvers are also listed for the
+		* pressure, velocity, temperature and species equations.
+		*
+		* The throughput is the number of cells times the number of time steps
+		* divided by the time spent in vel_step, temp_step and den_step. It
+		* does not contain the time that a coupled simulation waits for Modelica.
+		*
+		* @param para Pointer to FFD parameters
+		* @param name Pointer to the file name without extension
+		*
+		* @return 0 if no error occurred
+		*/
+int write_profile(PARA_DATA *para, char *name) {
+  TIME_DATA *t = para->mytime;
+  long cells = (long) para->geom->imax*para->geom->jmax*para->geom->kmax;
+  double compute = t->phase_time[PHASE_VEL] + t->phase_time[PHASE_TEMP]
+                 + t->phase_time[PHASE_DEN];
+  char file_name[400];
+  FILE *file;
+  int n;
+
+  sprintf(file_name, "%s.json", name);
+  file = fopen(file_name, "w");
+  if(file==NULL) {
+    sprintf(msg, "write_profile(): Could not open the file %s.", file_name);
+    ffd_log(msg, FFD_ERROR);
+    return 1;
+  }
+
+  fprintf(file, "{\n");
+  fprintf(file, "  \"cells\": %ld,\n", cells);
+  fprintf(file, "  \"steps\": %d,\n", t->step_current);
+  fprintf(file, "  \"simulation_time\": %.6e,\n", (double) t->t);
+  fprintf(file, "  \"compute_time\": %.6e,\n", compute);
+  fprintf(file, "  \"cells_per_second\": %.6e,\n",
+          compute>0 ? (double) cells*t->step_current/compute : 0.0);
+
+  fprintf(file, "  \"phases\": {\n");
+  for(n=0; n<NB_PHASE; n++)
+    fprintf(file, "    \"%s\": {\"time\": %.6e, \"calls\": %ld}%s\n",
+            phase_name[n], t->phase_time[n], t->phase_calls[n],
+            n<NB_PHASE-1 ? "," : "");
+  fprintf(file, "  },\n");
+
+  fprintf(file, "  \"solvers\": {\n");
+  for(n=0; n<NB_SOLVER; n++)
+    fprintf(file, "    \"%s\": {\"calls\": %ld, \"iterations\": %ld}%s\n",
+            solver_name[n], t->solver_calls[n], t->solver_it[n],
+            n<NB_SOLVER-1 ? "," : "");
+  fprintf(file, "  },\n");
+
+  fprintf(file, "  \"equations\": {\n");
+  for(n=0; n<NB_EQU; n++)
+    fprintf(file, "    \"%s\": {\"calls\": %ld, \"iterations\": %ld, "
+            "\"iterations_per_call\": %.3f, \"most_iterations\": %d, "
+            "\"missed_tolerance\": %ld}%s\n",
+            equation_name[n], t->equ_calls[n], t->equ_it[n],
+            t->equ_calls[n]>0 ? (double) t->equ_it[n]/t->equ_calls[n] : 0.0,
+            t->equ_it_most[n], t->equ_missed[n], n<NB_EQU-1 ? "," : "");
+  fprintf(file, "  }\n");
+  fprintf(file, "}\n");
+
+  if(fclose(file)!=0) {
+    sprintf(msg, "write_profile(): Could not write the file %s.", file_name);
+    ffd_log(msg, FFD_ERROR);
+    return 1;
+  }
+
+  sprintf(msg, "write_profile(): %ld cells, %d steps, %.4f s compute time, "
+          "%.4e cells/s.", cells, t->step_current, compute,
+          compute>0 ? (double) cells*t->step_current/compute : 0.0);
+  ffd_log(msg, FFD_NORMAL);
+
+  return 0;
+} /* End of write_profile()*/
@@ -36,3 +36,98 @@
 	* @return No return needed
 	*/
 void timing(PARA_DATA *para);
+
+/* Maximum growth of the adaptive time step size from one step to the next*/
+#define DT_GROWTH 1.2
+
+/*
+	* Choose the size of the next time step
+	*
+	* The step size is limited by the CFL number of the advection, by the
+	* change of the temperature over the last time step and by the growth
+	* factor DT_GROWTH. The steps to the next synchronization point are
+	* evened out so that the point is reached exactly.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param t_sync Time of the next synchronization point, or a negative
+	*        value for a single simulation
+	*
+	* @return 0 if no error occurred
+	*/
+int adapt_time_step(PARA_DATA *para, REAL **var, double t_sync);
+
+/*
+	* Free the memory of the adaptive time step
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return No return needed
+	*/
+void free_time_step(PARA_DATA *para);
+
+/*
+	* Read the monotonic wall clock
+	*
+	* @return Time in seconds since an arbitrary point in the past
+	*/
+double wall_clock();
+
+/*
+	* Start the timer of a phase of the solver
+	*
+	* The times of the phases are inclusive. For instance, the time of
+	* vel_step contains the time of the advection of the velocity, and the
+	* time of the advection contains the time of the boundary conditions.
+	*
+	* @param para Pointer to FFD parameters
+	* @param phase Phase of the solver
+	*
+	* @return No return needed
+	*/
+void phase_start(PARA_DATA *para, PHASE phase);
+
+/*
+	* Stop the timer of a phase of the solver
+	*
+	* @param para Pointer to FFD parameters
+	* @param phase Phase of the solver
+	*
+	* @return No return needed
+	*/
+void phase_end(PARA_DATA *para, PHASE phase);
+
+/*
+	* Count the iterations of an equation solver
+	*
+	* @param para Pointer to FFD parameters
+	* @param solver Type of the solver
+	* @param it Number of iterations, sweeps or cycles
+	*
+	* @return No return needed
+	*/
+void count_iterations(PARA_DATA *para, SOLVERTYPE solver, int it);
+
+/*
+	* Count the iterations that the GS or RBGS solver used for an equation
+	*
+	* @param para Pointer to FFD parameters
+	* @param equ Equation
+	* @param it Number of GS iterations
+	* @param residual Residual after the last iteration
+	*
+	* @return No return needed
+	*/
+void count_equation(PARA_DATA *para, EQUATION equ, int it, REAL residual);
+
+/*
+	* Write the times of the phases and the iterations of the solvers
+	*
+	* The summary is written in JSON format to the file name.json.
+	*
+	* @param para Pointer to FFD parameters
+	* @param name Pointer to the file name without extension
+	*
+	* @return 0 if no error occurred
+	*/
+int write_profile(PARA_DATA *para, char *name);
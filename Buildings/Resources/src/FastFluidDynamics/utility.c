@@ -16,7 +16,7 @@
 	*/
 
 #include "utility.h"
-FILE *file_log;
+FFD_THREAD_LOCAL FILE *file_log;
 
 	/*
 		* Check the residual of equation
@@ -34,9 +34,12 @@ REAL check_residual(PARA_DATA *para, REAL **var, REAL *x) {
   int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
   REAL *aw = var[AW], *ae = var[AE], *as = var[AS], *an = var[AN];
   REAL *ap = var[AP], *ab = var[AB], *af = var[AF], *b = var[B];
+  REAL *flagp = var[FLAGP];
   REAL tmp, residual = 0.0;
 
   FOR_EACH_CELL
+    /* No equation is solved in solid cells*/
+    if(flagp[IX(i,j,k)]>=0) continue;
     tmp = ap[IX(i,j,k)]*x[IX(i,j,k)]
         - ae[IX(i,j,k)]*x[IX(i+1,j,k)] - aw[IX(i,j,k)]*x[IX(i-1,j,k)]
         - an[IX(i,j,k)]*x[IX(i,j+1,k)] - as[IX(i,j,k)]*x[IX(i,j-1,k)]
@@ -52,6 +55,10 @@ REAL check_residual(PARA_DATA *para, REAL **var, REAL *x) {
 	/*
 		* Write the log file
 		*
+		* The messages of an instance are buffered by its logger. Messages
+		* below the level outp.log_level are not logged. Errors are always
+		* logged and written to the file before Modelica is informed.
+		*
 		* @param message Pointer the message
 		* @param msg_type Type of message
 		*
@@ -59,6 +66,73 @@ REAL check_residual(PARA_DATA *para, REAL **var, REAL *x) {
 		*/
 void ffd_log(char *message, FFD_MSG_TYPE msg_type) {
   char mymsg[400];
+  char line[1024];
+  LOG_LEVEL level;
+
+  /* Messages outside of an instance are written to ffd.log directly*/
+  if(ffd_instance==NULL) {
+    ffd_log_direct(message, msg_type);
+    return;
+  }
+
+  if(msg_type==FFD_NEW || ffd_instance->logger==NULL) {
+    logger_close((LOGGER *) ffd_instance->logger);
+    ffd_instance->logger = logger_open(ffd_instance->log_file_name,
+                                       msg_type==FFD_NEW ? "w" : "a");
+    if(ffd_instance->logger==NULL) {
+      fprintf(stderr, "Error: Cannot open log file.\n");
+      exit(1);
+    }
+  }
+
+  /* Filter the messages by their level*/
+  switch(msg_type) {
+    case FFD_WARNING:
+      level = LOG_WARNING;
+      break;
+    case FFD_ERROR:
+      level = LOG_ERROR;
+      break;
+    default:
+      level = LOG_NORMAL;
+  }
+  if(msg_type!=FFD_NEW && level<ffd_instance->outp.log_level)
+    return;
+
+  switch(msg_type) {
+    /* Warnings are logged but do not stop the simulation*/
+    case FFD_WARNING:
+      sprintf(line, "WARNING in %.1000s\n", message);
+      logger_write((LOGGER *) ffd_instance->logger, line);
+      break;
+    case FFD_ERROR:
+      sprintf(line, "ERROR in %.1000s\n", message);
+      logger_write((LOGGER *) ffd_instance->logger, line);
+      logger_flush((LOGGER *) ffd_instance->logger);
+      sprintf(mymsg, "ERROR in FFD: %.380s\n", message);
+      modelicaError(mymsg);
+      break;
+    /* Normal log*/
+    default:
+      sprintf(line, "%.1000s\n", message);
+      logger_write((LOGGER *) ffd_instance->logger, line);
+  }
+} /* End of ffd_log()*/
+
+	/*
+		* Write a message to ffd.log without buffering
+		*
+		* Used if the message does not belong to an instance, such as if the
+		* instance could not be created.
+		*
+		* @param message Pointer the message
+		* @param msg_type Type of message
+		*
+		* @return No return needed
+		*/
+void ffd_log_direct(char *message, FFD_MSG_TYPE msg_type) {
+  char mymsg[400];
+
   if(msg_type==FFD_NEW) {
     if((file_log=fopen("ffd.log","w+"))==NULL) {
         fprintf(stderr, "Error: Cannot open log file.\n");
@@ -71,7 +145,10 @@ void ffd_log(char *message, FFD_MSG_TYPE msg_type) {
   }
 
   switch(msg_type) {
+    /* Warnings are logged but do not stop the simulation*/
     case FFD_WARNING:
+      fprintf(file_log, "WARNING in %s\n", message);
+      break;
     case FFD_ERROR:
       fprintf(file_log, "ERROR in %s\n", message);
       sprintf(mymsg, "ERROR in FFD: %s\n", message);
@@ -82,7 +159,50 @@ void ffd_log(char *message, FFD_MSG_TYPE msg_type) {
       fprintf(file_log, "%s\n", message);
   }
   fclose(file_log);
-} /* End of ffd_log()*/
+} /* End of ffd_log_direct()*/
+
+	/*
+		* Move the log of the current instance to another file
+		*
+		* @param name New name of the log file
+		*
+		* @return 0 if no error occurred
+		*/
+int ffd_log_rename(const char *name) {
+  if(ffd_instance==NULL || ffd_instance->logger==NULL)
+    return 1;
+
+  if(logger_rename((LOGGER *) ffd_instance->logger, name)!=0)
+    return 1;
+
+  strncpy(ffd_instance->log_file_name, name, FFD_LOG_NAME_LENGTH-1);
+  return 0;
+} /* End of ffd_log_rename()*/
+
+	/*
+		* Write the buffered messages of the current instance to its log file
+		*
+		* @return No return needed
+		*/
+void ffd_log_flush() {
+  if(ffd_instance==NULL || ffd_instance->logger==NULL)
+    return;
+
+  logger_flush((LOGGER *) ffd_instance->logger);
+} /* End of ffd_log_flush()*/
+
+	/*
+		* Write the remaining messages and close the log of the current instance
+		*
+		* @return No return needed
+		*/
+void ffd_log_close() {
+  if(ffd_instance==NULL)
+    return;
+
+  logger_close((LOGGER *) ffd_instance->logger);
+  ffd_instance->logger = NULL;
+} /* End of ffd_log_close()*/
 
 	/*
 		* Check the outflow rate of the scalar psi
@@ -554,82 +674,69 @@ REAL qwall(PARA_DATA *para, REAL **var,int **BINDEX) {
 
 } /* End of qwall()*/
 
+	/*
+		* Allocate memory that is aligned to FFD_ALIGNMENT
+		*
+		* The address returned by calloc() is stored in front of the aligned
+		* block, so the block must be freed by aligned_free().
+		*
+		* @param nb Number of elements
+		* @param size Size of one element
+		*
+		* @return Pointer to the zero-initialized memory, NULL if failed
+		*/
+void *aligned_calloc(size_t nb, size_t size) {
+  char *raw, *p;
+
+  raw = (char *) calloc(nb*size + FFD_ALIGNMENT + sizeof(void *), 1);
+  if(raw==NULL)
+    return NULL;
+
+  p = raw + sizeof(void *);
+  p += (FFD_ALIGNMENT - (size_t) p % FFD_ALIGNMENT) % FFD_ALIGNMENT;
+  ((void **) p)[-1] = raw;
+
+  return p;
+} /* End of aligned_calloc()*/
+
+	/*
+		* Free memory allocated by aligned_calloc()
+		*
+		* @param p Pointer to the memory
+		*
+		* @return No return needed
+		*/
+void aligned_free(void *p) {
+  if(p!=NULL)
+    free(((void **) p)[-1]);
+} /* End of aligned_free()*/
+
 	/*
 		* Free memory for BINDEX
 		*
+		* All boundary indices are stored in the block of BINDEX[0].
+		*
 		* @param BINDEX Pointer to the boundary index
 		*
 		* @return 0 if no error occurred
 		*/
 void free_index(int **BINDEX) {
   if(BINDEX[0]) free(BINDEX[0]);
-  if(BINDEX[1]) free(BINDEX[1]);
-  if(BINDEX[2]) free(BINDEX[2]);
-  if(BINDEX[3]) free(BINDEX[3]);
-  if(BINDEX[4]) free(BINDEX[4]);
+  free(BINDEX);
 } /* End of free_index ()*/
 
 	/*
 		* Free memory for FFD simulation variables
 		*
+		* All variables are stored in the block that starts at var[X].
+		*
 		* @param var Pointer to FFD simulation variables
 		*
 		* @return 0 if no error occurred
 		*/
 void free_data(REAL **var) {
-  if(var[X]) free(var[X]);
-  if(var[Y]) free(var[Y]);
-  if(var[Z]) free(var[Z]);
-  if(var[VX]) free(var[VX]);
-  if(var[VY]) free(var[VY]);
-  if(var[VZ]) free(var[VZ]);
-  if(var[VXS]) free(var[VXS]);
-  if(var[VYS]) free(var[VYS]);
-  if(var[VZS]) free(var[VZS]);
-  if(var[VXM]) free(var[VXM]);
-  if(var[VYM]) free(var[VYM]);
-  if(var[VZM]) free(var[VZM]);
-  if(var[TEMP]) free(var[TEMP]);
-  if(var[TEMPM]) free(var[TEMPM]);
-  if(var[TEMPS]) free(var[TEMPS]);
-  if(var[IP]) free(var[IP]);
-  if(var[TMP1]) free(var[TMP1]);
-  if(var[TMP2]) free(var[TMP2]);
-  if(var[TMP3]) free(var[TMP3]);
-  if(var[AP]) free(var[AP]);
-  if(var[AN]) free(var[AN]);
-  if(var[AS]) free(var[AS]);
-  if(var[AE]) free(var[AE]);
-  if(var[AW]) free(var[AW]);
-  if(var[AF]) free(var[AF]);
-  if(var[AB]) free(var[AB]);
-  if(var[B])  free(var[B]);
-  if(var[GX])  free(var[GX]);
-  if(var[GY])  free(var[GY]);
-  if(var[GZ])  free(var[GZ]);
-  if(var[AP0])  free(var[AP0]);
-  if(var[PP])  free(var[PP]);
-  if(var[FLAGP])  free(var[FLAGP]);
-  if(var[FLAGU])  free(var[FLAGU]);
-  if(var[FLAGV])  free(var[FLAGV]);
-  if(var[FLAGW])  free(var[FLAGW]);
-  if(var[LOCMIN])  free(var[LOCMIN]);
-  if(var[LOCMAX])  free(var[LOCMAX]);
-  if(var[VXBC])  free(var[VXBC]);
-  if(var[VYBC])  free(var[VYBC]);
-  if(var[VZBC])  free(var[VZBC]);
-  if(var[TEMPBC])  free(var[TEMPBC]);
-  if(var[Xi1])  free(var[Xi1]);
-  if(var[Xi2])  free(var[Xi2]);
-  if(var[Xi1BC])  free(var[Xi1BC]);
-  if(var[Xi2BC])  free(var[Xi2BC]);
-  if(var[C1])  free(var[C1]);
-  if(var[C2])  free(var[C2]);
-  if(var[C1BC])  free(var[C1BC]);
-  if(var[C2BC])  free(var[C2BC]);
-  if(var[QFLUXBC])  free(var[QFLUXBC]);
-  if(var[QFLUX])  free(var[QFLUX]);
-
+  aligned_free(var[X]);
+  free(var);
 } /* End of free_data()*/
 
 	/*
@@ -809,7 +916,7 @@ void free_para(PARA_DATA *para) {
   /*------------------------------------------------------------------------
   | Free the path string allocated in read_parameter()
   ------------------------------------------------------------------------*/
-  if(para->cosim->para->filePath) {
+  if(para->cosim!=NULL && para->cosim->para->filePath) {
     free(para->cosim->para->filePath);
     para->cosim->para->filePath = NULL;
   }
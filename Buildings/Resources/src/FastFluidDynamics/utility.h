@@ -34,6 +34,11 @@
 #include "geometry.h"
 #endif
 
+#ifndef _LOGGER_H
+#define _LOGGER_H
+#include "logger.h"
+#endif
+
 
 /*
 	* Check the residual of equation
@@ -49,6 +54,9 @@ REAL check_residual(PARA_DATA *para, REAL **var, REAL *x);
 /*
 	* Write the log file
 	*
+	* The messages of an instance are buffered by its logger. Messages
+	* below the level outp.log_level are not logged.
+	*
 	* @param message Pointer the message
 	* @param msg_type Type of message
 	*
@@ -56,6 +64,39 @@ REAL check_residual(PARA_DATA *para, REAL **var, REAL *x);
 	*/
 void ffd_log(char *message, FFD_MSG_TYPE msg_type);
 
+/*
+	* Write a message to ffd.log without buffering
+	*
+	* @param message Pointer the message
+	* @param msg_type Type of message
+	*
+	* @return No return needed
+	*/
+void ffd_log_direct(char *message, FFD_MSG_TYPE msg_type);
+
+/*
+	* Move the log of the current instance to another file
+	*
+	* @param name New name of the log file
+	*
+	* @return 0 if no error occurred
+	*/
+int ffd_log_rename(const char *name);
+
+/*
+	* Write the buffered messages of the current instance to its log file
+	*
+	* @return No return needed
+	*/
+void ffd_log_flush();
+
+/*
+	* Write the remaining messages and close the log of the current instance
+	*
+	* @return No return needed
+	*/
+void ffd_log_close();
+
 /*
 	* Check the outflow rate of the scalar psi
 	*
@@ -175,9 +216,33 @@ int add_time_averaged_data (PARA_DATA *para, REAL **var);
 	*/
 REAL qwall(PARA_DATA *para, REAL **var,int **BINDEX);
 
+/*
+	* Allocate memory that is aligned to FFD_ALIGNMENT
+	*
+	* The address returned by calloc() is stored in front of the aligned
+	* block, so the block must be freed by aligned_free().
+	*
+	* @param nb Number of elements
+	* @param size Size of one element
+	*
+	* @return Pointer to the zero-initialized memory, NULL if failed
+	*/
+void *aligned_calloc(size_t nb, size_t size);
+
+/*
+	* Free memory allocated by aligned_calloc()
+	*
+	* @param p Pointer to the memory
+	*
+	* @return No return needed
+	*/
+void aligned_free(void *p);
+
 /*
 	* Free memory for BINDEX
 	*
+	* All boundary indices are stored in the block of BINDEX[0].
+	*
 	* @param BINDEX Pointer to the boundary index
 	*
 	* @return 0 if no error occurred
@@ -187,6 +252,8 @@ void free_index(int **BINDEX);
 /*
 	* Free memory for FFD simulation variables
 	*
+	* All variables are stored in the block that starts at var[X].
+	*
 	* @param var Pointer to FFD simulation variables
 	*
 	* @return 0 if no error occurred
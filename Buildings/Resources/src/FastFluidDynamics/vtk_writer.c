@@ -0,0 +1,517 @@
+/*
+	*
+	* \file   vtk_writer.c
+	*
+	* \brief  Write the transient flow field in binary VTK files
+	*
+	* \date   10/18/2026
+	*
+	*/
+
+#include "vtk_writer.h"
+
+/* Number of values per cell in a snapshot: U, V, W, P, T, Xi, FlagP*/
+#define VTK_NB_VALUE 7
+
+	/*
+		* Acquire the lock of the writer
+		*
+		* @param w Pointer to the writer
+		*
+		* @return No return needed
+		*/
+static void vtk_lock(VTK_WRITER *w) {
+#ifdef _MSC_VER /*Windows*/
+  EnterCriticalSection(&w->lock);
+#else /*Linux*/
+  pthread_mutex_lock(&w->lock);
+#endif
+} /* End of vtk_lock()*/
+
+	/*
+		* Release the lock of the writer
+		*
+		* @param w Pointer to the writer
+		*
+		* @return No return needed
+		*/
+static void vtk_unlock(VTK_WRITER *w) {
+#ifdef _MSC_VER /*Windows*/
+  LeaveCriticalSection(&w->lock);
+#else /*Linux*/
+  pthread_mutex_unlock(&w->lock);
+#endif
+} /* End of vtk_unlock()*/
+
+	/*
+		* Wake up all threads that wait for the writer
+		*
+		* @param w Pointer to the writer
+		*
+		* @return No return needed
+		*/
+static void vtk_notify(VTK_WRITER *w) {
+#ifdef _MSC_VER /*Windows*/
+  WakeAllConditionVariable(&w->cond);
+#else /*Linux*/
+  pthread_cond_broadcast(&w->cond);
+#endif
+} /* End of vtk_notify()*/
+
+	/*
+		* Wait until the writer changed
+		*
+		* The lock must be held by the caller.
+		*
+		* @param w Pointer to the writer
+		*
+		* @return No return needed
+		*/
+static void vtk_wait(VTK_WRITER *w) {
+#ifdef _MSC_VER /*Windows*/
+  SleepConditionVariableCS(&w->cond, &w->lock, INFINITE);
+#else /*Linux*/
+  pthread_cond_wait(&w->cond, &w->lock);
+#endif
+} /* End of vtk_wait()*/
+
+	/*
+		* Write one array of the appended data with its size
+		*
+		* @param file Pointer to the file
+		* @param data Pointer to the array
+		* @param n Number of values
+		*
+		* @return 0 if no error occurred
+		*/
+static int vtk_write_array(FILE *file, const float *data, int n) {
+  unsigned int nb_byte = (unsigned int) (n*sizeof(float));
+
+  if(fwrite(&nb_byte, sizeof(nb_byte), 1, file)!=1) return 1;
+  if(fwrite(data, sizeof(float), n, file)!=(size_t) n) return 1;
+
+  return 0;
+} /* End of vtk_write_array()*/
+
+	/*
+		* Write a snapshot to a VTK rectilinear grid file
+		*
+		* The function is called by the background thread and must not log.
+		*
+		* @param w Pointer to the writer
+		* @param idx Index of the snapshot
+		*
+		* @return 0 if no error occurred
+		*/
+static int vtk_write_file(VTK_WRITER *w, int idx) {
+  int n = w->imax*w->jmax*w->kmax;
+  int nx = w->imax+1, ny = w->jmax+1, nz = w->kmax+1;
+  unsigned long offset = 0;
+  float *data = w->buf[idx];
+  unsigned int one = 1;
+  char filename[VTK_NAME_LENGTH+16];
+  FILE *file;
+  int flag = 0;
+
+  sprintf(filename, "%s_%d.vtr", w->name, w->step[idx]);
+  if((file=fopen(filename, "wb"))==NULL) {
+    strcpy(w->error_name, filename);
+    return 1;
+  }
+
+  fprintf(file, "<?xml version=\"1.0\"?>\n");
+  fprintf(file, "<VTKFile type=\"RectilinearGrid\" version=\"1.0\" "
+          "byte_order=\"%s\" header_type=\"UInt32\">\n",
+          *((unsigned char *) &one)==1 ? "LittleEndian" : "BigEndian");
+  fprintf(file, "  <RectilinearGrid WholeExtent=\"0 %d 0 %d 0 %d\">\n",
+          w->imax, w->jmax, w->kmax);
+  fprintf(file, "    <FieldData>\n");
+  fprintf(file, "      <DataArray type=\"Float64\" Name=\"TimeValue\" "
+          "NumberOfTuples=\"1\" format=\"ascii\">%.9g</DataArray>\n",
+          (double) w->t[idx]);
+  fprintf(file, "    </FieldData>\n");
+  fprintf(file, "    <Piece Extent=\"0 %d 0 %d 0 %d\">\n",
+          w->imax, w->jmax, w->kmax);
+
+  /****************************************************************************
+  | Cell data and coordinates, in the order of the appended data
+  ****************************************************************************/
+  fprintf(file, "      <CellData Scalars=\"T\" Vectors=\"U\">\n");
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"U\" "
+          "NumberOfComponents=\"3\" format=\"appended\" offset=\"%lu\"/>\n",
+          offset);
+  offset += sizeof(unsigned int) + 3*n*sizeof(float);
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"P\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  offset += sizeof(unsigned int) + n*sizeof(float);
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"T\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  offset += sizeof(unsigned int) + n*sizeof(float);
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"Xi\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  offset += sizeof(unsigned int) + n*sizeof(float);
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"FlagP\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  offset += sizeof(unsigned int) + n*sizeof(float);
+  fprintf(file, "      </CellData>\n");
+  fprintf(file, "      <Coordinates>\n");
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"X\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  offset += sizeof(unsigned int) + nx*sizeof(float);
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"Y\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  offset += sizeof(unsigned int) + ny*sizeof(float);
+  fprintf(file, "        <DataArray type=\"Float32\" Name=\"Z\" "
+          "format=\"appended\" offset=\"%lu\"/>\n", offset);
+  fprintf(file, "      </Coordinates>\n");
+  fprintf(file, "    </Piece>\n");
+  fprintf(file, "  </RectilinearGrid>\n");
+  fprintf(file, "  <AppendedData encoding=\"raw\">\n_");
+
+  /****************************************************************************
+  | Appended data
+  ****************************************************************************/
+  flag = vtk_write_array(file, data, 3*n)
+         || vtk_write_array(file, data+3*n, n)
+         || vtk_write_array(file, data+4*n, n)
+         || vtk_write_array(file, data+5*n, n)
+         || vtk_write_array(file, data+6*n, n)
+         || vtk_write_array(file, w->coord, nx)
+         || vtk_write_array(file, w->coord+nx, ny)
+         || vtk_write_array(file, w->coord+nx+ny, nz);
+
+  fprintf(file, "\n  </AppendedData>\n");
+  fprintf(file, "</VTKFile>\n");
+
+  if(fclose(file)!=0 || flag!=0) {
+    strcpy(w->error_name, filename);
+    return 1;
+  }
+
+  return 0;
+} /* End of vtk_write_file()*/
+
+	/*
+		* Write a snapshot and record it for the collection file
+		*
+		* The lock must not be held by the caller.
+		*
+		* @param w Pointer to the writer
+		* @param idx Index of the snapshot
+		*
+		* @return No return needed
+		*/
+static void vtk_write_snapshot(VTK_WRITER *w, int idx) {
+  int flag;
+  REAL *file_t;
+  int *file_step;
+
+  flag = vtk_write_file(w, idx);
+
+  if(flag==0 && w->nb_file==w->nb_alloc) {
+    w->nb_alloc = w->nb_alloc>0 ? 2*w->nb_alloc : 64;
+    file_t = (REAL *) realloc(w->file_t, w->nb_alloc*sizeof(REAL));
+    if(file_t!=NULL) w->file_t = file_t;
+    file_step = (int *) realloc(w->file_step, w->nb_alloc*sizeof(int));
+    if(file_step!=NULL) w->file_step = file_step;
+    if(file_t==NULL || file_step==NULL) {
+      /* Only the collection file is incomplete*/
+      w->nb_alloc = w->nb_file;
+      flag = 0;
+      idx = -1;
+    }
+  }
+  if(flag==0 && idx>=0) {
+    w->file_t[w->nb_file] = w->t[idx];
+    w->file_step[w->nb_file] = w->step[idx];
+    w->nb_file++;
+  }
+
+  vtk_lock(w);
+  if(flag!=0) w->error = 1;
+  vtk_unlock(w);
+} /* End of vtk_write_snapshot()*/
+
+	/*
+		* Run the background thread that writes the snapshots
+		*
+		* @param w Pointer to the writer
+		*
+		* @return No return needed
+		*/
+static void vtk_run(VTK_WRITER *w) {
+  int idx;
+
+  vtk_lock(w);
+  while(1) {
+    while(w->ready<0 && w->stop==0)
+      vtk_wait(w);
+    if(w->ready<0) break;
+
+    idx = w->busy = w->ready;
+    w->ready = -1;
+    vtk_notify(w);
+    vtk_unlock(w);
+
+    vtk_write_snapshot(w, idx);
+
+    vtk_lock(w);
+    w->busy = -1;
+    vtk_notify(w);
+  }
+  vtk_unlock(w);
+} /* End of vtk_run()*/
+
+	/*
+		* Entry of the background thread
+		*
+		* @param p Pointer to the writer
+		*
+		* @return 0
+		*/
+#ifdef _MSC_VER /*Windows*/
+static DWORD WINAPI vtk_thread(LPVOID p) {
+  vtk_run((VTK_WRITER *) p);
+  return 0;
+}
+#else /*Linux*/
+static void *vtk_thread(void *p) {
+  vtk_run((VTK_WRITER *) p);
+  return NULL;
+}
+#endif
+
+	/*
+		* Report an error of the background thread
+		*
+		* @param w Pointer to the writer
+		*
+		* @return 0 if no error occurred
+		*/
+static int vtk_check_error(VTK_WRITER *w) {
+  int error;
+
+  vtk_lock(w);
+  error = w->error;
+  vtk_unlock(w);
+
+  if(error!=0) {
+    sprintf(msg, "vtk_writer: Failed to write file %s.", w->error_name);
+    ffd_log(msg, FFD_ERROR);
+  }
+
+  return error;
+} /* End of vtk_check_error()*/
+
+	/*
+		* Open the writer of the transient VTK files
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		* @param name Pointer to the file name without extension
+		*
+		* @return 0 if no error occurred
+		*/
+int open_vtk_writer(PARA_DATA *para, REAL **var, char *name) {
+  int i, j, k;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int n = imax*jmax*kmax;
+  REAL *gx = var[GX], *gy = var[GY], *gz = var[GZ];
+  VTK_WRITER *w;
+
+  if(strlen(name)>=VTK_NAME_LENGTH) {
+    sprintf(msg, "open_vtk_writer(): File name %s is too long.", name);
+    ffd_log(msg, FFD_ERROR);
+    return 1;
+  }
+
+  w = (VTK_WRITER *) calloc(1, sizeof(VTK_WRITER));
+  if(w==NULL) {
+    ffd_log("open_vtk_writer(): Failed to allocate memory for the writer.",
+            FFD_ERROR);
+    return 1;
+  }
+
+  w->coord = (float *) malloc((imax+jmax+kmax+3)*sizeof(float));
+  w->buf[0] = (float *) malloc(2*VTK_NB_VALUE*n*sizeof(float));
+  if(w->coord==NULL || w->buf[0]==NULL) {
+    ffd_log("open_vtk_writer(): Failed to allocate memory for the snapshots.",
+            FFD_ERROR);
+    free(w->coord);
+    free(w->buf[0]);
+    free(w);
+    return 1;
+  }
+  w->buf[1] = w->buf[0] + VTK_NB_VALUE*n;
+
+  strcpy(w->name, name);
+  w->imax = imax;
+  w->jmax = jmax;
+  w->kmax = kmax;
+  w->ready = -1;
+  w->busy = -1;
+
+  /****************************************************************************
+  | The grid does not change during the simulation
+  ****************************************************************************/
+  for(i=0; i<=imax; i++)
+    w->coord[i] = (float) gx[IX(i,0,0)];
+  for(j=0; j<=jmax; j++)
+    w->coord[imax+1+j] = (float) gy[IX(0,j,0)];
+  for(k=0; k<=kmax; k++)
+    w->coord[imax+jmax+2+k] = (float) gz[IX(0,0,k)];
+
+#ifdef _MSC_VER /*Windows*/
+  InitializeCriticalSection(&w->lock);
+  InitializeConditionVariable(&w->cond);
+  w->thread = CreateThread(NULL, 0, vtk_thread, (LPVOID) w, 0, NULL);
+  w->threaded = w->thread!=NULL;
+#else /*Linux*/
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->cond, NULL);
+  w->threaded = pthread_create(&w->thread, NULL, vtk_thread, (void *) w)==0;
+#endif
+
+  if(w->threaded==0)
+    ffd_log("open_vtk_writer(): Could not start the writer thread. "
+            "The VTK files are written by the solver.", FFD_WARNING);
+
+  para->outp->vtk = (void *) w;
+  return 0;
+} /* End of open_vtk_writer()*/
+
+	/*
+		* Take a snapshot of the flow field and hand it to the writer
+		*
+		* The velocities are interpolated from the faces to the cell centers.
+		*
+		* @param para Pointer to FFD parameters
+		* @param var Pointer to FFD simulation variables
+		*
+		* @return 0 if no error occurred
+		*/
+int write_vtk_snapshot(PARA_DATA *para, REAL **var) {
+  int i, j, k, m;
+  int imax = para->geom->imax, jmax = para->geom->jmax;
+  int kmax = para->geom->kmax;
+  int IMAX = imax+2, IJMAX = (imax+2)*(jmax+2);
+  int n = imax*jmax*kmax;
+  REAL *u = var[VX], *v = var[VY], *w = var[VZ], *p = var[IP];
+  REAL *T = var[TEMP], *Xi = var[Xi1], *flagp = var[FLAGP];
+  VTK_WRITER *vtk = (VTK_WRITER *) para->outp->vtk;
+  float *data;
+
+  if(vtk==NULL) return 0;
+
+  /* Wait until the snapshot to be filled is no longer used by the writer*/
+  vtk_lock(vtk);
+  while(vtk->ready>=0 || vtk->busy==vtk->cur)
+    vtk_wait(vtk);
+  vtk_unlock(vtk);
+
+  if(vtk_check_error(vtk)!=0) return 1;
+
+  data = vtk->buf[vtk->cur];
+  m = 0;
+  for(k=1; k<=kmax; k++)
+    for(j=1; j<=jmax; j++)
+      for(i=1; i<=imax; i++) {
+        data[3*m] = (float) (0.5*(u[IX(i,j,k)]+u[IX(i-1,j,k)]));
+        data[3*m+1] = (float) (0.5*(v[IX(i,j,k)]+v[IX(i,j-1,k)]));
+        data[3*m+2] = (float) (0.5*(w[IX(i,j,k)]+w[IX(i,j,k-1)]));
+        data[3*n+m] = (float) p[IX(i,j,k)];
+        data[4*n+m] = (float) T[IX(i,j,k)];
+        data[5*n+m] = (float) Xi[IX(i,j,k)];
+        data[6*n+m] = (float) flagp[IX(i,j,k)];
+        m++;
+      }
+  vtk->t[vtk->cur] = para->mytime->t;
+  vtk->step[vtk->cur] = para->mytime->step_current;
+
+  /* Without background thread, the snapshot is written directly*/
+  if(vtk->threaded==0) {
+    vtk_write_snapshot(vtk, vtk->cur);
+    return vtk_check_error(vtk);
+  }
+
+  vtk_lock(vtk);
+  vtk->ready = vtk->cur;
+  vtk->cur = 1 - vtk->cur;
+  vtk_notify(vtk);
+  vtk_unlock(vtk);
+
+  return 0;
+} /* End of write_vtk_snapshot()*/
+
+	/*
+		* Write the remaining snapshot and the collection file, and free the writer
+		*
+		* @param para Pointer to FFD parameters
+		*
+		* @return 0 if no error occurred
+		*/
+int close_vtk_writer(PARA_DATA *para) {
+  VTK_WRITER *w = (VTK_WRITER *) para->outp->vtk;
+  char filename[VTK_NAME_LENGTH+16];
+  FILE *file;
+  int n, flag;
+
+  if(w==NULL) return 0;
+
+  if(w->threaded==1) {
+    vtk_lock(w);
+    w->stop = 1;
+    vtk_notify(w);
+    vtk_unlock(w);
+#ifdef _MSC_VER /*Windows*/
+    WaitForSingleObject(w->thread, INFINITE);
+    CloseHandle(w->thread);
+#else /*Linux*/
+    pthread_join(w->thread, NULL);
+#endif
+  }
+
+  flag = vtk_check_error(w);
+
+  /****************************************************************************
+  | Write the collection file of the snapshots
+  ****************************************************************************/
+  sprintf(filename, "%s.pvd", w->name);
+  if((file=fopen(filename, "w"))==NULL) {
+    sprintf(msg, "close_vtk_writer(): Failed to open file %s.", filename);
+    ffd_log(msg, FFD_ERROR);
+    flag = 1;
+  }
+  else {
+    fprintf(file, "<?xml version=\"1.0\"?>\n");
+    fprintf(file, "<VTKFile type=\"Collection\" version=\"0.1\">\n");
+    fprintf(file, "  <Collection>\n");
+    for(n=0; n<w->nb_file; n++)
+      fprintf(file, "    <DataSet timestep=\"%.9g\" file=\"%s_%d.vtr\"/>\n",
+              (double) w->file_t[n], w->name, w->file_step[n]);
+    fprintf(file, "  </Collection>\n");
+    fprintf(file, "</VTKFile>\n");
+    fclose(file);
+
+    sprintf(msg, "close_vtk_writer(): Wrote %d VTK files listed in %s.",
+            w->nb_file, filename);
+    ffd_log(msg, FFD_NORMAL);
+  }
+
+#ifdef _MSC_VER /*Windows*/
+  DeleteCriticalSection(&w->lock);
+#else /*Linux*/
+  pthread_mutex_destroy(&w->lock);
+  pthread_cond_destroy(&w->cond);
+#endif
+  free(w->file_t);
+  free(w->file_step);
+  free(w->coord);
+  free(w->buf[0]);
+  free(w);
+  para->outp->vtk = NULL;
+
+  return flag;
+} /* End of close_vtk_writer()*/
@@ -0,0 +1,100 @@
+/*
+	*
+	* @file   vtk_writer.h
+	*
+	* @brief  Write the transient flow field in binary VTK files
+	*
+	* @date   10/18/2026
+	*
+	* Every outp.transient_step time steps, the solver copies the cell
+	* centered values into a snapshot buffer. A background thread writes the
+	* snapshot to a VTK rectilinear grid file (.vtr) with raw appended data,
+	* while the solver continues with the next time steps. The variables of
+	* the solver are not modified. The files of all snapshots are listed in a
+	* ParaView collection file (.pvd) that is written when the writer is
+	* closed.
+	*
+	*/
+
+#ifndef _VTK_WRITER_H
+#define _VTK_WRITER_H
+#endif
+
+#ifndef _DATA_STRUCTURE_H
+#define _DATA_STRUCTURE_H
+#include "data_structure.h"
+#endif
+
+#ifndef _UTILITY_H
+#define _UTILITY_H
+#include "utility.h"
+#endif
+
+#ifndef _MSC_VER /*Linux*/
+#include <pthread.h>
+#endif
+
+/* Maximum length of the file names*/
+#define VTK_NAME_LENGTH 400
+
+/* Writer of the transient VTK files*/
+typedef struct {
+  char name[VTK_NAME_LENGTH]; /* File name without extension and step*/
+  int imax, jmax, kmax;
+  float *coord; /* Coordinates of the cell faces in x, y and z direction*/
+  float *buf[2]; /* Snapshots, one is filled while the other one is written*/
+  REAL t[2]; /* Simulation time of the snapshots*/
+  int step[2]; /* Time step of the snapshots*/
+  int cur; /* Index of the snapshot that is filled by the solver*/
+  int ready; /* Index of the snapshot that waits to be written, or -1*/
+  int busy; /* Index of the snapshot that is being written, or -1*/
+  int stop; /* 1: Stop the background thread*/
+  int threaded; /* 1: The snapshots are written by the background thread*/
+  int error; /* 1: A file could not be written*/
+  char error_name[VTK_NAME_LENGTH+16]; /* Name of the file with the error*/
+  int nb_file; /* Number of files that have been written*/
+  int nb_alloc; /* Length of the arrays file_t and file_step*/
+  REAL *file_t; /* Simulation time of the files that have been written*/
+  int *file_step; /* Time step of the files that have been written*/
+#ifdef _MSC_VER /*Windows*/
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE cond;
+  HANDLE thread;
+#else /*Linux*/
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  pthread_t thread;
+#endif
+} VTK_WRITER;
+
+/*
+	* Open the writer of the transient VTK files
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	* @param name Pointer to the file name without extension
+	*
+	* @return 0 if no error occurred
+	*/
+int open_vtk_writer(PARA_DATA *para, REAL **var, char *name);
+
+/*
+	* Take a snapshot of the flow field and hand it to the writer
+	*
+	* The caller waits only if the writer is two snapshots behind.
+	*
+	* @param para Pointer to FFD parameters
+	* @param var Pointer to FFD simulation variables
+	*
+	* @return 0 if no error occurred
+	*/
+int write_vtk_snapshot(PARA_DATA *para, REAL **var);
+
+/*
+	* Write the remaining snapshot and the collection file, and free the writer
+	*
+	* @param para Pointer to FFD parameters
+	*
+	* @return 0 if no error occurred
+	*/
+int close_vtk_writer(PARA_DATA *para);
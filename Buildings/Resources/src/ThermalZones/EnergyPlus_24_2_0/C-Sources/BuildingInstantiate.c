@@ -260,59 +260,66 @@ void writeModelStructureForEnergyPlus(const FMUBuilding* bui, char** modelicaBui
   fclose(fp);
 }
 
+/* Set the value references and units of ptrSpawnReals.
+   The variables are looked up by name in the index that the fmi library builds
+   when parsing modelDescription.xml, which avoids a loop over all variables of the FMU. */
 void setAttributesReal(
   FMUBuilding* bui,
-  fmi2_import_variable_list_t* varLis,
-  const fmi2_value_reference_t varValRef[],
-  const size_t nVar,
-  const spawnReals* ptrSpawnReals){
+  spawnReals* ptrSpawnReals){
 
   const char* fmuNam = bui->fmuAbsPat;
-  size_t iFMI;
   fmi2_import_variable_t* var;
-  bool found;
+  fmi2_import_real_variable_t* varRea;
+  fmi2_value_reference_t valRef;
   size_t i;
 
   void (*SpawnFormatMessage)(const char *string, ...) = bui->SpawnFormatMessage;
   void (*SpawnFormatError)(const char *string, ...) = bui->SpawnFormatError;
 
   for(i = 0; i < ptrSpawnReals->n; i++){
-    found = false;
     if (bui->logLevel >= TIMESTEP)
         SpawnFormatMessage("%.3f %s: Setting variable reference for %s.\n",
           bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i]);
 
-    for (iFMI = 0; iFMI < nVar; iFMI++){
-      var = fmi2_import_get_variable(varLis, iFMI);
-      if (strcmp(ptrSpawnReals->fmiNames[i], fmi2_import_get_variable_name(var)) == 0){
-        /* Found the variable */
-        fmi2_import_real_variable_t* varRea = fmi2_import_get_variable_as_real(var);
-        ptrSpawnReals->units[i] = fmi2_import_get_real_variable_unit(varRea);
-        /* If a unit is not specified in modelDescription.xml, then unit is NULL */
-
-        if (ptrSpawnReals->units[i] == NULL){
-          SpawnFormatMessage("%.3f %s: Warning: Variable %s does not specify units in %s. It will not be converted to SI units.\n",
-            bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i], fmuNam);
-        }
+    var = fmi2_import_get_variable_by_name(bui->fmu, ptrSpawnReals->fmiNames[i]);
+    if (var == NULL)
+      SpawnFormatError("%s: Failed to find variable %s in %s.", bui->modelicaNameBuilding,
+        ptrSpawnReals->fmiNames[i], fmuNam);
 
-        if (bui->logLevel >= MEDIUM){
-          if (ptrSpawnReals->units[i] == NULL)
-            SpawnFormatMessage("%.3f %s: Variable with name %s has no units and valRef= %d.\n",
-              bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i], varValRef[iFMI]);
-          else{
-            const char* unitName = fmi2_import_get_unit_name(ptrSpawnReals->units[i]); /* This is 'W', 'm2', etc. */
-            SpawnFormatMessage("%.3f %s: Variable with name %s has unit = %s and valRef= %d.\n",
-              bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i], unitName, varValRef[iFMI]);
-          }
-        }
-        ptrSpawnReals->valRefs[i] = varValRef[iFMI];
-        found = true;
-        break;
+    /* Found the variable */
+    valRef = fmi2_import_get_variable_vr(var);
+    varRea = fmi2_import_get_variable_as_real(var);
+    ptrSpawnReals->units[i] = fmi2_import_get_real_variable_unit(varRea);
+    /* If a unit is not specified in modelDescription.xml, then unit is NULL */
+
+    if (ptrSpawnReals->units[i] == NULL){
+      SpawnFormatMessage("%.3f %s: Warning: Variable %s does not specify units in %s. It will not be converted to SI units.\n",
+        bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i], fmuNam);
+    }
+
+    if (bui->logLevel >= MEDIUM){
+      if (ptrSpawnReals->units[i] == NULL)
+        SpawnFormatMessage("%.3f %s: Variable with name %s has no units and valRef= %d.\n",
+          bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i], valRef);
+      else{
+        const char* unitName = fmi2_import_get_unit_name(ptrSpawnReals->units[i]); /* This is 'W', 'm2', etc. */
+        SpawnFormatMessage("%.3f %s: Variable with name %s has unit = %s and valRef= %d.\n",
+          bui->time, bui->modelicaNameBuilding, ptrSpawnReals->fmiNames[i], unitName, valRef);
       }
     }
-    if (!found)
-      SpawnFormatError("%s: Failed to find variable %s in %s.", bui->modelicaNameBuilding,
-        ptrSpawnReals->fmiNames[i], fmuNam);
+    ptrSpawnReals->valRefs[i] = valRef;
+
+    /* Store the unit conversion, as the units do not change during the simulation */
+    if (ptrSpawnReals->units[i] != NULL){
+      ptrSpawnReals->scale[i] = fmi2_import_get_SI_unit_factor(ptrSpawnReals->units[i]);
+      ptrSpawnReals->offset[i] = fmi2_import_get_SI_unit_offset(ptrSpawnReals->units[i]);
+    }
+    else{
+      ptrSpawnReals->scale[i] = 1;
+      ptrSpawnReals->offset[i] = 0;
+    }
+    if (ptrSpawnReals->scale[i] != 1 || ptrSpawnReals->offset[i] != 0)
+      ptrSpawnReals->isIdentity = false;
   }
 }
 
@@ -320,10 +327,6 @@ void setValueReferences(FMUBuilding* bui){
   size_t i;
   SpawnObject* ptrSpaObj;
 
-  fmi2_import_variable_list_t* vl = fmi2_import_get_variable_list(bui->fmu, 0);
-  const fmi2_value_reference_t* vrl = fmi2_import_get_value_referece_list(vl);
-  size_t nv = fmi2_import_get_variable_list_size(vl);
-
   void (*SpawnFormatMessage)(const char *string, ...) = bui->SpawnFormatMessage;
 
   /* Set value references for the ptrSpaObj by assigning the values obtained from the FMU */
@@ -333,14 +336,14 @@ void setValueReferences(FMUBuilding* bui){
 
   for(i = 0; i < bui->nExcObj; i++){
     ptrSpaObj = (SpawnObject*) bui->exchange[i];
-    setAttributesReal(bui, vl, vrl, nv, ptrSpaObj->parameters);
-    setAttributesReal(bui, vl, vrl, nv, ptrSpaObj->inputs);
-    setAttributesReal(bui, vl, vrl, nv, ptrSpaObj->outputs);
+    setAttributesReal(bui, ptrSpaObj->parameters);
+    setAttributesReal(bui, ptrSpaObj->inputs);
+    setAttributesReal(bui, ptrSpaObj->outputs);
     ptrSpaObj->valueReferenceIsSet = true;
   }
 
-  /* Free the variable list */
-  fmi2_import_free_variable_list(vl);
+  /* Allocate the outputs of all exchange objects, which are obtained with one call to the FMU */
+  mallocBuildingOutputs(bui);
 
   return;
 }
@@ -559,6 +562,7 @@ void generateFMU(FMUBuilding* bui, const char* spawnFullPath, const char* modeli
       bui->time, bui->modelicaNameBuilding, bui->fmuAbsPat);
 
   if( access(modelicaBuildingsJsonFile, F_OK ) == -1 ) {
+    releaseFMUCacheLock(bui);
     SpawnFormatError("Requested to use json file '%s' which does not exist.", modelicaBuildingsJsonFile);
   }
 
@@ -603,9 +607,11 @@ void generateFMU(FMUBuilding* bui, const char* spawnFullPath, const char* modeli
   retVal = system(fulCmd);
   /* Check if generated FMU indeed exists */
   if( access( bui->fmuAbsPat, F_OK ) != 0 ) {
+    releaseFMUCacheLock(bui);
     SpawnFormatError("%.3f %s: Executing '%s' failed to generate fmu '%s'.", bui->time, bui->modelicaNameBuilding, fulCmd, bui->fmuAbsPat);
   }
   if (retVal != 0){
+    releaseFMUCacheLock(bui);
     SpawnFormatError("%.3f %s: Generating FMU returned value %d, but FMU exists.\n", bui->time, bui->modelicaNameBuilding, retVal);
   }
   free(fulCmd);
@@ -716,6 +722,39 @@ void spawnLogger(
 
 /* Import the EnergyPlus FMU
 */
+/* Set the method used to compute the derivatives from the environment variable SPAWNDERIVATIVES.
+   The directional derivatives are only used if the FMU provides them. */
+void setDerivativeMethod(FMUBuilding* bui){
+  const char* env;
+
+  bui->derivativeMethod = finiteDifference;
+  env = getenv("SPAWNDERIVATIVES");
+  if (env == NULL || strlen(env) == 0 || strcmp(env, "finiteDifference") == 0)
+    return;
+
+  if (strcmp(env, "bulkFiniteDifference") == 0)
+    bui->derivativeMethod = bulkFiniteDifference;
+  else if (strcmp(env, "directionalDerivative") == 0){
+    if (fmi2_import_get_capability(bui->fmu, fmi2_me_providesDirectionalDerivatives))
+      bui->derivativeMethod = directionalDerivative;
+    else{
+      bui->derivativeMethod = bulkFiniteDifference;
+      if (bui->logLevel >= WARNINGS)
+        bui->SpawnFormatMessage("%.3f %s: Warning: FMU does not provide directional derivatives, using bulkFiniteDifference for the derivatives.\n",
+          bui->time, bui->modelicaNameBuilding);
+    }
+  }
+  else if (bui->logLevel >= WARNINGS)
+    bui->SpawnFormatMessage("%.3f %s: Warning: Unknown value '%s' of environment variable SPAWNDERIVATIVES, using finiteDifference for the derivatives.\n",
+      bui->time, bui->modelicaNameBuilding, env);
+
+  if (bui->logLevel >= MEDIUM)
+    bui->SpawnFormatMessage("%.3f %s: Using %s for the derivatives.\n",
+      bui->time, bui->modelicaNameBuilding,
+      bui->derivativeMethod == directionalDerivative ? "directionalDerivative" :
+        (bui->derivativeMethod == bulkFiniteDifference ? "bulkFiniteDifference" : "finiteDifference"));
+}
+
 void importSpawnFMU(FMUBuilding* bui){
   const fmi2Boolean visible = fmi2False;
 
@@ -766,6 +805,8 @@ void importSpawnFMU(FMUBuilding* bui){
     SpawnFormatError("Unxepected FMU kind for %s, require ME.", FMUPath);
   }
 
+  setDerivativeMethod(bui);
+
   /* Get model statistics
   fmi2_import_collect_model_counts(bui->fmu, &mc);
   printf("*** Number of discrete variables %lu.\n", mc.num_discrete);
@@ -909,6 +950,12 @@ void generateAndInstantiateBuilding(FMUBuilding* bui){
         bui->time, bui->modelicaNameBuilding, bui->precompiledFMUAbsPat, bui->fmuAbsPat);
     copyBinaryFile(bui->precompiledFMUAbsPat, bui->fmuAbsPat, SpawnFormatError);
   }
+  else if (getFMUFromCache(bui)){
+    /* Copied the FMU from the cache directory SPAWNCACHE, which was generated by an earlier simulation */
+    if (bui->logLevel >= QUIET)
+      SpawnFormatMessage("%.3f %s: Using FMU %s from the cache.\n",
+        bui->time, bui->modelicaNameBuilding, bui->fmuCacheFile);
+  }
   else{
     /* Find where the spawn executable is located, and return it in spawnFullPath.
        If not found, then spawnFullPath == NULL.
@@ -932,12 +979,15 @@ void generateAndInstantiateBuilding(FMUBuilding* bui){
         spawnFullPath = findSpawnExe(bui, env, bui->spawnExe);
     }
     if (spawnFullPath == NULL){
+      releaseFMUCacheLock(bui);
       SpawnFormatError("Failed to find spawn executable in Buildings Library installation, on SPAWNPATH and on PATH. See installation instructions at Buildings.ThermalZones.EnergyPlus_%s.UsersGuide.Installation", bui->idfVersion);
     }
 
     /* Generate FMU using spawnFullPath */
     generateFMU(bui, spawnFullPath, modelicaBuildingsJsonFile);
     free(spawnFullPath);
+    /* Store the FMU if the cache is used and this building holds its lock */
+    storeFMUInCache(bui);
   }
 
   free(modelicaBuildingsJsonFile);
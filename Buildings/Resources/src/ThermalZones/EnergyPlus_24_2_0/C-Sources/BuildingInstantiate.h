@@ -10,6 +10,7 @@
 #include "SpawnFMU.h"
 #include "SpawnUtil.h"
 #include "cryptographicsHash.h"
+#include "SpawnFMUCache.h"
 
 #include <stdio.h>
 #ifdef _MSC_VER
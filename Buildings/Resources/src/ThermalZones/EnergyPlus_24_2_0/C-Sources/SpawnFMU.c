@@ -150,6 +150,18 @@ size_t AllocateBuildingDataStructure(
   Buildings_FMUS[nFMU]->relativeSurfaceTolerance = relativeSurfaceTolerance;
   /* Set the model hash to null */
   Buildings_FMUS[nFMU]->modelHash = NULL;
+  /* Set the outputs of all exchange objects to null, they are allocated when the FMU is loaded */
+  Buildings_FMUS[nFMU]->nOutAll = 0;
+  Buildings_FMUS[nFMU]->valRefsOut = NULL;
+  Buildings_FMUS[nFMU]->valsOutEP = NULL;
+  Buildings_FMUS[nFMU]->valsOutVersion = 0;
+  Buildings_FMUS[nFMU]->exchangeVersion = 1;
+  Buildings_FMUS[nFMU]->tNext = startTime;
+  Buildings_FMUS[nFMU]->tNextVersion = 0;
+  Buildings_FMUS[nFMU]->derivativeMethod = finiteDifference;
+  /* Set the FMU cache to null, it is set up when the FMU is generated */
+  Buildings_FMUS[nFMU]->fmuCacheFile = NULL;
+  Buildings_FMUS[nFMU]->fmuCacheLock = NULL;
   /* Set the number of this FMU */
   Buildings_FMUS[nFMU]->iFMU = nFMU;
 
@@ -336,6 +348,14 @@ void FMUBuildingFree(FMUBuilding* bui){
       free(bui->tmpDir);
     if (bui->modelHash != NULL)
       free(bui->modelHash);
+    if (bui->valRefsOut != NULL)
+      free(bui->valRefsOut);
+    if (bui->valsOutEP != NULL)
+      free(bui->valsOutEP);
+    if (bui->fmuCacheFile != NULL)
+      free(bui->fmuCacheFile);
+    /* Remove the lock of the FMU cache if the simulation stopped while generating the FMU */
+    releaseFMUCacheLock(bui);
     free(bui);
   }
   decrementBuildings_nFMU();
@@ -0,0 +1,325 @@
+/*
+ * Cache of the EnergyPlus FMUs that is shared by simulations.
+ */
+
+#include "SpawnFMUCache.h"
+#include "SpawnUtil.h"
+#include "cryptographicsHash.h"
+
+#ifndef Buildings_SpawnFMUCache_c
+#define Buildings_SpawnFMUCache_c
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <fcntl.h>
+#ifdef _WIN32 /* Win32 or Win64 */
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+/* Return the process id, used to make the names of temporary files unique */
+static long getProcessId(){
+#ifdef _WIN32 /* Win32 or Win64 */
+  return (long)_getpid();
+#else
+  return (long)getpid();
+#endif
+}
+
+/* Return the name dir + "/" + key + ext.
+   The calling routine is responsible to free the returned string. */
+static char* getCacheFileName(
+  const char* dir,
+  const char* key,
+  const char* ext,
+  void (*SpawnFormatError)(const char *string, ...)){
+  char* name;
+  const size_t len = strlen(dir) + strlen(SEPARATOR) + strlen(key) + strlen(ext) + 1;
+
+  mallocString(len, "Failed to allocate memory for the name of a file in the FMU cache.", &name, SpawnFormatError);
+  memset(name, '\0', len);
+  strcpy(name, dir);
+  strcat(name, SEPARATOR);
+  strcat(name, key);
+  strcat(name, ext);
+  return name;
+}
+
+/* Create the cache directory if it does not exist.
+   Return 0 if the directory exists. */
+static int createCacheDirectory(const char* dirName){
+#ifdef _WIN32 /* Win32 or Win64 */
+  struct _stat64i32 st = {0};
+  if (_stat64i32(dirName, &st) == -1)
+    return _mkdir(dirName);
+#else
+  struct stat st = {0};
+  if (stat(dirName, &st) == -1)
+    return mkdir(dirName, 0755);
+#endif
+  return 0;
+}
+
+/* Copy the file src to des.
+   Return 0 if the file was copied.
+   Unlike copyBinaryFile(), this does not stop the simulation as the cache is optional. */
+static int copyCacheFile(const char* src, const char* des){
+  FILE* srcFil;
+  FILE* desFil;
+  size_t n;
+  unsigned char buff[8192];
+  int retVal = 0;
+
+  srcFil = fopen(src, "rb");
+  if (srcFil == NULL)
+    return 1;
+  desFil = fopen(des, "wb");
+  if (desFil == NULL){
+    fclose(srcFil);
+    return 1;
+  }
+
+  while ((n = fread(buff, 1, sizeof buff, srcFil)) > 0){
+    if (fwrite(buff, 1, n, desFil) != n){
+      retVal = 1;
+      break;
+    }
+  }
+  if (ferror(srcFil))
+    retVal = 1;
+
+  fclose(srcFil);
+  if (fclose(desFil) != 0)
+    retVal = 1;
+  if (retVal != 0)
+    deleteFile(des);
+  return retVal;
+}
+
+/* Create the lock file. This fails if the file exists, in which case
+   another simulation holds the lock.
+   Return true if the lock was created. */
+static bool createLock(const char* lockName){
+  char pid[32];
+  int fd;
+  long nWri;
+
+  sprintf(pid, "%ld\n", getProcessId());
+#ifdef _WIN32 /* Win32 or Win64 */
+  fd = _open(lockName, _O_WRONLY | _O_CREAT | _O_EXCL, _S_IREAD | _S_IWRITE);
+  if (fd == -1)
+    return false;
+  nWri = _write(fd, pid, (unsigned int)strlen(pid));
+  _close(fd);
+#else
+  fd = open(lockName, O_WRONLY | O_CREAT | O_EXCL, 0644);
+  if (fd == -1)
+    return false;
+  nWri = write(fd, pid, strlen(pid));
+  close(fd);
+#endif
+  if (nWri < 0){
+    deleteFile(lockName);
+    return false;
+  }
+  return true;
+}
+
+/* Return true if the lock file is older than SPAWN_FMU_CACHE_LOCK_TIMEOUT */
+static bool lockIsStale(const char* lockName){
+#ifdef _WIN32 /* Win32 or Win64 */
+  struct _stat64i32 st = {0};
+  if (_stat64i32(lockName, &st) == -1)
+    return false;
+#else
+  struct stat st = {0};
+  if (stat(lockName, &st) == -1)
+    return false;
+#endif
+  return difftime(time(NULL), st.st_mtime) > SPAWN_FMU_CACHE_LOCK_TIMEOUT;
+}
+
+static void waitForLock(){
+#ifdef _WIN32 /* Win32 or Win64 */
+  Sleep(1000);
+#else
+  sleep(1);
+#endif
+}
+
+/* Set bui->fmuCacheFile if the environment variable SPAWNCACHE is set.
+   Return true if the cache is used. */
+static bool setFMUCacheFile(FMUBuilding* bui){
+  const char* cacheDir;
+  const char* idfHash;
+  const char* epwHash;
+  const char* key;
+  char* keyString;
+  size_t len;
+
+  void (*SpawnFormatMessage)(const char *string, ...) = bui->SpawnFormatMessage;
+  void (*SpawnFormatError)(const char *string, ...) = bui->SpawnFormatError;
+
+  cacheDir = getenv("SPAWNCACHE");
+  if (cacheDir == NULL || strlen(cacheDir) == 0)
+    return false;
+
+  if (createCacheDirectory(cacheDir) != 0){
+    if (bui->logLevel >= WARNINGS)
+      SpawnFormatMessage("%.3f %s: Warning: Failed to create FMU cache directory '%s': %s. The FMU will not be cached.\n",
+        bui->time, bui->modelicaNameBuilding, cacheDir, strerror(errno));
+    return false;
+  }
+
+  /* The key contains everything that spawn uses to generate the FMU,
+     except the name of the FMU which is excluded from modelHash */
+  idfHash = cryptographicsHashFile(bui->idfName, SpawnFormatError);
+  epwHash = cryptographicsHashFile(bui->weather, SpawnFormatError);
+
+  len = strlen(bui->modelHash) + strlen(idfHash) + strlen(epwHash)
+    + strlen(bui->spawnExe) + strlen(bui->idfVersion) + 5;
+  mallocString(len, "Failed to allocate memory for the key of the FMU cache.", &keyString, SpawnFormatError);
+  memset(keyString, '\0', len);
+  strcpy(keyString, bui->modelHash);
+  strcat(keyString, " ");
+  strcat(keyString, idfHash);
+  strcat(keyString, " ");
+  strcat(keyString, epwHash);
+  strcat(keyString, " ");
+  strcat(keyString, bui->spawnExe);
+  strcat(keyString, " ");
+  strcat(keyString, bui->idfVersion);
+
+  key = cryptographicsHash(keyString, bui->SpawnError);
+  bui->fmuCacheFile = getCacheFileName(cacheDir, key, ".fmu", SpawnFormatError);
+
+  free((char*)idfHash);
+  free((char*)epwHash);
+  free((char*)key);
+  free(keyString);
+
+  if (bui->logLevel >= MEDIUM)
+    SpawnFormatMessage("%.3f %s: Using FMU cache file '%s'.\n",
+      bui->time, bui->modelicaNameBuilding, bui->fmuCacheFile);
+  return true;
+}
+
+/* Disable the cache for this building after an error */
+static void disableFMUCache(FMUBuilding* bui, const char* reason){
+  if (bui->logLevel >= WARNINGS)
+    bui->SpawnFormatMessage("%.3f %s: Warning: %s '%s': %s. The FMU will be generated without the cache.\n",
+      bui->time, bui->modelicaNameBuilding, reason, bui->fmuCacheFile, strerror(errno));
+  free(bui->fmuCacheFile);
+  bui->fmuCacheFile = NULL;
+}
+
+bool getFMUFromCache(FMUBuilding* bui){
+  char* lockName;
+  bool waiting = false;
+  const size_t lenExt = strlen(".fmu");
+
+  void (*SpawnFormatMessage)(const char *string, ...) = bui->SpawnFormatMessage;
+  void (*SpawnFormatError)(const char *string, ...) = bui->SpawnFormatError;
+
+  if (!setFMUCacheFile(bui))
+    return false;
+
+  /* Replace .fmu with .lock */
+  mallocString(strlen(bui->fmuCacheFile) - lenExt + strlen(".lock") + 1,
+    "Failed to allocate memory for the name of the lock of the FMU cache.", &lockName, SpawnFormatError);
+  memset(lockName, '\0', strlen(bui->fmuCacheFile) - lenExt + strlen(".lock") + 1);
+  memcpy(lockName, bui->fmuCacheFile, strlen(bui->fmuCacheFile) - lenExt);
+  strcat(lockName, ".lock");
+
+  for(;;){
+    if (access(bui->fmuCacheFile, F_OK) == 0){
+      /* The FMU has been generated by this or another simulation */
+      if (copyCacheFile(bui->fmuCacheFile, bui->fmuAbsPat) != 0){
+        free(lockName);
+        disableFMUCache(bui, "Failed to copy the FMU from the cache");
+        return false;
+      }
+      free(lockName);
+      return true;
+    }
+
+    if (createLock(lockName)){
+      /* Another simulation may have stored the FMU and released the lock after the above check */
+      if (access(bui->fmuCacheFile, F_OK) == 0){
+        deleteFile(lockName);
+        continue;
+      }
+      if (bui->logLevel >= MEDIUM)
+        SpawnFormatMessage("%.3f %s: FMU is not in the cache, generating it while holding lock '%s'.\n",
+          bui->time, bui->modelicaNameBuilding, lockName);
+      bui->fmuCacheLock = lockName;
+      return false;
+    }
+
+    if (errno != EEXIST){
+      free(lockName);
+      disableFMUCache(bui, "Failed to create the lock of the FMU cache file");
+      return false;
+    }
+
+    /* Another simulation generates the same FMU */
+    if (lockIsStale(lockName)){
+      if (bui->logLevel >= WARNINGS)
+        SpawnFormatMessage("%.3f %s: Warning: Removing lock '%s' which is older than %d seconds.\n",
+          bui->time, bui->modelicaNameBuilding, lockName, SPAWN_FMU_CACHE_LOCK_TIMEOUT);
+      deleteFile(lockName);
+      continue;
+    }
+    if (!waiting && bui->logLevel >= QUIET)
+      SpawnFormatMessage("%.3f %s: Waiting for another simulation to store the FMU %s in the cache.\n",
+        bui->time, bui->modelicaNameBuilding, bui->fmuCacheFile);
+    waiting = true;
+    waitForLock();
+  }
+}
+
+void storeFMUInCache(FMUBuilding* bui){
+  char* tmpName;
+  char pid[32];
+  size_t len;
+
+  if (bui->fmuCacheLock == NULL)
+    return;
+
+  /* Copy the FMU to a temporary file and rename it, so that no other simulation reads an incomplete FMU */
+  sprintf(pid, ".%ld", getProcessId());
+  len = strlen(bui->fmuCacheFile) + strlen(pid) + 1;
+  mallocString(len, "Failed to allocate memory for the name of a file in the FMU cache.", &tmpName, bui->SpawnFormatError);
+  memset(tmpName, '\0', len);
+  strcpy(tmpName, bui->fmuCacheFile);
+  strcat(tmpName, pid);
+
+  if (copyCacheFile(bui->fmuAbsPat, tmpName) != 0 || rename(tmpName, bui->fmuCacheFile) != 0){
+    if (bui->logLevel >= WARNINGS)
+      bui->SpawnFormatMessage("%.3f %s: Warning: Failed to store the FMU in the cache file '%s': %s.\n",
+        bui->time, bui->modelicaNameBuilding, bui->fmuCacheFile, strerror(errno));
+    deleteFile(tmpName);
+  }
+  else if (bui->logLevel >= MEDIUM)
+    bui->SpawnFormatMessage("%.3f %s: Stored FMU %s in the cache as %s.\n",
+      bui->time, bui->modelicaNameBuilding, bui->fmuAbsPat, bui->fmuCacheFile);
+
+  free(tmpName);
+  releaseFMUCacheLock(bui);
+}
+
+void releaseFMUCacheLock(FMUBuilding* bui){
+  if (bui->fmuCacheLock == NULL)
+    return;
+  deleteFile(bui->fmuCacheLock);
+  free(bui->fmuCacheLock);
+  bui->fmuCacheLock = NULL;
+}
+
+#endif
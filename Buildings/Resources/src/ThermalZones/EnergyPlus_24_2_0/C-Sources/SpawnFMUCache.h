@@ -0,0 +1,34 @@
+/*
+ * Cache of the EnergyPlus FMUs that is shared by simulations.
+ *
+ * If the environment variable SPAWNCACHE is set to a directory, each FMU
+ * generated by spawn is stored in this directory, and later simulations of
+ * the same building load it from there rather than generating it again.
+ * The FMU is stored as SPAWNCACHE/<key>.fmu, where <key> is the SHA-1 hash of
+ * the model hash, the content of the idf and epw files, and the name of the
+ * spawn executable, which contains its version.
+ * While a simulation generates an FMU, it holds the lock file
+ * SPAWNCACHE/<key>.lock. Other simulations that need the same FMU wait until
+ * it is stored.
+ */
+#ifndef Buildings_SpawnFMUCache_h
+#define Buildings_SpawnFMUCache_h
+
+#include "SpawnTypes.h"
+
+/* Time in seconds after which a lock is considered to be left over from a simulation that stopped */
+#define SPAWN_FMU_CACHE_LOCK_TIMEOUT 1800
+
+/* Copy the FMU from the cache to bui->fmuAbsPat.
+   Return true if the FMU was copied. If false is returned and bui->fmuCacheLock
+   is not NULL, then this building holds the lock and must generate the FMU
+   and call storeFMUInCache(). */
+bool getFMUFromCache(FMUBuilding* bui);
+
+/* Store the FMU bui->fmuAbsPat in the cache and release the lock */
+void storeFMUInCache(FMUBuilding* bui);
+
+/* Release the lock of the cache if it is held by this building */
+void releaseFMUCacheLock(FMUBuilding* bui);
+
+#endif
@@ -31,6 +31,7 @@ void initializeDerivativeStructure(
       (*r)->structure[i][1] = (size_t)(derivatives_structure[2*i+1]) - 1;
       (*r)->delta[i] = derivatives_delta[i];
       (*r)->vals[i] = 0;
+      (*r)->uVals[i] = 0;
     }
   }
 
@@ -189,6 +190,10 @@ void* allocate_Spawn_EnergyPlus_24_2_0(
 
   ptrSpaObj->valueReferenceIsSet = fmi2False;
 
+  /* Outputs are not yet exchanged */
+  ptrSpaObj->iOut = 0;
+  ptrSpaObj->exchangeVersion = 0;
+
   /* Assign the object type */
   ptrSpaObj->objectType = objectType;
 
@@ -24,6 +24,116 @@ bool areAllSpawnObjectsInitialized(FMUBuilding* bui){
   return true;
 }
 
+/* Return true if the inputs u are the same as the inputs of the last exchange.
+   If the object was exchanged before, these inputs are set in the FMU. */
+static bool inputsAreUnchanged(const SpawnObject* ptrSpaObj, const double* u){
+  size_t iU;
+  if (! ptrSpaObj->isInitialized)
+    return false;
+  for(iU = 0; iU < ptrSpaObj->inputs->n; iU++){
+    if (ptrSpaObj->inputs->valsSI[iU] != u[iU])
+      return false;
+  }
+  return true;
+}
+
+/* Return true if the derivatives can be reused because no input u_j changed
+   by more than the step delta since they were computed.
+   As the state of EnergyPlus changes at the next event time, the derivatives are
+   only reused before the next event time that was requested when they were computed.
+   The derivatives are never reused by the method finiteDifference. */
+static bool derivativesCanBeReused(const FMUBuilding* bui, const SpawnObject* ptrSpaObj, const double* u){
+  size_t iDer;
+  const spawnDerivatives* der = ptrSpaObj->derivatives;
+
+  if (bui->derivativeMethod == finiteDifference || !der->valsAreSet || bui->time >= der->tMax)
+    return false;
+  for(iDer = 0; iDer < der->n; iDer++){
+    if (fabs(u[der->structure[iDer][1]] - der->uVals[iDer]) > fabs(der->delta[iDer]))
+      return false;
+  }
+  return true;
+}
+
+/* Set the inputs u + du_j and store y_i(u + du_j) in the derivatives.
+   With bulkFiniteDifference, each input is perturbed only once for all derivatives
+   with respect to this input that use the same step. */
+static void perturbInputs(FMUBuilding* bui, SpawnObject* ptrSpaObj, const double* u){
+  size_t iDer;
+  size_t jDer;
+  size_t iU;
+  spawnDerivatives* der = ptrSpaObj->derivatives;
+  const bool bulk = (bui->derivativeMethod == bulkFiniteDifference);
+
+  for(iDer = 0; iDer < der->n; iDer++){
+    iU = der->structure[iDer][1];
+    if (bulk){
+      /* Skip if y(u + du_j) has been stored when evaluating an earlier derivative */
+      for(jDer = 0; jDer < iDer; jDer++){
+        if (der->structure[jDer][1] == iU && der->delta[jDer] == der->delta[iDer])
+          break;
+      }
+      if (jDer < iDer)
+        continue;
+    }
+    /* Change value of iU-th input to the FMU, using forward difference */
+    ptrSpaObj->inputs->valsSI[iU] = u[iU] + der->delta[iDer];
+    /* Evaluate y(u + du_j) */
+    setVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->inputs);
+    getVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->outputs);
+    /* Store value of y_i(u + du_j). This is not yet the derivative! */
+    for(jDer = iDer; jDer < (bulk ? der->n : iDer + 1); jDer++){
+      if (der->structure[jDer][1] == iU && der->delta[jDer] == der->delta[iDer])
+        der->vals[jDer] = ptrSpaObj->outputs->valsSI[der->structure[jDer][0]];
+    }
+    /* Reset the input to the non-perturbed value */
+    ptrSpaObj->inputs->valsSI[iU] = u[iU];
+  }
+}
+
+/* Get the derivatives from the FMU using fmi2GetDirectionalDerivative */
+static void getDirectionalDerivatives(FMUBuilding* bui, SpawnObject* ptrSpaObj){
+  size_t iDer;
+  size_t iY;
+  size_t iU;
+  fmi2_status_t status;
+  fmi2_value_reference_t vRef;
+  fmi2_value_reference_t zRef;
+  const fmi2_real_t dv = 1.0;
+  fmi2_real_t dz;
+  spawnDerivatives* der = ptrSpaObj->derivatives;
+
+  for(iDer = 0; iDer < der->n; iDer++){
+    iY = der->structure[iDer][0];
+    iU = der->structure[iDer][1];
+    vRef = ptrSpaObj->inputs->valRefs[iU];
+    zRef = ptrSpaObj->outputs->valRefs[iY];
+    status = fmi2_import_get_directional_derivative(bui->fmu, &vRef, 1, &zRef, 1, &dv, &dz);
+    if (status != fmi2_status_ok){
+      bui->SpawnFormatError("Failed to get directional derivative for %s during mode = %s.\n",
+        ptrSpaObj->modelicaName, fmuModeToString(bui->mode));
+    }
+    /* Convert to SI units. The offsets of the units do not affect the derivative */
+    der->vals[iDer] = dz * ptrSpaObj->outputs->scale[iY] / ptrSpaObj->inputs->scale[iU];
+  }
+}
+
+/* Assign the outputs, the derivatives and the next event time to y */
+static void assignExchangeOutputs(const SpawnObject* ptrSpaObj, double tNext, double* y){
+  size_t iY;
+  size_t iDer;
+  const size_t nOut = ptrSpaObj->outputs->n;
+  const size_t nDer = ptrSpaObj->derivatives->n;
+
+  for(iY = 0; iY < nOut; iY++){
+    y[iY] = ptrSpaObj->outputs->valsSI[iY];
+  }
+  for(iDer = 0; iDer < nDer; iDer++){
+    y[nOut + iDer] = ptrSpaObj->derivatives->vals[iDer];
+  }
+  y[nOut+nDer] = tNext;
+}
+
 
 /* Exchange data between Modelica and EnergyPlus during time stepping
 */
@@ -37,6 +147,9 @@ void exchange_Spawn_EnergyPlus_24_2_0(
   FMUBuilding* bui = ptrSpaObj->bui;
 
   fmi2Status status;
+  bool inputsUnchanged;
+  bool computeDerivatives;
+  bool perturbed;
 
   size_t iU;
   size_t iY;
@@ -106,29 +219,52 @@ void exchange_Spawn_EnergyPlus_24_2_0(
     advanceTime_completeIntegratorStep_enterEventMode(bui, ptrSpaObj->modelicaName, time);
   }
 
+  /* In the initial call, the inputs have not yet been set in the FMU */
+  inputsUnchanged = (!initialCall) && inputsAreUnchanged(ptrSpaObj, u);
+
+  /* If neither the inputs nor the state of the FMU changed since the outputs were
+     obtained, which is the case for repeated calls at the same time,
+     return them without calling the FMU */
+  if (bui->mode == eventMode && inputsUnchanged
+    && bui->tNextVersion == bui->exchangeVersion){
+    if (ptrSpaObj->exchangeVersion == bui->exchangeVersion){
+      if (bui->logLevel >= TIMESTEP)
+        SpawnFormatMessage("%.3f %s: Returning outputs of last exchange as inputs and FMU state are unchanged.\n", bui->time, ptrSpaObj->modelicaName);
+      assignExchangeOutputs(ptrSpaObj, bui->tNext, y);
+      return;
+    }
+    /* Another object obtained the outputs of all objects for this state of the FMU.
+       Objects with derivatives are excluded as their derivatives must be recomputed. */
+    if (nDer == 0 && bui->valsOutVersion == bui->exchangeVersion){
+      if (bui->logLevel >= TIMESTEP)
+        SpawnFormatMessage("%.3f %s: Returning outputs obtained for all objects as inputs and FMU state are unchanged.\n", bui->time, ptrSpaObj->modelicaName);
+      getBuildingOutputs(bui, ptrSpaObj);
+      ptrSpaObj->exchangeVersion = bui->exchangeVersion;
+      assignExchangeOutputs(ptrSpaObj, bui->tNext, y);
+      return;
+    }
+  }
+  /* The outputs of this object become valid again once they are obtained below */
+  ptrSpaObj->exchangeVersion = 0;
+
  /* Set inputs */
   for(iU = 0; iU < nInp; iU++){
     ptrSpaObj->inputs->valsSI[iU] = u[iU];
   }
 
   /* Compute derivatives dy_i/du_j */
-  for(iDer = 0; iDer < nDer; iDer++){
-    iY = ptrSpaObj->derivatives->structure[iDer][0];
-    iU = ptrSpaObj->derivatives->structure[iDer][1];
-    /* Change value of iU-th input to the FMU, using forward difference */
-    ptrSpaObj->inputs->valsSI[iU] = u[iU] + ptrSpaObj->derivatives->delta[iDer];
-    /* Evaluate y(u + du_j) */
-    setVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->inputs);
-    getVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->outputs);
-    /* Store value of y_i(u + du_j). This is not yet the derivative! */
-    ptrSpaObj->derivatives->vals[iDer] = ptrSpaObj->outputs->valsSI[iY];
-    /* Reset the input to the non-perturbed value */
-    ptrSpaObj->inputs->valsSI[iU] = u[iU];
-  }
+  computeDerivatives = (nDer > 0) && !derivativesCanBeReused(bui, ptrSpaObj, u);
+  perturbed = computeDerivatives && bui->derivativeMethod != directionalDerivative;
+  if (perturbed)
+    perturbInputs(bui, ptrSpaObj, u);
 
   // Evaluate the FMU for the non-perturbed output */
-  setVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->inputs);
+  /* If the inputs are already set in the FMU, setting them again would only invalidate the outputs of all objects */
+  if (perturbed || !inputsUnchanged)
+    setVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->inputs);
   getVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->outputs);
+  if (computeDerivatives && bui->derivativeMethod == directionalDerivative)
+    getDirectionalDerivatives(bui, ptrSpaObj);
 
   /* Get next event time, unless FMU is in initialization mode */
   if (bui->mode == initializationMode){
@@ -146,21 +282,34 @@ void exchange_Spawn_EnergyPlus_24_2_0(
        discrete output before the time event, and not after.
        To test, run SingleZone.mo in EnergyPlus/src
     */
-    getVariables(bui, ptrSpaObj->modelicaName, ptrSpaObj->outputs);
+    /* The outputs of all objects are obtained with one call, and they are
+       reused by objects whose inputs are unchanged at this time */
+    getBuildingOutputs(bui, ptrSpaObj);
+    bui->tNext = y[nOut+nDer];
+    bui->tNextVersion = bui->exchangeVersion;
+    ptrSpaObj->exchangeVersion = bui->exchangeVersion;
   }
 
-  /* Assign output values */
-  for(iY = 0; iY < nOut; iY++){
-    y[iY] = ptrSpaObj->outputs->valsSI[iY];
-  }
   /* Compute the derivative values */
-  for(iDer = 0; iDer < nDer; iDer++){
-    iY = ptrSpaObj->derivatives->structure[iDer][0];
-    ptrSpaObj->derivatives->vals[iDer] -= ptrSpaObj->outputs->valsSI[iY];
-    ptrSpaObj->derivatives->vals[iDer] /= ptrSpaObj->derivatives->delta[iDer];
-    /* Assign value to output array */
-    y[nOut + iDer] = ptrSpaObj->derivatives->vals[iDer];
+  if (perturbed){
+    for(iDer = 0; iDer < nDer; iDer++){
+      iY = ptrSpaObj->derivatives->structure[iDer][0];
+      ptrSpaObj->derivatives->vals[iDer] -= ptrSpaObj->outputs->valsSI[iY];
+      ptrSpaObj->derivatives->vals[iDer] /= ptrSpaObj->derivatives->delta[iDer];
+    }
+  }
+  if (computeDerivatives){
+    for(iDer = 0; iDer < nDer; iDer++){
+      ptrSpaObj->derivatives->uVals[iDer] = u[ptrSpaObj->derivatives->structure[iDer][1]];
+    }
+    ptrSpaObj->derivatives->valsAreSet = true;
+    ptrSpaObj->derivatives->tMax = y[nOut+nDer];
   }
+  else if (nDer > 0 && bui->logLevel >= TIMESTEP)
+    SpawnFormatMessage("%.3f %s: Reusing derivatives as inputs changed by less than the step used to compute them.\n",
+      bui->time, ptrSpaObj->modelicaName);
+  /* Assign output values */
+  assignExchangeOutputs(ptrSpaObj, y[nOut+nDer], y);
 
   return;
 }
@@ -7,6 +7,7 @@
 
 #include "SpawnObjectFree.h"
 #include "SpawnFMU.h"
+#include "SpawnUtil.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
@@ -59,6 +60,12 @@ void free_Spawn_EnergyPlus_24_2_0(void* object){
       /* Free the building if no more SpawnObjects reference it */
       FMUBuildingFree(ptrBui);
 
+      /* Free the values, units and unit conversions of the SpawnObject */
+      freeSpawnReals(ptrSpaObj->parameters);
+      freeSpawnReals(ptrSpaObj->inputs);
+      freeSpawnReals(ptrSpaObj->outputs);
+      freeSpawnDerivatives(ptrSpaObj->derivatives);
+
       /* Free the SpawnObject itself */
       free(ptrSpaObj);
     }
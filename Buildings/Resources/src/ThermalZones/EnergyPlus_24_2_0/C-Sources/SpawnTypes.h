@@ -63,6 +63,9 @@ to not export all symbols but only the needed ones */
 
 typedef enum {instantiationMode, initializationMode, eventMode, continuousTimeMode, terminatedMode} FMUMode;
 
+/* Method used to compute the derivatives, selected with the environment variable SPAWNDERIVATIVES */
+typedef enum {finiteDifference, bulkFiniteDifference, directionalDerivative} DerivativeMethod;
+
 enum logLevels {ERRORS = 1, WARNINGS = 2, QUIET = 3, MEDIUM = 4, TIMESTEP = 5};
 enum objectTypes {THERMALZONE = 1, SCHEDULE = 2, ACTUATOR = 3, OUTPUT = 4, SURFACE = 5, DETAILEDSURFACE = 6};
 
@@ -96,11 +99,22 @@ typedef struct FMUBuilding
   bool usePrecompiledFMU; /* if true, a pre-compiled FMU will be used (for debugging) */
   char* precompiledFMUAbsPat; /* Name of pre-compiled FMU (if usePrecompiledFMU = true, otherwise set the NULL) */
   char* modelHash; /* Hash code of the model definition used to create the FMU (except the FMU path) */
+  char* fmuCacheFile; /* Name of the FMU in the cache directory SPAWNCACHE, or NULL if the cache is not used */
+  char* fmuCacheLock; /* Name of the lock file of fmuCacheFile while this building generates the FMU, otherwise NULL */
   fmi2Boolean dllfmu_created; /* Flag to indicate if dll fmu functions were successfully created */
   fmi2Real time; /* Time that is set in the building fmu */
   FMUMode mode; /* Mode that the FMU is in */
   size_t iFMU; /* Number of this FMU */
 
+  size_t nOutAll; /* Number of outputs of all exchange objects */
+  fmi2ValueReference* valRefsOut; /* Value references of the outputs of all exchange objects */
+  fmi2Real* valsOutEP; /* Outputs of all exchange objects as received from EnergyPlus */
+  unsigned long valsOutVersion; /* Value of exchangeVersion for which valsOutEP is valid, or 0 */
+  unsigned long exchangeVersion; /* Incremented whenever inputs are set or the FMU mode changes */
+  fmi2Real tNext; /* Next event time returned by the last event iteration */
+  unsigned long tNextVersion; /* Value of exchangeVersion for which tNext is valid */
+  DerivativeMethod derivativeMethod; /* Method used to compute the derivatives */
+
   int logLevel; /* Log level */
   void (*SpawnMessage)(const char *string);
   void (*SpawnError)(const char *string);
@@ -115,6 +129,9 @@ typedef struct spawnReals{
   fmi2Real* valsEP; /* Values as used by EnergyPlus */
   fmi2Real* valsSI; /* vals in SI units as used by Modelica */
   fmi2_import_unit_t** units; /* Unit type, or NULL if not specified */
+  fmi2Real* scale;  /* Factor of the conversion valsSI = scale * valsEP + offset */
+  fmi2Real* offset; /* Offset of the conversion valsSI = scale * valsEP + offset */
+  bool isIdentity;  /* Flag, true if no value needs to be converted to SI units */
   char** unitsModelica;        /* Unit specified in the Modelica model */
   fmi2ValueReference* valRefs; /* Value references */
   fmi2Byte** fmiNames; /* Full names, as listed in modelDescripton.xml file */
@@ -127,6 +144,9 @@ typedef struct spawnDerivatives{
   size_t** structure; /* 2-d array with list of derivatives (0-based index, [i,j] means dy_i/du_j */
   fmi2Real* delta; /* Step used to compute the derivatives */
   fmi2Real* vals;  /* Values of the derivatives */
+  fmi2Real* uVals; /* Value of the input u_j for which vals was computed */
+  bool valsAreSet; /* Flag, set to true after vals has been computed */
+  fmi2Real tMax;   /* Time until which vals can be reused, which is the next event time when vals was computed */
 } spawnDerivatives;
 
 
@@ -156,6 +176,9 @@ typedef struct SpawnObject
   bool valueReferenceIsSet;         /* Flag, set to true after value references are set,
                                        and used to check for Dymola 2020x whether the flag 'Hidden.AvoidDoubleComputation=true' is set */
 
+  size_t iOut;                      /* Index of the first output of this object in bui->valsOutEP */
+  unsigned long exchangeVersion;    /* Value of bui->exchangeVersion for which outputs and derivatives are valid, or 0 */
+
 } SpawnObject;
 
 #endif
@@ -38,6 +38,9 @@ void mallocSpawnReals(const size_t n, spawnReals** r, void (*SpawnFormatError)(c
   (*r)->valsEP = NULL;
   (*r)->valsSI = NULL;
   (*r)->units = NULL;
+  (*r)->scale = NULL;
+  (*r)->offset = NULL;
+  (*r)->isIdentity = true;
   (*r)->unitsModelica = NULL;
   (*r)->valRefs = NULL;
   (*r)->fmiNames = NULL;
@@ -56,6 +59,12 @@ void mallocSpawnReals(const size_t n, spawnReals** r, void (*SpawnFormatError)(c
 
     if ((*r)->units == NULL)
       SpawnFormatError("%s", "Failed to allocate memory for (*r)->units in EnergyPlus.c");
+    (*r)->scale = (fmi2Real*)malloc(n * sizeof(fmi2Real));
+    if ((*r)->scale == NULL)
+      SpawnFormatError("%s", "Failed to allocate memory for (*r)->scale in EnergyPlus.c");
+    (*r)->offset = (fmi2Real*)malloc(n * sizeof(fmi2Real));
+    if ((*r)->offset == NULL)
+      SpawnFormatError("%s", "Failed to allocate memory for (*r)->offset in EnergyPlus.c");
     (*r)->unitsModelica = (char**)malloc(n * sizeof(char*));
 
     if ((*r)->unitsModelica == NULL)
@@ -63,18 +72,44 @@ void mallocSpawnReals(const size_t n, spawnReals** r, void (*SpawnFormatError)(c
 
     for(i = 0; i < n; i++){
       (*r)->unitsModelica[i] = NULL;
+      (*r)->scale[i] = 1;
+      (*r)->offset[i] = 0;
     }
 
     (*r)->valRefs = (fmi2ValueReference*)malloc(n * sizeof(fmi2ValueReference));
     if ((*r)->valRefs == NULL)
       SpawnFormatError("%s", "Failed to allocate memory for (*r)->valRefs in EnergyPlus.c");
 
-    (*r)->fmiNames = (fmi2Byte**)malloc(n * sizeof(fmi2Byte*));
-    if ((*r)->fmiNames == NULL)
-        SpawnFormatError("%s", "Failed to allocate memory for (*r)->fmiNames in EnergyPlus.c");
+    /* (*r)->fmiNames is allocated by buildVariableNames */
   }
 }
 
+void freeSpawnReals(spawnReals* r){
+  size_t i;
+
+  if (r == NULL)
+    return;
+
+  free(r->valsEP);
+  free(r->valsSI);
+  /* The units are owned by fmilib, hence only the array is freed */
+  free(r->units);
+  free(r->scale);
+  free(r->offset);
+  if (r->unitsModelica != NULL){
+    for(i = 0; i < r->n; i++)
+      free(r->unitsModelica[i]);
+    free(r->unitsModelica);
+  }
+  free(r->valRefs);
+  if (r->fmiNames != NULL){
+    for(i = 0; i < r->n; i++)
+      free(r->fmiNames[i]);
+    free(r->fmiNames);
+  }
+  free(r);
+}
+
 void mallocSpawnDerivatives(const size_t n, spawnDerivatives** r, void (*SpawnFormatError)(const char *string, ...)){
 
   size_t i;
@@ -87,6 +122,9 @@ void mallocSpawnDerivatives(const size_t n, spawnDerivatives** r, void (*SpawnFo
   (*r)->structure = NULL;
   (*r)->delta = NULL;
   (*r)->vals = NULL;
+  (*r)->uVals = NULL;
+  (*r)->valsAreSet = false;
+  (*r)->tMax = 0;
 
   /* If there are no derivatives, then len = 0, but we still need derivatives->n = 0 to be set */
   (*r)->n = n;
@@ -108,7 +146,28 @@ void mallocSpawnDerivatives(const size_t n, spawnDerivatives** r, void (*SpawnFo
     (*r)->vals = (fmi2Real*)malloc(n * sizeof(fmi2Real));
     if ((*r)->vals == NULL)
       SpawnFormatError("%s", "Failed to allocate memory for (*r)->vals in EnergyPlus.c");
+
+    (*r)->uVals = (fmi2Real*)malloc(n * sizeof(fmi2Real));
+    if ((*r)->uVals == NULL)
+      SpawnFormatError("%s", "Failed to allocate memory for (*r)->uVals in EnergyPlus.c");
+  }
+}
+
+void freeSpawnDerivatives(spawnDerivatives* r){
+  size_t i;
+
+  if (r == NULL)
+    return;
+
+  if (r->structure != NULL){
+    for(i = 0; i < r->n; i++)
+      free(r->structure[i]);
+    free(r->structure);
   }
+  free(r->delta);
+  free(r->vals);
+  free(r->uVals);
+  free(r);
 }
 
 char* fmuModeToString(FMUMode mode){
@@ -133,11 +192,16 @@ void setVariables(
   size_t i;
   fmi2_status_t status;
 
-  for(i = 0; i < ptrReals->n; i++){
-    if (ptrReals->units[i]) /* Units are defined */
-      ptrReals->valsEP[i] = fmi2_import_convert_from_SI_base_unit(ptrReals->valsSI[i], ptrReals->units[i]);
-    else
+  /* Convert from SI units, using the same operations as fmi2_import_convert_from_SI_base_unit */
+  if (ptrReals->isIdentity){
+    for(i = 0; i < ptrReals->n; i++){
       ptrReals->valsEP[i] = ptrReals->valsSI[i];
+    }
+  }
+  else{
+    for(i = 0; i < ptrReals->n; i++){
+      ptrReals->valsEP[i] = (ptrReals->valsSI[i] - ptrReals->offset[i]) / ptrReals->scale[i];
+    }
   }
 
   /* If debug mode, write exchanged values to log file */
@@ -159,6 +223,8 @@ void setVariables(
   if (status != (fmi2_status_t)fmi2OK) {
     bui->SpawnFormatError("Failed to set variables for %s in FMU.\n",  modelicaInstanceName);
   }
+  /* Outputs that were obtained before are no longer valid */
+  bui->exchangeVersion++;
 }
 
 void stopIfResultsAreNaN(FMUBuilding* bui, const char* modelicaInstanceName, spawnReals* ptrReals){
@@ -181,7 +247,7 @@ void stopIfResultsAreNaN(FMUBuilding* bui, const char* modelicaInstanceName, spa
       fmiVar = fmi2_import_get_variable_by_vr(bui->fmu, fmi2_base_type_real, ptrReals->valRefs[i]);
       varNam = fmi2_import_get_variable_name(fmiVar);
       if (isnan(ptrReals->valsSI[i])){
-        SpawnFormatMessage("%.3f %s: Received nan from EnergyPlus for %s at time = %.2f:\n", bui->time, modelicaInstanceName, bui->time);
+        SpawnFormatMessage("%.3f %s: Received nan from EnergyPlus for %s at time = %.2f:\n", bui->time, modelicaInstanceName, varNam, bui->time);
       }
       SpawnFormatMessage("%.3f %s:   %s = %.2f\n", bui->time, modelicaInstanceName, varNam, ptrReals->valsSI[i]);
     }
@@ -191,9 +257,47 @@ void stopIfResultsAreNaN(FMUBuilding* bui, const char* modelicaInstanceName, spa
   }
 }
 
-void getVariables(FMUBuilding* bui, const char* modelicaInstanceName, spawnReals* ptrReals)
+/* Convert the values received from EnergyPlus to SI units and stop if they are nan */
+static void setSIValues(FMUBuilding* bui, const char* modelicaInstanceName, spawnReals* ptrReals)
 {
   size_t i;
+  int hasNaN = 0;
+
+  /* Set SI unit value, using the same operations as fmi2_import_convert_to_SI_base_unit,
+     and check for nan in the same pass */
+  if (ptrReals->isIdentity){
+    for(i = 0; i < ptrReals->n; i++){
+      ptrReals->valsSI[i] = ptrReals->valsEP[i];
+      hasNaN |= isnan(ptrReals->valsSI[i]);
+    }
+  }
+  else{
+    for(i = 0; i < ptrReals->n; i++){
+      ptrReals->valsSI[i] = ptrReals->valsEP[i] * ptrReals->scale[i] + ptrReals->offset[i];
+      hasNaN |= isnan(ptrReals->valsSI[i]);
+    }
+  }
+  /* If debug mode, write exchanged values to log file */
+  if (bui->logLevel >= TIMESTEP){
+    for(i = 0; i < ptrReals->n; i++){
+      if (ptrReals->units[i]){ /* Units are defined */
+        bui->SpawnFormatMessage("%.3f %s: Received from EnergyPlus, %s = %.6g [%s].\n",
+          bui->time, modelicaInstanceName, ptrReals->fmiNames[i], ptrReals->valsEP[i],
+          fmi2_import_get_unit_name(ptrReals->units[i]));
+      }
+      else{
+        bui->SpawnFormatMessage("%.3f %s: Received from EnergyPlus, %s = %.6g (no units declared).\n",
+          bui->time, modelicaInstanceName, ptrReals->fmiNames[i], ptrReals->valsEP[i]);
+      }
+    }
+  }
+
+  if (hasNaN)
+    stopIfResultsAreNaN(bui, modelicaInstanceName, ptrReals);
+}
+
+void getVariables(FMUBuilding* bui, const char* modelicaInstanceName, spawnReals* ptrReals)
+{
   fmi2_status_t status;
 
   if (bui->logLevel >= TIMESTEP)
@@ -212,29 +316,67 @@ void getVariables(FMUBuilding* bui, const char* modelicaInstanceName, spawnReals
       modelicaInstanceName, fmuModeToString(bui->mode));
     }
   }
-  /* Set SI unit value */
-  for(i = 0; i < ptrReals->n; i++){
-    if (ptrReals->units[i]) /* Units are defined */
-      ptrReals->valsSI[i] = fmi2_import_convert_to_SI_base_unit(ptrReals->valsEP[i], ptrReals->units[i]);
-    else
-      ptrReals->valsSI[i] = ptrReals->valsEP[i];
+  setSIValues(bui, modelicaInstanceName, ptrReals);
+}
+
+/* Allocate the outputs of all exchange objects of the building,
+   so that they can be obtained with one call to the FMU */
+void mallocBuildingOutputs(FMUBuilding* bui){
+  size_t i;
+  size_t iOut;
+  SpawnObject* ptrSpaObj;
+
+  bui->nOutAll = 0;
+  for(i = 0; i < bui->nExcObj; i++){
+    ptrSpaObj = (SpawnObject*) bui->exchange[i];
+    ptrSpaObj->iOut = bui->nOutAll;
+    bui->nOutAll += ptrSpaObj->outputs->n;
   }
-  /* If debug mode, write exchanged values to log file */
-  if (bui->logLevel >= TIMESTEP){
-    for(i = 0; i < ptrReals->n; i++){
-      if (ptrReals->units[i]){ /* Units are defined */
-        bui->SpawnFormatMessage("%.3f %s: Received from EnergyPlus, %s = %.6g [%s].\n",
-          bui->time, modelicaInstanceName, ptrReals->fmiNames[i], ptrReals->valsEP[i],
-          fmi2_import_get_unit_name(ptrReals->units[i]));
-      }
-      else{
-        bui->SpawnFormatMessage("%.3f %s: Received from EnergyPlus, %s = %.6g (no units declared).\n",
-          bui->time, modelicaInstanceName, ptrReals->fmiNames[i], ptrReals->valsEP[i]);
+  if (bui->nOutAll == 0)
+    return;
+
+  bui->valRefsOut = (fmi2ValueReference*)malloc(bui->nOutAll * sizeof(fmi2ValueReference));
+  if (bui->valRefsOut == NULL)
+    bui->SpawnFormatError("Failed to allocate memory for value references of outputs of %s.", bui->modelicaNameBuilding);
+  bui->valsOutEP = (fmi2Real*)malloc(bui->nOutAll * sizeof(fmi2Real));
+  if (bui->valsOutEP == NULL)
+    bui->SpawnFormatError("Failed to allocate memory for outputs of %s.", bui->modelicaNameBuilding);
+
+  for(i = 0; i < bui->nExcObj; i++){
+    ptrSpaObj = (SpawnObject*) bui->exchange[i];
+    for(iOut = 0; iOut < ptrSpaObj->outputs->n; iOut++){
+      bui->valRefsOut[ptrSpaObj->iOut + iOut] = ptrSpaObj->outputs->valRefs[iOut];
+    }
+  }
+}
+
+/* Get the outputs of ptrSpaObj from the outputs of all exchange objects.
+   The outputs of all objects are obtained with one call to the FMU,
+   which is only made again after the inputs or the mode of the FMU changed.
+   Each object then only converts its own outputs. */
+void getBuildingOutputs(FMUBuilding* bui, const SpawnObject* ptrSpaObj)
+{
+  fmi2_status_t status;
+
+  if (bui->valsOutVersion != bui->exchangeVersion){
+    if (bui->logLevel >= TIMESTEP)
+      bui->SpawnFormatMessage("%.3f %s: Getting outputs of all %lu objects from EnergyPlus, mode = %s.\n",
+        bui->time, ptrSpaObj->modelicaName, bui->nExcObj, fmuModeToString(bui->mode));
+
+    if (bui->nOutAll > 0){
+      status = fmi2_import_get_real(bui->fmu, bui->valRefsOut, bui->nOutAll, bui->valsOutEP);
+      if (status != (fmi2_status_t)fmi2OK) {
+        bui->SpawnFormatError("Failed to get variables for %s during mode = %s.\n",
+          ptrSpaObj->modelicaName, fmuModeToString(bui->mode));
       }
     }
+    bui->valsOutVersion = bui->exchangeVersion;
   }
 
-  stopIfResultsAreNaN(bui, modelicaInstanceName, ptrReals);
+  if (ptrSpaObj->outputs->n > 0){
+    memcpy(ptrSpaObj->outputs->valsEP, &(bui->valsOutEP[ptrSpaObj->iOut]), ptrSpaObj->outputs->n * sizeof(fmi2Real));
+    setSIValues(bui, ptrSpaObj->modelicaName, ptrSpaObj->outputs);
+  }
 }
 
 
@@ -380,6 +522,8 @@ void setFMUMode(FMUBuilding* bui, FMUMode mode){
       bui->SpawnFormatMessage("%.3f %s: Switching to mode %s\n", bui->time, bui->modelicaNameBuilding, fmuModeToString(mode));
   }
   bui->mode = mode;
+  /* Outputs that were obtained before are no longer valid */
+  bui->exchangeVersion++;
 }
 /*
  Appends a character array to another character array.
@@ -39,6 +39,8 @@
 
 void mallocSpawnReals(const size_t n, spawnReals** r, void (*SpawnFormatError)(const char *string, ...));
 void mallocSpawnDerivatives(const size_t n, spawnDerivatives** r, void (*SpawnFormatError)(const char *string, ...));
+void freeSpawnReals(spawnReals* r);
+void freeSpawnDerivatives(spawnDerivatives* r);
 
 
 void mallocString(
@@ -55,6 +57,10 @@ void setVariables(
 
 void getVariables(FMUBuilding* bui, const char* modelicaInstanceName, spawnReals* ptrReals);
 
+void mallocBuildingOutputs(FMUBuilding* bui);
+
+void getBuildingOutputs(FMUBuilding* bui, const SpawnObject* ptrSpaObj);
+
 double do_event_iteration(FMUBuilding* bui, const char* modelicaInstanceName);
 
 void saveAppend(char* *buffer, const char *toAdd, size_t *bufLen, void (*SpawnFormatError)(const char *string, ...));
@@ -314,4 +314,42 @@ const char* cryptographicsHash(const char* str, void (*SpawnError)(const char *s
   return hexresult;
 }
 
+const char* cryptographicsHashFile(const char* fileName, void (*SpawnFormatError)(const char *string, ...))
+{
+  SHA1_CTX ctx;
+  FILE* fp;
+  unsigned char buff[8192];
+  unsigned char result[20];
+  size_t n;
+  size_t offset;
+  char* hexresult = (char *)malloc(41*sizeof(char));
+
+  if (!hexresult){
+    SpawnFormatError("Failed to allocate memory in cryptographicsHashFile for '%s'.", fileName);
+  }
+
+  fp = fopen(fileName, "rb");
+  if (fp == NULL){
+    free(hexresult);
+    SpawnFormatError("Failed to open '%s' to compute its hash: %s.", fileName, strerror(errno));
+  }
+
+  SHA1Init(&ctx);
+  while ((n = fread(buff, 1, sizeof buff, fp)) > 0)
+    SHA1Update(&ctx, buff, (uint32_t)n);
+  if (ferror(fp)){
+    fclose(fp);
+    free(hexresult);
+    SpawnFormatError("Failed to read '%s' to compute its hash.", fileName);
+  }
+  fclose(fp);
+  SHA1Final(result, &ctx);
+
+  for(offset = 0; offset < 20; offset++) {
+    sprintf( ( hexresult + (2*offset)), "%02x", result[offset]);
+  }
+
+  return hexresult;
+}
+
 #endif
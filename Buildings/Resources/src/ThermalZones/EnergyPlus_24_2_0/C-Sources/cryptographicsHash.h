@@ -44,4 +44,8 @@ static void SHA1(
 
 const char* cryptographicsHash(const char* str, void (*SpawnError)(const char *string));
 
+/* Return the SHA-1 hash of the content of the file fileName as a hex string.
+   The calling routine is responsible to free the returned string. */
+const char* cryptographicsHashFile(const char* fileName, void (*SpawnFormatError)(const char *string, ...));
+
 #endif /* CRYPTOGRAPHICSHASH_H */
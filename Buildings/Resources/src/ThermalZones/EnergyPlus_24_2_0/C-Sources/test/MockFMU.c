@@ -0,0 +1,368 @@
+/*
+ * Mock of the FMI Library for the tests of the Spawn C sources.
+ *
+ * The functions that are needed to exchange data with the FMU evaluate
+ * the model of mockFMU. All other functions stop the test, as the tests
+ * do not load an FMU.
+ */
+
+#include "MockFMU.h"
+#include "SpawnUtil.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+MockFMU mockFMU;
+
+/* The FMU and the variables are not dereferenced, hence any non-null pointer can be used */
+static int mockVariable;
+
+static void notSupported(const char* name){
+  fprintf(stderr, "Error: %s is not supported by the mock FMU.\n", name);
+  exit(1);
+}
+
+void mockFMUReset(
+  fmi2Real (*output)(const fmi2Real* vals, fmi2ValueReference vr),
+  fmi2Real (*derivative)(const fmi2Real* vals, fmi2ValueReference vrOut, fmi2ValueReference vrInp)){
+  memset(&mockFMU, 0, sizeof(MockFMU));
+  mockFMU.output = output;
+  mockFMU.derivative = derivative;
+}
+
+void mockMessage(const char *string){
+  printf("%s", string);
+}
+
+void mockError(const char *string){
+  fprintf(stderr, "Error: %s\n", string);
+  exit(1);
+}
+
+void mockFormatMessage(const char *string, ...){
+  va_list args;
+  va_start(args, string);
+  vprintf(string, args);
+  va_end(args);
+}
+
+void mockFormatError(const char *string, ...){
+  va_list args;
+  va_start(args, string);
+  fprintf(stderr, "Error: ");
+  vfprintf(stderr, string, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+  exit(1);
+}
+
+/* Allocate a building whose FMU is in event mode at time 0 */
+FMUBuilding* mockBuilding(size_t nExcObj){
+  FMUBuilding* bui = (FMUBuilding*)calloc(1, sizeof(FMUBuilding));
+  if (bui == NULL)
+    mockFormatError("Failed to allocate memory for the building.");
+  bui->exchange = (void**)calloc(nExcObj, sizeof(void*));
+  if (bui->exchange == NULL)
+    mockFormatError("Failed to allocate memory for the exchange objects.");
+  bui->fmu = (fmi2_import_t*)&mockVariable;
+  bui->modelicaNameBuilding = "building";
+  bui->time = 0;
+  bui->mode = eventMode;
+  bui->exchangeVersion = 1;
+  bui->derivativeMethod = finiteDifference;
+  bui->logLevel = WARNINGS;
+  bui->SpawnMessage = mockMessage;
+  bui->SpawnError = mockError;
+  bui->SpawnFormatMessage = mockFormatMessage;
+  bui->SpawnFormatError = mockFormatError;
+  return bui;
+}
+
+/* Allocate an exchange object of the building. The derivatives use the 1-based index of Modelica */
+SpawnObject* mockSpawnObject(
+  FMUBuilding* bui,
+  const char* modelicaName,
+  size_t nInp,
+  const fmi2ValueReference* inpValRefs,
+  size_t nOut,
+  const fmi2ValueReference* outValRefs,
+  size_t nDer,
+  const int* derivatives_structure,
+  const double* derivatives_delta){
+  size_t i;
+  SpawnObject* ptrSpaObj = (SpawnObject*)calloc(1, sizeof(SpawnObject));
+  if (ptrSpaObj == NULL)
+    mockFormatError("Failed to allocate memory for %s.", modelicaName);
+
+  ptrSpaObj->bui = bui;
+  ptrSpaObj->modelicaName = (char*)modelicaName;
+  ptrSpaObj->isInstantiated = fmi2True;
+  mallocSpawnReals(0, &(ptrSpaObj->parameters), mockFormatError);
+  mallocSpawnReals(nInp, &(ptrSpaObj->inputs), mockFormatError);
+  mallocSpawnReals(nOut, &(ptrSpaObj->outputs), mockFormatError);
+  mallocSpawnDerivatives(nDer, &(ptrSpaObj->derivatives), mockFormatError);
+
+  for(i = 0; i < nInp; i++){
+    ptrSpaObj->inputs->valRefs[i] = inpValRefs[i];
+    ptrSpaObj->inputs->units[i] = NULL;
+  }
+  for(i = 0; i < nOut; i++){
+    ptrSpaObj->outputs->valRefs[i] = outValRefs[i];
+    ptrSpaObj->outputs->units[i] = NULL;
+  }
+  for(i = 0; i < nDer; i++){
+    ptrSpaObj->derivatives->structure[i][0] = (size_t)(derivatives_structure[2*i]  ) - 1;
+    ptrSpaObj->derivatives->structure[i][1] = (size_t)(derivatives_structure[2*i+1]) - 1;
+    ptrSpaObj->derivatives->delta[i] = derivatives_delta[i];
+    ptrSpaObj->derivatives->vals[i] = 0;
+    ptrSpaObj->derivatives->uVals[i] = 0;
+  }
+
+  bui->exchange[bui->nExcObj] = ptrSpaObj;
+  bui->nExcObj++;
+  return ptrSpaObj;
+}
+
+void mockFreeBuilding(FMUBuilding* bui){
+  size_t i;
+  SpawnObject* ptrSpaObj;
+  for(i = 0; i < bui->nExcObj; i++){
+    ptrSpaObj = (SpawnObject*)bui->exchange[i];
+    freeSpawnReals(ptrSpaObj->parameters);
+    freeSpawnReals(ptrSpaObj->inputs);
+    freeSpawnReals(ptrSpaObj->outputs);
+    freeSpawnDerivatives(ptrSpaObj->derivatives);
+    free(ptrSpaObj);
+  }
+  free(bui->exchange);
+  free(bui->valRefsOut);
+  free(bui->valsOutEP);
+  free(bui);
+}
+
+static void checkValueReference(fmi2_value_reference_t vr){
+  if (vr >= MOCK_FMU_NVR)
+    mockFormatError("Value reference %u is not defined in the mock FMU.", vr);
+}
+
+/* Functions of the FMI Library that are evaluated by the mock FMU */
+fmi2_status_t fmi2_import_get_real(fmi2_import_t* fmu, const fmi2_value_reference_t vr[], size_t nvr, fmi2_real_t value[]){
+  size_t i;
+  mockFMU.nGetReal++;
+  mockFMU.nGetRealVals += nvr;
+  for(i = 0; i < nvr; i++){
+    checkValueReference(vr[i]);
+    if (vr[i] >= MOCK_FMU_OUTPUT_VR && mockFMU.output != NULL){
+      mockFMU.nOutputEval++;
+      value[i] = mockFMU.output(mockFMU.vals, vr[i]);
+    }
+    else
+      value[i] = mockFMU.vals[vr[i]];
+  }
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_set_real(fmi2_import_t* fmu, const fmi2_value_reference_t vr[], size_t nvr, const fmi2_real_t value[]){
+  size_t i;
+  mockFMU.nSetReal++;
+  for(i = 0; i < nvr; i++){
+    checkValueReference(vr[i]);
+    mockFMU.vals[vr[i]] = value[i];
+  }
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_get_directional_derivative(fmi2_import_t* fmu, const fmi2_value_reference_t v_ref[], size_t nv,
+  const fmi2_value_reference_t z_ref[], size_t nz, const fmi2_real_t dv[], fmi2_real_t dz[]){
+  size_t iv;
+  size_t iz;
+  mockFMU.nDirectionalDerivative++;
+  if (mockFMU.derivative == NULL)
+    return fmi2_status_error;
+  for(iz = 0; iz < nz; iz++){
+    dz[iz] = 0;
+    for(iv = 0; iv < nv; iv++)
+      dz[iz] += mockFMU.derivative(mockFMU.vals, z_ref[iz], v_ref[iv]) * dv[iv];
+  }
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_new_discrete_states(fmi2_import_t* fmu, fmi2_event_info_t* eventInfo){
+  eventInfo->newDiscreteStatesNeeded = fmi2_false;
+  eventInfo->terminateSimulation = fmi2_false;
+  eventInfo->nominalsOfContinuousStatesChanged = fmi2_false;
+  eventInfo->valuesOfContinuousStatesChanged = fmi2_false;
+  eventInfo->nextEventTimeDefined = fmi2_true;
+  eventInfo->nextEventTime = mockFMU.time + 600;
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_set_time(fmi2_import_t* fmu, fmi2_real_t time){
+  mockFMU.time = time;
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_enter_continuous_time_mode(fmi2_import_t* fmu){
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_enter_event_mode(fmi2_import_t* fmu){
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_completed_integrator_step(fmi2_import_t* fmu,
+  fmi2_boolean_t noSetFMUStatePriorToCurrentPoint,
+  fmi2_boolean_t* enterEventMode, fmi2_boolean_t* terminateSimulation){
+  *enterEventMode = fmi2_false;
+  *terminateSimulation = fmi2_false;
+  return fmi2_status_ok;
+}
+
+fmi2_status_t fmi2_import_exit_initialization_mode(fmi2_import_t* fmu){
+  return fmi2_status_ok;
+}
+
+fmi2_import_variable_t* fmi2_import_get_variable_by_vr(fmi2_import_t* fmu, fmi2_base_type_enu_t baseType, fmi2_value_reference_t vr){
+  return (fmi2_import_variable_t*)&mockVariable;
+}
+
+const char* fmi2_import_get_variable_name(fmi2_import_variable_t* v){
+  return "mockVariable";
+}
+
+const char* fmi2_import_get_unit_name(fmi2_import_unit_t* u){
+  return "1";
+}
+
+const char* fmi2_status_to_string(fmi2_status_t status){
+  return status == fmi2_status_ok ? "OK" : "Error";
+}
+
+/* Functions of the FMI Library that are not used by the tests */
+fmi2_status_t fmi2_import_enter_initialization_mode(fmi2_import_t* fmu){
+  notSupported("fmi2_import_enter_initialization_mode");
+  return fmi2_status_error;
+}
+
+fmi2_status_t fmi2_import_setup_experiment(fmi2_import_t* fmu,
+  fmi2_boolean_t toleranceDefined, fmi2_real_t tolerance,
+  fmi2_real_t startTime, fmi2_boolean_t stopTimeDefined,
+  fmi2_real_t stopTime){
+  notSupported("fmi2_import_setup_experiment");
+  return fmi2_status_error;
+}
+
+fmi2_status_t fmi2_import_terminate(fmi2_import_t* fmu){
+  notSupported("fmi2_import_terminate");
+  return fmi2_status_error;
+}
+
+fmi2_status_t fmi2_import_set_debug_logging(fmi2_import_t* fmu, fmi2_boolean_t loggingOn, size_t nCategories, fmi2_string_t categories[]){
+  notSupported("fmi2_import_set_debug_logging");
+  return fmi2_status_error;
+}
+
+jm_status_enu_t fmi2_import_instantiate(fmi2_import_t* fmu,
+  fmi2_string_t instanceName, fmi2_type_t fmuType,
+  fmi2_string_t fmuResourceLocation, fmi2_boolean_t visible){
+  notSupported("fmi2_import_instantiate");
+  return jm_status_error;
+}
+
+jm_status_enu_t fmi2_import_create_dllfmu(fmi2_import_t* fmu, fmi2_fmu_kind_enu_t fmuKind, const fmi2_callback_functions_t* callBackFunctions){
+  notSupported("fmi2_import_create_dllfmu");
+  return jm_status_error;
+}
+
+void fmi2_import_destroy_dllfmu(fmi2_import_t* fmu){
+  notSupported("fmi2_import_destroy_dllfmu");
+}
+
+void fmi2_import_free(fmi2_import_t* fmu){
+  notSupported("fmi2_import_free");
+}
+
+fmi2_import_t* fmi2_import_parse_xml(fmi_import_context_t* context, const char* dirPath, fmi2_xml_callbacks_t* xml_callbacks){
+  notSupported("fmi2_import_parse_xml");
+  return NULL;
+}
+
+const char* fmi2_import_get_GUID(fmi2_import_t* fmu){
+  notSupported("fmi2_import_get_GUID");
+  return NULL;
+}
+
+unsigned int fmi2_import_get_capability(fmi2_import_t* fmu, fmi2_capabilities_enu_t id){
+  notSupported("fmi2_import_get_capability");
+  return 0;
+}
+
+fmi2_fmu_kind_enu_t fmi2_import_get_fmu_kind(fmi2_import_t* fmu){
+  notSupported("fmi2_import_get_fmu_kind");
+  return fmi2_fmu_kind_unknown;
+}
+
+size_t fmi2_import_get_log_categories_num(fmi2_import_t* fmu){
+  notSupported("fmi2_import_get_log_categories_num");
+  return 0;
+}
+
+const char* fmi2_import_get_log_category(fmi2_import_t* fmu, size_t index){
+  notSupported("fmi2_import_get_log_category");
+  return NULL;
+}
+
+fmi2_import_variable_t* fmi2_import_get_variable_by_name(fmi2_import_t* fmu, const char* name){
+  notSupported("fmi2_import_get_variable_by_name");
+  return NULL;
+}
+
+fmi2_value_reference_t fmi2_import_get_variable_vr(fmi2_import_variable_t* v){
+  notSupported("fmi2_import_get_variable_vr");
+  return 0;
+}
+
+fmi2_import_real_variable_t* fmi2_import_get_variable_as_real(fmi2_import_variable_t* v){
+  notSupported("fmi2_import_get_variable_as_real");
+  return NULL;
+}
+
+fmi2_import_unit_t* fmi2_import_get_real_variable_unit(fmi2_import_real_variable_t* v){
+  notSupported("fmi2_import_get_real_variable_unit");
+  return NULL;
+}
+
+double fmi2_import_get_SI_unit_factor(fmi2_import_unit_t* u){
+  notSupported("fmi2_import_get_SI_unit_factor");
+  return 1;
+}
+
+double fmi2_import_get_SI_unit_offset(fmi2_import_unit_t* u){
+  notSupported("fmi2_import_get_SI_unit_offset");
+  return 0;
+}
+
+fmi_import_context_t* fmi_import_allocate_context(jm_callbacks* callbacks){
+  notSupported("fmi_import_allocate_context");
+  return NULL;
+}
+
+void fmi_import_free_context(fmi_import_context_t* c){
+  notSupported("fmi_import_free_context");
+}
+
+fmi_version_enu_t fmi_import_get_fmi_version(fmi_import_context_t* c, const char* fileName, const char* dirName){
+  notSupported("fmi_import_get_fmi_version");
+  return fmi_version_unknown_enu;
+}
+
+const char* fmi_version_to_string(fmi_version_enu_t v){
+  return "2.0";
+}
+
+jm_callbacks* jm_get_default_callbacks(void){
+  notSupported("jm_get_default_callbacks");
+  return NULL;
+}
@@ -0,0 +1,58 @@
+/*
+ * Mock of the FMI Library for the tests of the Spawn C sources.
+ *
+ * The mock replaces the EnergyPlus FMU by a model whose outputs are
+ * functions of the inputs, and counts the calls to the FMU.
+ */
+
+#ifndef Buildings_MockFMU_h
+#define Buildings_MockFMU_h
+
+#include "SpawnTypes.h"
+
+#define MOCK_FMU_NVR 64 /* Number of value references of the mock FMU */
+#define MOCK_FMU_OUTPUT_VR 32 /* Value references of outputs are at least MOCK_FMU_OUTPUT_VR */
+
+typedef struct MockFMU
+{
+  fmi2Real vals[MOCK_FMU_NVR]; /* Values of the inputs, indexed by the value reference */
+  fmi2Real time; /* Time that is set in the FMU */
+  fmi2Real (*output)(const fmi2Real* vals, fmi2ValueReference vr); /* Function that computes the output vr */
+  fmi2Real (*derivative)(const fmi2Real* vals, fmi2ValueReference vrOut, fmi2ValueReference vrInp); /* Derivative of output vrOut with respect to input vrInp */
+  size_t nGetReal;      /* Number of calls to fmi2_import_get_real */
+  size_t nGetRealVals;  /* Number of values obtained by fmi2_import_get_real */
+  size_t nSetReal;      /* Number of calls to fmi2_import_set_real */
+  size_t nOutputEval;   /* Number of evaluations of the function output */
+  size_t nDirectionalDerivative; /* Number of calls to fmi2_import_get_directional_derivative */
+} MockFMU;
+
+extern MockFMU mockFMU;
+
+void mockFMUReset(
+  fmi2Real (*output)(const fmi2Real* vals, fmi2ValueReference vr),
+  fmi2Real (*derivative)(const fmi2Real* vals, fmi2ValueReference vrOut, fmi2ValueReference vrInp));
+
+FMUBuilding* mockBuilding(size_t nExcObj);
+
+SpawnObject* mockSpawnObject(
+  FMUBuilding* bui,
+  const char* modelicaName,
+  size_t nInp,
+  const fmi2ValueReference* inpValRefs,
+  size_t nOut,
+  const fmi2ValueReference* outValRefs,
+  size_t nDer,
+  const int* derivatives_structure,
+  const double* derivatives_delta);
+
+void mockFreeBuilding(FMUBuilding* bui);
+
+void mockMessage(const char *string);
+
+void mockError(const char *string);
+
+void mockFormatMessage(const char *string, ...);
+
+void mockFormatError(const char *string, ...);
+
+#endif
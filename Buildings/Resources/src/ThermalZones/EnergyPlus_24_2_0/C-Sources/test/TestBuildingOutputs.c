@@ -0,0 +1,120 @@
+/*
+ * Test of the outputs that are obtained for all exchange objects of a building.
+ *
+ * Two objects A and B exchange data with a building whose outputs
+ * depend on the inputs of both objects. The test checks that
+ *  - outputs of A that were obtained before are not reused after B set its inputs,
+ *  - A reuses the outputs that B obtained for all objects, without calling the FMU,
+ *  - each object only converts its own outputs.
+ */
+
+#include "MockFMU.h"
+#include "SpawnObjectExchange.h"
+#include "SpawnUtil.h"
+
+#include <stdio.h>
+
+/* Outputs of the building: A has the input vr 0 and the outputs vr 32 and 33,
+   B has the input vr 1 and the output vr 34 */
+static fmi2Real output(const fmi2Real* vals, fmi2ValueReference vr){
+  switch(vr){
+    case 32: return vals[0] + 10*vals[1];
+    case 33: return 2*vals[0];
+    case 34: return vals[0]*vals[1] + 1;
+    default: return 0;
+  }
+}
+
+static int nErr = 0;
+
+static void check(const char* label, double y, double yExp){
+  if (y != yExp){
+    printf("%s: y = %g, expected %g. Error.\n", label, y, yExp);
+    nErr++;
+  }
+  else
+    printf("%s: y = %g.\n", label, y);
+}
+
+static void checkCalls(const char* label, size_t n, size_t nExp){
+  if (n != nExp){
+    printf("%s: %lu calls to get outputs, expected %lu. Error.\n", label, (unsigned long)n, (unsigned long)nExp);
+    nErr++;
+  }
+}
+
+int main(void){
+  const fmi2ValueReference inpA[] = {0};
+  const fmi2ValueReference outA[] = {32, 33};
+  const fmi2ValueReference inpB[] = {1};
+  const fmi2ValueReference outB[] = {34};
+  double uA[2]; /* Input and time */
+  double uB[2];
+  double yA[3]; /* Outputs and next event time */
+  double yB[2];
+  size_t nGetReal;
+  FMUBuilding* bui;
+  SpawnObject* A;
+  SpawnObject* B;
+
+  mockFMUReset(output, NULL);
+  bui = mockBuilding(2);
+  A = mockSpawnObject(bui, "A", 1, inpA, 2, outA, 0, NULL, NULL);
+  B = mockSpawnObject(bui, "B", 1, inpB, 1, outB, 0, NULL, NULL);
+  mallocBuildingOutputs(bui);
+
+  uA[0] = 1; uA[1] = 0;
+  uB[0] = 2; uB[1] = 0;
+  exchange_Spawn_EnergyPlus_24_2_0(A, 1, uA, yA);
+  check("Initial exchange of A", yA[0], 1);
+  check("Next event time of A", yA[2], 600);
+  exchange_Spawn_EnergyPlus_24_2_0(B, 1, uB, yB);
+  check("Initial exchange of B", yB[0], 3);
+
+  /* The inputs of A are unchanged, but B set its inputs after A obtained its outputs */
+  nGetReal = mockFMU.nGetReal;
+  B->outputs->valsSI[0] = -1;
+  exchange_Spawn_EnergyPlus_24_2_0(A, 0, uA, yA);
+  check("Exchange of A after inputs of B were set", yA[0], 21);
+  check("Second output of A", yA[1], 2);
+  checkCalls("Exchange of A after inputs of B were set", mockFMU.nGetReal - nGetReal, 0);
+  check("Output of B not converted by A", B->outputs->valsSI[0], -1);
+
+  /* B changes its inputs */
+  uB[0] = 3;
+  A->outputs->valsSI[0] = -1;
+  exchange_Spawn_EnergyPlus_24_2_0(B, 0, uB, yB);
+  check("Exchange of B with new input", yB[0], 4);
+  check("Output of A not converted by B", A->outputs->valsSI[0], -1);
+  nGetReal = mockFMU.nGetReal;
+  exchange_Spawn_EnergyPlus_24_2_0(A, 0, uA, yA);
+  check("Exchange of A after input of B changed", yA[0], 31);
+  checkCalls("Exchange of A after input of B changed", mockFMU.nGetReal - nGetReal, 0);
+
+  /* Repeated call of A at the same time */
+  nGetReal = mockFMU.nGetReal;
+  exchange_Spawn_EnergyPlus_24_2_0(A, 0, uA, yA);
+  check("Repeated exchange of A", yA[0], 31);
+  checkCalls("Repeated exchange of A", mockFMU.nGetReal - nGetReal, 0);
+
+  /* Time advances: the outputs must be obtained again */
+  uA[1] = 600;
+  uB[1] = 600;
+  nGetReal = mockFMU.nGetReal;
+  exchange_Spawn_EnergyPlus_24_2_0(A, 0, uA, yA);
+  check("Exchange of A at new time", yA[0], 31);
+  check("Next event time of A at new time", yA[2], 1200);
+  if (mockFMU.nGetReal == nGetReal){
+    printf("Exchange of A at new time did not get the outputs from the FMU. Error.\n");
+    nErr++;
+  }
+
+  mockFreeBuilding(bui);
+
+  if (nErr > 0){
+    printf("%d checks failed.\n", nErr);
+    return 1;
+  }
+  printf("All checks passed.\n");
+  return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Test of the methods used to compute the derivatives of the outputs with respect to the inputs.
+ *
+ * An object with two inputs and two outputs exchanges data with a building
+ * whose outputs are nonlinear functions of the inputs. The test compares the
+ * accuracy and the cost of finiteDifference, bulkFiniteDifference and
+ * directionalDerivative, and checks that the derivatives are only reused
+ * before the next event time that was requested when they were computed.
+ */
+
+#include "MockFMU.h"
+#include "SpawnObjectExchange.h"
+#include "SpawnUtil.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define NINP 2
+#define NOUT 2
+#define NDER 4
+
+static const char* methodNames[] = {"finiteDifference", "bulkFiniteDifference", "directionalDerivative"};
+
+/* Outputs of the building: the inputs have the vr 0 and 1, the outputs have the vr 32 and 33 */
+static fmi2Real output(const fmi2Real* vals, fmi2ValueReference vr){
+  switch(vr){
+    case 32: return vals[0]*vals[0] + 3*vals[0]*vals[1];
+    case 33: return exp(0.5*vals[1]) + vals[0];
+    default: return 0;
+  }
+}
+
+static fmi2Real derivative(const fmi2Real* vals, fmi2ValueReference vrOut, fmi2ValueReference vrInp){
+  if (vrOut == 32)
+    return vrInp == 0 ? 2*vals[0] + 3*vals[1] : 3*vals[0];
+  if (vrOut == 33)
+    return vrInp == 0 ? 1 : 0.5*exp(0.5*vals[1]);
+  return 0;
+}
+
+static const fmi2ValueReference inpValRefs[NINP] = {0, 1};
+static const fmi2ValueReference outValRefs[NOUT] = {32, 33};
+/* dy1/du1, dy1/du2, dy2/du1, dy2/du2, using the 1-based index of Modelica */
+static const int derivatives_structure[2*NDER] = {1, 1, 1, 2, 2, 1, 2, 2};
+static const double derivatives_delta[NDER] = {0.1, 0.1, 0.1, 0.1};
+
+static int nErr = 0;
+
+static void check(const char* label, bool passed){
+  if (!passed){
+    printf("%s. Error.\n", label);
+    nErr++;
+  }
+}
+
+/* Return the largest error of the derivatives y[NOUT], ..., y[NOUT+NDER-1] at the inputs u */
+static double maxError(const double* u, const double* y){
+  size_t iDer;
+  double err = 0;
+  fmi2Real vals[MOCK_FMU_NVR] = {0};
+  vals[0] = u[0];
+  vals[1] = u[1];
+  for(iDer = 0; iDer < NDER; iDer++){
+    err = max(err, fabs(y[NOUT+iDer] -
+      derivative(vals, outValRefs[derivatives_structure[2*iDer]-1], inpValRefs[derivatives_structure[2*iDer+1]-1])));
+  }
+  return err;
+}
+
+/* Exchange the object and check if the derivatives were computed or reused */
+static void exchange(SpawnObject* ptrSpaObj, int initialCall, const double* u, double* y, bool reuse, const char* label){
+  const size_t nSetReal = mockFMU.nSetReal;
+  const size_t nDirectionalDerivative = mockFMU.nDirectionalDerivative;
+  bool computed;
+
+  exchange_Spawn_EnergyPlus_24_2_0(ptrSpaObj, initialCall, u, y);
+  /* The inputs are set at most once if the derivatives are reused */
+  computed = (mockFMU.nSetReal > nSetReal + 1) || (mockFMU.nDirectionalDerivative > nDirectionalDerivative);
+  printf("  %-45s derivatives %s.\n", label, computed ? "computed" : "reused");
+  check(label, computed != reuse);
+}
+
+int main(void){
+  DerivativeMethod method;
+  FMUBuilding* bui;
+  SpawnObject* ptrSpaObj;
+  double u[NINP+1]; /* Inputs and time */
+  double y[NOUT+NDER+1]; /* Outputs, derivatives and next event time */
+  double yFD[NOUT+NDER+1]; /* Results of finiteDifference */
+  size_t nSetRealFD = 0;
+  double err;
+  size_t iDer;
+
+  printf("%-22s %12s %10s %10s %12s\n", "method", "max. error", "set real", "get real", "dir. deriv.");
+  for(method = finiteDifference; method <= directionalDerivative; method++){
+    mockFMUReset(output, derivative);
+    bui = mockBuilding(1);
+    bui->derivativeMethod = method;
+    ptrSpaObj = mockSpawnObject(bui, "zone", NINP, inpValRefs, NOUT, outValRefs,
+      NDER, derivatives_structure, derivatives_delta);
+    mallocBuildingOutputs(bui);
+
+    u[0] = 1;
+    u[1] = 2;
+    u[2] = 0;
+    exchange_Spawn_EnergyPlus_24_2_0(ptrSpaObj, 1, u, y);
+    err = maxError(u, y);
+    printf("%-22s %12.3e %10lu %10lu %12lu\n", methodNames[method], err,
+      (unsigned long)mockFMU.nSetReal, (unsigned long)mockFMU.nGetRealVals,
+      (unsigned long)mockFMU.nDirectionalDerivative);
+
+    /* Accuracy and cost */
+    if (method == finiteDifference){
+      /* The forward difference has an error of delta/2 times the second derivative, which is 2 for dy1/du1 */
+      check("Error of finiteDifference", err > 0 && err <= 0.5*0.1*2 + 1E-10);
+      check("Number of evaluations of finiteDifference", mockFMU.nSetReal == NDER + 1);
+      nSetRealFD = mockFMU.nSetReal;
+      for(iDer = 0; iDer < NOUT+NDER+1; iDer++)
+        yFD[iDer] = y[iDer];
+    }
+    else if (method == bulkFiniteDifference){
+      for(iDer = 0; iDer < NOUT+NDER+1; iDer++)
+        check("Results of bulkFiniteDifference differ from finiteDifference", y[iDer] == yFD[iDer]);
+      /* Each input is only perturbed once */
+      check("Number of evaluations of bulkFiniteDifference", mockFMU.nSetReal == NINP + 1 && mockFMU.nSetReal < nSetRealFD);
+    }
+    else{
+      check("Error of directionalDerivative", err < 1E-12);
+      check("Number of evaluations of directionalDerivative", mockFMU.nSetReal == 1 && mockFMU.nDirectionalDerivative == NDER);
+    }
+
+    /* Reuse of the derivatives */
+    u[0] = 1.01;
+    exchange(ptrSpaObj, 0, u, y, method != finiteDifference, "Input changed by less than delta");
+    u[0] = 1.5;
+    exchange(ptrSpaObj, 0, u, y, false, "Input changed by more than delta");
+    u[2] = 300;
+    exchange(ptrSpaObj, 0, u, y, method != finiteDifference, "Time advanced before the next event time");
+    u[2] = 600;
+    exchange(ptrSpaObj, 0, u, y, false, "Time advanced to the next event time");
+    if (method == directionalDerivative)
+      check("Error of directionalDerivative after recomputation", maxError(u, y) < 1E-12);
+
+    mockFreeBuilding(bui);
+  }
+
+  if (nErr > 0){
+    printf("%d checks failed.\n", nErr);
+    return 1;
+  }
+  printf("All checks passed.\n");
+  return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Test of the cache of the EnergyPlus FMUs.
+ *
+ * The test uses the directory TestFMUCache.tmp in the current directory as
+ * SPAWNCACHE, with small text files in place of the idf, epw and FMU files.
+ * It checks that
+ *  - an FMU that is not in the cache is generated while holding the lock,
+ *  - a stored FMU is copied from the cache,
+ *  - a change of the idf file gives a different cache file,
+ *  - a lock that is older than SPAWN_FMU_CACHE_LOCK_TIMEOUT is removed,
+ *  - a simulation waits for the FMU while another process holds a recent lock.
+ */
+
+#include "MockFMU.h"
+#include "SpawnFMUCache.h"
+#include "SpawnUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define TEST_DIR "TestFMUCache.tmp"
+
+static int nErr = 0;
+
+static void check(const char* label, bool passed){
+  printf("%-60s %s\n", label, passed ? "passed" : "failed. Error.");
+  if (!passed)
+    nErr++;
+}
+
+static void writeFile(const char* name, const char* text){
+  FILE* fil = fopen(name, "w");
+  if (fil == NULL || fputs(text, fil) == EOF)
+    mockFormatError("Failed to write '%s'.", name);
+  fclose(fil);
+}
+
+static bool fileExists(const char* name){
+  return access(name, F_OK) == 0;
+}
+
+/* Return true if the file name contains text */
+static bool hasContent(const char* name, const char* text){
+  char buff[256];
+  size_t n;
+  FILE* fil = fopen(name, "r");
+  if (fil == NULL)
+    return false;
+  n = fread(buff, 1, sizeof(buff) - 1, fil);
+  fclose(fil);
+  buff[n] = '\0';
+  return strcmp(buff, text) == 0;
+}
+
+/* Return a building that loads the FMU fmuName generated from the idf and epw files of the test */
+static FMUBuilding* cacheBuilding(const char* fmuName){
+  FMUBuilding* bui = mockBuilding(1);
+  bui->modelHash = "modelHash";
+  bui->idfName = TEST_DIR "/model.idf";
+  bui->weather = TEST_DIR "/weather.epw";
+  bui->spawnExe = "spawn-test";
+  bui->idfVersion = "24_2_0";
+  bui->fmuAbsPat = (char*)fmuName;
+  return bui;
+}
+
+static void freeCacheBuilding(FMUBuilding* bui){
+  releaseFMUCacheLock(bui);
+  free(bui->fmuCacheFile);
+  bui->fmuCacheFile = NULL;
+  mockFreeBuilding(bui);
+}
+
+int main(void){
+  FMUBuilding* bui;
+  FMUBuilding* buiOther;
+  char* cacheFile1;
+  char* cacheFile;
+  char* lockName;
+  char pid[32];
+  struct utimbuf times;
+  pid_t child;
+  int status;
+
+  mkdir(TEST_DIR, 0755);
+  if (setenv("SPAWNCACHE", TEST_DIR "/cache", 1) != 0)
+    mockFormatError("Failed to set SPAWNCACHE.");
+  writeFile(TEST_DIR "/model.idf", "idf 1");
+  writeFile(TEST_DIR "/weather.epw", "epw");
+
+  /* The cache is empty */
+  bui = cacheBuilding(TEST_DIR "/generated.fmu");
+  check("FMU not in empty cache", !getFMUFromCache(bui));
+  check("Lock held while generating FMU", bui->fmuCacheLock != NULL && fileExists(bui->fmuCacheLock));
+  cacheFile1 = strdup(bui->fmuCacheFile);
+  lockName = strdup(bui->fmuCacheLock);
+  writeFile(TEST_DIR "/generated.fmu", "FMU 1");
+  storeFMUInCache(bui);
+  check("FMU stored in cache", hasContent(cacheFile1, "FMU 1"));
+  check("Lock released after storing FMU", bui->fmuCacheLock == NULL && !fileExists(lockName));
+  freeCacheBuilding(bui);
+
+  /* The same building is simulated again */
+  bui = cacheBuilding(TEST_DIR "/loaded.fmu");
+  check("FMU in cache", getFMUFromCache(bui));
+  check("FMU copied from cache", hasContent(TEST_DIR "/loaded.fmu", "FMU 1"));
+  check("No lock held for FMU in cache", bui->fmuCacheLock == NULL);
+  freeCacheBuilding(bui);
+  free(lockName);
+
+  /* The idf file changed */
+  writeFile(TEST_DIR "/model.idf", "idf 2");
+  bui = cacheBuilding(TEST_DIR "/generated.fmu");
+  check("FMU of changed idf file not in cache", !getFMUFromCache(bui));
+  cacheFile = strdup(bui->fmuCacheFile);
+  check("Cache file changed with idf file", strcmp(cacheFile, cacheFile1) != 0);
+  lockName = strdup(bui->fmuCacheLock);
+  freeCacheBuilding(bui);
+  check("Lock released without storing FMU", !fileExists(lockName) && !fileExists(cacheFile));
+
+  /* A simulation that stopped without releasing the lock left a stale lock */
+  writeFile(lockName, "12345\n");
+  times.actime = time(NULL) - SPAWN_FMU_CACHE_LOCK_TIMEOUT - 60;
+  times.modtime = times.actime;
+  utime(lockName, &times);
+  bui = cacheBuilding(TEST_DIR "/generated.fmu");
+  check("FMU not in cache with stale lock", !getFMUFromCache(bui));
+  sprintf(pid, "%ld\n", (long)getpid());
+  check("Stale lock replaced by lock of this process",
+    bui->fmuCacheLock != NULL && strcmp(bui->fmuCacheLock, lockName) == 0 && hasContent(lockName, pid));
+  freeCacheBuilding(bui);
+
+  /* Another process holds a recent lock and stores the FMU after a while */
+  buiOther = cacheBuilding(TEST_DIR "/other.fmu");
+  check("FMU not in cache for other process", !getFMUFromCache(buiOther));
+  fflush(stdout);
+  child = fork();
+  if (child == 0){
+    sleep(2);
+    writeFile(TEST_DIR "/other.fmu", "FMU 2");
+    storeFMUInCache(buiOther);
+    _exit(0);
+  }
+  /* The lock of buiOther is released by the child process */
+  free(buiOther->fmuCacheLock);
+  buiOther->fmuCacheLock = NULL;
+  bui = cacheBuilding(TEST_DIR "/loaded.fmu");
+  check("FMU in cache after waiting for other process", child > 0 && getFMUFromCache(bui));
+  check("FMU of other process copied from cache", hasContent(TEST_DIR "/loaded.fmu", "FMU 2"));
+  check("Lock of other process released", !fileExists(lockName));
+  if (child > 0)
+    waitpid(child, &status, 0);
+  freeCacheBuilding(bui);
+  freeCacheBuilding(buiOther);
+
+  remove(cacheFile1);
+  remove(cacheFile);
+  remove(TEST_DIR "/cache");
+  free(cacheFile1);
+  free(cacheFile);
+  free(lockName);
+  remove(TEST_DIR "/model.idf");
+  remove(TEST_DIR "/weather.epw");
+  remove(TEST_DIR "/generated.fmu");
+  remove(TEST_DIR "/loaded.fmu");
+  remove(TEST_DIR "/other.fmu");
+  remove(TEST_DIR);
+
+  if (nErr > 0){
+    printf("%d checks failed.\n", nErr);
+    return 1;
+  }
+  printf("All checks passed.\n");
+  return 0;
+}